@@ -34,6 +34,9 @@ function configure_graphics_api()
     elseif ARG_API_GRAPHICS == "vulkan" then
         API_CPP_DEFINE = "API_GRAPHICS_VULKAN"
         EXECUTABLE_NAME = EXECUTABLE_NAME .. "_vulkan"
+    elseif ARG_API_GRAPHICS == "null" then
+        API_CPP_DEFINE = "API_GRAPHICS_NULL"
+        EXECUTABLE_NAME = EXECUTABLE_NAME .. "_null"
     else
         error("Unsupported graphics API: " .. tostring(ARG_API_GRAPHICS))
     end
@@ -90,9 +93,11 @@ function spartan_project_configuration()
         }
 
         if ARG_API_GRAPHICS == "d3d12" then
-            removefiles { SOURCE_DIR .. "/runtime/RHI/Vulkan/**" }
+            removefiles { SOURCE_DIR .. "/runtime/RHI/Vulkan/**", SOURCE_DIR .. "/runtime/RHI/Null/**" }
         elseif ARG_API_GRAPHICS == "vulkan" then
-            removefiles { SOURCE_DIR .. "/runtime/RHI/D3D12/**" }
+            removefiles { SOURCE_DIR .. "/runtime/RHI/D3D12/**", SOURCE_DIR .. "/runtime/RHI/Null/**" }
+        elseif ARG_API_GRAPHICS == "null" then
+            removefiles { SOURCE_DIR .. "/runtime/RHI/Vulkan/**", SOURCE_DIR .. "/runtime/RHI/D3D12/**" }
         end
 
         pchheader "pch.h"
@@ -121,6 +126,8 @@ function spartan_project_configuration()
                 "/usr/include/SDL3", "/usr/include/assimp", "/usr/include/physx",
                 "/usr/include/freetype2", "/usr/include/renderdoc"
             }
+            links { "dl" }
+            linkoptions { "-rdynamic" } -- exported symbols let the allocation profiler name call stacks
 
         -- Vulkan-specific includes (Windows only)
         filter { "system:windows" }
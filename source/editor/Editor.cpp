@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Widgets/MenuBar.h"
 #include "Core/Engine.h"
 #include "Core/Settings.h"
+#include "Memory/Allocator.h"
 #include "ImGui/ImGui_Extension.h"
 #include "ImGui/Implementation/ImGui_RHI.h"
 #include "ImGui/Implementation/imgui_impl_sdl3.h"
@@ -52,7 +53,7 @@ namespace
     float font_size  = 18.0f;
     float font_scale = 1.0f;
 
-    void process_event(spartan::sp_variant data)
+    void process_event(const spartan::sp_variant& data)
     {
         SDL_Event* event_sdl = static_cast<SDL_Event*>(get<void*>(data));
         ImGui_ImplSDL3_ProcessEvent(event_sdl);
@@ -142,6 +143,8 @@ void Editor::Tick()
             // editor
             if (render_editor)
             {
+                SP_MEMORY_TAG(spartan::MemoryTag::Ui);
+
                 BeginWindow();
 
                 for (shared_ptr<Widget>& widget : m_widgets)
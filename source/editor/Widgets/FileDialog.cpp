@@ -103,6 +103,8 @@ end
 -- Called every frame. Main update function.
 function MyScript:Tick(Entity)
     -- Frame update logic here
+    -- Spread expensive work over frames with a coroutine:
+    -- Coroutine.Start(function() Coroutine.WaitSeconds(1.0) --[[ ... ]] end)
 end
 
 -- Called when the entity is being saved.
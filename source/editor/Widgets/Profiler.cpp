@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Profiling/Profiler.h"
 #include "../RHI/RHI_Device.h"
 #include "../Memory/Allocator.h"
+#include "../Memory/AllocationProfiler.h"
 //===================================
 
 //= NAMESPACES ===============
@@ -62,6 +63,21 @@ namespace
         );
     }
 
+    // 1234567 -> "1.23M", keeps counter columns narrow
+    const char* format_count(const double value, char* buffer, const size_t buffer_size)
+    {
+        if (value >= 1e9)      snprintf(buffer, buffer_size, "%.2fG", value / 1e9);
+        else if (value >= 1e6) snprintf(buffer, buffer_size, "%.2fM", value / 1e6);
+        else if (value >= 1e3) snprintf(buffer, buffer_size, "%.1fk", value / 1e3);
+        else                   snprintf(buffer, buffer_size, "%.0f", value);
+        return buffer;
+    }
+
+    float get_ipc(const double cycles, const double instructions)
+    {
+        return cycles > 0.0 ? static_cast<float>(instructions / cycles) : 0.0f;
+    }
+
     void show_time_block(const spartan::TimeBlock& time_block)
     {
         const float m_tree_depth_stride = 10;
@@ -79,7 +95,20 @@ namespace
         ImGui::GetWindowDrawList()->AddRectFilled(pos_screen, ImVec2(pos_screen.x + width, pos_screen.y + text_height), col);
 
         ImGui::SetCursorPos(ImVec2(pos.x + m_tree_depth_stride * time_block.GetTreeDepth(), pos.y));
-        ImGui::Text("%s - %.2f ms", name, duration);
+        if (time_block.HasCounters())
+        {
+            char l1[16], llc[16], branch[16];
+            const double cycles       = static_cast<double>(time_block.GetCounter(spartan::HardwareCounter::Cycles));
+            const double instructions = static_cast<double>(time_block.GetCounter(spartan::HardwareCounter::Instructions));
+            ImGui::Text("%s - %.2f ms | %.2f ipc, %s l1 miss, %s llc miss, %s branch miss", name, duration, get_ipc(cycles, instructions),
+                format_count(static_cast<double>(time_block.GetCounter(spartan::HardwareCounter::CacheMissesL1)), l1, sizeof(l1)),
+                format_count(static_cast<double>(time_block.GetCounter(spartan::HardwareCounter::CacheMissesLlc)), llc, sizeof(llc)),
+                format_count(static_cast<double>(time_block.GetCounter(spartan::HardwareCounter::BranchMisses)), branch, sizeof(branch)));
+        }
+        else
+        {
+            ImGui::Text("%s - %.2f ms", name, duration);
+        }
     }
 
     void show_memory_bar(const char* label, float used_mb, float budget_mb, float total_mb, ImVec2 size = ImVec2(-1, 0))
@@ -127,6 +156,9 @@ namespace
     int mode_hardware = 0; // 0: gpu, 1: cpu
     int mode_sort     = 1; // 0: alphabetically, 1: by duration
     int mode_view     = 1; // 0: list, 1: timeline
+
+    const size_t allocation_sampling_interval = 256 * 1024; // bytes between samples
+    const size_t allocation_sites_shown       = 20;
 }
 
 Profiler::Profiler(Editor* editor) : Widget(editor)
@@ -197,6 +229,15 @@ void Profiler::OnTickVisible()
             }
         }
 
+        // capture every thread for a few seconds, the file opens in chrome://tracing or perfetto
+        ImGui::SameLine();
+        ImGui::BeginDisabled(spartan::Profiler::IsTracing());
+        if (ImGui::Button(spartan::Profiler::IsTracing() ? "Capturing..." : "Capture Trace"))
+        {
+            spartan::Profiler::TraceCaptureFrames(300, "profiler_trace.json");
+        }
+        ImGui::EndDisabled();
+
         // freeze toggle and update interval on the same line
         ImGui::Text("Freeze");
         ImGui::SameLine();
@@ -643,6 +684,20 @@ void Profiler::OnTickVisible()
                     queue_name = "compute";
                 ImGui::Text("queue:    %s", queue_name);
             }
+            else if (tooltip_block->HasCounters())
+            {
+                ImGui::Separator();
+                char count[16];
+                for (uint32_t i = 0; i < static_cast<uint32_t>(spartan::HardwareCounter::Count); i++)
+                {
+                    spartan::HardwareCounter counter = static_cast<spartan::HardwareCounter>(i);
+                    if (spartan::HardwareCounters::IsAvailable(counter))
+                    {
+                        ImGui::Text("%-14s %s", spartan::HardwareCounters::GetName(counter), format_count(static_cast<double>(tooltip_block->GetCounter(counter)), count, sizeof(count)));
+                    }
+                }
+                ImGui::Text("%-14s %.2f", "ipc", get_ipc(static_cast<double>(tooltip_block->GetCounter(spartan::HardwareCounter::Cycles)), static_cast<double>(tooltip_block->GetCounter(spartan::HardwareCounter::Instructions))));
+            }
             ImGui::EndTooltip();
         }
 
@@ -714,4 +769,191 @@ void Profiler::OnTickVisible()
 
         show_memory_bar(is_vram ? "VRAM" : "RAM", allocated, available, total, ImVec2(-1, 32));
     }
+
+    // allocations (ram) and hardware counters
+    if (type == spartan::TimeBlockType::Cpu)
+    {
+        ShowAllocations();
+        ShowHardwareCounters();
+    }
+}
+
+void Profiler::ShowAllocations()
+{
+    ImGui::Separator();
+
+    // by tag
+    if (ImGui::BeginTable("##allocation_tags", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+    {
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Allocated");
+        ImGui::TableSetupColumn("Allocations/Frame");
+        ImGui::TableHeadersRow();
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(spartan::MemoryTag::Count); i++)
+        {
+            spartan::MemoryTag tag = static_cast<spartan::MemoryTag>(i);
+
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(spartan::Allocator::GetTagName(tag));
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%.2f MB", spartan::Allocator::GetMemoryAllocatedByTagMb(tag));
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%u", spartan::Allocator::GetAllocationsLastFrame(tag));
+        }
+
+        ImGui::EndTable();
+    }
+
+    // sampling, take a snapshot, play for a while, then diff to see what grew
+    bool sampling = spartan::Allocator::GetSamplingInterval() != 0;
+    ImGui::Text("Sample Allocations");
+    ImGui::SameLine();
+    if (ImGuiSp::toggle_switch("##allocation_sampling", &sampling))
+    {
+        spartan::Allocator::SetSamplingInterval(sampling ? allocation_sampling_interval : 0);
+    }
+
+    ImGui::BeginDisabled(!sampling);
+    {
+        ImGui::SameLine();
+        if (ImGuiSp::button("Snapshot"))
+        {
+            m_heap_baseline     = spartan::AllocationProfiler::TakeSnapshot();
+            m_heap_has_baseline = true;
+            m_heap_diff         = {};
+            m_heap_diff_labels.clear();
+            m_heap_diff_stacks.clear();
+        }
+
+        ImGui::SameLine();
+        ImGui::BeginDisabled(!m_heap_has_baseline);
+        if (ImGuiSp::button("Diff"))
+        {
+            m_heap_diff = spartan::AllocationProfiler::Diff(m_heap_baseline, spartan::AllocationProfiler::TakeSnapshot());
+            m_heap_diff_labels.clear();
+            m_heap_diff_stacks.clear();
+
+            // symbolizing is slow, do it once for the sites that are shown
+            for (size_t i = 0; i < min(m_heap_diff.sites.size(), allocation_sites_shown); i++)
+            {
+                vector<string> frames = spartan::AllocationProfiler::GetStack(m_heap_diff.sites[i].stack_id);
+
+                // skip the standard library to land on the code that asked for the memory
+                string label = frames.empty() ? "unknown" : frames.front();
+                string stack;
+                for (const string& frame : frames)
+                {
+                    if (label.rfind("std::", 0) == 0 && frame.rfind("std::", 0) != 0)
+                    {
+                        label = frame;
+                    }
+                    stack += frame + "\n";
+                }
+
+                m_heap_diff_labels.push_back(label);
+                m_heap_diff_stacks.push_back(stack);
+            }
+        }
+        ImGui::EndDisabled();
+
+        // the diff when there is one, the live heap otherwise
+        ImGui::SameLine();
+        if (ImGuiSp::button("Export"))
+        {
+            spartan::AllocationProfiler::Export(m_heap_diff_labels.empty() ? spartan::AllocationProfiler::TakeSnapshot() : m_heap_diff, "allocation_profile.txt");
+        }
+    }
+    ImGui::EndDisabled();
+
+    ImGui::SameLine();
+    ImGui::Text("Live samples: %u", spartan::AllocationProfiler::GetLiveSampleCount());
+
+    for (size_t i = 0; i < m_heap_diff_labels.size(); i++)
+    {
+        const spartan::AllocationSite& site = m_heap_diff.sites[i];
+        ImGui::Text("%+9.2f MB  %-10s %s", site.bytes / (1024.0 * 1024.0), spartan::Allocator::GetTagName(site.tag), m_heap_diff_labels[i].c_str());
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::SetTooltip("%s", m_heap_diff_stacks[i].c_str());
+        }
+    }
+}
+
+void Profiler::ShowHardwareCounters()
+{
+    ImGui::Separator();
+
+    bool enabled = spartan::HardwareCounters::IsEnabled();
+    ImGui::Text("Hardware Counters");
+    ImGui::SameLine();
+    if (ImGuiSp::toggle_switch("##hardware_counters", &enabled))
+    {
+        spartan::HardwareCounters::SetEnabled(enabled);
+    }
+
+    if (!enabled)
+        return;
+
+    if (!spartan::HardwareCounters::IsAvailable())
+    {
+        ImGui::SameLine();
+        ImGui::TextDisabled("not available, see the log");
+        return;
+    }
+
+    // per block name, the most expensive first
+    vector<const spartan::HardwareCounterStats*> stats_sorted;
+    for (const spartan::HardwareCounterStats& stats : spartan::Profiler::GetHardwareCounterStats())
+    {
+        if (stats.calls > 0)
+        {
+            stats_sorted.push_back(&stats);
+        }
+    }
+    sort(stats_sorted.begin(), stats_sorted.end(), [](const spartan::HardwareCounterStats* a, const spartan::HardwareCounterStats* b)
+    {
+        return a->per_frame[static_cast<size_t>(spartan::HardwareCounter::Cycles)] > b->per_frame[static_cast<size_t>(spartan::HardwareCounter::Cycles)];
+    });
+
+    const uint32_t counter_count = static_cast<uint32_t>(spartan::HardwareCounter::Count);
+    if (ImGui::BeginTable("##hardware_counters_table", 3 + counter_count, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 200.0f)))
+    {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Block");
+        ImGui::TableSetupColumn("Calls");
+        for (uint32_t i = 0; i < counter_count; i++)
+        {
+            ImGui::TableSetupColumn(spartan::HardwareCounters::GetName(static_cast<spartan::HardwareCounter>(i)));
+        }
+        ImGui::TableSetupColumn("IPC");
+        ImGui::TableHeadersRow();
+
+        char count[16];
+        for (const spartan::HardwareCounterStats* stats : stats_sorted)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(stats->name.c_str());
+            ImGui::TableSetColumnIndex(1);
+            ImGui::Text("%u", stats->calls);
+            for (uint32_t i = 0; i < counter_count; i++)
+            {
+                ImGui::TableSetColumnIndex(2 + i);
+                if (spartan::HardwareCounters::IsAvailable(static_cast<spartan::HardwareCounter>(i)))
+                {
+                    ImGui::TextUnformatted(format_count(stats->per_frame[i], count, sizeof(count)));
+                }
+                else
+                {
+                    ImGui::TextDisabled("n/a");
+                }
+            }
+            ImGui::TableSetColumnIndex(2 + counter_count);
+            ImGui::Text("%.2f", get_ipc(stats->per_frame[static_cast<size_t>(spartan::HardwareCounter::Cycles)], stats->per_frame[static_cast<size_t>(spartan::HardwareCounter::Instructions)]));
+        }
+
+        ImGui::EndTable();
+    }
 }
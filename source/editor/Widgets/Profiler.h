@@ -26,7 +26,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <array>
 #include <utility>
 #include <vector>
+#include <string>
 #include "Profiling/TimeBlock.h"
+#include "Memory/AllocationProfiler.h"
 //=================================
 
 struct Timings
@@ -66,6 +68,9 @@ class Profiler : public Widget
     void OnTickVisible() override;
 
 private:
+    void ShowAllocations();
+    void ShowHardwareCounters();
+
     std::array<float, 400> m_plot;
     Timings m_timings;
 
@@ -82,4 +87,11 @@ class Profiler : public Widget
     std::vector<spartan::TimeBlock> m_frozen_time_blocks;
     float m_frozen_time_cpu  = 0.0f;
     float m_frozen_time_gpu  = 0.0f;
+
+    // allocation profiling
+    spartan::HeapSnapshot m_heap_baseline;
+    spartan::HeapSnapshot m_heap_diff;
+    std::vector<std::string> m_heap_diff_labels; // innermost engine frame of the largest diff sites
+    std::vector<std::string> m_heap_diff_stacks; // their full stacks, shown on hover
+    bool m_heap_has_baseline = false;
 };
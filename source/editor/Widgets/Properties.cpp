@@ -272,7 +272,7 @@ namespace
             {
                 if (copied_component && copied_component->GetType() == component->GetType())
                 {
-                    component->SetAttributes(copied_component->GetAttributes());
+                    component->CopyAttributesFrom(copied_component);
                 }
             }
             ImGui::EndDisabled();
@@ -831,7 +831,15 @@ void Properties::ShowScript(spartan::Script* script) const
 
         // status
         bool is_loaded = script->script.valid();
-        property_text("Status", is_loaded ? "Loaded" : "Not Loaded", "whether the script is loaded and valid");
+        const char* status = !is_loaded ? "Not Loaded" : script->IsFaulted() ? "Aborted (runaway)" : script->IsOverBudget() ? "Loaded (over budget)" : "Loaded";
+        property_text("Status", status, "whether the script is loaded and valid, and if it has exceeded its time budget");
+
+        if (is_loaded)
+        {
+            char time_buf[32];
+            std::snprintf(time_buf, sizeof(time_buf), "%.3f ms", script->GetTimeMs());
+            property_text("Tick Time", time_buf, "time spent in the script last frame, coroutines included");
+        }
 
         if (is_loaded)
         {
@@ -1289,7 +1297,7 @@ void Properties::ShowPhysics(Physics* body) const
         // body type
         static vector<string> body_types = {
             "Box", "Sphere", "Plane", "Capsule",
-            "Mesh", "Mesh (Convex)", "Controller", "Vehicle"
+            "Mesh", "Mesh (Convex)", "Controller", "Vehicle", "Height Field"
         };
 
         uint32_t body_type_index = static_cast<uint32_t>(body->GetBodyType());
@@ -1789,6 +1797,12 @@ void Properties::ShowTerrain(Terrain* terrain) const
         std::snprintf(stat_buf, sizeof(stat_buf), "%llu", static_cast<unsigned long long>(terrain->GetIndexCount()));
         property_text("Indices", stat_buf);
 
+        std::snprintf(stat_buf, sizeof(stat_buf), "%u / %u", terrain->GetChunkCountResident(), terrain->GetChunkCount());
+        property_text("Resident Chunks", stat_buf);
+
+        std::snprintf(stat_buf, sizeof(stat_buf), "%.1f MB", static_cast<double>(terrain->GetChunkMemoryUsage()) / (1024.0 * 1024.0));
+        property_text("Chunk Memory", stat_buf);
+
         //= MAP =================================================
         if (min_y != terrain->GetMinY()) terrain->SetMinY(min_y);
         if (max_y != terrain->GetMaxY()) terrain->SetMaxY(max_y);
@@ -436,6 +436,7 @@ void RenderOptions::OnTickVisible()
                         ImGui::PopItemWidth();
                         Timer::SetFpsLimit(fps_target);
                     }
+                    option_value("Frames in flight", "r.frames_in_flight", "How many frames the CPU can record ahead of the GPU, more overlap at the cost of latency", 1.0f, 1.0f, static_cast<float>(rhi_max_frames_in_flight), "%.0f");
                     option_check_box("Show performance metrics", "r.performance_metrics");
                 }
 
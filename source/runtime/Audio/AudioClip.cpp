@@ -0,0 +1,363 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===================================
+#include "pch.h"
+#include "AudioClip.h"
+#include "../Commands/Console/ConsoleCommands.h"
+SP_WARNINGS_OFF
+#include <SDL3/SDL_audio.h>
+#include <SDL3/SDL_iostream.h>
+SP_WARNINGS_ON
+//==============================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace spartan
+{
+    namespace
+    {
+        atomic<uint64_t> resident_bytes = 0;
+
+        unordered_map<string, weak_ptr<AudioClip>> cache;
+        mutex cache_mutex;
+    }
+
+    void on_audio_clip_budget_change(const CVarVariant& value)
+    {
+        *ConsoleRegistry::Get().Find("audio.clip_budget_mb")->m_value_ptr = max(get<float>(value), 0.0f);
+    }
+    void on_audio_stream_threshold_change(const CVarVariant& value)
+    {
+        *ConsoleRegistry::Get().Find("audio.stream_threshold_mb")->m_value_ptr = max(get<float>(value), 0.0f);
+    }
+    TConsoleVar<float> cvar_audio_clip_budget     ("audio.clip_budget_mb",      256.0f, "memory budget for clips kept in memory, over budget clips get compressed or streamed", on_audio_clip_budget_change);
+    TConsoleVar<float> cvar_audio_stream_threshold("audio.stream_threshold_mb", 8.0f,   "clips larger than this (decoded) are streamed from disk",                               on_audio_stream_threshold_change);
+    TConsoleVar<float> cvar_audio_compress_clips  ("audio.compress_clips",      0.0f,   "store all in-memory clips as adpcm");
+
+    namespace adpcm
+    {
+        // ima adpcm, blocks are independently decodable so loops and seeks can restart at any block
+        constexpr uint32_t block_samples = 2048;
+        constexpr uint32_t header_size   = 4; // int16 predictor, uint8 step index, uint8 padding
+        constexpr uint32_t block_size    = header_size + block_samples / 2;
+
+        const int32_t index_table[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+        const int32_t step_table[89] =
+        {
+            7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+            157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552,
+            1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+            12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+        };
+
+        int32_t decode_nibble(const uint8_t nibble, int32_t& predictor, int32_t& step_index)
+        {
+            int32_t step = step_table[step_index];
+            int32_t diff = step >> 3;
+            if (nibble & 4) diff += step;
+            if (nibble & 2) diff += step >> 1;
+            if (nibble & 1) diff += step >> 2;
+            predictor  = clamp(nibble & 8 ? predictor - diff : predictor + diff, -32768, 32767);
+            step_index = clamp(step_index + index_table[nibble], 0, 88);
+            return predictor;
+        }
+
+        vector<uint8_t> encode(const float* samples, const uint32_t count)
+        {
+            const uint32_t block_count = (count + block_samples - 1) / block_samples;
+            vector<uint8_t> output(static_cast<size_t>(block_count) * block_size, 0);
+
+            int32_t predictor  = 0;
+            int32_t step_index = 0;
+            for (uint32_t block = 0; block < block_count; block++)
+            {
+                uint8_t* header = &output[static_cast<size_t>(block) * block_size];
+                uint8_t* data   = header + header_size;
+                uint32_t first  = block * block_samples;
+
+                // seed the block with the exact first sample so decoding can start here
+                predictor = static_cast<int32_t>(clamp(samples[first], -1.0f, 1.0f) * 32767.0f);
+                memcpy(header, &predictor, sizeof(int16_t));
+                header[2] = static_cast<uint8_t>(step_index);
+
+                for (uint32_t i = 0; i < block_samples && first + i < count; i++)
+                {
+                    int32_t sample = static_cast<int32_t>(clamp(samples[first + i], -1.0f, 1.0f) * 32767.0f);
+                    int32_t step   = step_table[step_index];
+                    int32_t diff   = sample - predictor;
+                    uint8_t nibble = 0;
+                    if (diff < 0)
+                    {
+                        nibble = 8;
+                        diff   = -diff;
+                    }
+                    if (diff >= step)        { nibble |= 4; diff -= step; }
+                    if (diff >= (step >> 1)) { nibble |= 2; diff -= step >> 1; }
+                    if (diff >= (step >> 2)) { nibble |= 1; }
+
+                    // track the decoder so encoder and decoder never drift apart
+                    decode_nibble(nibble, predictor, step_index);
+                    data[i / 2] |= (i & 1) ? static_cast<uint8_t>(nibble << 4) : nibble;
+                }
+            }
+
+            return output;
+        }
+    }
+
+    namespace wav
+    {
+        struct Info
+        {
+            uint64_t data_offset = 0;
+            uint64_t data_size   = 0;
+            uint32_t format      = 0;
+            uint32_t channels    = 0;
+            uint32_t sample_rate = 0;
+            uint32_t frame_size  = 0;
+        };
+
+        // reads the riff header, returns false for anything that can't be streamed as raw pcm
+        bool probe(const string& file_path, Info& info)
+        {
+            SDL_IOStream* file = SDL_IOFromFile(file_path.c_str(), "rb");
+            if (!file)
+                return false;
+
+            bool found_format = false;
+            bool found_data   = false;
+            char riff[12]     = {};
+            if (SDL_ReadIO(file, riff, sizeof(riff)) == sizeof(riff) && memcmp(riff, "RIFF", 4) == 0 && memcmp(riff + 8, "WAVE", 4) == 0)
+            {
+                char id[4]     = {};
+                uint32_t size  = 0;
+                while (!found_data && SDL_ReadIO(file, id, 4) == 4 && SDL_ReadU32LE(file, &size))
+                {
+                    if (memcmp(id, "fmt ", 4) == 0 && size >= 16)
+                    {
+                        uint16_t tag = 0, channels = 0, block_align = 0, bits = 0;
+                        uint32_t rate = 0, byte_rate = 0;
+                        SDL_ReadU16LE(file, &tag);
+                        SDL_ReadU16LE(file, &channels);
+                        SDL_ReadU32LE(file, &rate);
+                        SDL_ReadU32LE(file, &byte_rate);
+                        SDL_ReadU16LE(file, &block_align);
+                        SDL_ReadU16LE(file, &bits);
+
+                        // extensible, the real tag is the start of the sub-format guid
+                        if (tag == 0xFFFE && size >= 40)
+                        {
+                            uint16_t extension_size = 0, valid_bits = 0;
+                            uint32_t channel_mask = 0;
+                            SDL_ReadU16LE(file, &extension_size);
+                            SDL_ReadU16LE(file, &valid_bits);
+                            SDL_ReadU32LE(file, &channel_mask);
+                            SDL_ReadU16LE(file, &tag);
+                            size -= 10;
+                        }
+                        SDL_SeekIO(file, size - 16 + (size & 1), SDL_IO_SEEK_CUR);
+
+                        if (tag == 1 && bits == 8)       info.format = SDL_AUDIO_U8;
+                        else if (tag == 1 && bits == 16) info.format = SDL_AUDIO_S16LE;
+                        else if (tag == 1 && bits == 32) info.format = SDL_AUDIO_S32LE;
+                        else if (tag == 3 && bits == 32) info.format = SDL_AUDIO_F32LE;
+
+                        info.channels    = channels;
+                        info.sample_rate = rate;
+                        info.frame_size  = block_align;
+                        found_format     = info.format != 0 && channels > 0 && rate > 0 && block_align == channels * bits / 8;
+                    }
+                    else if (memcmp(id, "data", 4) == 0)
+                    {
+                        info.data_offset = static_cast<uint64_t>(SDL_TellIO(file));
+                        info.data_size   = size;
+                        found_data       = true;
+                    }
+                    else
+                    {
+                        SDL_SeekIO(file, size + (size & 1), SDL_IO_SEEK_CUR);
+                    }
+                }
+            }
+
+            // some writers leave the data size at zero or past the end of the file
+            if (found_data)
+            {
+                uint64_t available = static_cast<uint64_t>(SDL_GetIOSize(file)) - info.data_offset;
+                info.data_size     = (info.data_size == 0 || info.data_size > available) ? available : info.data_size;
+            }
+
+            SDL_CloseIO(file);
+            return found_format && found_data && info.data_size >= info.frame_size;
+        }
+    }
+
+    namespace
+    {
+        shared_ptr<AudioClip> load_resident(const string& file_path)
+        {
+            SDL_AudioSpec wav_spec = {};
+            uint8_t* wav_buffer    = nullptr;
+            uint32_t wav_length    = 0;
+            if (!SDL_LoadWAV(file_path.c_str(), &wav_spec, &wav_buffer, &wav_length))
+            {
+                SP_LOG_ERROR("%s", SDL_GetError());
+                return nullptr;
+            }
+
+            // the mixer works on mono float32, resampling happens at mix time
+            SDL_AudioSpec target_spec = {};
+            target_spec.freq          = wav_spec.freq;
+            target_spec.format        = SDL_AUDIO_F32;
+            target_spec.channels      = 1;
+            uint8_t* target_buffer    = nullptr;
+            int target_length         = 0;
+            if (!SDL_ConvertAudioSamples(&wav_spec, wav_buffer, static_cast<int>(wav_length), &target_spec, &target_buffer, &target_length))
+            {
+                SP_LOG_ERROR("%s", SDL_GetError());
+                SDL_free(wav_buffer);
+                return nullptr;
+            }
+            SDL_free(wav_buffer);
+
+            shared_ptr<AudioClip> clip = make_shared<AudioClip>();
+            clip->storage              = AudioClipStorage::Resident;
+            clip->samples              = reinterpret_cast<float*>(target_buffer);
+            clip->sample_count         = static_cast<uint32_t>(target_length) / sizeof(float);
+            clip->sample_rate          = static_cast<uint32_t>(target_spec.freq);
+
+            return clip;
+        }
+    }
+
+    AudioClip::~AudioClip()
+    {
+        resident_bytes.fetch_sub(GetMemoryUsage(), memory_order_relaxed);
+
+        if (samples)
+        {
+            SDL_free(samples);
+            samples = nullptr;
+        }
+    }
+
+    shared_ptr<AudioClip> AudioClip::Load(const string& file_path)
+    {
+        lock_guard<mutex> lock(cache_mutex);
+
+        auto it = cache.find(file_path);
+        if (it != cache.end())
+        {
+            if (shared_ptr<AudioClip> clip = it->second.lock())
+                return clip;
+        }
+
+        const uint64_t budget    = static_cast<uint64_t>(cvar_audio_clip_budget.GetValue() * 1024.0f * 1024.0f);
+        const uint64_t threshold = static_cast<uint64_t>(cvar_audio_stream_threshold.GetValue() * 1024.0f * 1024.0f);
+        const uint64_t used      = resident_bytes.load(memory_order_relaxed);
+        const uint64_t remaining = budget > used ? budget - used : 0;
+
+        // decide on storage before decoding anything, large clips never get fully decoded
+        wav::Info info;
+        bool streamable         = wav::probe(file_path, info);
+        uint64_t frame_count    = streamable ? info.data_size / info.frame_size : 0;
+        uint64_t decoded_size   = frame_count * sizeof(float);
+        uint64_t compressed_size = (frame_count + adpcm::block_samples - 1) / adpcm::block_samples * adpcm::block_size;
+
+        shared_ptr<AudioClip> clip;
+        if (streamable && (decoded_size > threshold || compressed_size > remaining))
+        {
+            clip                  = make_shared<AudioClip>();
+            clip->storage         = AudioClipStorage::Streamed;
+            clip->sample_count    = static_cast<uint32_t>(frame_count);
+            clip->sample_rate     = info.sample_rate;
+            clip->file_path       = file_path;
+            clip->data_offset     = info.data_offset;
+            clip->data_size       = info.data_size;
+            clip->source_format   = info.format;
+            clip->source_channels = info.channels;
+        }
+        else
+        {
+            clip = load_resident(file_path);
+            if (!clip)
+                return nullptr;
+
+            uint64_t size = static_cast<uint64_t>(clip->sample_count) * sizeof(float);
+            if (cvar_audio_compress_clips.GetValue() != 0.0f || size > remaining)
+            {
+                clip->adpcm   = adpcm::encode(clip->samples, clip->sample_count);
+                clip->storage = AudioClipStorage::Compressed;
+                SDL_free(clip->samples);
+                clip->samples = nullptr;
+            }
+
+            if (clip->GetMemoryUsage() > remaining)
+            {
+                SP_LOG_WARNING("\"%s\" exceeds the audio clip budget and can't be streamed", file_path.c_str());
+            }
+        }
+
+        resident_bytes.fetch_add(clip->GetMemoryUsage(), memory_order_relaxed);
+
+        cache[file_path] = clip;
+        return clip;
+    }
+
+    uint64_t AudioClip::GetResidentBytes()
+    {
+        return resident_bytes.load(memory_order_relaxed);
+    }
+
+    void AudioClip::Decode(AudioClipCursor& cursor, uint32_t position, float* output, uint32_t count) const
+    {
+        const float scale = 1.0f / 32768.0f;
+        for (uint32_t i = 0; i < count; i++, position++)
+        {
+            const uint8_t* block = &adpcm[static_cast<size_t>(position / adpcm::block_samples) * adpcm::block_size];
+            uint32_t offset      = position % adpcm::block_samples;
+            if (offset == 0)
+            {
+                int16_t predictor = 0;
+                memcpy(&predictor, block, sizeof(int16_t));
+                cursor.predictor  = predictor;
+                cursor.step_index = block[2];
+            }
+
+            uint8_t byte   = block[adpcm::header_size + offset / 2];
+            uint8_t nibble = (offset & 1) ? (byte >> 4) : (byte & 0x0F);
+            output[i]      = static_cast<float>(adpcm::decode_nibble(nibble, cursor.predictor, cursor.step_index)) * scale;
+        }
+    }
+
+    uint64_t AudioClip::GetMemoryUsage() const
+    {
+        switch (storage)
+        {
+            case AudioClipStorage::Resident:   return static_cast<uint64_t>(sample_count) * sizeof(float);
+            case AudioClipStorage::Compressed: return adpcm.size();
+            default:                           return 0;
+        }
+    }
+}
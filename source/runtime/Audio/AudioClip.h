@@ -0,0 +1,77 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =======
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+//==================
+
+namespace spartan
+{
+    enum class AudioClipStorage : uint8_t
+    {
+        Resident,   // mono float32 in memory
+        Compressed, // ima adpcm in memory, ~8x smaller than resident, decoded at mix time
+        Streamed    // decoded from disk in chunks while playing
+    };
+
+    // decoder state for compressed clips, owned by whoever is reading the clip
+    struct AudioClipCursor
+    {
+        int32_t predictor  = 0;
+        int32_t step_index = 0;
+    };
+
+    // a clip at its native sample rate, always presented to the mixer as mono float32
+    struct AudioClip
+    {
+        ~AudioClip();
+
+        // loads or returns a cached clip, storage is picked based on size and the clip memory budget
+        static std::shared_ptr<AudioClip> Load(const std::string& file_path);
+        static uint64_t GetResidentBytes();
+
+        // decodes count samples of a compressed clip starting at position, position + count must not cross the end of the clip
+        void Decode(AudioClipCursor& cursor, uint32_t position, float* output, uint32_t count) const;
+        uint64_t GetMemoryUsage() const;
+
+        AudioClipStorage storage = AudioClipStorage::Resident;
+        uint32_t sample_count    = 0;
+        uint32_t sample_rate     = 0;
+
+        // resident
+        float* samples = nullptr;
+
+        // compressed
+        std::vector<uint8_t> adpcm;
+
+        // streamed, the location and format of the raw pcm data in the file
+        std::string file_path;
+        uint64_t data_offset     = 0;
+        uint64_t data_size       = 0;
+        uint32_t source_format   = 0; // SDL_AudioFormat
+        uint32_t source_channels = 0;
+    };
+}
@@ -0,0 +1,1005 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===================================
+#include "pch.h"
+#include "AudioMixer.h"
+#include "AudioStream.h"
+#include "../Commands/Console/ConsoleCommands.h"
+#include "../Memory/Allocator.h"
+#include <immintrin.h>
+#include <bit>
+SP_WARNINGS_OFF
+#include <SDL3/SDL_audio.h>
+#include <SDL3/SDL_hints.h>
+#include <SDL3/SDL_init.h>
+#include <SDL3/SDL_thread.h>
+#include <SDL3/SDL_timer.h>
+SP_WARNINGS_ON
+//==============================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace spartan
+{
+    namespace
+    {
+        constexpr uint32_t sample_rate        = 48000;
+        constexpr uint32_t channel_count      = 2;
+        constexpr uint32_t block_frames       = 256;                            // ~5.3 ms at 48khz
+        constexpr uint32_t max_voices         = 64;                             // one bit per voice in the allocation mask
+        constexpr uint32_t command_queue_size = 1024;                           // power of two
+        constexpr float max_ratio             = 32.0f;                          // fastest playback rate the resampler accepts
+        constexpr uint32_t staging_frames     = block_frames * static_cast<uint32_t>(max_ratio) + 2;       // source frames one block can consume at max_ratio
+        constexpr uint32_t reverb_buffer_size = 65536;                          // power of two, ~1.4 seconds at 48khz
+        constexpr uint32_t reverb_min_delay   = 1439;                           // shortest tap at the smallest room size
+
+        // the reverb kernel reads a whole block ahead of its writes, which is only valid while the shortest tap is longer than a block
+        static_assert(block_frames < reverb_min_delay, "reverb taps must be longer than a mix block");
+
+        atomic<uint32_t> latency_frames = sample_rate / 50; // 20 ms
+    }
+
+    void on_audio_latency_change(const CVarVariant& value)
+    {
+        float v = clamp(get<float>(value), 5.0f, 200.0f);
+        *ConsoleRegistry::Get().Find("audio.latency_ms")->m_value_ptr = v;
+        latency_frames.store(static_cast<uint32_t>(v * 0.001f * sample_rate), memory_order_relaxed);
+    }
+    TConsoleVar<float> cvar_audio_latency("audio.latency_ms", 20.0f, "audio output latency in milliseconds (5-200)", on_audio_latency_change);
+
+    namespace kernels
+    {
+        // linear interpolation resampler, output frame i reads source at fraction + i * ratio
+        void resample(const float* source, const float fraction, const float ratio, float* output, const uint32_t count)
+        {
+            if (ratio == 1.0f && fraction == 0.0f)
+            {
+                memcpy(output, source, count * sizeof(float));
+                return;
+            }
+
+            uint32_t i           = 0;
+            const __m256 v_ratio = _mm256_set1_ps(ratio);
+            const __m256 v_frac  = _mm256_set1_ps(fraction);
+            const __m256 v_lane  = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+            for (; i + 8 <= count; i += 8)
+            {
+                // no fma, so the vector and scalar paths round identically
+                __m256 position = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), v_lane), v_ratio), v_frac);
+                __m256 floored  = _mm256_floor_ps(position);
+                __m256 weight   = _mm256_sub_ps(position, floored);
+                __m256i index   = _mm256_cvttps_epi32(floored);
+                __m256 s0       = _mm256_i32gather_ps(source, index, 4);
+                __m256 s1       = _mm256_i32gather_ps(source + 1, index, 4);
+                _mm256_storeu_ps(output + i, _mm256_add_ps(s0, _mm256_mul_ps(_mm256_sub_ps(s1, s0), weight)));
+            }
+
+            for (; i < count; i++)
+            {
+                float position = static_cast<float>(i) * ratio + fraction;
+                uint32_t index = static_cast<uint32_t>(position);
+                float weight   = position - static_cast<float>(index);
+                output[i]      = source[index] + (source[index + 1] - source[index]) * weight;
+            }
+        }
+
+        // output += input * gain, with the gain ramped linearly across the span to avoid zipper noise
+        void mix_ramp(const float* input, float* output, const float gain_start, const float gain_end, const uint32_t count)
+        {
+            const float step = (gain_end - gain_start) / static_cast<float>(count);
+            if (gain_start == 0.0f && step == 0.0f)
+                return;
+
+            uint32_t i           = 0;
+            const __m256 v_step  = _mm256_set1_ps(step * 8.0f);
+            __m256 v_gain        = _mm256_add_ps(_mm256_set1_ps(gain_start), _mm256_mul_ps(_mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f), _mm256_set1_ps(step)));
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 result = _mm256_add_ps(_mm256_loadu_ps(output + i), _mm256_mul_ps(_mm256_loadu_ps(input + i), v_gain));
+                _mm256_storeu_ps(output + i, result);
+                v_gain = _mm256_add_ps(v_gain, v_step);
+            }
+
+            for (; i < count; i++)
+            {
+                output[i] += input[i] * (gain_start + step * static_cast<float>(i));
+            }
+        }
+
+        // output += input * gain
+        void accumulate(const float* input, float* output, const float gain, const uint32_t count)
+        {
+            uint32_t i          = 0;
+            const __m256 v_gain = _mm256_set1_ps(gain);
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_loadu_ps(output + i), _mm256_mul_ps(_mm256_loadu_ps(input + i), v_gain)));
+            }
+
+            for (; i < count; i++)
+            {
+                output[i] += input[i] * gain;
+            }
+        }
+
+        // output = a + b * gain
+        void multiply_add(const float* a, const float* b, float* output, const float gain, const uint32_t count)
+        {
+            uint32_t i          = 0;
+            const __m256 v_gain = _mm256_set1_ps(gain);
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_mul_ps(_mm256_loadu_ps(b + i), v_gain)));
+            }
+
+            for (; i < count; i++)
+            {
+                output[i] = a[i] + b[i] * gain;
+            }
+        }
+
+        // planar left/right to interleaved stereo, returns the absolute peak
+        float interleave(const float* left, const float* right, float* output, const uint32_t count)
+        {
+            uint32_t i          = 0;
+            const __m128 v_sign = _mm_set1_ps(-0.0f);
+            __m128 v_peak       = _mm_setzero_ps();
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 l = _mm_loadu_ps(left + i);
+                __m128 r = _mm_loadu_ps(right + i);
+                _mm_storeu_ps(output + i * 2,     _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(output + i * 2 + 4, _mm_unpackhi_ps(l, r));
+                v_peak = _mm_max_ps(v_peak, _mm_max_ps(_mm_andnot_ps(v_sign, l), _mm_andnot_ps(v_sign, r)));
+            }
+
+            float lanes[4];
+            _mm_storeu_ps(lanes, v_peak);
+            float peak = max(max(lanes[0], lanes[1]), max(lanes[2], lanes[3]));
+            for (; i < count; i++)
+            {
+                output[i * 2]     = left[i];
+                output[i * 2 + 1] = right[i];
+                peak              = max(peak, max(fabsf(left[i]), fabsf(right[i])));
+            }
+
+            return peak;
+        }
+    }
+
+    namespace
+    {
+        // bounded lock-free queue (vyukov), any number of producers, the mixer thread is the only consumer
+        template<typename T, uint32_t capacity>
+        class command_queue
+        {
+            static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+        public:
+            command_queue()
+            {
+                for (uint32_t i = 0; i < capacity; i++)
+                {
+                    m_cells[i].sequence.store(i, memory_order_relaxed);
+                }
+            }
+
+            bool push(T&& value)
+            {
+                cell* target = nullptr;
+                size_t position = m_enqueue.load(memory_order_relaxed);
+                while (true)
+                {
+                    target             = &m_cells[position & (capacity - 1)];
+                    size_t sequence    = target->sequence.load(memory_order_acquire);
+                    intptr_t different = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                    if (different == 0)
+                    {
+                        if (m_enqueue.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                            break;
+                    }
+                    else if (different < 0)
+                    {
+                        return false; // full
+                    }
+                    else
+                    {
+                        position = m_enqueue.load(memory_order_relaxed);
+                    }
+                }
+
+                target->data = std::move(value);
+                target->sequence.store(position + 1, memory_order_release);
+                return true;
+            }
+
+            bool pop(T& value)
+            {
+                cell* target    = &m_cells[m_dequeue & (capacity - 1)];
+                size_t sequence = target->sequence.load(memory_order_acquire);
+                if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(m_dequeue + 1) < 0)
+                    return false; // empty
+
+                value        = std::move(target->data);
+                target->data = T();
+                target->sequence.store(m_dequeue + capacity, memory_order_release);
+                m_dequeue++;
+                return true;
+            }
+
+        private:
+            struct cell
+            {
+                atomic<size_t> sequence;
+                T data;
+            };
+
+            cell m_cells[capacity];
+            alignas(64) atomic<size_t> m_enqueue = 0;
+            alignas(64) size_t m_dequeue         = 0;
+        };
+
+        enum class CommandType : uint8_t
+        {
+            PlayClip,
+            PlaySynthesis,
+            SetParameters,
+            Stop
+        };
+
+        struct Command
+        {
+            CommandType type = CommandType::Stop;
+            AudioVoice voice = 0;
+            bool loop        = false;
+            AudioVoiceParameters parameters;
+            shared_ptr<AudioClip> clip;
+            AudioStream* stream = nullptr; // owned by the streaming thread
+            SynthesisCallback synthesis;
+        };
+
+        // mixer thread state for a single voice
+        struct Voice
+        {
+            AudioVoice handle = 0;
+            bool active       = false;
+            bool loop         = false;
+            bool ended        = false; // the source ran out, the voice stops after the current block
+            uint32_t channels = 1;
+            shared_ptr<AudioClip> clip;
+            AudioStream* stream = nullptr;
+            AudioClipCursor cursor;    // adpcm decoder state for compressed clips
+            SynthesisCallback synthesis;
+            uint32_t position = 0;     // next clip frame to read
+            AudioVoiceParameters parameters;
+
+            // resampler state, see mix_voice()
+            float fraction        = 0.0f;
+            uint32_t carry_count  = 0;
+            uint32_t skip         = 0;
+            float carry[2][2]     = {};
+
+            // gains reached at the end of the previous block, ramped towards the new targets
+            float gain_dry[2]  = {};
+            float gain_send[2] = {};
+            bool gains_primed  = false;
+        };
+
+        // state the game thread can observe without talking to the mixer
+        struct VoiceStatus
+        {
+            atomic<uint32_t> generation = 0;
+            atomic<AudioVoice> playing  = 0; // the handle this slot is playing, 0 when idle
+            atomic<float> progress      = 0.0f;
+        };
+
+        // a feedback delay network shared by every voice that sends to it
+        struct ReverbBus
+        {
+            vector<float> buffer[2];
+            uint32_t write_position = 0;
+            float room_size         = 0.5f;
+            float decay             = 0.5f;
+        };
+
+        // mixer thread
+        thread mixer_thread;
+        atomic<bool> running = false;
+        command_queue<Command, command_queue_size> commands;
+        array<Voice, max_voices> voices;
+        ReverbBus reverb;
+        vector<float> staging[2];        // source frames pulled for one voice
+        vector<float> synthesis_scratch; // interleaved output of a synthesis callback
+        array<float, block_frames> voice_output[2];
+        array<float, block_frames> bus_dry[2];
+        array<float, block_frames> bus_send[2];
+        array<float, block_frames> reverb_taps[2];
+        array<float, block_frames * channel_count> output;
+
+        // shared
+        array<VoiceStatus, max_voices> voice_status;
+        atomic<uint64_t> voices_allocated = 0; // bit mask
+        atomic<uint64_t> frames_mixed     = 0;
+        atomic<float> peak                = 0.0f;
+        atomic<uint64_t> stream_underruns = 0;
+
+        // streaming thread, owns every stream and keeps their ring buffers topped up
+        thread streaming_thread;
+        mutex streams_mutex;
+        condition_variable streams_condition;
+        vector<shared_ptr<AudioStream>> streams;
+
+        // device
+        SDL_AudioDeviceID device_id    = 0;
+        SDL_AudioStream* device_stream = nullptr;
+
+        uint32_t voice_index(const AudioVoice voice)
+        {
+            return voice & 0xFF;
+        }
+
+        bool is_valid(const AudioVoice voice)
+        {
+            if (voice == 0 || voice_index(voice) >= max_voices)
+                return false;
+
+            return voice_status[voice_index(voice)].generation.load(memory_order_relaxed) == (voice >> 8);
+        }
+
+        AudioVoice voice_allocate()
+        {
+            uint64_t allocated = voices_allocated.load(memory_order_relaxed);
+            while (true)
+            {
+                if (allocated == ~0ull)
+                {
+                    SP_LOG_WARNING("All %u voices are in use", max_voices);
+                    return 0;
+                }
+
+                uint32_t index = static_cast<uint32_t>(countr_one(allocated));
+                if (voices_allocated.compare_exchange_weak(allocated, allocated | (1ull << index), memory_order_acquire, memory_order_relaxed))
+                {
+                    // 24-bit generation so stale handles to a recycled slot are rejected
+                    uint32_t generation = (voice_status[index].generation.load(memory_order_relaxed) + 1) & 0xFFFFFF;
+                    generation          = generation == 0 ? 1 : generation;
+                    voice_status[index].generation.store(generation, memory_order_relaxed);
+                    voice_status[index].progress.store(0.0f, memory_order_relaxed);
+
+                    AudioVoice voice = (generation << 8) | index;
+                    voice_status[index].playing.store(voice, memory_order_release);
+                    return voice;
+                }
+            }
+        }
+
+        void voice_free(const AudioVoice voice)
+        {
+            uint32_t index    = voice_index(voice);
+            AudioVoice expect = voice;
+            voice_status[index].playing.compare_exchange_strong(expect, 0, memory_order_release);
+            voices_allocated.fetch_and(~(1ull << index), memory_order_release);
+        }
+
+        void submit(Command&& command)
+        {
+            // the mixer drains the queue every block, so a full queue only lasts a moment
+            while (!commands.push(std::move(command)))
+            {
+                if (!running.load(memory_order_relaxed))
+                    return;
+
+                this_thread::yield();
+            }
+        }
+
+        // pulls source frames into planar buffers, returns false once a non-looping source ran out
+        bool voice_pull(Voice& voice, float* left, float* right, uint32_t count)
+        {
+            if (voice.synthesis)
+            {
+                synthesis_scratch.resize(max<size_t>(synthesis_scratch.size(), count * 2));
+                voice.synthesis(synthesis_scratch.data(), static_cast<int>(count));
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    left[i]  = synthesis_scratch[i * 2];
+                    right[i] = synthesis_scratch[i * 2 + 1];
+                }
+                return true;
+            }
+
+            if (voice.stream)
+            {
+                uint32_t read = voice.stream->Read(left, count);
+                if (read < count)
+                {
+                    memset(left + read, 0, (count - read) * sizeof(float));
+                    if (voice.stream->IsDrained())
+                        return false;
+
+                    // the streaming thread fell behind, play silence rather than wait
+                    stream_underruns.fetch_add(1, memory_order_relaxed);
+                }
+                return true;
+            }
+
+            const AudioClip* clip = voice.clip.get();
+            uint32_t written      = 0;
+            while (written < count)
+            {
+                if (voice.position >= clip->sample_count)
+                {
+                    if (!voice.loop)
+                    {
+                        memset(left + written, 0, (count - written) * sizeof(float));
+                        return false;
+                    }
+                    voice.position = 0;
+                }
+
+                uint32_t span = min(count - written, clip->sample_count - voice.position);
+                if (clip->storage == AudioClipStorage::Compressed)
+                {
+                    clip->Decode(voice.cursor, voice.position, left + written, span);
+                }
+                else
+                {
+                    memcpy(left + written, clip->samples + voice.position, span * sizeof(float));
+                }
+                voice.position += span;
+                written        += span;
+            }
+
+            return true;
+        }
+
+        void voice_skip(Voice& voice, uint32_t count)
+        {
+            if (voice.synthesis || voice.stream || voice.clip->storage == AudioClipStorage::Compressed)
+            {
+                // decoders and synthesizers are stateful, so the skipped frames still have to be produced
+                while (count > 0)
+                {
+                    uint32_t chunk = min(count, staging_frames);
+                    voice_pull(voice, staging[0].data(), staging[1].data(), chunk);
+                    count -= chunk;
+                }
+                return;
+            }
+
+            uint32_t length = voice.clip->sample_count;
+            voice.position += count;
+            if (voice.position >= length)
+            {
+                voice.position = voice.loop ? voice.position % length : length;
+            }
+        }
+
+        void voice_stop(Voice& voice)
+        {
+            uint32_t index    = voice_index(voice.handle);
+            AudioVoice expect = voice.handle;
+            voice_status[index].playing.compare_exchange_strong(expect, 0, memory_order_release);
+
+            if (voice.stream)
+            {
+                voice.stream->Release();
+                voice.stream = nullptr;
+            }
+
+            voice.active = false;
+            voice.clip.reset();
+            voice.synthesis = nullptr;
+        }
+
+        void mix_voice(Voice& voice, const uint32_t frame_count, float& loudest_send)
+        {
+            const uint32_t source_rate = voice.synthesis ? sample_rate : voice.clip->sample_rate;
+            const float ratio          = clamp(static_cast<float>(source_rate) / static_cast<float>(sample_rate) * voice.parameters.pitch, 1.0f / 256.0f, max_ratio);
+
+            // frames left over from the previous block sit at the start of the staging buffer
+            if (voice.skip > 0)
+            {
+                voice_skip(voice, voice.skip);
+                voice.skip = 0;
+            }
+
+            const uint32_t needed = static_cast<uint32_t>(static_cast<float>(frame_count - 1) * ratio + voice.fraction) + 2;
+            for (uint32_t c = 0; c < voice.channels; c++)
+            {
+                for (uint32_t i = 0; i < voice.carry_count; i++)
+                {
+                    staging[c][i] = voice.carry[i][c];
+                }
+            }
+
+            if (needed > voice.carry_count)
+            {
+                uint32_t count = needed - voice.carry_count;
+                if (!voice_pull(voice, staging[0].data() + voice.carry_count, staging[1].data() + voice.carry_count, count))
+                {
+                    voice.ended = true;
+                }
+            }
+
+            for (uint32_t c = 0; c < voice.channels; c++)
+            {
+                kernels::resample(staging[c].data(), voice.fraction, ratio, voice_output[c].data(), frame_count);
+            }
+
+            // advance, keeping the frames the next block still interpolates from
+            float position    = static_cast<float>(frame_count) * ratio + voice.fraction;
+            uint32_t consumed = static_cast<uint32_t>(position);
+            voice.fraction    = position - static_cast<float>(consumed);
+            if (consumed >= needed)
+            {
+                voice.carry_count = 0;
+                voice.skip        = consumed - needed;
+            }
+            else
+            {
+                voice.carry_count = needed - consumed;
+                for (uint32_t c = 0; c < voice.channels; c++)
+                {
+                    for (uint32_t i = 0; i < voice.carry_count; i++)
+                    {
+                        voice.carry[i][c] = staging[c][consumed + i];
+                    }
+                }
+            }
+
+            // gains, voices that send to the reverb give up some of their dry signal
+            const AudioVoiceParameters& parameters = voice.parameters;
+            const float send                       = clamp(parameters.reverb_send, 0.0f, 1.0f);
+            const float dry                        = 1.0f - send * 0.4f;
+            const float target_dry[2]              = { parameters.gain_left * dry,  parameters.gain_right * dry };
+            const float target_send[2]             = { parameters.gain_left * send, parameters.gain_right * send };
+            if (!voice.gains_primed)
+            {
+                memcpy(voice.gain_dry,  target_dry,  sizeof(target_dry));
+                memcpy(voice.gain_send, target_send, sizeof(target_send));
+                voice.gains_primed = true;
+            }
+
+            for (uint32_t c = 0; c < channel_count; c++)
+            {
+                const float* source = voice_output[voice.channels == 1 ? 0 : c].data();
+                kernels::mix_ramp(source, bus_dry[c].data(),  voice.gain_dry[c],  target_dry[c],  frame_count);
+                kernels::mix_ramp(source, bus_send[c].data(), voice.gain_send[c], target_send[c], frame_count);
+                voice.gain_dry[c]  = target_dry[c];
+                voice.gain_send[c] = target_send[c];
+            }
+
+            // the reverb bus takes its character from the voice that feeds it the most
+            float send_level = send * max(parameters.gain_left, parameters.gain_right);
+            if (send_level > loudest_send)
+            {
+                loudest_send     = send_level;
+                reverb.room_size = parameters.reverb_room_size;
+                reverb.decay     = parameters.reverb_decay;
+            }
+
+            if (voice.stream)
+            {
+                voice_status[voice_index(voice.handle)].progress.store(voice.stream->GetProgress(), memory_order_relaxed);
+            }
+            else if (voice.clip)
+            {
+                voice_status[voice_index(voice.handle)].progress.store(static_cast<float>(voice.position) / static_cast<float>(voice.clip->sample_count), memory_order_relaxed);
+            }
+
+            if (voice.ended)
+            {
+                voice_stop(voice);
+            }
+        }
+
+        // 6 taps with long delays for large-space character (tunnels, halls)
+        void mix_reverb(const uint32_t frame_count)
+        {
+            const uint32_t mask           = reverb_buffer_size - 1;
+            const uint32_t base_delays[6] = { 4799, 6907, 8893, 10007, 11903, 13313 };
+            const float room_scale        = 0.3f + clamp(reverb.room_size, 0.0f, 1.0f) * 0.7f;
+            const float tap_gain          = 1.0f / 6.0f;
+            const float feedback          = clamp(reverb.decay, 0.0f, 0.99f) * 0.85f;
+
+            for (uint32_t c = 0; c < channel_count; c++)
+            {
+                float* buffer = reverb.buffer[c].data();
+                float* taps   = reverb_taps[c].data();
+                fill_n(taps, frame_count, 0.0f);
+
+                // gather the taps, each one is a contiguous read that wraps at most once
+                for (uint32_t d = 0; d < 6; d++)
+                {
+                    uint32_t delay = static_cast<uint32_t>(base_delays[d] * room_scale) + (c == 1 ? 181 : 0);
+                    uint32_t read  = (reverb.write_position + reverb_buffer_size - delay) & mask;
+                    uint32_t span  = min(frame_count, reverb_buffer_size - read);
+                    kernels::accumulate(buffer + read, taps, tap_gain, span);
+                    kernels::accumulate(buffer, taps + span, tap_gain, frame_count - span);
+                }
+
+                // write the input plus feedback, no tap reads from the span being written
+                const float* send = bus_send[c].data();
+                uint32_t write    = reverb.write_position;
+                uint32_t span     = min(frame_count, reverb_buffer_size - write);
+                kernels::multiply_add(send, taps, buffer + write, feedback, span);
+                kernels::multiply_add(send + span, taps + span, buffer, feedback, frame_count - span);
+
+                kernels::accumulate(taps, bus_dry[c].data(), 1.0f, frame_count);
+            }
+
+            reverb.write_position = (reverb.write_position + frame_count) & mask;
+        }
+
+        void process_commands()
+        {
+            Command command;
+            while (commands.pop(command))
+            {
+                Voice& voice = voices[voice_index(command.voice)];
+                switch (command.type)
+                {
+                    case CommandType::PlayClip:
+                    case CommandType::PlaySynthesis:
+                    {
+                        voice            = Voice();
+                        voice.handle     = command.voice;
+                        voice.active     = true;
+                        voice.loop       = command.loop;
+                        voice.parameters = command.parameters;
+                        voice.clip       = std::move(command.clip);
+                        voice.stream     = command.stream;
+                        voice.synthesis  = std::move(command.synthesis);
+                        voice.channels   = voice.synthesis ? 2 : 1;
+                        break;
+                    }
+                    case CommandType::SetParameters:
+                    {
+                        if (voice.handle == command.voice)
+                        {
+                            voice.parameters = command.parameters;
+                        }
+                        break;
+                    }
+                    case CommandType::Stop:
+                    {
+                        if (voice.handle == command.voice && voice.active)
+                        {
+                            voice_stop(voice);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        void mix_block(const uint32_t frame_count)
+        {
+            for (uint32_t c = 0; c < channel_count; c++)
+            {
+                fill_n(bus_dry[c].data(), frame_count, 0.0f);
+                fill_n(bus_send[c].data(), frame_count, 0.0f);
+            }
+
+            float loudest_send = 0.0f;
+            for (Voice& voice : voices)
+            {
+                if (voice.active)
+                {
+                    mix_voice(voice, frame_count, loudest_send);
+                }
+            }
+
+            mix_reverb(frame_count);
+
+            float block_peak = kernels::interleave(bus_dry[0].data(), bus_dry[1].data(), output.data(), frame_count);
+            peak.store(block_peak, memory_order_relaxed);
+
+            if (!SDL_PutAudioStreamData(device_stream, output.data(), static_cast<int>(frame_count * channel_count * sizeof(float))))
+            {
+                SP_LOG_ERROR("%s", SDL_GetError());
+            }
+
+            frames_mixed.fetch_add(frame_count, memory_order_relaxed);
+        }
+
+        void mixer_loop()
+        {
+            SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL);
+            SP_MEMORY_TAG(MemoryTag::Audio);
+
+            const int frame_size = static_cast<int>(channel_count * sizeof(float));
+            while (running.load(memory_order_acquire))
+            {
+                process_commands();
+
+                // keep the device stream topped up to the requested latency, no further
+                uint32_t queued = static_cast<uint32_t>(max(SDL_GetAudioStreamQueued(device_stream), 0) / frame_size);
+                if (queued < latency_frames.load(memory_order_relaxed))
+                {
+                    mix_block(block_frames);
+                }
+                else
+                {
+                    SDL_DelayNS(500000); // 0.5 ms
+                }
+            }
+        }
+
+        void streaming_loop()
+        {
+            SP_MEMORY_TAG(MemoryTag::Audio);
+            vector<shared_ptr<AudioStream>> active;
+            while (running.load(memory_order_acquire))
+            {
+                {
+                    unique_lock<mutex> lock(streams_mutex);
+
+                    // a ring holds ~0.7 seconds, so waking every few milliseconds leaves plenty of headroom
+                    streams_condition.wait_for(lock, chrono::milliseconds(5));
+
+                    // streams the mixer released are destroyed here, never on the mixer thread
+                    erase_if(streams, [](const shared_ptr<AudioStream>& stream) { return stream->IsReleased(); });
+                    active = streams;
+                }
+
+                // disk reads happen outside the lock so starting a clip never waits on them
+                for (const shared_ptr<AudioStream>& stream : active)
+                {
+                    stream->Refill();
+                }
+                active.clear();
+            }
+        }
+    }
+
+    void AudioMixer::Initialize()
+    {
+        if (!SDL_WasInit(SDL_INIT_AUDIO))
+        {
+            SP_LOG_WARNING("SDL audio is not initialized, audio is disabled");
+            return;
+        }
+
+        // ask for a device period that matches the mix block, so latency is governed by the queue depth
+        SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, to_string(block_frames).c_str());
+
+        device_id = SDL_OpenAudioDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, nullptr);
+        if (device_id == 0)
+        {
+            SP_LOG_ERROR("%s", SDL_GetError());
+            return;
+        }
+
+        SDL_AudioSpec device_spec = {};
+        if (!SDL_GetAudioDeviceFormat(device_id, &device_spec, nullptr))
+        {
+            SP_LOG_ERROR("%s", SDL_GetError());
+        }
+
+        SDL_AudioSpec mix_spec = {};
+        mix_spec.freq          = sample_rate;
+        mix_spec.format        = SDL_AUDIO_F32;
+        mix_spec.channels      = channel_count;
+        device_stream = SDL_CreateAudioStream(&mix_spec, &device_spec);
+        if (!device_stream || !SDL_BindAudioStream(device_id, device_stream))
+        {
+            SP_LOG_ERROR("%s", SDL_GetError());
+            Shutdown();
+            return;
+        }
+
+        // allocate everything the mixer thread touches up front
+        for (uint32_t c = 0; c < channel_count; c++)
+        {
+            staging[c].assign(staging_frames, 0.0f);
+            reverb.buffer[c].assign(reverb_buffer_size, 0.0f);
+        }
+        synthesis_scratch.assign(staging_frames * channel_count, 0.0f);
+        reverb.write_position = 0;
+
+        on_audio_latency_change(cvar_audio_latency.GetValue());
+
+        SDL_ResumeAudioStreamDevice(device_stream);
+        running.store(true, memory_order_release);
+        mixer_thread     = thread(mixer_loop);
+        streaming_thread = thread(streaming_loop);
+
+        SP_LOG_INFO("Audio mixer running on \"%s\" at %u Hz, %u voices, %.1f ms latency",
+            SDL_GetCurrentAudioDriver(), sample_rate, max_voices, cvar_audio_latency.GetValue());
+    }
+
+    void AudioMixer::Shutdown()
+    {
+        running.store(false, memory_order_release);
+        streams_condition.notify_all();
+        if (mixer_thread.joinable())
+        {
+            mixer_thread.join();
+        }
+        if (streaming_thread.joinable())
+        {
+            streaming_thread.join();
+        }
+
+        // drop any commands that never made it to the mixer, and with them their clips and callbacks
+        Command command;
+        while (commands.pop(command)) {}
+
+        for (Voice& voice : voices)
+        {
+            voice = Voice();
+        }
+        streams.clear();
+
+        for (VoiceStatus& status : voice_status)
+        {
+            status.playing.store(0, memory_order_relaxed);
+        }
+        voices_allocated.store(0, memory_order_relaxed);
+
+        if (device_stream)
+        {
+            SDL_DestroyAudioStream(device_stream);
+            device_stream = nullptr;
+        }
+
+        if (device_id != 0)
+        {
+            SDL_CloseAudioDevice(device_id);
+            device_id = 0;
+        }
+    }
+
+    AudioVoice AudioMixer::PlayClip(const shared_ptr<AudioClip>& clip, const bool loop, const AudioVoiceParameters& parameters)
+    {
+        if (!running.load(memory_order_relaxed) || !clip || clip->sample_count == 0)
+            return 0;
+
+        // streamed clips get a ring buffer, primed here so playback starts without a gap
+        shared_ptr<AudioStream> stream;
+        if (clip->storage == AudioClipStorage::Streamed)
+        {
+            stream = make_shared<AudioStream>(clip, loop);
+            if (!stream->IsValid())
+                return 0;
+
+            stream->Refill();
+        }
+
+        AudioVoice voice = voice_allocate();
+        if (voice == 0)
+            return 0;
+
+        if (stream)
+        {
+            lock_guard<mutex> lock(streams_mutex);
+            streams.push_back(stream);
+        }
+
+        Command command;
+        command.type       = CommandType::PlayClip;
+        command.voice      = voice;
+        command.loop       = loop;
+        command.parameters = parameters;
+        command.clip       = clip;
+        command.stream     = stream.get();
+        submit(std::move(command));
+
+        return voice;
+    }
+
+    AudioVoice AudioMixer::PlaySynthesis(SynthesisCallback callback, const AudioVoiceParameters& parameters)
+    {
+        if (!running.load(memory_order_relaxed) || !callback)
+            return 0;
+
+        AudioVoice voice = voice_allocate();
+        if (voice == 0)
+            return 0;
+
+        Command command;
+        command.type       = CommandType::PlaySynthesis;
+        command.voice      = voice;
+        command.loop       = true;
+        command.parameters = parameters;
+        command.synthesis  = std::move(callback);
+        submit(std::move(command));
+
+        return voice;
+    }
+
+    void AudioMixer::SetParameters(const AudioVoice voice, const AudioVoiceParameters& parameters)
+    {
+        if (!is_valid(voice))
+            return;
+
+        Command command;
+        command.type       = CommandType::SetParameters;
+        command.voice      = voice;
+        command.parameters = parameters;
+        submit(std::move(command));
+    }
+
+    void AudioMixer::Stop(const AudioVoice voice)
+    {
+        if (!is_valid(voice))
+            return;
+
+        // the slot can be reused right away, the queue is ordered so the mixer sees this stop before any new play
+        Command command;
+        command.type  = CommandType::Stop;
+        command.voice = voice;
+        submit(std::move(command));
+
+        voice_free(voice);
+    }
+
+    bool AudioMixer::IsPlaying(const AudioVoice voice)
+    {
+        if (voice == 0 || voice_index(voice) >= max_voices)
+            return false;
+
+        return voice_status[voice_index(voice)].playing.load(memory_order_acquire) == voice;
+    }
+
+    float AudioMixer::GetProgress(const AudioVoice voice)
+    {
+        if (!is_valid(voice))
+            return 0.0f;
+
+        return voice_status[voice_index(voice)].progress.load(memory_order_relaxed);
+    }
+
+    bool AudioMixer::IsRunning()
+    {
+        return running.load(memory_order_relaxed);
+    }
+
+    uint32_t AudioMixer::GetSampleRate()
+    {
+        return sample_rate;
+    }
+
+    uint32_t AudioMixer::GetVoiceCount()
+    {
+        return static_cast<uint32_t>(popcount(voices_allocated.load(memory_order_relaxed)));
+    }
+
+    uint64_t AudioMixer::GetFramesMixed()
+    {
+        return frames_mixed.load(memory_order_relaxed);
+    }
+
+    float AudioMixer::GetPeak()
+    {
+        return peak.load(memory_order_relaxed);
+    }
+
+    uint64_t AudioMixer::GetStreamUnderruns()
+    {
+        return stream_underruns.load(memory_order_relaxed);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =======
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include "AudioClip.h"
+//==================
+
+namespace spartan
+{
+    // callback type for audio synthesis: generates stereo samples into buffer
+    // parameters: output buffer (stereo interleaved), number of sample frames
+    using SynthesisCallback = std::function<void(float*, int)>;
+
+    // everything the mixer needs to render a voice, resolved on the game thread
+    struct AudioVoiceParameters
+    {
+        float gain_left        = 1.0f;
+        float gain_right       = 1.0f;
+        float pitch            = 1.0f; // playback rate, includes doppler
+        float reverb_send      = 0.0f; // 0.0 bypasses the reverb bus
+        float reverb_room_size = 0.5f;
+        float reverb_decay     = 0.5f;
+    };
+
+    // a handle to a voice in the mixer's pool, 0 is never a valid voice
+    using AudioVoice = uint32_t;
+
+    // owns the audio device and mixes all voices on a dedicated thread
+    // the game thread talks to it through a lock-free command queue
+    class AudioMixer
+    {
+    public:
+        static void Initialize();
+        static void Shutdown();
+
+        // voices - a voice stays reserved until Stop() is called, even if it finished playing
+        static AudioVoice PlayClip(const std::shared_ptr<AudioClip>& clip, const bool loop, const AudioVoiceParameters& parameters);
+        static AudioVoice PlaySynthesis(SynthesisCallback callback, const AudioVoiceParameters& parameters);
+        static void SetParameters(const AudioVoice voice, const AudioVoiceParameters& parameters);
+        static void Stop(const AudioVoice voice);
+        static bool IsPlaying(const AudioVoice voice);
+        static float GetProgress(const AudioVoice voice);
+
+        // properties
+        static bool IsRunning();
+        static uint32_t GetSampleRate();
+        static uint32_t GetVoiceCount();
+        static uint64_t GetFramesMixed();
+        static float GetPeak();
+        static uint64_t GetStreamUnderruns();
+    };
+}
@@ -0,0 +1,172 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ============
+#include "pch.h"
+#include "AudioStream.h"
+#include "AudioClip.h"
+SP_WARNINGS_OFF
+#include <SDL3/SDL_audio.h>
+#include <SDL3/SDL_iostream.h>
+SP_WARNINGS_ON
+//=======================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace spartan
+{
+    namespace
+    {
+        constexpr uint32_t ring_frames  = 32768; // power of two, ~0.7 seconds at 48khz
+        constexpr uint32_t chunk_frames = 4096;  // decode granularity
+    }
+
+    AudioStream::AudioStream(const shared_ptr<AudioClip>& clip, const bool loop) : m_clip(clip), m_loop(loop)
+    {
+        SDL_AudioSpec source_spec = {};
+        source_spec.format        = static_cast<SDL_AudioFormat>(clip->source_format);
+        source_spec.channels      = static_cast<int>(clip->source_channels);
+        source_spec.freq          = static_cast<int>(clip->sample_rate);
+
+        SDL_AudioSpec target_spec = source_spec;
+        target_spec.format        = SDL_AUDIO_F32;
+        target_spec.channels      = 1;
+
+        m_file      = SDL_IOFromFile(clip->file_path.c_str(), "rb");
+        m_converter = SDL_CreateAudioStream(&source_spec, &target_spec);
+        if (!m_file || !m_converter || SDL_SeekIO(m_file, static_cast<Sint64>(clip->data_offset), SDL_IO_SEEK_SET) < 0)
+        {
+            SP_LOG_ERROR("Failed to open \"%s\" for streaming: %s", clip->file_path.c_str(), SDL_GetError());
+            return;
+        }
+
+        // whole frames only, so a loop never splits a frame
+        const uint32_t frame_size = SDL_AUDIO_BYTESIZE(source_spec.format) * clip->source_channels;
+        m_bytes_remaining         = clip->data_size - clip->data_size % frame_size;
+
+        m_read_buffer.resize(static_cast<size_t>(chunk_frames) * frame_size);
+        m_decoded.resize(chunk_frames);
+        m_ring.assign(ring_frames, 0.0f);
+    }
+
+    AudioStream::~AudioStream()
+    {
+        if (m_converter)
+        {
+            SDL_DestroyAudioStream(m_converter);
+            m_converter = nullptr;
+        }
+
+        if (m_file)
+        {
+            SDL_CloseIO(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    void AudioStream::Refill()
+    {
+        if (!IsValid())
+            return;
+
+        while (!m_end_of_stream.load(memory_order_relaxed))
+        {
+            const uint64_t write = m_write.load(memory_order_relaxed);
+            const uint32_t space = ring_frames - static_cast<uint32_t>(write - m_read.load(memory_order_acquire));
+            if (space < chunk_frames)
+                break;
+
+            // feed the converter until it can produce a full chunk or the input ran out
+            int available = SDL_GetAudioStreamAvailable(m_converter) / static_cast<int>(sizeof(float));
+            while (available < static_cast<int>(chunk_frames) && !m_input_done)
+            {
+                if (m_bytes_remaining == 0 && m_loop)
+                {
+                    SDL_SeekIO(m_file, static_cast<Sint64>(m_clip->data_offset), SDL_IO_SEEK_SET);
+                    m_bytes_remaining = m_clip->data_size - m_clip->data_size % (m_read_buffer.size() / chunk_frames);
+                }
+
+                size_t bytes = min<size_t>(m_read_buffer.size(), m_bytes_remaining);
+                size_t read  = bytes > 0 ? SDL_ReadIO(m_file, m_read_buffer.data(), bytes) : 0;
+                if (read == 0)
+                {
+                    // end of a one-shot clip, or a truncated file
+                    SDL_FlushAudioStream(m_converter);
+                    m_input_done = true;
+                    break;
+                }
+
+                m_bytes_remaining -= read;
+                SDL_PutAudioStreamData(m_converter, m_read_buffer.data(), static_cast<int>(read));
+                available = SDL_GetAudioStreamAvailable(m_converter) / static_cast<int>(sizeof(float));
+            }
+
+            int frames = SDL_GetAudioStreamData(m_converter, m_decoded.data(), static_cast<int>(chunk_frames * sizeof(float))) / static_cast<int>(sizeof(float));
+            if (frames <= 0)
+            {
+                if (m_input_done)
+                {
+                    m_end_of_stream.store(true, memory_order_release);
+                }
+                break;
+            }
+
+            // copy into the ring, wrapping at most once
+            uint32_t start = static_cast<uint32_t>(write & (ring_frames - 1));
+            uint32_t span  = min(static_cast<uint32_t>(frames), ring_frames - start);
+            memcpy(m_ring.data() + start, m_decoded.data(), span * sizeof(float));
+            memcpy(m_ring.data(), m_decoded.data() + span, (frames - span) * sizeof(float));
+            m_write.store(write + frames, memory_order_release);
+        }
+    }
+
+    uint32_t AudioStream::Read(float* output, const uint32_t count)
+    {
+        const uint64_t read      = m_read.load(memory_order_relaxed);
+        const uint32_t available = static_cast<uint32_t>(m_write.load(memory_order_acquire) - read);
+        const uint32_t frames    = min(count, available);
+
+        uint32_t start = static_cast<uint32_t>(read & (ring_frames - 1));
+        uint32_t span  = min(frames, ring_frames - start);
+        memcpy(output, m_ring.data() + start, span * sizeof(float));
+        memcpy(output + span, m_ring.data(), (frames - span) * sizeof(float));
+        m_read.store(read + frames, memory_order_release);
+
+        return frames;
+    }
+
+    bool AudioStream::IsDrained() const
+    {
+        // end of stream is published after the last write, so check it first
+        return m_end_of_stream.load(memory_order_acquire) && m_read.load(memory_order_relaxed) == m_write.load(memory_order_acquire);
+    }
+
+    float AudioStream::GetProgress() const
+    {
+        if (m_clip->sample_count == 0)
+            return 0.0f;
+
+        uint64_t position = m_read.load(memory_order_relaxed) % m_clip->sample_count;
+        return static_cast<float>(position) / static_cast<float>(m_clip->sample_count);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =======
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+//==================
+
+struct SDL_IOStream;
+struct SDL_AudioStream;
+
+namespace spartan
+{
+    struct AudioClip;
+
+    // a streamed clip being played by one voice
+    // the streaming thread decodes from disk into a ring buffer, the mixer thread drains it
+    class AudioStream
+    {
+    public:
+        AudioStream(const std::shared_ptr<AudioClip>& clip, const bool loop);
+        ~AudioStream();
+
+        // streaming thread, tops up the ring buffer in chunks
+        void Refill();
+
+        // mixer thread
+        uint32_t Read(float* output, const uint32_t count);
+        bool IsDrained() const;
+        float GetProgress() const;
+
+        // the mixer is done with it, the streaming thread can destroy it
+        void Release()          { m_released.store(true, std::memory_order_release); }
+        bool IsReleased() const { return m_released.load(std::memory_order_acquire); }
+        bool IsValid() const    { return m_file != nullptr && m_converter != nullptr; }
+
+    private:
+        std::shared_ptr<AudioClip> m_clip;
+        bool m_loop                   = false;
+        SDL_IOStream* m_file          = nullptr;
+        SDL_AudioStream* m_converter  = nullptr; // source pcm to mono float32
+        uint64_t m_bytes_remaining    = 0;
+        bool m_input_done             = false;
+        std::vector<uint8_t> m_read_buffer;
+        std::vector<float> m_decoded;
+
+        // single producer, single consumer
+        std::vector<float> m_ring;
+        alignas(64) std::atomic<uint64_t> m_write = 0;
+        alignas(64) std::atomic<uint64_t> m_read  = 0;
+        std::atomic<bool> m_end_of_stream         = false;
+        std::atomic<bool> m_released              = false;
+    };
+}
@@ -26,8 +26,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <algorithm>
 #include <cstdint>
+#include <atomic>
 #include "../../editor/ImGui/Source/imgui.h"
 #include "CarTireSquealSynthesis.h"
+#include "CarSynthesisSimd.h"
 //==========================================
 
 namespace engine_sound
@@ -179,6 +181,16 @@ namespace engine_sound
             return hp;
         }
 
+        // coefficients for sample i of a block computed by synthesis_simd::compute_svf_coefficients()
+        template<int block_size>
+        void set_coefficients(const synthesis_simd::svf_coefficients<block_size>& coefficients, int i)
+        {
+            k  = coefficients.k[i];
+            a1 = coefficients.a1[i];
+            a2 = coefficients.a2[i];
+            a3 = coefficients.a3[i];
+        }
+
         void reset()
         {
             ic1eq = ic2eq = 0.0f;
@@ -395,15 +407,20 @@ namespace engine_sound
 
         void set_parameters(float rpm, float throttle, float load, float boost_pressure = 0.0f)
         {
-            m_target_rpm      = std::clamp(rpm, tuning::idle_rpm, tuning::max_rpm);
-            m_target_throttle = std::clamp(throttle, 0.0f, 1.0f);
-            m_target_load     = std::clamp(load, 0.0f, 1.0f);
-            m_boost_pressure  = std::clamp(boost_pressure, 0.0f, 2.0f);
-
-            m_debug.rpm      = m_target_rpm;
-            m_debug.throttle = m_target_throttle;
-            m_debug.load     = m_target_load;
-            m_debug.boost    = m_boost_pressure;
+            // called from the game thread while generate() runs on the audio mixer thread
+            rpm            = std::clamp(rpm, tuning::idle_rpm, tuning::max_rpm);
+            throttle       = std::clamp(throttle, 0.0f, 1.0f);
+            load           = std::clamp(load, 0.0f, 1.0f);
+            boost_pressure = std::clamp(boost_pressure, 0.0f, 2.0f);
+            m_target_rpm.store(rpm, std::memory_order_relaxed);
+            m_target_throttle.store(throttle, std::memory_order_relaxed);
+            m_target_load.store(load, std::memory_order_relaxed);
+            m_boost_pressure.store(boost_pressure, std::memory_order_relaxed);
+
+            m_debug.rpm      = rpm;
+            m_debug.throttle = throttle;
+            m_debug.load     = load;
+            m_debug.boost    = boost_pressure;
         }
 
         void generate(float* output_buffer, int num_samples, bool stereo = true)
@@ -419,6 +436,12 @@ namespace engine_sound
                 return;
             }
 
+            // targets are sampled once per block
+            const float target_rpm      = m_target_rpm.load(std::memory_order_relaxed);
+            const float target_throttle = m_target_throttle.load(std::memory_order_relaxed);
+            const float target_load     = m_target_load.load(std::memory_order_relaxed);
+            const float boost_pressure  = m_boost_pressure.load(std::memory_order_relaxed);
+
             float combustion_sum = 0.0f, exhaust_sum = 0.0f;
             float induction_sum = 0.0f, mechanical_sum = 0.0f;
             float turbo_sum = 0.0f, output_sum = 0.0f;
@@ -426,28 +449,19 @@ namespace engine_sound
 
             for (int i = 0; i < num_samples; i++)
             {
-                float rpm      = m_rpm_smooth.process(m_target_rpm);
-                float throttle = m_throttle_smooth.process(m_target_throttle);
-                float load     = m_load_smooth.process(m_target_load);
-
-                float rpm_norm = (rpm - tuning::idle_rpm) / (tuning::redline_rpm - tuning::idle_rpm);
-                rpm_norm = std::clamp(rpm_norm, 0.0f, 1.0f);
+                // controls, combustion and the rpm driven filter coefficients are computed a block ahead
+                const int j = i % block_size;
+                if (j == 0)
+                {
+                    prepare_block(std::min(block_size, num_samples - i), target_rpm, target_throttle, target_load, boost_pressure);
+                }
 
-                for (auto& cyl : m_cylinders)
-                    cyl.set_rpm(rpm, m_sample_rate);
+                float throttle = m_block.throttle[j];
+                float rpm_norm = m_block.rpm_norm[j];
 
                 // combustion
-                float combustion_raw = 0.0f;
-                float combustion_derivative = 0.0f;
-                int firing_count = 0;
-
-                for (auto& cyl : m_cylinders)
-                {
-                    float pulse = cyl.tick(load, rpm_norm);
-                    combustion_raw += pulse;
-                    combustion_derivative += (pulse - cyl.prev_pressure);
-                    if (cyl.is_firing) firing_count++;
-                }
+                float combustion_raw        = m_block.combustion_raw[j];
+                float combustion_derivative = m_block.combustion_derivative[j];
 
                 combustion_raw /= 3.0f;
                 combustion_derivative *= 2.0f;
@@ -468,14 +482,9 @@ namespace engine_sound
                 }
 
                 // exhaust
-                float res1_freq = tuning::exhaust_res_1_idle + rpm_norm * (tuning::exhaust_res_1_high - tuning::exhaust_res_1_idle);
-                float res2_freq = tuning::exhaust_res_2_idle + rpm_norm * (tuning::exhaust_res_2_high - tuning::exhaust_res_2_idle);
-                float res3_freq = tuning::exhaust_res_3_idle + rpm_norm * (tuning::exhaust_res_3_high - tuning::exhaust_res_3_idle);
-
-                float q_mod = 1.5f + rpm_norm * 2.5f;
-                m_exhaust_res1.set_params(res1_freq, q_mod * 0.8f, m_sample_rate);
-                m_exhaust_res2.set_params(res2_freq, q_mod * 0.6f, m_sample_rate);
-                m_exhaust_res3.set_params(res3_freq, q_mod * 0.5f, m_sample_rate);
+                m_exhaust_res1.set_coefficients(m_block.coefficients[slot_exhaust_res1], j);
+                m_exhaust_res2.set_coefficients(m_block.coefficients[slot_exhaust_res2], j);
+                m_exhaust_res3.set_coefficients(m_block.coefficients[slot_exhaust_res3], j);
 
                 float exhaust_noise = m_noise.pink() * (0.15f + throttle * 0.1f);
                 float exhaust_input = combustion * 0.8f + exhaust_noise;
@@ -485,8 +494,7 @@ namespace engine_sound
                 exhaust += m_exhaust_res2.bandpass(exhaust_input) * 0.35f;
                 exhaust += m_exhaust_res3.bandpass(exhaust_input) * (0.2f + rpm_norm * 0.3f);
 
-                float body_freq = 150.0f + rpm_norm * 200.0f;
-                m_exhaust_body.set_params(body_freq, 0.7f, m_sample_rate);
+                m_exhaust_body.set_coefficients(m_block.coefficients[slot_exhaust_body], j);
                 exhaust += m_exhaust_body.lowpass(exhaust_input) * 0.4f;
                 exhaust = tanhf(exhaust * 2.0f);
 
@@ -517,11 +525,11 @@ namespace engine_sound
                 {
                     float intake_pulse = combustion_raw * combustion_raw;
 
-                    m_induction_body.set_params(60.0f + rpm_norm * 80.0f, 0.5f, m_sample_rate);
+                    m_induction_body.set_coefficients(m_block.coefficients[slot_induction_body], j);
                     float intake_body = m_induction_body.lowpass(intake_pulse) * throttle;
 
                     float turb = m_noise.pink() * 0.1f * throttle * (0.3f + combustion_raw * 0.7f);
-                    m_induction_res.set_params(100.0f + rpm_norm * 150.0f, 0.6f, m_sample_rate);
+                    m_induction_res.set_coefficients(m_block.coefficients[slot_induction_res], j);
                     turb = m_induction_res.lowpass(turb);
 
                     induction = intake_body * 0.7f + turb * 0.3f;
@@ -534,11 +542,10 @@ namespace engine_sound
                     float valve_tick = combustion_derivative * combustion_derivative * 4.0f;
 
                     float chain_rattle = m_noise.white() * (0.3f + valve_tick * 0.7f);
-                    m_mechanical_hp.set_params(800.0f + rpm_norm * 600.0f, 1.2f, m_sample_rate);
+                    m_mechanical_hp.set_coefficients(m_block.coefficients[slot_mechanical_hp], j);
                     chain_rattle = m_mechanical_hp.bandpass(chain_rattle);
 
-                    float gear_freq = 200.0f + rpm * 0.05f;
-                    m_mechanical_lp.set_params(gear_freq, 3.0f, m_sample_rate);
+                    m_mechanical_lp.set_coefficients(m_block.coefficients[slot_mechanical_lp], j);
                     float gear_whine = m_mechanical_lp.bandpass(m_noise.pink() * 0.3f);
 
                     mechanical = valve_tick * 0.4f + chain_rattle * 0.4f + gear_whine * 0.2f;
@@ -550,63 +557,47 @@ namespace engine_sound
                 float turbo = 0.0f;
                 {
                     float dt = 1.0f / m_sample_rate;
-                    float raw_throttle = m_target_throttle;
-
-                    float rpm_factor = std::clamp((rpm - tuning::turbo_min_rpm) / (tuning::turbo_full_rpm - tuning::turbo_min_rpm), 0.0f, 1.0f);
-                    float demand = rpm_factor * throttle * (0.5f + load * 0.5f);
-                    m_turbo_target_spool = demand * m_boost_pressure;
+                    float raw_throttle = target_throttle;
 
-                    float prev_spool = m_turbo_spool;
-
-                    // spool dynamics
-                    float spool_diff = m_turbo_target_spool - m_turbo_spool;
-                    if (spool_diff > 0)
-                        m_turbo_spool += spool_diff * tuning::turbo_spool_up * dt;
-                    else
-                        m_turbo_spool += spool_diff * tuning::turbo_spool_down * dt;
-                    m_turbo_spool = std::clamp(m_turbo_spool, 0.0f, 1.0f);
-
-                    float spool_rate = (m_turbo_spool - prev_spool) * m_sample_rate;
+                    // spool dynamics run ahead in prepare_block()
+                    float turbo_spool = m_block.turbo_spool[j];
+                    float spool_rate  = m_block.spool_rate[j];
 
                     // flutter on throttle lift
                     float throttle_delta = raw_throttle - m_prev_throttle;
-                    if (throttle_delta < -0.08f && m_turbo_spool > 0.25f)
+                    if (throttle_delta < -0.08f && turbo_spool > 0.25f)
                     {
-                        float flutter_strength = m_turbo_spool * fabsf(throttle_delta) * 6.0f;
+                        float flutter_strength = turbo_spool * fabsf(throttle_delta) * 6.0f;
                         m_turbo_flutter_env = std::max(m_turbo_flutter_env, std::min(flutter_strength, 1.0f));
                     }
 
                     // wastegate on boost drop
-                    float boost_delta = m_boost_pressure - m_prev_boost;
-                    if (boost_delta < -0.08f && m_turbo_spool > 0.3f)
+                    float boost_delta = boost_pressure - m_prev_boost;
+                    if (boost_delta < -0.08f && turbo_spool > 0.3f)
                         m_wastegate_env = std::max(m_wastegate_env, fabsf(boost_delta) * 2.5f);
 
                     m_prev_throttle = raw_throttle;
-                    m_prev_boost = m_boost_pressure;
+                    m_prev_boost = boost_pressure;
 
                     // spool whoosh
-                    if (m_turbo_spool > 0.02f)
+                    if (turbo_spool > 0.02f)
                     {
                         float turbo_noise = m_noise.white() * 0.7f + m_noise.pink() * 0.3f;
 
-                        float whoosh_freq = 300.0f + m_turbo_spool * m_turbo_spool * 2500.0f;
-                        float whoosh_q = 0.8f + m_turbo_spool * 1.5f;
-
-                        m_turbo_whine_bp.set_params(whoosh_freq, whoosh_q, m_sample_rate);
+                        m_turbo_whine_bp.set_coefficients(m_block.coefficients[slot_turbo_whoosh], j);
                         float whoosh = m_turbo_whine_bp.bandpass(turbo_noise);
 
-                        float air_freq = 1500.0f + m_turbo_spool * 3000.0f;
-                        m_turbo_filter.set_params(air_freq, 1.0f, m_sample_rate);
+                        m_turbo_filter.set_coefficients(m_block.coefficients[slot_turbo_air], j);
                         float air = m_turbo_filter.bandpass(turbo_noise) * 0.3f;
 
-                        float spool_vol = m_turbo_spool * m_turbo_spool;
+                        float spool_vol = turbo_spool * turbo_spool;
                         turbo += (whoosh * 0.7f + air * 0.3f) * spool_vol * tuning::turbo_whine_level * 3.0f;
                     }
 
                     // spindown whistle
-                    if (spool_rate < -0.1f && m_turbo_spool > 0.05f)
+                    if (spool_rate < -0.1f && turbo_spool > 0.05f)
                     {
-                        float whistle_freq = 2000.0f + m_turbo_spool * 6000.0f;
+                        float whistle_freq = 2000.0f + turbo_spool * 6000.0f;
 
                         m_turbo_phase += whistle_freq / m_sample_rate;
                         if (m_turbo_phase > 1.0f) m_turbo_phase -= 1.0f;
@@ -615,7 +606,7 @@ namespace engine_sound
                         whistle += sinf(m_turbo_phase * TWO_PI * 2.0f) * 0.2f;
 
                         float spindown_intensity = std::min(fabsf(spool_rate) * 2.0f, 1.0f);
-                        spindown_intensity *= m_turbo_spool;
+                        spindown_intensity *= turbo_spool;
                         whistle *= (0.85f + m_noise.white() * 0.15f);
 
                         turbo += whistle * spindown_intensity * tuning::turbo_whine_level * 1.5f;
@@ -786,14 +777,232 @@ namespace engine_sound
         bool is_initialized() const { return m_initialized; }
         const debug_data& get_debug() const { return m_debug; }
 
+        // the scalar path is kept as the reference the vector kernels are validated against
+        void set_simd(bool enabled) { m_simd = enabled; }
+
     private:
+        static constexpr int block_size = 64;
+
+        // filters whose coefficients follow rpm every sample
+        enum coefficient_slot
+        {
+            slot_exhaust_res1,
+            slot_exhaust_res2,
+            slot_exhaust_res3,
+            slot_exhaust_body,
+            slot_induction_body,
+            slot_induction_res,
+            slot_mechanical_hp,
+            slot_mechanical_lp,
+            slot_turbo_whoosh,
+            slot_turbo_air,
+            slot_count
+        };
+
+        struct control_block
+        {
+            float rpm[block_size];
+            float throttle[block_size];
+            float load[block_size];
+            float rpm_norm[block_size];
+            float combustion_raw[block_size];
+            float combustion_derivative[block_size];
+            float turbo_spool[block_size];
+            float spool_rate[block_size];
+            float freq[slot_count][block_size];
+            float q[slot_count][block_size];
+            synthesis_simd::svf_coefficients<block_size> coefficients[slot_count];
+        };
+
+        void prepare_block(int count, float target_rpm, float target_throttle, float target_load, float boost_pressure)
+        {
+            for (int j = 0; j < count; j++)
+            {
+                float rpm      = m_rpm_smooth.process(target_rpm);
+                float throttle = m_throttle_smooth.process(target_throttle);
+                float load     = m_load_smooth.process(target_load);
+
+                float rpm_norm = (rpm - tuning::idle_rpm) / (tuning::redline_rpm - tuning::idle_rpm);
+                rpm_norm = std::clamp(rpm_norm, 0.0f, 1.0f);
+
+                m_block.rpm[j]      = rpm;
+                m_block.throttle[j] = throttle;
+                m_block.load[j]     = load;
+                m_block.rpm_norm[j] = rpm_norm;
+
+                float q_mod = 1.5f + rpm_norm * 2.5f;
+                m_block.freq[slot_exhaust_res1][j]   = tuning::exhaust_res_1_idle + rpm_norm * (tuning::exhaust_res_1_high - tuning::exhaust_res_1_idle);
+                m_block.freq[slot_exhaust_res2][j]   = tuning::exhaust_res_2_idle + rpm_norm * (tuning::exhaust_res_2_high - tuning::exhaust_res_2_idle);
+                m_block.freq[slot_exhaust_res3][j]   = tuning::exhaust_res_3_idle + rpm_norm * (tuning::exhaust_res_3_high - tuning::exhaust_res_3_idle);
+                m_block.freq[slot_exhaust_body][j]   = 150.0f + rpm_norm * 200.0f;
+                m_block.freq[slot_induction_body][j] = 60.0f + rpm_norm * 80.0f;
+                m_block.freq[slot_induction_res][j]  = 100.0f + rpm_norm * 150.0f;
+                m_block.freq[slot_mechanical_hp][j]  = 800.0f + rpm_norm * 600.0f;
+                m_block.freq[slot_mechanical_lp][j]  = 200.0f + rpm * 0.05f;
+                m_block.q[slot_exhaust_res1][j]      = q_mod * 0.8f;
+                m_block.q[slot_exhaust_res2][j]      = q_mod * 0.6f;
+                m_block.q[slot_exhaust_res3][j]      = q_mod * 0.5f;
+                m_block.q[slot_exhaust_body][j]      = 0.7f;
+                m_block.q[slot_induction_body][j]    = 0.5f;
+                m_block.q[slot_induction_res][j]     = 0.6f;
+                m_block.q[slot_mechanical_hp][j]     = 1.2f;
+                m_block.q[slot_mechanical_lp][j]     = 3.0f;
+
+                // turbo spool only follows the controls, so it runs ahead with them
+                float dt         = 1.0f / m_sample_rate;
+                float rpm_factor = std::clamp((rpm - tuning::turbo_min_rpm) / (tuning::turbo_full_rpm - tuning::turbo_min_rpm), 0.0f, 1.0f);
+                float demand     = rpm_factor * throttle * (0.5f + load * 0.5f);
+                m_turbo_target_spool = demand * boost_pressure;
+
+                float prev_spool = m_turbo_spool;
+                float spool_diff = m_turbo_target_spool - m_turbo_spool;
+                if (spool_diff > 0)
+                    m_turbo_spool += spool_diff * tuning::turbo_spool_up * dt;
+                else
+                    m_turbo_spool += spool_diff * tuning::turbo_spool_down * dt;
+                m_turbo_spool = std::clamp(m_turbo_spool, 0.0f, 1.0f);
+
+                m_block.turbo_spool[j]             = m_turbo_spool;
+                m_block.spool_rate[j]              = (m_turbo_spool - prev_spool) * m_sample_rate;
+                m_block.freq[slot_turbo_whoosh][j] = 300.0f + m_turbo_spool * m_turbo_spool * 2500.0f;
+                m_block.freq[slot_turbo_air][j]    = 1500.0f + m_turbo_spool * 3000.0f;
+                m_block.q[slot_turbo_whoosh][j]    = 0.8f + m_turbo_spool * 1.5f;
+                m_block.q[slot_turbo_air][j]       = 1.0f;
+            }
+
+            for (int slot = 0; slot < slot_count; slot++)
+            {
+                synthesis_simd::compute_svf_coefficients(m_block.freq[slot], m_block.q[slot], count, m_sample_rate, m_block.coefficients[slot], m_simd);
+            }
+
+        #if defined(__AVX2__)
+            if (m_simd)
+            {
+                tick_cylinders_simd(count);
+                return;
+            }
+        #endif
+
+            for (int j = 0; j < count; j++)
+            {
+                for (auto& cyl : m_cylinders)
+                    cyl.set_rpm(m_block.rpm[j], m_sample_rate);
+
+                float combustion_raw        = 0.0f;
+                float combustion_derivative = 0.0f;
+                for (auto& cyl : m_cylinders)
+                {
+                    float pulse = cyl.tick(m_block.load[j], m_block.rpm_norm[j]);
+                    combustion_raw += pulse;
+                    combustion_derivative += (pulse - cyl.prev_pressure);
+                }
+
+                m_block.combustion_raw[j]        = combustion_raw;
+                m_block.combustion_derivative[j] = combustion_derivative;
+            }
+        }
+
+    #if defined(__AVX2__)
+        // cylinder::tick() with the cylinders spread across lanes, unused lanes have zero intensity
+        void tick_cylinders_simd(int count)
+        {
+            constexpr int lanes        = ((tuning::cylinder_count + 7) / 8) * 8;
+            constexpr float window_end = tuning::combustion_attack + tuning::combustion_hold + tuning::combustion_decay;
+
+            alignas(32) float phase[lanes]         = {};
+            alignas(32) float pressure[lanes]      = {};
+            alignas(32) float prev_pressure[lanes] = {};
+            alignas(32) float firing[lanes]        = {};
+            alignas(32) float fire_phase[lanes]    = {};
+            alignas(32) float firing_offset[lanes] = {};
+            alignas(32) float timing_jitter[lanes] = {};
+            alignas(32) float intensity_var[lanes] = {};
+            for (int c = 0; c < tuning::cylinder_count; c++)
+            {
+                phase[c]         = m_cylinders[c].phase;
+                pressure[c]      = m_cylinders[c].pressure;
+                prev_pressure[c] = m_cylinders[c].prev_pressure;
+                fire_phase[c]    = m_cylinders[c].fire_phase;
+                firing_offset[c] = m_cylinders[c].firing_offset;
+                timing_jitter[c] = m_cylinders[c].timing_jitter;
+                intensity_var[c] = m_cylinders[c].intensity_var;
+            }
+
+            const __m256 v_one        = _mm256_set1_ps(1.0f);
+            const __m256 v_attack     = _mm256_set1_ps(tuning::combustion_attack);
+            const __m256 v_hold_end   = _mm256_set1_ps(tuning::combustion_attack + tuning::combustion_hold);
+            const __m256 v_window_end = _mm256_set1_ps(window_end);
+
+            for (int j = 0; j < count; j++)
+            {
+                // per-sample scalars, same expressions as cylinder::set_rpm() and cylinder::tick()
+                const float cycles_per_second = m_block.rpm[j] / 60.0f / 2.0f;
+                const __m256 v_phase_inc      = _mm256_set1_ps(cycles_per_second / m_sample_rate);
+                const __m256 v_jitter_scale   = _mm256_set1_ps(1.0f - m_block.load[j] * 0.5f);
+                const __m256 v_load_factor    = _mm256_set1_ps(0.3f + m_block.load[j] * 0.7f);
+                const __m256 v_sharpness      = _mm256_set1_ps(1.0f / (1.0f + m_block.rpm_norm[j] * 0.5f));
+
+                __m256 v_pulse_sum      = _mm256_setzero_ps();
+                __m256 v_derivative_sum = _mm256_setzero_ps();
+                for (int lane = 0; lane < lanes; lane += 8)
+                {
+                    __m256 p = _mm256_add_ps(_mm256_load_ps(phase + lane), v_phase_inc);
+                    p = _mm256_blendv_ps(p, _mm256_sub_ps(p, v_one), _mm256_cmp_ps(p, v_one, _CMP_GE_OQ));
+
+                    // fmodf(x, 1.0f) is x - trunc(x), exact for this range
+                    __m256 t = _mm256_add_ps(_mm256_add_ps(p, _mm256_load_ps(firing_offset + lane)), _mm256_mul_ps(_mm256_load_ps(timing_jitter + lane), v_jitter_scale));
+                    t = _mm256_sub_ps(t, _mm256_round_ps(t, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+                    __m256 in_window = _mm256_cmp_ps(t, v_window_end, _CMP_LT_OQ);
+
+                    // pressure envelope, all three segments evaluated and selected
+                    __m256 attack_t = _mm256_div_ps(t, v_attack);
+                    __m256 env_a    = _mm256_mul_ps(_mm256_mul_ps(attack_t, attack_t), _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), attack_t)));
+                    __m256 hold_t   = _mm256_div_ps(_mm256_sub_ps(t, v_attack), _mm256_set1_ps(tuning::combustion_hold));
+                    __m256 env_h    = _mm256_sub_ps(v_one, _mm256_mul_ps(hold_t, _mm256_set1_ps(0.1f)));
+                    __m256 decay_t  = _mm256_div_ps(_mm256_sub_ps(_mm256_sub_ps(t, v_attack), _mm256_set1_ps(tuning::combustion_hold)), _mm256_set1_ps(tuning::combustion_decay));
+                    __m256 env_d    = _mm256_mul_ps(synthesis_simd::exp_ps(_mm256_mul_ps(_mm256_set1_ps(-4.0f), decay_t)), _mm256_sub_ps(v_one, _mm256_mul_ps(decay_t, _mm256_set1_ps(0.2f))));
+                    __m256 env      = _mm256_blendv_ps(env_d, env_h, _mm256_cmp_ps(t, v_hold_end, _CMP_LT_OQ));
+                    env             = _mm256_blendv_ps(env, env_a, _mm256_cmp_ps(t, v_attack, _CMP_LT_OQ));
+                    env             = synthesis_simd::pow_ps(env, v_sharpness);
+
+                    __m256 old_pressure = _mm256_load_ps(pressure + lane);
+                    __m256 fired        = _mm256_mul_ps(_mm256_mul_ps(env, v_load_factor), _mm256_load_ps(intensity_var + lane));
+                    __m256 new_pressure = _mm256_blendv_ps(_mm256_mul_ps(old_pressure, _mm256_set1_ps(0.95f)), fired, in_window);
+
+                    v_pulse_sum      = _mm256_add_ps(v_pulse_sum, new_pressure);
+                    v_derivative_sum = _mm256_add_ps(v_derivative_sum, _mm256_sub_ps(new_pressure, old_pressure));
+
+                    _mm256_store_ps(phase + lane, p);
+                    _mm256_store_ps(pressure + lane, new_pressure);
+                    _mm256_store_ps(prev_pressure + lane, old_pressure);
+                    _mm256_store_ps(firing + lane, in_window);
+                    _mm256_store_ps(fire_phase + lane, _mm256_blendv_ps(_mm256_load_ps(fire_phase + lane), _mm256_div_ps(t, v_window_end), in_window));
+                }
+
+                m_block.combustion_raw[j]        = synthesis_simd::hsum_ps(v_pulse_sum);
+                m_block.combustion_derivative[j] = synthesis_simd::hsum_ps(v_derivative_sum);
+            }
+
+            for (int c = 0; c < tuning::cylinder_count; c++)
+            {
+                m_cylinders[c].phase         = phase[c];
+                m_cylinders[c].pressure      = pressure[c];
+                m_cylinders[c].prev_pressure = prev_pressure[c];
+                m_cylinders[c].is_firing     = firing[c] != 0.0f;
+                m_cylinders[c].fire_phase    = fire_phase[c];
+            }
+        }
+    #endif
+
         bool  m_initialized = false;
+        bool  m_simd        = true;
         float m_sample_rate = tuning::sample_rate;
+        control_block m_block;
 
-        float m_target_rpm      = tuning::idle_rpm;
-        float m_target_throttle = 0.0f;
-        float m_target_load     = 0.0f;
-        float m_boost_pressure  = 0.0f;
+        std::atomic<float> m_target_rpm      = tuning::idle_rpm;
+        std::atomic<float> m_target_throttle = 0.0f;
+        std::atomic<float> m_target_load     = 0.0f;
+        std::atomic<float> m_boost_pressure  = 0.0f;
 
         std::vector<cylinder> m_cylinders;
 
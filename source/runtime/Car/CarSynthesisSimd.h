@@ -0,0 +1,190 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===============================
+#include <cmath>
+#include <algorithm>
+#include <immintrin.h>
+//==========================================
+
+// block kernels shared by the procedural car synthesizers
+// per-sample filter coefficients only depend on the smoothed control signals, so they are
+// computed 8 samples at a time ahead of the serial filter chain. the vector transcendentals
+// are cephes-style polynomial approximations, accurate to a few ulp of the libm versions.
+
+namespace synthesis_simd
+{
+    constexpr float PI = 3.14159265358979f;
+
+    // struct of arrays coefficients for one svf over a block, same layout as svf_filter's
+    template<int block_size>
+    struct svf_coefficients
+    {
+        alignas(32) float k[block_size];
+        alignas(32) float a1[block_size];
+        alignas(32) float a2[block_size];
+        alignas(32) float a3[block_size];
+    };
+
+#if defined(__AVX2__)
+    inline __m256 exp_ps(__m256 x)
+    {
+        x = _mm256_min_ps(x, _mm256_set1_ps(88.3762626647949f));
+        x = _mm256_max_ps(x, _mm256_set1_ps(-88.3762626647949f));
+
+        // x = n * ln2 + r, with ln2 split in two for precision
+        __m256 fx = _mm256_floor_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)), _mm256_set1_ps(0.5f)));
+        x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(0.693359375f)));
+        x = _mm256_sub_ps(x, _mm256_mul_ps(fx, _mm256_set1_ps(-2.12194440e-4f)));
+
+        __m256 z = _mm256_mul_ps(x, x);
+        __m256 y = _mm256_set1_ps(1.9875691500e-4f);
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.3981999507e-3f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(8.3334519073e-3f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(4.1665795894e-2f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.6666665459e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(5.0000001201e-1f));
+        y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(y, z), x), _mm256_set1_ps(1.0f));
+
+        // scale by 2^n
+        __m256i n = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(127)), 23);
+        return _mm256_mul_ps(y, _mm256_castsi256_ps(n));
+    }
+
+    inline float hsum_ps(__m256 v)
+    {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+        return _mm_cvtss_f32(sum);
+    }
+
+    // natural log, x must be positive
+    inline __m256 log_ps(__m256 x)
+    {
+        x = _mm256_max_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x00800000)));
+
+        // split into exponent and a mantissa in [0.5, 1)
+        __m256i exponent = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+        x = _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(~0x7f800000)));
+        x = _mm256_or_ps(x, _mm256_set1_ps(0.5f));
+        __m256 e = _mm256_add_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(exponent, _mm256_set1_epi32(127))), _mm256_set1_ps(1.0f));
+
+        // keep the mantissa in [sqrt(0.5), sqrt(2)) around 1
+        __m256 mask = _mm256_cmp_ps(x, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+        __m256 tmp  = _mm256_and_ps(x, mask);
+        x = _mm256_sub_ps(x, _mm256_set1_ps(1.0f));
+        e = _mm256_sub_ps(e, _mm256_and_ps(_mm256_set1_ps(1.0f), mask));
+        x = _mm256_add_ps(x, tmp);
+
+        __m256 z = _mm256_mul_ps(x, x);
+        __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.1514610310e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.1676998740e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.2420140846e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(1.4249322787e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-1.6668057665e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(2.0000714765e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(-2.4999993993e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(3.3333331174e-1f));
+        y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+
+        y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(-2.12194440e-4f)));
+        y = _mm256_sub_ps(y, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+        x = _mm256_add_ps(x, y);
+        return _mm256_add_ps(x, _mm256_mul_ps(e, _mm256_set1_ps(0.693359375f)));
+    }
+
+    // x^y for x >= 0
+    inline __m256 pow_ps(__m256 x, __m256 y)
+    {
+        __m256 result = exp_ps(_mm256_mul_ps(y, log_ps(x)));
+        return _mm256_and_ps(result, _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ));
+    }
+
+    // tangent for x in [0, pi/2)
+    inline __m256 tan_ps(__m256 x)
+    {
+        // reduce to [-pi/4, pi/4], the upper octant maps to -1 / tan(x - pi/2)
+        __m256 upper = _mm256_cmp_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)), _mm256_set1_ps(1.0f), _CMP_GE_OQ);
+        __m256 j     = _mm256_and_ps(upper, _mm256_set1_ps(2.0f));
+        __m256 z     = _mm256_sub_ps(x, _mm256_mul_ps(j, _mm256_set1_ps(0.78515625f)));
+        z = _mm256_sub_ps(z, _mm256_mul_ps(j, _mm256_set1_ps(2.4187564849853515625e-4f)));
+        z = _mm256_sub_ps(z, _mm256_mul_ps(j, _mm256_set1_ps(3.77489497744594108e-8f)));
+
+        __m256 zz = _mm256_mul_ps(z, z);
+        __m256 y  = _mm256_set1_ps(9.38540185543e-3f);
+        y = _mm256_add_ps(_mm256_mul_ps(y, zz), _mm256_set1_ps(3.11992232697e-3f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, zz), _mm256_set1_ps(2.44301354525e-2f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, zz), _mm256_set1_ps(5.34112807005e-2f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, zz), _mm256_set1_ps(1.33387994085e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(y, zz), _mm256_set1_ps(3.33331568548e-1f));
+        y = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(y, zz), z), z);
+
+        return _mm256_blendv_ps(y, _mm256_div_ps(_mm256_set1_ps(-1.0f), y), upper);
+    }
+#endif
+
+    // svf_filter::set_params for a block of samples, simd selects the vector path
+    template<int block_size>
+    inline void compute_svf_coefficients(const float* freq, const float* q, int count, float sample_rate, svf_coefficients<block_size>& out, bool simd)
+    {
+        int i = 0;
+
+    #if defined(__AVX2__)
+        if (simd)
+        {
+            const __m256 v_min_freq = _mm256_set1_ps(20.0f);
+            const __m256 v_max_freq = _mm256_set1_ps(sample_rate * 0.45f);
+            const __m256 v_rate     = _mm256_set1_ps(sample_rate);
+            const __m256 v_one      = _mm256_set1_ps(1.0f);
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 f  = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(freq + i), v_min_freq), v_max_freq);
+                __m256 qv = _mm256_max_ps(_mm256_loadu_ps(q + i), _mm256_set1_ps(0.5f));
+
+                __m256 g  = tan_ps(_mm256_div_ps(_mm256_mul_ps(_mm256_set1_ps(PI), f), v_rate));
+                __m256 k  = _mm256_div_ps(v_one, qv);
+                __m256 a1 = _mm256_div_ps(v_one, _mm256_add_ps(v_one, _mm256_mul_ps(g, _mm256_add_ps(g, k))));
+                __m256 a2 = _mm256_mul_ps(g, a1);
+                _mm256_storeu_ps(out.k + i, k);
+                _mm256_storeu_ps(out.a1 + i, a1);
+                _mm256_storeu_ps(out.a2 + i, a2);
+                _mm256_storeu_ps(out.a3 + i, _mm256_mul_ps(g, a2));
+            }
+        }
+    #endif
+
+        for (; i < count; i++)
+        {
+            float f  = std::clamp(freq[i], 20.0f, sample_rate * 0.45f);
+            float qs = std::max(q[i], 0.5f);
+
+            float g   = tanf(PI * f / sample_rate);
+            out.k[i]  = 1.0f / qs;
+            out.a1[i] = 1.0f / (1.0f + g * (g + out.k[i]));
+            out.a2[i] = g * out.a1[i];
+            out.a3[i] = g * out.a2[i];
+        }
+    }
+}
@@ -25,6 +25,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <cmath>
 #include <algorithm>
 #include <cstdint>
+#include <atomic>
+#include "CarSynthesisSimd.h"
 //==========================================
 
 // procedural tire squeal synthesizer
@@ -129,6 +131,16 @@ namespace tire_squeal_sound
             return hp;
         }
 
+        // coefficients for sample i of a block computed by synthesis_simd::compute_svf_coefficients()
+        template<int block_size>
+        void set_coefficients(const synthesis_simd::svf_coefficients<block_size>& coefficients, int i)
+        {
+            k  = coefficients.k[i];
+            a1 = coefficients.a1[i];
+            a2 = coefficients.a2[i];
+            a3 = coefficients.a3[i];
+        }
+
         void reset()
         {
             ic1eq = ic2eq = 0.0f;
@@ -249,8 +261,9 @@ namespace tire_squeal_sound
 
         void set_parameters(float intensity, float speed_normalized)
         {
-            m_target_intensity  = std::clamp(intensity, 0.0f, 1.0f);
-            m_target_speed_norm = std::clamp(speed_normalized, 0.0f, 1.0f);
+            // called from the game thread while generate() runs on the audio mixer thread
+            m_target_intensity.store(std::clamp(intensity, 0.0f, 1.0f), std::memory_order_relaxed);
+            m_target_speed_norm.store(std::clamp(speed_normalized, 0.0f, 1.0f), std::memory_order_relaxed);
         }
 
         void generate(float* output_buffer, int num_samples, bool stereo = true)
@@ -263,13 +276,23 @@ namespace tire_squeal_sound
                 return;
             }
 
+            // targets are sampled once per block
+            const float target_intensity  = m_target_intensity.load(std::memory_order_relaxed);
+            const float target_speed_norm = m_target_speed_norm.load(std::memory_order_relaxed);
+
             float screech_sum = 0.0f, sibilance_sum = 0.0f, body_sum = 0.0f;
             float output_sum = 0.0f, peak = 0.0f;
 
             for (int i = 0; i < num_samples; i++)
             {
-                float intensity  = m_intensity_smooth.process(m_target_intensity);
-                float speed_norm = m_speed_smooth.process(m_target_speed_norm);
+                // controls and filter coefficients are computed a block ahead
+                const int j = i % block_size;
+                if (j == 0)
+                {
+                    prepare_block(std::min(block_size, num_samples - i), target_intensity, target_speed_norm);
+                }
+
+                float intensity = m_block.intensity[j];
 
                 if (intensity < 0.005f)
                 {
@@ -292,9 +315,7 @@ namespace tire_squeal_sound
                 // ---- screech layer ----
                 // white noise -> bandpass -> warm multi-stage saturation -> bandpass
                 // warm tanh saturation instead of hard-clipping avoids the dry/papery character
-                float screech_freq = tuning::screech_freq_low +
-                    (tuning::screech_freq_high - tuning::screech_freq_low) * (speed_norm * 0.4f + intensity * 0.6f);
-                m_screech_pre_bp.set_params(screech_freq, 1.8f + intensity * 0.5f, m_sample_rate);
+                m_screech_pre_bp.set_coefficients(m_block.coefficients[slot_screech_pre], j);
                 float screech = m_screech_pre_bp.bandpass(noise_w);
 
                 float drive = tuning::screech_drive_min +
@@ -307,24 +328,20 @@ namespace tire_squeal_sound
                 screech = screech * 1.8f / (1.0f + fabsf(screech) * 0.6f);
 
                 // post-filter keeps the spectral energy focused
-                m_screech_post_bp.set_params(screech_freq * 1.05f, 1.0f, m_sample_rate);
+                m_screech_post_bp.set_coefficients(m_block.coefficients[slot_screech_post], j);
                 screech = m_screech_post_bp.bandpass(screech);
 
                 // ---- sibilance layer ----
-                float sib_freq = tuning::sibilance_freq_low +
-                    (tuning::sibilance_freq_high - tuning::sibilance_freq_low) * intensity;
-                m_sibilance_hp.set_params(sib_freq * 0.8f, 0.8f, m_sample_rate);
+                m_sibilance_hp.set_coefficients(m_block.coefficients[slot_sibilance_hp], j);
                 float sibilance = m_sibilance_hp.highpass(noise_w2);
                 sibilance = tanhf(sibilance * (2.0f + intensity * 2.5f));
 
-                m_sibilance_post_lp.set_params(sib_freq, 0.7f, m_sample_rate);
+                m_sibilance_post_lp.set_coefficients(m_block.coefficients[slot_sibilance_post_lp], j);
                 sibilance = m_sibilance_post_lp.lowpass(sibilance);
 
                 // ---- body layer ----
                 // modest low-mid weight so it doesn't sound thin, but not enough to get windy
-                float body_freq = tuning::body_freq_low +
-                    (tuning::body_freq_high - tuning::body_freq_low) * speed_norm;
-                m_body_bp.set_params(body_freq, 1.0f, m_sample_rate);
+                m_body_bp.set_coefficients(m_block.coefficients[slot_body], j);
                 float body = m_body_bp.bandpass(noise_p);
                 body = tanhf(body * (2.0f + intensity * 2.0f));
 
@@ -399,12 +416,71 @@ namespace tire_squeal_sound
         bool is_initialized() const { return m_initialized; }
         const debug_data& get_debug() const { return m_debug; }
 
+        // the scalar path is kept as the reference the vector kernels are validated against
+        void set_simd(bool enabled) { m_simd = enabled; }
+
     private:
+        static constexpr int block_size = 64;
+
+        // filters whose coefficients follow intensity and speed every sample
+        enum coefficient_slot
+        {
+            slot_screech_pre,
+            slot_screech_post,
+            slot_sibilance_hp,
+            slot_sibilance_post_lp,
+            slot_body,
+            slot_count
+        };
+
+        struct control_block
+        {
+            float intensity[block_size];
+            float freq[slot_count][block_size];
+            float q[slot_count][block_size];
+            synthesis_simd::svf_coefficients<block_size> coefficients[slot_count];
+        };
+
+        void prepare_block(int count, float target_intensity, float target_speed_norm)
+        {
+            for (int j = 0; j < count; j++)
+            {
+                float intensity  = m_intensity_smooth.process(target_intensity);
+                float speed_norm = m_speed_smooth.process(target_speed_norm);
+
+                float screech_freq = tuning::screech_freq_low +
+                    (tuning::screech_freq_high - tuning::screech_freq_low) * (speed_norm * 0.4f + intensity * 0.6f);
+                float sib_freq = tuning::sibilance_freq_low +
+                    (tuning::sibilance_freq_high - tuning::sibilance_freq_low) * intensity;
+                float body_freq = tuning::body_freq_low +
+                    (tuning::body_freq_high - tuning::body_freq_low) * speed_norm;
+
+                m_block.intensity[j]                    = intensity;
+                m_block.freq[slot_screech_pre][j]       = screech_freq;
+                m_block.freq[slot_screech_post][j]      = screech_freq * 1.05f;
+                m_block.freq[slot_sibilance_hp][j]      = sib_freq * 0.8f;
+                m_block.freq[slot_sibilance_post_lp][j] = sib_freq;
+                m_block.freq[slot_body][j]              = body_freq;
+                m_block.q[slot_screech_pre][j]          = 1.8f + intensity * 0.5f;
+                m_block.q[slot_screech_post][j]         = 1.0f;
+                m_block.q[slot_sibilance_hp][j]         = 0.8f;
+                m_block.q[slot_sibilance_post_lp][j]    = 0.7f;
+                m_block.q[slot_body][j]                 = 1.0f;
+            }
+
+            for (int slot = 0; slot < slot_count; slot++)
+            {
+                synthesis_simd::compute_svf_coefficients(m_block.freq[slot], m_block.q[slot], count, m_sample_rate, m_block.coefficients[slot], m_simd);
+            }
+        }
+
         bool  m_initialized = false;
+        bool  m_simd        = true;
         float m_sample_rate = tuning::sample_rate;
+        control_block m_block;
 
-        float m_target_intensity  = 0.0f;
-        float m_target_speed_norm = 0.0f;
+        std::atomic<float> m_target_intensity  = 0.0f;
+        std::atomic<float> m_target_speed_norm = 0.0f;
 
         // screech: noise -> bandpass -> hard clip -> bandpass
         svf_filter m_screech_pre_bp;
@@ -36,6 +36,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Game/Game.h"
 #include "../Memory/Allocator.h"
 #include "../Testing/SmokeTest.h"
+#include "../Testing/Benchmark.h"
+#include "../Audio/AudioMixer.h"
 #include "../RHI/RHI_Device.h"
 #include "../XR/Xr.h"
 #include "../Commands/Console/ConsoleCommands.h"
@@ -74,6 +76,7 @@ namespace spartan
             Timer::Initialize();
             Input::Initialize();
             ThreadPool::Initialize();
+            AudioMixer::Initialize();
             ResourceCache::Initialize();
             Profiler::Initialize();
             PhysicsWorld::Initialize();
@@ -98,6 +101,7 @@ namespace spartan
             Window::PumpEvents();
             ResourceCache::LoadDefaultResources();
             Window::PumpEvents();
+            Benchmark::Initialize();
         }
 
         SP_LOG_INFO("%s has been initialized. Duration %.1f sec", version::c_str(), timer_initialize.GetElapsedTimeSec());
@@ -116,6 +120,7 @@ namespace spartan
 
         PhysicsWorld::Shutdown();
         World::Shutdown();
+        AudioMixer::Shutdown();
         Xr::Shutdown();
         Renderer::Shutdown();
    
@@ -124,6 +129,9 @@ namespace spartan
         ImageImporter::Shutdown();
         FontImporter::Shutdown();
         Settings::Shutdown();
+
+        // last, so everything above can still log
+        Log::Shutdown();
     }
 
     void Engine::Tick()
@@ -145,14 +153,21 @@ namespace spartan
         }
 
         // tick
+        // simulation and recording run in lockstep, only recording and gpu execution overlap (r.frames_in_flight)
+        // simulating frame n + 1 while frame n is recorded is left for a follow-up, it first needs recording to read
+        // only the RenderWorld snapshot (the camera, particles, debug lines, icons and outlines still read live entities)
+        // and entity deletion and mesh and instance buffer replacement deferred until recording is done
         Window::Tick();
         Input::Tick();
+        Event::Dispatch(); // deferred events fired since the last dispatch, before the simulation runs
         PhysicsWorld::Tick();
         World::Tick();
+        Event::Dispatch(); // deferred events fired by the simulation, before the frame is rendered
         Xr::Tick();
         Renderer::Tick();
         Allocator::Tick();
         SmokeTest::Tick();
+        Benchmark::Tick();
 
         // post-tick
         Timer::PostTick();
@@ -184,4 +199,15 @@ namespace spartan
 
         return false;
     }
+
+    string Engine::GetArgumentValue(const string& argument)
+    {
+        for (size_t i = 0; i + 1 < arguments.size(); i++)
+        {
+            if (arguments[i] == argument)
+                return arguments[i + 1];
+        }
+
+        return "";
+    }
 }
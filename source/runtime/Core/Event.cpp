@@ -19,10 +19,11 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =====
+//= INCLUDES =======================
 #include "pch.h"
 #include "Event.h"
-//================
+#include "../Memory/FrameAllocator.h"
+//==================================
 
 //= NAMESPACES =====
 using namespace std;
@@ -32,37 +33,112 @@ namespace spartan
 {
     namespace
     {
-        static array<map<subscription_handle, subscriber>, static_cast<uint32_t>(EventType::Max)> event_subscribers;
+        // handles only grow, so appending keeps each list sorted by handle
+        static array<vector<pair<subscription_handle, subscriber>>, static_cast<uint32_t>(EventType::Max)> event_subscribers;
         static subscription_handle next_subscription_id = 1;
+
+        // deferred events, a lock free stack which producers push to and the main thread takes whole
+        // nodes and payloads live in frame memory, which outlives the next dispatch, so nothing is freed
+        struct queued_event
+        {
+            queued_event* next = nullptr;
+            EventType type     = EventType::Max;
+            sp_variant data    = 0;
+        };
+        atomic<queued_event*> queue_head = nullptr;
+
+        void queue_push(const EventType event_type, const sp_variant& data)
+        {
+            queued_event* node = new (FrameAllocator::Allocate(sizeof(queued_event), alignof(queued_event))) queued_event();
+            node->type         = event_type;
+            node->data         = data;
+            node->next         = queue_head.load(memory_order_relaxed);
+            while (!queue_head.compare_exchange_weak(node->next, node, memory_order_release, memory_order_relaxed))
+            {
+                // node->next was refreshed with the current head, try again
+            }
+        }
+
+        void deliver(const EventType event_type, const sp_variant& data)
+        {
+            // called in place, so a handler can't subscribe to or unsubscribe from the event it's handling
+            for (const auto& [handle, subscriber_func] : event_subscribers[static_cast<uint32_t>(event_type)])
+            {
+                subscriber_func(data);
+            }
+        }
     }
 
     void Event::Shutdown()
     {
-        for (map<subscription_handle, subscriber>& subscribers : event_subscribers)
+        for (vector<pair<subscription_handle, subscriber>>& subscribers : event_subscribers)
         {
             subscribers.clear();
         }
         next_subscription_id = 1;
+
+        // pending events are dropped, their memory belongs to the frame allocator
+        queue_head.store(nullptr, memory_order_relaxed);
     }
 
     subscription_handle Event::Subscribe(const EventType event_type, subscriber&& function)
     {
         subscription_handle handle = next_subscription_id++;
-        event_subscribers[static_cast<uint32_t>(event_type)][handle] = std::forward<subscriber>(function);
+        event_subscribers[static_cast<uint32_t>(event_type)].emplace_back(handle, std::forward<subscriber>(function));
         return handle;
     }
 
     void Event::Unsubscribe(const EventType event_type, subscription_handle handle)
     {
         auto& subscribers = event_subscribers[static_cast<uint32_t>(event_type)];
-        subscribers.erase(handle);
+        auto it = lower_bound(subscribers.begin(), subscribers.end(), handle, [](const pair<subscription_handle, subscriber>& entry, subscription_handle value)
+        {
+            return entry.first < value;
+        });
+
+        if (it != subscribers.end() && it->first == handle)
+        {
+            subscribers.erase(it);
+        }
     }
 
-    void Event::Fire(const EventType event_type, sp_variant data /*= 0*/)
+    void Event::Fire(const EventType event_type, const sp_variant& data /*= 0*/, const EventDelivery delivery /*= EventDelivery::Immediate*/)
     {
-        for (const auto& [handle, subscriber_func] : event_subscribers[static_cast<uint32_t>(event_type)])
+        if (delivery == EventDelivery::Deferred)
+        {
+            queue_push(event_type, data);
+            return;
+        }
+
+        deliver(event_type, data);
+    }
+
+    void Event::Queue(const EventType event_type, const void* payload, size_t size, size_t alignment)
+    {
+        void* copy = FrameAllocator::Allocate(size, alignment);
+        memcpy(copy, payload, size);
+        queue_push(event_type, copy);
+    }
+
+    void Event::Dispatch()
+    {
+        queued_event* node = queue_head.exchange(nullptr, memory_order_acquire);
+        if (!node)
+            return;
+
+        // the stack holds the newest event first, reverse it so events arrive in the order they were fired
+        queued_event* ordered = nullptr;
+        while (node)
+        {
+            queued_event* next = node->next;
+            node->next         = ordered;
+            ordered            = node;
+            node               = next;
+        }
+
+        for (queued_event* event = ordered; event; event = event->next)
         {
-            subscriber_func(data);
+            deliver(event->type, event->data);
         }
     }
 }
@@ -21,12 +21,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ========
+//= INCLUDES ==========
 #include <functional>
 #include <variant>
 #include <cstdint>
-#include <map>
-//===================
+#include <type_traits>
+//=====================
 
 /*
 HOW TO USE
@@ -35,29 +35,37 @@ To subscribe a function to an event -> SP_SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
 To subscribe and store handle       -> auto handle = SP_SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
 To unsubscribe from an event        -> SP_UNSUBSCRIBE_FROM_EVENT(EVENT_ID, handle);
 To fire an event                    -> SP_FIRE_EVENT(EVENT_ID);
-To fire an event with data          -> SP_FIRE_EVENT_DATA(EVENT_ID, Variant);
+To fire an event with data          -> SP_FIRE_EVENT_DATA(EVENT_ID, Payload);
+To fire an event from any thread    -> SP_FIRE_EVENT_DEFERRED(EVENT_ID) or SP_FIRE_EVENT_DATA_DEFERRED(EVENT_ID, Payload);
+To read the payload in a handler    -> spartan::Event::GetPayload<EVENT_ID>(var);
 
-Note: This is a blocking event system
+Note: Immediate events block, their subscribers run inside the fire call. Deferred events are
+queued and their subscribers run on the main thread, when the engine dispatches the queue.
+The payload type of each event is checked at compile time, see EventPayload below.
 ==============================================================================================
 */
 
 //= MACROS ===============================================================================================
-#define SP_EVENT_HANDLER_EXPRESSION(expression)        [this](spartan::sp_variant var)  { expression }
-#define SP_EVENT_HANDLER_EXPRESSION_STATIC(expression) [](spartan::sp_variant var)      { expression }
+#define SP_EVENT_HANDLER_EXPRESSION(expression)        [this](const spartan::sp_variant& var)  { expression }
+#define SP_EVENT_HANDLER_EXPRESSION_STATIC(expression) [](const spartan::sp_variant& var)      { expression }
 
-#define SP_EVENT_HANDLER(function)                     [this](spartan::sp_variant var)  { function(); }
-#define SP_EVENT_HANDLER_STATIC(function)              [](spartan::sp_variant var)      { function(); }
+#define SP_EVENT_HANDLER(function)                     [this](const spartan::sp_variant& var)  { function(); }
+#define SP_EVENT_HANDLER_STATIC(function)              [](const spartan::sp_variant& var)      { function(); }
                                                                                      
-#define SP_EVENT_HANDLER_VARIANT(function)             [this](spartan::sp_variant var)  { function(var); }
-#define SP_EVENT_HANDLER_VARIANT_STATIC(function)      [](spartan::sp_variant var)      { function(var); }
+#define SP_EVENT_HANDLER_VARIANT(function)             [this](const spartan::sp_variant& var)  { function(var); }
+#define SP_EVENT_HANDLER_VARIANT_STATIC(function)      [](const spartan::sp_variant& var)      { function(var); }
                                                        
-#define SP_FIRE_EVENT(event_enum)                      spartan::Event::Fire(event_enum)
-#define SP_FIRE_EVENT_DATA(event_enum, data)           spartan::Event::Fire(event_enum, data)
+#define SP_FIRE_EVENT(event_enum)                       spartan::Event::Fire<event_enum>()
+#define SP_FIRE_EVENT_DATA(event_enum, data)            spartan::Event::Fire<event_enum>(data)
+#define SP_FIRE_EVENT_DEFERRED(event_enum)              spartan::Event::Fire<event_enum>(spartan::EventDelivery::Deferred)
+#define SP_FIRE_EVENT_DATA_DEFERRED(event_enum, data)   spartan::Event::Fire<event_enum>(data, spartan::EventDelivery::Deferred)
                                                        
 #define SP_SUBSCRIBE_TO_EVENT(event_enum, function)    spartan::Event::Subscribe(event_enum, function)
 #define SP_UNSUBSCRIBE_FROM_EVENT(event_enum, handle)  spartan::Event::Unsubscribe(event_enum, handle)
 //========================================================================================================
 
+union SDL_Event;
+
 namespace spartan
 {
     enum class EventType
@@ -71,18 +79,26 @@ namespace spartan
         // Window                      
         WindowResized,                 // The window has been resized
         WindowFullScreenToggled,       // The window has been toggled to full screen
+        // Testing
+        Test,                          // Fired by the smoke tests and the benchmark, nothing in the engine subscribes to it
         // Max
         Max
     };
 
-    class Entity;
+    // the payload each event carries, void for none
+    template<EventType type> struct EventPayload             { using data = void; };
+    template<> struct EventPayload<EventType::Sdl>           { using data = SDL_Event; };
+    template<> struct EventPayload<EventType::Test>          { using data = uint64_t; };
 
-    using sp_variant = std::variant<
-        int,
-        void*,
-        std::vector<std::shared_ptr<Entity>>
-    >;
-    using subscriber = std::function<void(const sp_variant&)>;
+    enum class EventDelivery : uint8_t
+    {
+        Immediate, // subscribers run inside the fire call, on the calling thread
+        Deferred   // thread safe, subscribers run on the main thread when the queue is dispatched
+    };
+
+    // payloads are passed by address, they belong to the caller (immediate) or to frame memory (deferred)
+    using sp_variant          = std::variant<int, void*>;
+    using subscriber          = std::function<void(const sp_variant&)>;
     using subscription_handle = uint64_t;
 
     class Event
@@ -91,6 +107,45 @@ namespace spartan
         static void Shutdown();
         static subscription_handle Subscribe(const EventType event_type, subscriber&& function);
         static void Unsubscribe(const EventType event_type, subscription_handle handle);
-        static void Fire(const EventType event_type, sp_variant data = 0);
+        static void Fire(const EventType event_type, const sp_variant& data = 0, const EventDelivery delivery = EventDelivery::Immediate);
+
+        // runs the subscribers of the deferred events in the order they were fired, main thread only
+        // events that are fired while dispatching are delivered on the next dispatch
+        static void Dispatch();
+
+        // typed, for events without a payload
+        template<EventType type>
+        static void Fire(const EventDelivery delivery = EventDelivery::Immediate)
+        {
+            static_assert(std::is_void_v<typename EventPayload<type>::data>, "this event carries a payload");
+            Fire(type, 0, delivery);
+        }
+
+        // typed, for events with a payload, a deferred payload is copied into frame memory so it outlives the caller
+        template<EventType type>
+        static void Fire(const typename EventPayload<type>::data& payload, const EventDelivery delivery = EventDelivery::Immediate)
+        {
+            using data = typename EventPayload<type>::data;
+
+            if (delivery == EventDelivery::Immediate)
+            {
+                Fire(type, const_cast<void*>(static_cast<const void*>(&payload)), delivery);
+            }
+            else
+            {
+                static_assert(std::is_trivially_copyable_v<data> && std::is_trivially_destructible_v<data>, "deferred payloads are copied and never destroyed");
+                Queue(type, &payload, sizeof(data), alignof(data));
+            }
+        }
+
+        // the payload of a typed event, valid for the duration of the handler
+        template<EventType type>
+        static const typename EventPayload<type>::data& GetPayload(const sp_variant& data)
+        {
+            return *static_cast<const typename EventPayload<type>::data*>(std::get<void*>(data));
+        }
+
+    private:
+        static void Queue(const EventType event_type, const void* payload, size_t size, size_t alignment);
     };
 }
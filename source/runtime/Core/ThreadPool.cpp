@@ -19,10 +19,13 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =========
+//= INCLUDES =========================
 #include "pch.h"
 #include "ThreadPool.h"
-//====================
+#include "../Profiling/Profiler.h"
+#include "../Memory/Allocator.h"
+#include "../Memory/FrameAllocator.h"
+//====================================
 
 //= NAMESPACES =====
 using namespace std;
@@ -48,10 +51,13 @@ namespace spartan
         thread_local bool is_worker_thread = false;
     }
 
-    static void thread_loop()
+    static void thread_loop(const uint32_t index)
     {
         is_worker_thread = true;
 
+        const string thread_name = "worker " + to_string(index);
+        Profiler::SetThreadName(thread_name.c_str());
+
         while (true)
         {
             Task task;
@@ -95,7 +101,7 @@ namespace spartan
         threads.reserve(thread_count);
         for (uint32_t i = 0; i < thread_count; i++)
         {
-            threads.emplace_back(thread_loop);
+            threads.emplace_back(thread_loop, i);
         }
 
         SP_LOG_INFO("%d threads have been created", thread_count);
@@ -138,8 +144,20 @@ namespace spartan
                 return result;
             }
 
+            // when tracing, the job is linked to whatever submitted it
+            const uint32_t job_id = Profiler::TraceJobSubmit();
+
+            // and its allocations are attributed to the submitter's memory tag
+            const MemoryTag memory_tag = Allocator::GetCurrentTag();
+
             pending_count.fetch_add(1, memory_order_relaxed);
-            tasks.emplace_back([packaged]() { (*packaged)(); });
+            tasks.emplace_back([packaged, job_id, memory_tag]()
+            {
+                SP_MEMORY_TAG(memory_tag);
+                Profiler::TraceJobBegin(job_id);
+                (*packaged)();
+                Profiler::TraceJobEnd();
+            });
         }
 
         task_cv.notify_one();
@@ -178,7 +196,8 @@ namespace spartan
         uint32_t base_work = work_total / workers;
         uint32_t remainder = work_total % workers;
 
-        vector<future<void>> futures;
+        // frame scratch, worker threads call this too and each gets its own arena
+        FrameVector<future<void>> futures;
         futures.reserve(workers);
 
         uint32_t work_index = 0;
@@ -112,6 +112,12 @@ namespace spartan
         {
             if (!SDL_WasInit(SDL_INIT_AUDIO))
             {
+                // the dummy driver consumes audio at real-time rate without a device, which keeps headless runs deterministic
+                if (Engine::HasArgument("-audio_dummy") || Engine::HasArgument("-ci_test"))
+                {
+                    SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+                }
+
                 if (!SDL_InitSubSystem(SDL_INIT_AUDIO))
                 {
                     SP_LOG_ERROR("Failed to initialise SDL audio subsystem: %s.", SDL_GetError());
@@ -120,6 +126,12 @@ namespace spartan
 
             if (!SDL_WasInit(SDL_INIT_VIDEO))
             {
+                // the null backend never presents, so the window doesn't need a display server
+                if (RHI_Context::api_type == RHI_Api_Type::Null)
+                {
+                    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+                }
+
                 if (!SDL_InitSubSystem(SDL_INIT_VIDEO))
                 {
                     SP_LOG_ERROR("Failed to initialise SDL video subsystem: %s.", SDL_GetError());
@@ -291,7 +303,7 @@ namespace spartan
                 }
             }
 
-            SP_FIRE_EVENT_DATA(EventType::Sdl, &sdl_event);
+            SP_FIRE_EVENT_DATA(EventType::Sdl, sdl_event);
         }
 
         // handle shortcuts
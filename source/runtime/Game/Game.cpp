@@ -655,14 +655,8 @@ namespace spartan
                         height_map->PrepareForGpu();
                     }
                     terrain->SetHeightMapSeed(height_map.get());
+                    terrain->SetCollision(true); // chunks get physics as they stream in
                     terrain->Generate();
-
-                    // terrain physics
-                    for (Entity* terrain_tile : terrain->GetEntity()->GetChildren())
-                    {
-                        Physics* physics_body = terrain_tile->AddComponent<Physics>();
-                        physics_body->SetBodyType(BodyType::Mesh);
-                    }
                 }
 
                 // water
@@ -801,10 +795,8 @@ namespace spartan
                         material_flower->SetResourceName("flower" + string(EXTENSION_MATERIAL));
                     }
 
-                    // place props on terrain tiles
-                    vector<Entity*> children = terrain->GetEntity()->GetChildren();
-                    auto place_props_on_tiles = [
-                        &children,
+                    // place props on terrain chunks
+                    auto place_props_on_chunks = [
                         &mesh_rock,
                         &mesh_tree,
                         &mesh_grass_blade,
@@ -824,18 +816,18 @@ namespace spartan
                         material_flower
                     ](uint32_t start_index, uint32_t end_index)
                     {
-                        for (uint32_t tile_index = start_index; tile_index < end_index; tile_index++)
+                        for (uint32_t chunk_index = start_index; chunk_index < end_index; chunk_index++)
                         {
-                            Entity* terrain_tile = children[tile_index];
+                            Entity* terrain_chunk = terrain->GetChunkEntity(chunk_index);
 
                             // trees
                             {
                                 Entity* entity = mesh_tree->GetRootEntity()->Clone();
                                 entity->SetObjectName("tree");
-                                entity->SetParent(terrain_tile);
+                                entity->SetParent(terrain_chunk);
 
                                 vector<Matrix> transforms;
-                                terrain->FindTransforms(tile_index, TerrainProp::Tree, entity, per_triangle_density_tree, 0.026f, transforms);
+                                terrain->FindTransforms(chunk_index, TerrainProp::Tree, entity, per_triangle_density_tree, 0.026f, transforms);
 
                                 if (Entity* trunk = entity->GetChildByIndex(0))
                                 {
@@ -863,10 +855,10 @@ namespace spartan
                             {
                                 Entity* entity = mesh_rock->GetRootEntity()->Clone();
                                 entity->SetObjectName("rock");
-                                entity->SetParent(terrain_tile);
+                                entity->SetParent(terrain_chunk);
 
                                 vector<Matrix> transforms;
-                                terrain->FindTransforms(tile_index, TerrainProp::Rock, entity, per_triangle_density_rock, 0.64f, transforms);
+                                terrain->FindTransforms(chunk_index, TerrainProp::Rock, entity, per_triangle_density_rock, 0.64f, transforms);
 
                                 if (Entity* rock_entity = entity->GetDescendantByName("untitled"))
                                 {
@@ -884,7 +876,7 @@ namespace spartan
                             // grass - density layers for lod
                             {
                                 vector<Matrix> all_transforms;
-                                terrain->FindTransforms(tile_index, TerrainProp::Grass, nullptr, per_triangle_density_grass_blade, 0.7f, all_transforms);
+                                terrain->FindTransforms(chunk_index, TerrainProp::Grass, nullptr, per_triangle_density_grass_blade, 0.7f, all_transforms);
 
                                 if (!all_transforms.empty())
                                 {
@@ -896,7 +888,7 @@ namespace spartan
                                     {
                                         Entity* entity = World::CreateEntity();
                                         entity->SetObjectName("grass_layer_density_low");
-                                        entity->SetParent(terrain_tile);
+                                        entity->SetParent(terrain_chunk);
 
                                         vector<Matrix> far_transforms(all_transforms.begin(), all_transforms.begin() + split_1);
 
@@ -912,7 +904,7 @@ namespace spartan
                                     {
                                         Entity* entity = World::CreateEntity();
                                         entity->SetObjectName("grass_layer_density_mid");
-                                        entity->SetParent(terrain_tile);
+                                        entity->SetParent(terrain_chunk);
 
                                         vector<Matrix> mid_transforms(all_transforms.begin() + split_1, all_transforms.begin() + split_2);
 
@@ -928,7 +920,7 @@ namespace spartan
                                     {
                                         Entity* entity = World::CreateEntity();
                                         entity->SetObjectName("grass_layer_density_high");
-                                        entity->SetParent(terrain_tile);
+                                        entity->SetParent(terrain_chunk);
 
                                         vector<Matrix> near_transforms(all_transforms.begin() + split_2, all_transforms.end());
 
@@ -946,10 +938,10 @@ namespace spartan
                             {
                                 Entity* entity = World::CreateEntity();
                                 entity->SetObjectName("flower");
-                                entity->SetParent(terrain_tile);
+                                entity->SetParent(terrain_chunk);
 
                                 vector<Matrix> transforms;
-                                terrain->FindTransforms(tile_index, TerrainProp::Flower, entity, per_triangle_density_flower, 0.64f, transforms);
+                                terrain->FindTransforms(chunk_index, TerrainProp::Flower, entity, per_triangle_density_flower, 0.64f, transforms);
 
                                 Renderable* renderable = entity->AddComponent<Renderable>();
                                 renderable->SetMesh(mesh_flower.get());
@@ -961,7 +953,7 @@ namespace spartan
                         }
                     };
 
-                    ThreadPool::ParallelLoop(place_props_on_tiles, static_cast<uint32_t>(children.size()));
+                    ThreadPool::ParallelLoop(place_props_on_chunks, terrain->GetChunkCount());
                 }
             }
 
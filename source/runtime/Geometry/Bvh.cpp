@@ -0,0 +1,327 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========
+#include "pch.h"
+#include "Bvh.h"
+//====================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan::math;
+//============================
+
+namespace spartan
+{
+    namespace
+    {
+        constexpr uint32_t leaf_size_max = 4;
+        constexpr uint32_t depth_max     = 48;
+        constexpr uint32_t stack_size    = 64;
+
+        bool overlaps(const BoundingBox& a, const BoundingBox& b)
+        {
+            return a.GetMin().x <= b.GetMax().x && a.GetMax().x >= b.GetMin().x &&
+                   a.GetMin().y <= b.GetMax().y && a.GetMax().y >= b.GetMin().y &&
+                   a.GetMin().z <= b.GetMax().z && a.GetMax().z >= b.GetMin().z;
+        }
+
+        // ray in slab form, the reciprocal direction is computed once per query
+        struct ray_slab
+        {
+            __m128 origin;
+            __m128 inv_direction;
+
+            explicit ray_slab(const Ray& ray)
+            {
+                // a huge finite reciprocal instead of infinity keeps 0 * inv from producing nan for axis aligned rays
+                auto reciprocal = [](float d) { return fabsf(d) > 1e-30f ? 1.0f / d : copysignf(1e30f, d); };
+
+                const Vector3& o = ray.GetStart();
+                const Vector3& d = ray.GetDirection();
+                origin           = _mm_setr_ps(o.x, o.y, o.z, 0.0f);
+                inv_direction    = _mm_setr_ps(reciprocal(d.x), reciprocal(d.y), reciprocal(d.z), 1.0f);
+            }
+
+            // distance at which the ray enters the box (0 if it starts inside), infinity on a miss
+            float intersect(const BoundingBox& box, const float max_distance) const
+            {
+                // the w lane spans (-inf, inf) so it never limits the interval
+                const Vector3& min = box.GetMin();
+                const Vector3& max = box.GetMax();
+                __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(min.x, min.y, min.z, -numeric_limits<float>::infinity()), origin), inv_direction);
+                __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(max.x, max.y, max.z, numeric_limits<float>::infinity()), origin), inv_direction);
+
+                __m128 t_near = _mm_min_ps(t0, t1);
+                __m128 t_far  = _mm_max_ps(t0, t1);
+                t_near        = _mm_max_ps(t_near, _mm_shuffle_ps(t_near, t_near, _MM_SHUFFLE(1, 0, 3, 2)));
+                t_near        = _mm_max_ps(t_near, _mm_shuffle_ps(t_near, t_near, _MM_SHUFFLE(2, 3, 0, 1)));
+                t_far         = _mm_min_ps(t_far, _mm_shuffle_ps(t_far, t_far, _MM_SHUFFLE(1, 0, 3, 2)));
+                t_far         = _mm_min_ps(t_far, _mm_shuffle_ps(t_far, t_far, _MM_SHUFFLE(2, 3, 0, 1)));
+
+                float entry = std::max(_mm_cvtss_f32(t_near), 0.0f);
+                float exit  = std::min(_mm_cvtss_f32(t_far), max_distance);
+                return entry <= exit ? entry : numeric_limits<float>::infinity();
+            }
+        };
+    }
+
+    void Bvh::Build(const vector<BoundingBox>& boxes)
+    {
+        Clear();
+        if (boxes.empty())
+            return;
+
+        m_boxes = boxes;
+        m_items.resize(boxes.size());
+        m_centers.resize(boxes.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(boxes.size()); i++)
+        {
+            m_items[i]   = i;
+            m_centers[i] = boxes[i].GetCenter();
+        }
+
+        m_nodes.reserve(boxes.size() * 2);
+        BuildRecursive(0, static_cast<uint32_t>(boxes.size()), 0);
+
+        m_centers.clear();
+        m_centers.shrink_to_fit();
+    }
+
+    void Bvh::Clear()
+    {
+        m_nodes.clear();
+        m_items.clear();
+        m_boxes.clear();
+    }
+
+    void Bvh::Refit(const vector<BoundingBox>& boxes)
+    {
+        if (m_nodes.empty() || boxes.size() != m_boxes.size())
+        {
+            Build(boxes);
+            return;
+        }
+
+        m_boxes = boxes;
+
+        // children always come after their parent, so a reverse sweep sees them first
+        for (uint32_t i = static_cast<uint32_t>(m_nodes.size()); i-- > 0;)
+        {
+            Node& node = m_nodes[i];
+            BoundingBox bounds;
+            if (node.count > 0)
+            {
+                for (uint32_t j = node.first; j < node.first + node.count; j++)
+                {
+                    bounds.Merge(m_boxes[m_items[j]]);
+                }
+            }
+            else
+            {
+                bounds.Merge(m_nodes[i + 1].box);
+                bounds.Merge(m_nodes[node.first].box);
+            }
+            node.box = bounds;
+        }
+    }
+
+    uint32_t Bvh::BuildRecursive(uint32_t first, uint32_t count, uint32_t depth)
+    {
+        uint32_t node_index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+
+        // bounds of the items and of their centers, the split happens on the latter
+        BoundingBox bounds;
+        BoundingBox center_bounds;
+        for (uint32_t i = first; i < first + count; i++)
+        {
+            bounds.Merge(m_boxes[m_items[i]]);
+            center_bounds.Merge(BoundingBox(m_centers[m_items[i]], m_centers[m_items[i]]));
+        }
+        m_nodes[node_index].box = bounds;
+
+        Vector3 extent = center_bounds.GetSize();
+        if (count <= leaf_size_max || depth >= depth_max || (extent.x <= 0.0f && extent.y <= 0.0f && extent.z <= 0.0f))
+        {
+            m_nodes[node_index].first = first;
+            m_nodes[node_index].count = count;
+            return node_index;
+        }
+
+        // median split along the longest axis
+        uint32_t axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        uint32_t half = count / 2;
+        nth_element(m_items.begin() + first, m_items.begin() + first + half, m_items.begin() + first + count, [this, axis](uint32_t a, uint32_t b)
+        {
+            return m_centers[a].Data()[axis] < m_centers[b].Data()[axis];
+        });
+
+        BuildRecursive(first, half, depth + 1);
+        uint32_t right = BuildRecursive(first + half, count - half, depth + 1);
+        m_nodes[node_index].first = right;
+
+        return node_index;
+    }
+
+    void Bvh::QueryPoint(const Vector3& point, vector<uint32_t>& indices) const
+    {
+        QueryBox(BoundingBox(point, point), indices);
+    }
+
+    void Bvh::QueryBox(const BoundingBox& box, vector<uint32_t>& indices) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        uint32_t stack[stack_size];
+        uint32_t stack_count = 0;
+        stack[stack_count++] = 0;
+        while (stack_count > 0)
+        {
+            const Node& node = m_nodes[stack[--stack_count]];
+            if (!overlaps(node.box, box))
+                continue;
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; i++)
+                {
+                    if (overlaps(m_boxes[m_items[i]], box))
+                    {
+                        indices.push_back(m_items[i]);
+                    }
+                }
+            }
+            else
+            {
+                uint32_t left        = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+                stack[stack_count++] = node.first;
+                stack[stack_count++] = left;
+            }
+        }
+    }
+
+    float Bvh::Raycast(const Ray& ray, float max_distance, const function<float(uint32_t)>& hit_item) const
+    {
+        float closest = numeric_limits<float>::infinity();
+        if (m_nodes.empty())
+            return closest;
+
+        const ray_slab slab(ray);
+        float root_distance = slab.intersect(m_nodes[0].box, max_distance);
+        if (root_distance == numeric_limits<float>::infinity())
+            return closest;
+
+        // entry distances ride along on the stack, so nodes that got occluded while waiting are skipped
+        uint32_t stack[stack_size];
+        float stack_distance[stack_size];
+        uint32_t stack_count = 0;
+        stack[stack_count]            = 0;
+        stack_distance[stack_count++] = root_distance;
+        while (stack_count > 0)
+        {
+            stack_count--;
+            if (stack_distance[stack_count] > min(closest, max_distance))
+                continue;
+
+            const Node& node = m_nodes[stack[stack_count]];
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; i++)
+                {
+                    float distance = hit_item(m_items[i]);
+                    if (distance < closest && distance <= max_distance)
+                    {
+                        closest = distance;
+                    }
+                }
+                continue;
+            }
+
+            // push the far child first so the near one is visited first
+            uint32_t left        = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+            uint32_t right       = node.first;
+            float limit          = min(closest, max_distance);
+            float distance_left  = slab.intersect(m_nodes[left].box, limit);
+            float distance_right = slab.intersect(m_nodes[right].box, limit);
+            if (distance_left > distance_right)
+            {
+                swap(left, right);
+                swap(distance_left, distance_right);
+            }
+
+            if (distance_right != numeric_limits<float>::infinity())
+            {
+                stack[stack_count]            = right;
+                stack_distance[stack_count++] = distance_right;
+            }
+
+            if (distance_left != numeric_limits<float>::infinity())
+            {
+                stack[stack_count]            = left;
+                stack_distance[stack_count++] = distance_left;
+            }
+        }
+
+        return closest;
+    }
+
+    void Bvh::QueryRay(const Ray& ray, float max_distance, vector<uint32_t>& indices) const
+    {
+        if (m_nodes.empty())
+            return;
+
+        const ray_slab slab(ray);
+        uint32_t stack[stack_size];
+        uint32_t stack_count = 0;
+        stack[stack_count++] = 0;
+        while (stack_count > 0)
+        {
+            const Node& node = m_nodes[stack[--stack_count]];
+            if (slab.intersect(node.box, max_distance) == numeric_limits<float>::infinity())
+                continue;
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; i++)
+                {
+                    if (slab.intersect(m_boxes[m_items[i]], max_distance) != numeric_limits<float>::infinity())
+                    {
+                        indices.push_back(m_items[i]);
+                    }
+                }
+            }
+            else
+            {
+                uint32_t left        = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+                stack[stack_count++] = node.first;
+                stack[stack_count++] = left;
+            }
+        }
+    }
+
+    const BoundingBox& Bvh::GetBoundingBox() const
+    {
+        static const BoundingBox empty;
+        return m_nodes.empty() ? empty : m_nodes[0].box;
+    }
+}
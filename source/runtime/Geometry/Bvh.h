@@ -0,0 +1,75 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "../Math/BoundingBox.h"
+#include "../Math/Ray.h"
+//================================
+
+namespace spartan
+{
+    // a bounding volume hierarchy over a set of boxes, item indices match the order of the boxes passed to Build()
+    class Bvh
+    {
+    public:
+        void Build(const std::vector<math::BoundingBox>& boxes);
+        void Clear();
+
+        // updates the bounds for moved boxes while keeping the tree, the box count must match the last Build()
+        void Refit(const std::vector<math::BoundingBox>& boxes);
+
+        // appends the indices of all boxes that contain the point or overlap the box
+        void QueryPoint(const math::Vector3& point, std::vector<uint32_t>& indices) const;
+        void QueryBox(const math::BoundingBox& box, std::vector<uint32_t>& indices) const;
+
+        // ray distances are in units of the ray direction, which doesn't need to be normalized
+        // closest hit: hit_item returns the distance to an item or infinity, items are visited front to back
+        // and subtrees beyond the closest hit so far are skipped, returns infinity if nothing was hit
+        float Raycast(const math::Ray& ray, float max_distance, const std::function<float(uint32_t)>& hit_item) const;
+
+        // appends the indices of all boxes the ray enters within max_distance
+        void QueryRay(const math::Ray& ray, float max_distance, std::vector<uint32_t>& indices) const;
+
+        bool IsEmpty() const             { return m_nodes.empty(); }
+        uint32_t GetNodeCount() const    { return static_cast<uint32_t>(m_nodes.size()); }
+        const math::BoundingBox& GetBoundingBox() const;
+
+    private:
+        struct Node
+        {
+            math::BoundingBox box;
+            uint32_t first = 0; // first item for leaves, right child for internal nodes (the left child is always next)
+            uint32_t count = 0; // 0 for internal nodes
+        };
+
+        uint32_t BuildRecursive(uint32_t first, uint32_t count, uint32_t depth);
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_items;
+        std::vector<math::BoundingBox> m_boxes;
+        std::vector<math::Vector3> m_centers; // only alive during Build()
+    };
+}
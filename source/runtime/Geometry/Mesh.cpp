@@ -29,6 +29,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Resource/Import/ModelImporter.h"
 #include "../Rendering/GeometryBuffer.h"
 #include "GeometryProcessing.h"
+#include "Bvh.h"
 //===========================================
 
 //= NAMESPACES ================
@@ -45,7 +46,9 @@ namespace spartan
 
     Mesh::~Mesh()
     {
-
+        // give the geometry buffer ranges back so streamed meshes can reuse them
+        GeometryBuffer::ReleaseVertices(m_global_vertex_offset, m_global_vertex_count);
+        GeometryBuffer::ReleaseIndices(m_global_index_offset, m_global_index_count);
     }
 
     void Mesh::RegisterForScripting(sol::state_view State)
@@ -61,6 +64,8 @@ namespace spartan
 
     void Mesh::Clear()
     {
+        m_bvh.clear();
+
         m_indices.clear();
         m_indices.shrink_to_fit();
 
@@ -294,6 +299,12 @@ namespace spartan
 
             // add lod to the specified sub-mesh
             m_sub_meshes[sub_mesh_index].lods.push_back(lod);
+
+            // the triangle bvh only covers lod 0, which may have just been added
+            if (sub_mesh_index < m_bvh.size())
+            {
+                m_bvh[sub_mesh_index].reset();
+            }
         }
     }
 
@@ -407,9 +418,15 @@ namespace spartan
 
     void Mesh::CreateGpuBuffers()
     {
+        // release the ranges of a previous upload
+        GeometryBuffer::ReleaseVertices(m_global_vertex_offset, m_global_vertex_count);
+        GeometryBuffer::ReleaseIndices(m_global_index_offset, m_global_index_count);
+
         // append this mesh's geometry into the global vertex/index buffers
-        m_global_vertex_offset = GeometryBuffer::AppendVertices(m_vertices.data(), static_cast<uint32_t>(m_vertices.size()));
-        m_global_index_offset  = GeometryBuffer::AppendIndices(m_indices.data(), static_cast<uint32_t>(m_indices.size()));
+        m_global_vertex_count  = static_cast<uint32_t>(m_vertices.size());
+        m_global_index_count   = static_cast<uint32_t>(m_indices.size());
+        m_global_vertex_offset = GeometryBuffer::AppendVertices(m_vertices.data(), m_global_vertex_count);
+        m_global_index_offset  = GeometryBuffer::AppendIndices(m_indices.data(), m_global_index_count);
 
         // normalize scale
         if (m_flags & static_cast<uint32_t>(MeshFlags::PostProcessNormalizeScale))
@@ -502,4 +519,68 @@ namespace spartan
 
         return m_blas[sub_mesh_index] != nullptr;
     }
+
+    float Mesh::Raycast(uint32_t sub_mesh_index, const Ray& ray, float max_distance, Vector3* out_normal)
+    {
+        lock_guard lock(m_mutex);
+
+        if (sub_mesh_index >= m_sub_meshes.size() || m_sub_meshes[sub_mesh_index].lods.empty())
+            return numeric_limits<float>::infinity();
+
+        const MeshLod& lod = m_sub_meshes[sub_mesh_index].lods[0];
+        const RHI_Vertex_PosTexNorTan* vertices = m_vertices.data() + lod.vertex_offset;
+        const uint32_t* indices                 = m_indices.data() + lod.index_offset;
+        auto vertex                             = [vertices, indices](uint32_t index)
+        {
+            const float* pos = vertices[indices[index]].pos;
+            return Vector3(pos[0], pos[1], pos[2]);
+        };
+
+        // build the triangle bvh on first use
+        if (m_bvh.size() < m_sub_meshes.size())
+        {
+            m_bvh.resize(m_sub_meshes.size());
+        }
+        if (!m_bvh[sub_mesh_index])
+        {
+            const Stopwatch timer;
+
+            vector<BoundingBox> boxes(lod.index_count / 3);
+            for (uint32_t i = 0; i < static_cast<uint32_t>(boxes.size()); i++)
+            {
+                Vector3 p0 = vertex(i * 3);
+                Vector3 p1 = vertex(i * 3 + 1);
+                Vector3 p2 = vertex(i * 3 + 2);
+                boxes[i] = BoundingBox(Vector3::Min(Vector3::Min(p0, p1), p2), Vector3::Max(Vector3::Max(p0, p1), p2));
+            }
+
+            m_bvh[sub_mesh_index] = make_unique<Bvh>();
+            m_bvh[sub_mesh_index]->Build(boxes);
+            SP_LOG_INFO("Built triangle bvh for \"%s\" sub-mesh %u (%u triangles) in %.1f ms", m_object_name.c_str(), sub_mesh_index, static_cast<uint32_t>(boxes.size()), timer.GetElapsedTimeMs());
+        }
+
+        uint32_t hit_triangle = numeric_limits<uint32_t>::max();
+        float hit_distance    = numeric_limits<float>::infinity();
+        float distance        = m_bvh[sub_mesh_index]->Raycast(ray, max_distance, [&](uint32_t triangle)
+        {
+            float triangle_distance = ray.HitDistance(vertex(triangle * 3), vertex(triangle * 3 + 1), vertex(triangle * 3 + 2));
+            if (triangle_distance < hit_distance && triangle_distance <= max_distance)
+            {
+                hit_distance = triangle_distance;
+                hit_triangle = triangle;
+            }
+
+            return triangle_distance;
+        });
+
+        if (out_normal && hit_triangle != numeric_limits<uint32_t>::max())
+        {
+            Vector3 p0 = vertex(hit_triangle * 3);
+            Vector3 p1 = vertex(hit_triangle * 3 + 1);
+            Vector3 p2 = vertex(hit_triangle * 3 + 2);
+            *out_normal = (p1 - p0).Cross(p2 - p0).Normalized();
+        }
+
+        return distance;
+    }
 }
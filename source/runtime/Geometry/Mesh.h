@@ -39,6 +39,12 @@ namespace spartan
     class RHI_Buffer;
     class RHI_AccelerationStructure;
     class RHI_CommandList;
+    class Bvh;
+
+    namespace math
+    {
+        class Ray;
+    }
 
     enum class MeshFlags : uint32_t
     {
@@ -128,6 +134,10 @@ namespace spartan
         RHI_AccelerationStructure* GetBlas(uint32_t sub_mesh_index) const;
         bool HasBlas(uint32_t sub_mesh_index) const;
 
+        // cpu raycast against lod 0 of a sub-mesh in mesh space, returns the distance in units of the ray direction or infinity
+        // a triangle bvh is built on first use and cached until the geometry changes
+        float Raycast(uint32_t sub_mesh_index, const math::Ray& ray, float max_distance, math::Vector3* out_normal = nullptr);
+
     private:
         // geometry
         std::vector<RHI_Vertex_PosTexNorTan> m_vertices; // all vertices of a model file
@@ -137,9 +147,12 @@ namespace spartan
         // global geometry buffer offsets (base offsets into the shared vertex/index buffers)
         uint32_t m_global_vertex_offset = 0;
         uint32_t m_global_index_offset  = 0;
+        uint32_t m_global_vertex_count  = 0; // what was appended, released when the mesh goes away
+        uint32_t m_global_index_count   = 0;
 
         // acceleration structures
         std::vector<std::unique_ptr<RHI_AccelerationStructure>> m_blas; // one blas per sub-mesh
+        std::vector<std::unique_ptr<Bvh>> m_bvh;                       // one cpu triangle bvh per sub-mesh, built lazily
 
         // misc
         std::mutex m_mutex;
@@ -59,7 +59,7 @@ namespace spartan
         PollSteeringWheel();
     }
 
-    void Input::OnEvent(sp_variant data)
+    void Input::OnEvent(const sp_variant& data)
     {
         SDL_Event* event_sdl = static_cast<SDL_Event*>(get<void*>(data));
 
@@ -113,7 +113,7 @@ namespace spartan
         static void PollSteeringWheel();
 
         // event driven input
-        static void OnEvent(sp_variant data);
+        static void OnEvent(const sp_variant& data);
         static void OnEventMouse(void* event);
         static void OnEventGamepad(void* event);
         static void OnEventSteeringWheel(void* event);
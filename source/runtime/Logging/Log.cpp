@@ -19,10 +19,11 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =================
+//= INCLUDES ===============================
 #include "pch.h"
 #include "../Core/Debugging.h"
-//============================
+#include "../Commands/Console/ConsoleCommands.h"
+//==========================================
 
 //= NAMESPACES =====
 using namespace std;
@@ -32,56 +33,229 @@ namespace spartan
 {
     namespace
     {
-        vector<LogCmd> logs;
-        string log_file_name = "log.txt";
-        ILogger* logger      = nullptr;
-        bool log_to_file     = true;
-        mutex log_output_mutex;
+        // queued message, producers link it in without locking
+        struct log_entry
+        {
+            atomic<log_entry*> next = nullptr;
+            LogType type            = LogType::Info;
+            time_t time             = 0;
+            string text;
+        };
+
+        // intrusive multi-producer single-consumer queue, producers swap themselves in at the back and the
+        // consumer walks from the front, a stub entry keeps the queue non-empty so neither side needs a lock
+        log_entry queue_stub;
+        atomic<log_entry*> queue_back = &queue_stub;
+        log_entry* queue_front        = &queue_stub;
+
+        void queue_push(log_entry* entry)
+        {
+            entry->next.store(nullptr, memory_order_relaxed);
+            log_entry* previous = queue_back.exchange(entry, memory_order_acq_rel);
+            previous->next.store(entry, memory_order_release);
+        }
 
-        void write_to_file(string text, const LogType type)
+        // consumer only, returns null when empty or when a producer is halfway through a push
+        log_entry* queue_pop()
         {
-            const string prefix = (type == LogType::Info) ? "Info:" : (type == LogType::Warning) ? "Warning:" : "Error:";
-            text = prefix + " " + text;
+            log_entry* front = queue_front;
+            log_entry* next  = front->next.load(memory_order_acquire);
 
-            // delete the previous log file (if it exists)
-            static bool is_first_log = true;
-            if (is_first_log)
+            if (front == &queue_stub)
             {
-                FileSystem::Delete(log_file_name);
-                is_first_log = false;
+                if (!next)
+                    return nullptr;
+
+                queue_front = next;
+                front       = next;
+                next        = next->next.load(memory_order_acquire);
             }
 
-            // open/create a log file to write the log into
-            ofstream fout;
-            fout.open(log_file_name, ofstream::out | ofstream::app);
+            if (next)
+            {
+                queue_front = next;
+                return front;
+            }
+
+            if (front != queue_back.load(memory_order_acquire))
+                return nullptr;
 
-            if (fout.is_open())
+            // front is the last entry, put the stub behind it so it can be detached
+            queue_push(&queue_stub);
+            next = front->next.load(memory_order_acquire);
+            if (next)
             {
-                fout << text << endl;
-                fout.close();
+                queue_front = next;
+                return front;
             }
+
+            return nullptr;
         }
-    }
 
-    std::array<char[SP_LOG_BUFFER_SIZE], SP_LOG_BUFFER_COUNT> Log::m_buffers;
-    std::array<std::mutex, SP_LOG_BUFFER_COUNT> Log::m_buffer_mutexes;
-    size_t Log::m_current_buffer = 0;
+        // consumer state, owned by whoever holds consumer_mutex (the log thread, or a thread flushing)
+        mutex consumer_mutex;
+        vector<LogCmd> logs; // kept until a logger is set
+        string log_file_name      = "log.txt";
+        ofstream log_file;
+        bool log_file_truncated   = false;
+        ILogger* logger           = nullptr;
+        string batch;
+
+        // set while this thread holds consumer_mutex and delivers messages, a logger that logs from inside Log()
+        // must not flush synchronously (it would lock consumer_mutex again), the drain it is in picks its message up
+        thread_local bool tl_draining = false;
+        struct draining_scope
+        {
+            draining_scope()  { tl_draining = true; }
+            ~draining_scope() { tl_draining = false; }
+        };
+
+        atomic<bool> log_to_file      = true;
+        atomic<uint32_t> level        = static_cast<uint32_t>(LogType::Info);
+        atomic<uint32_t> wake_signal  = 0;
+        atomic<bool> running          = false;
+        constexpr size_t logs_max     = 10000; // messages kept for a logger that isn't set yet
+
+        void on_log_level_change(const CVarVariant& value)
+        {
+            int v = clamp(static_cast<int>(get<float>(value)), 0, 2);
+            *ConsoleRegistry::Get().Find("log.level")->m_value_ptr = static_cast<float>(v);
+            level.store(static_cast<uint32_t>(v), memory_order_relaxed);
+        }
+        TConsoleVar<float> cvar_log_level("log.level", 0.0f, "minimum level to log, 0: info, 1: warning, 2: error", on_log_level_change);
+
+        // writes out everything that is queued, callers hold consumer_mutex
+        void drain()
+        {
+            draining_scope scope;
+            const bool to_file = log_to_file.load(memory_order_relaxed) || !logger || Debugging::IsLoggingToFileEnabled();
+
+            // timestamps only change once per second, so format them once per second
+            time_t time_formatted = -1;
+            char timestamp[16]   = {};
+
+            batch.clear();
+            while (log_entry* entry = queue_pop())
+            {
+                if (entry->time != time_formatted)
+                {
+                    tm tm_struct{};
+                    localtime_s(&tm_struct, &entry->time);
+                    strftime(timestamp, sizeof(timestamp), "[%H:%M:%S]: ", &tm_struct);
+                    time_formatted = entry->time;
+                }
+
+                string text = timestamp + entry->text;
+
+                if (to_file)
+                {
+                    batch += entry->type == LogType::Info ? "Info: " : entry->type == LogType::Warning ? "Warning: " : "Error: ";
+                    batch += text;
+                    batch += '\n';
+                }
+
+                if (logger)
+                {
+                    logger->Log(text, static_cast<uint32_t>(entry->type));
+                }
+                else if (logs.size() < logs_max)
+                {
+                    logs.emplace_back(text, entry->type);
+                }
+
+                delete entry;
+            }
+
+            if (batch.empty())
+                return;
+
+            // one handle for the whole session, the previous session's log is replaced on first use
+            if (!log_file.is_open())
+            {
+                log_file.open(log_file_name, ios::out | (log_file_truncated ? ios::app : ios::trunc));
+                log_file_truncated = true;
+            }
+
+            if (log_file.is_open())
+            {
+                log_file.write(batch.data(), static_cast<streamsize>(batch.size()));
+                log_file.flush();
+            }
+        }
+
+        struct log_thread
+        {
+            thread handle;
+
+            void start()
+            {
+                running.store(true, memory_order_release);
+                handle = thread([]()
+                {
+                    while (running.load(memory_order_acquire))
+                    {
+                        const uint32_t signal = wake_signal.load(memory_order_acquire);
+                        {
+                            lock_guard<mutex> lock(consumer_mutex);
+                            drain();
+                        }
+                        wake_signal.wait(signal, memory_order_acquire);
+                    }
+                });
+            }
+
+            void stop()
+            {
+                if (!handle.joinable())
+                    return;
+
+                running.store(false, memory_order_release);
+                wake_signal.fetch_add(1, memory_order_release);
+                wake_signal.notify_one();
+                handle.join();
+
+                lock_guard<mutex> lock(consumer_mutex);
+                drain();
+                log_file.close();
+            }
+
+            // declared last in this file, so it stops before the state above is destroyed
+            ~log_thread() { stop(); }
+        };
+        log_thread worker;
+    }
 
     void Log::Initialize()
     {
         SP_SUBSCRIBE_TO_EVENT(EventType::RendererOnFirstFrameCompleted, SP_EVENT_HANDLER_EXPRESSION_STATIC( SetLogToFile(false); ));
         SP_SUBSCRIBE_TO_EVENT(EventType::RendererOnShutdown,            SP_EVENT_HANDLER_EXPRESSION_STATIC( SetLogToFile(true);  ));
+
+        // messages logged before this point were written synchronously
+        if (!running.load(memory_order_acquire))
+        {
+            worker.start();
+        }
+    }
+
+    void Log::Shutdown()
+    {
+        // later messages are written synchronously
+        worker.stop();
     }
 
     void Log::SetLogger(ILogger* logger_in)
     {
-        lock_guard<mutex> guard(log_output_mutex);
+        lock_guard<mutex> guard(consumer_mutex);
+
+        // deliver what is queued to the current logger before switching
+        drain();
 
         logger = logger_in;
 
         // flush the log buffer, if needed
         if (logger && !logs.empty())
         {
+            draining_scope scope;
             for (const LogCmd& log : logs)
             {
                 logger->Log(log.text, static_cast<uint32_t>(log.type));
@@ -90,69 +264,94 @@ namespace spartan
         }
     }
 
+    ILogger* Log::GetLogger()
+    {
+        lock_guard<mutex> guard(consumer_mutex);
+        return logger;
+    }
+
     void Log::SetLogToFile(const bool log)
     {
-        log_to_file = log;
+        log_to_file.store(log, memory_order_relaxed);
     }
 
     void Log::Clear()
     {
-        lock_guard<mutex> guard(log_output_mutex);
+        lock_guard<mutex> guard(consumer_mutex);
 
+        drain();
         logs.clear();
 
-        if (log_to_file || Debugging::IsLoggingToFileEnabled())
+        if (log_to_file.load(memory_order_relaxed) || Debugging::IsLoggingToFileEnabled())
+        {
+            log_file.close();
+            log_file.open(log_file_name, ios::out | ios::trunc);
+            log_file_truncated = true;
+        }
+    }
+
+    void Log::SetLevel(const LogType level_in)
+    {
+        ConsoleRegistry::Get().SetValueFromString("log.level", to_string(static_cast<uint32_t>(level_in)));
+    }
+
+    LogType Log::GetLevel()
+    {
+        return static_cast<LogType>(level.load(memory_order_relaxed));
+    }
+
+    bool Log::ShouldLog(LogSite& site, const LogType type, const char* function)
+    {
+        if (static_cast<uint32_t>(type) < level.load(memory_order_relaxed))
+            return false;
+
+        // the first message of a new second resets the budget and reports what was dropped in the previous ones
+        const uint32_t second = static_cast<uint32_t>(chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now().time_since_epoch()).count());
+        uint32_t site_second  = site.second.load(memory_order_relaxed);
+        if (site_second != second && site.second.compare_exchange_strong(site_second, second, memory_order_relaxed))
         {
-            ofstream file("log.txt", ios::out | ios::trunc);
-            if (file.is_open())
+            site.count.store(0, memory_order_relaxed);
+            if (uint32_t suppressed = site.suppressed.exchange(0, memory_order_relaxed); suppressed > 0)
             {
-                file.close();
+                char buffer[SP_LOG_BUFFER_SIZE];
+                snprintf(buffer, sizeof(buffer), "%s: %u similar messages were suppressed", function, suppressed);
+                WriteBuffer(buffer, type);
             }
         }
+
+        if (site.count.fetch_add(1, memory_order_relaxed) < rate_limit_per_second)
+            return true;
+
+        site.suppressed.fetch_add(1, memory_order_relaxed);
+        return false;
     }
 
     void Log::WriteBuffer(const char* text, const LogType type)
     {
         SP_ASSERT_MSG(text != nullptr, "Text is null");
-    
-        // get a buffer
-        size_t buffer_index;
+
+        log_entry* entry = new log_entry();
+        entry->type      = type;
+        entry->time      = time(nullptr);
+        entry->text      = text;
+        queue_push(entry);
+
+        // errors tend to precede an assert or a crash, so they are written out before returning
+        // unless this thread is already draining, in which case the drain in progress writes it out
+        if ((type == LogType::Error || !running.load(memory_order_acquire)) && !tl_draining)
         {
-            static std::mutex buffer_select_mutex;
-            std::lock_guard<std::mutex> guard(buffer_select_mutex);
-            buffer_index = m_current_buffer;
-            m_current_buffer = (m_current_buffer + 1) % SP_LOG_BUFFER_COUNT;
+            Flush();
+            return;
         }
-    
-        // lock the selected buffer
-        std::lock_guard<std::mutex> guard(m_buffer_mutexes[buffer_index]);
-        char* buffer = m_buffers[buffer_index];
-    
-        // add timestamp directly to buffer
-        auto t = time(nullptr);
-        tm tm_struct{};
-        localtime_s(&tm_struct, &t);
-        size_t timestamp_len = strftime(buffer, SP_LOG_BUFFER_SIZE, "[%H:%M:%S]: ", &tm_struct);
-        size_t available_len = SP_LOG_BUFFER_SIZE - timestamp_len - 1; // -1 for null terminator
-    
-        // append text to buffer after timestamp
-        strncpy_s(buffer + timestamp_len, available_len + 1, text, _TRUNCATE);
-    
-        // serialize access to the shared log vector, file, and logger
-        {
-            lock_guard<mutex> output_guard(log_output_mutex);
 
-            if (log_to_file || !logger || Debugging::IsLoggingToFileEnabled())
-            {
-                logs.emplace_back(buffer, type);
-                write_to_file(buffer, type);
-            }
+        wake_signal.fetch_add(1, memory_order_release);
+        wake_signal.notify_one();
+    }
 
-            if (logger)
-            {
-                logger->Log(buffer, static_cast<uint32_t>(type));
-            }
-        }
+    void Log::Flush()
+    {
+        lock_guard<mutex> lock(consumer_mutex);
+        drain();
     }
 
     void Log::FormatBuffer(char* buffer, const char* function, const char* text, ...)
@@ -24,17 +24,40 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =======
 #include <string>
 #include <memory>
+#include <atomic>
 #include "ILogger.h"
 //==================
 
 namespace spartan
 {
     // macros for easy logging across the engine
+    // each call site is rate limited and checked against the runtime level before anything is formatted,
+    // define SP_LOG_LEVEL_MIN as 1 (warnings and errors) or 2 (errors only) to compile lower levels out
     #define SP_LOG_BUFFER_SIZE 2048
-    #define SP_LOG_BUFFER_COUNT 16
-    #define SP_LOG_INFO(text, ...)    { char buffer[SP_LOG_BUFFER_SIZE]; spartan::Log::FormatBuffer(buffer, __FUNCTION__, text, ##__VA_ARGS__); spartan::Log::WriteBuffer(buffer, spartan::LogType::Info); }
-    #define SP_LOG_WARNING(text, ...) { char buffer[SP_LOG_BUFFER_SIZE]; spartan::Log::FormatBuffer(buffer, __FUNCTION__, text, ##__VA_ARGS__); spartan::Log::WriteBuffer(buffer, spartan::LogType::Warning); }
-    #define SP_LOG_ERROR(text, ...)   { char buffer[SP_LOG_BUFFER_SIZE]; spartan::Log::FormatBuffer(buffer, __FUNCTION__, text, ##__VA_ARGS__); spartan::Log::WriteBuffer(buffer, spartan::LogType::Error); }
+    #ifndef SP_LOG_LEVEL_MIN
+        #define SP_LOG_LEVEL_MIN 0
+    #endif
+    #define SP_LOG(type, text, ...)                                                                      \
+    {                                                                                                    \
+        static spartan::LogSite log_site;                                                                \
+        if (spartan::Log::ShouldLog(log_site, type, __FUNCTION__))                                       \
+        {                                                                                                \
+            char buffer[SP_LOG_BUFFER_SIZE];                                                             \
+            spartan::Log::FormatBuffer(buffer, __FUNCTION__, text, ##__VA_ARGS__);                       \
+            spartan::Log::WriteBuffer(buffer, type);                                                     \
+        }                                                                                                \
+    }
+    #if SP_LOG_LEVEL_MIN <= 0
+        #define SP_LOG_INFO(text, ...) SP_LOG(spartan::LogType::Info, text, ##__VA_ARGS__)
+    #else
+        #define SP_LOG_INFO(text, ...) {}
+    #endif
+    #if SP_LOG_LEVEL_MIN <= 1
+        #define SP_LOG_WARNING(text, ...) SP_LOG(spartan::LogType::Warning, text, ##__VA_ARGS__)
+    #else
+        #define SP_LOG_WARNING(text, ...) {}
+    #endif
+    #define SP_LOG_ERROR(text, ...) SP_LOG(spartan::LogType::Error, text, ##__VA_ARGS__)
 
     // Forward declarations
     class Entity;
@@ -66,6 +89,14 @@ namespace spartan
         LogType type;
     };
 
+    // per call site state for rate limiting, lives in a static inside the logging macros
+    struct LogSite
+    {
+        std::atomic<uint32_t> second     = 0;
+        std::atomic<uint32_t> count      = 0;
+        std::atomic<uint32_t> suppressed = 0;
+    };
+
     class Log
     {
         friend class ILogger;
@@ -74,17 +105,25 @@ namespace spartan
 
         // misc
         static void Initialize();
+        static void Shutdown();
         static void SetLogger(ILogger* logger);
+        static ILogger* GetLogger();
         static void SetLogToFile(const bool log_to_file);
         static void Clear();
 
-        // buffer-based logging
+        // messages below this level are dropped before formatting
+        static void SetLevel(const LogType level);
+        static LogType GetLevel();
+
+        // level and rate limit check, a call site may log this many messages per second
+        static constexpr uint32_t rate_limit_per_second = 100;
+        static bool ShouldLog(LogSite& site, const LogType type, const char* function);
+
+        // buffer-based logging, messages are queued and written by a background thread, errors are written before returning
         static void WriteBuffer(const char* text, LogType type);
         static void FormatBuffer(char* buffer, const char* function, const char* text, ...);
 
-    private:
-        static std::array<char[SP_LOG_BUFFER_SIZE], SP_LOG_BUFFER_COUNT> m_buffers;
-        static std::array<std::mutex, SP_LOG_BUFFER_COUNT> m_buffer_mutexes;
-        static size_t m_current_buffer;
+        // blocks until every queued message has reached the file and the logger
+        static void Flush();
     };
 }
@@ -45,6 +45,7 @@ namespace spartan
 
             Entity* m_entity;
             Vector3 m_position;
+            Vector3 m_normal = Vector3::Zero;
             float m_distance;
             bool m_inside;
         };
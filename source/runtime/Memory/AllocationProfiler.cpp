@@ -0,0 +1,310 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==================
+#include "pch.h"
+#include "AllocationProfiler.h"
+#include "FrameAllocator.h"
+#if defined(_WIN32)
+#include <Windows.h>
+#include <DbgHelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#elif defined(__linux__)
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#endif
+//=============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace spartan
+{
+    namespace
+    {
+        constexpr uint32_t stack_depth_max   = 24;
+        constexpr uint32_t stack_frames_skip = 3; // RecordAllocation(), Allocator::Allocate() and operator new
+
+        struct stack_trace
+        {
+            array<void*, stack_depth_max> frames = {};
+            uint32_t depth                       = 0;
+        };
+
+        struct live_sample
+        {
+            uint64_t  stack_id;
+            uint64_t  weight;
+            MemoryTag tag;
+        };
+
+        mutex samples_mutex;
+        unordered_map<void*, live_sample> samples;
+        unordered_map<uint64_t, stack_trace> stacks;
+
+        uint32_t capture_stack(void** frames)
+        {
+        #if defined(_WIN32)
+            return CaptureStackBackTrace(stack_frames_skip, stack_depth_max, frames, nullptr);
+        #elif defined(__linux__)
+            void* buffer[stack_depth_max + stack_frames_skip];
+            int captured = backtrace(buffer, static_cast<int>(stack_depth_max + stack_frames_skip));
+            uint32_t depth = captured > static_cast<int>(stack_frames_skip) ? static_cast<uint32_t>(captured) - stack_frames_skip : 0;
+            memcpy(frames, buffer + stack_frames_skip, depth * sizeof(void*));
+            return depth;
+        #else
+            return 0;
+        #endif
+        }
+
+        uint64_t hash_stack(void* const* frames, uint32_t depth)
+        {
+            // fnv-1a
+            uint64_t hash = 14695981039346656037ull;
+            for (uint32_t i = 0; i < depth; i++)
+            {
+                hash ^= reinterpret_cast<uintptr_t>(frames[i]);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        string symbolize(void* address)
+        {
+            char text[512];
+            snprintf(text, sizeof(text), "%p", address);
+
+        #if defined(_WIN32)
+            // dbghelp is single threaded
+            static mutex dbghelp_mutex;
+            lock_guard<mutex> lock(dbghelp_mutex);
+
+            HANDLE process = GetCurrentProcess();
+            static bool initialized = false;
+            if (!initialized)
+            {
+                SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+                SymInitialize(process, nullptr, TRUE);
+                initialized = true;
+            }
+
+            alignas(SYMBOL_INFO) char buffer[sizeof(SYMBOL_INFO) + 256] = {};
+            SYMBOL_INFO* symbol  = reinterpret_cast<SYMBOL_INFO*>(buffer);
+            symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+            symbol->MaxNameLen   = 255;
+            DWORD64 displacement = 0;
+            if (SymFromAddr(process, reinterpret_cast<DWORD64>(address), &displacement, symbol))
+            {
+                IMAGEHLP_LINE64 line   = {};
+                line.SizeOfStruct      = sizeof(IMAGEHLP_LINE64);
+                DWORD line_displacement = 0;
+                if (SymGetLineFromAddr64(process, reinterpret_cast<DWORD64>(address), &line_displacement, &line))
+                {
+                    snprintf(text, sizeof(text), "%s (%s:%lu)", symbol->Name, line.FileName, line.LineNumber);
+                }
+                else
+                {
+                    snprintf(text, sizeof(text), "%s", symbol->Name);
+                }
+            }
+        #elif defined(__linux__)
+            // without -rdynamic only exported symbols resolve, the module offset still works with addr2line
+            Dl_info info = {};
+            if (dladdr(address, &info))
+            {
+                if (info.dli_sname)
+                {
+                    int status      = 0;
+                    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                    snprintf(text, sizeof(text), "%s", status == 0 && demangled ? demangled : info.dli_sname);
+                    free(demangled);
+                }
+                else if (info.dli_fname)
+                {
+                    snprintf(text, sizeof(text), "%s+0x%zx", info.dli_fname, static_cast<size_t>(static_cast<char*>(address) - static_cast<char*>(info.dli_fbase)));
+                }
+            }
+        #endif
+
+            return text;
+        }
+    }
+
+    void AllocationProfiler::RecordAllocation(void* ptr, size_t size, size_t weight, MemoryTag tag)
+    {
+        // walking the stack is the expensive part, do it before taking the lock
+        stack_trace stack;
+        stack.depth             = capture_stack(stack.frames.data());
+        const uint64_t stack_id = hash_stack(stack.frames.data(), stack.depth);
+
+        lock_guard<mutex> lock(samples_mutex);
+        stacks.try_emplace(stack_id, stack);
+        samples[ptr] = { stack_id, static_cast<uint64_t>(max(size, weight)), tag };
+    }
+
+    void AllocationProfiler::RecordFree(void* ptr)
+    {
+        lock_guard<mutex> lock(samples_mutex);
+        samples.erase(ptr);
+    }
+
+    HeapSnapshot AllocationProfiler::TakeSnapshot()
+    {
+        HeapSnapshot snapshot;
+        snapshot.frame = FrameAllocator::GetFrame();
+
+        // sites are keyed by stack and tag, the same stack can run under different tags
+        unordered_map<uint64_t, AllocationSite> sites;
+        {
+            lock_guard<mutex> lock(samples_mutex);
+            sites.reserve(stacks.size());
+            for (const auto& [ptr, sample] : samples)
+            {
+                const uint64_t key   = sample.stack_id ^ (static_cast<uint64_t>(sample.tag) << 56);
+                AllocationSite& site = sites[key];
+                site.stack_id        = sample.stack_id;
+                site.tag             = sample.tag;
+                site.bytes          += static_cast<int64_t>(sample.weight);
+                site.samples++;
+            }
+        }
+
+        snapshot.sites.reserve(sites.size());
+        for (const auto& [key, site] : sites)
+        {
+            snapshot.bytes += site.bytes;
+            snapshot.sites.push_back(site);
+        }
+
+        sort(snapshot.sites.begin(), snapshot.sites.end(), [](const AllocationSite& a, const AllocationSite& b)
+        {
+            return a.bytes > b.bytes;
+        });
+
+        return snapshot;
+    }
+
+    HeapSnapshot AllocationProfiler::Diff(const HeapSnapshot& before, const HeapSnapshot& after)
+    {
+        HeapSnapshot diff;
+        diff.frame = after.frame;
+        diff.bytes = after.bytes - before.bytes;
+
+        unordered_map<uint64_t, AllocationSite> sites;
+        for (const AllocationSite& site : after.sites)
+        {
+            sites[site.stack_id ^ (static_cast<uint64_t>(site.tag) << 56)] = site;
+        }
+
+        for (const AllocationSite& site : before.sites)
+        {
+            AllocationSite& entry = sites[site.stack_id ^ (static_cast<uint64_t>(site.tag) << 56)];
+            entry.stack_id        = site.stack_id;
+            entry.tag             = site.tag;
+            entry.bytes          -= site.bytes;
+            entry.samples        -= site.samples;
+        }
+
+        for (const auto& [key, site] : sites)
+        {
+            if (site.bytes != 0 || site.samples != 0)
+            {
+                diff.sites.push_back(site);
+            }
+        }
+
+        sort(diff.sites.begin(), diff.sites.end(), [](const AllocationSite& a, const AllocationSite& b)
+        {
+            return llabs(a.bytes) > llabs(b.bytes);
+        });
+
+        return diff;
+    }
+
+    vector<string> AllocationProfiler::GetStack(uint64_t stack_id)
+    {
+        stack_trace stack;
+        {
+            lock_guard<mutex> lock(samples_mutex);
+            auto it = stacks.find(stack_id);
+            if (it == stacks.end())
+                return {};
+
+            stack = it->second;
+        }
+
+        vector<string> frames;
+        frames.reserve(stack.depth);
+        for (uint32_t i = 0; i < stack.depth; i++)
+        {
+            frames.push_back(symbolize(stack.frames[i]));
+        }
+
+        return frames;
+    }
+
+    bool AllocationProfiler::Export(const HeapSnapshot& snapshot, const string& file_path)
+    {
+        ofstream file(file_path, ios::out | ios::trunc);
+        if (!file.is_open())
+        {
+            SP_LOG_ERROR("Failed to open \"%s\" for writing", file_path.c_str());
+            return false;
+        }
+
+        const double mb = 1024.0 * 1024.0;
+        char line[256];
+        snprintf(line, sizeof(line), "frame %llu, %.2f MB across %zu call sites, sampling every %zu bytes\n\n",
+            static_cast<unsigned long long>(snapshot.frame), snapshot.bytes / mb, snapshot.sites.size(), Allocator::GetSamplingInterval());
+        file << line;
+
+        for (const AllocationSite& site : snapshot.sites)
+        {
+            snprintf(line, sizeof(line), "%+10.3f MB %+8lld samples  %s\n", site.bytes / mb, static_cast<long long>(site.samples), Allocator::GetTagName(site.tag));
+            file << line;
+
+            for (const string& frame : GetStack(site.stack_id))
+            {
+                file << "        " << frame << "\n";
+            }
+            file << "\n";
+        }
+
+        SP_LOG_INFO("Exported %zu allocation sites to \"%s\"", snapshot.sites.size(), file_path.c_str());
+        return true;
+    }
+
+    uint32_t AllocationProfiler::GetLiveSampleCount()
+    {
+        lock_guard<mutex> lock(samples_mutex);
+        return static_cast<uint32_t>(samples.size());
+    }
+
+    void AllocationProfiler::Clear()
+    {
+        // allocations that are still live keep their header flag, freeing them later is a no-op lookup
+        lock_guard<mutex> lock(samples_mutex);
+        samples.clear();
+        stacks.clear();
+    }
+}
@@ -0,0 +1,73 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ========
+#include <vector>
+#include <string>
+#include "Allocator.h"
+//===================
+
+namespace spartan
+{
+    // live bytes attributed to one call stack and tag, estimated from samples
+    struct AllocationSite
+    {
+        uint64_t  stack_id = 0;
+        MemoryTag tag      = MemoryTag::Untagged;
+        int64_t   bytes    = 0; // every sample stands for at least the sampling interval
+        int64_t   samples  = 0;
+    };
+
+    // negative bytes and samples only appear in diffs
+    struct HeapSnapshot
+    {
+        uint64_t frame = 0;
+        int64_t bytes  = 0;
+        std::vector<AllocationSite> sites; // largest first
+    };
+
+    // keeps the allocations the allocator samples (see Allocator::SetSamplingInterval) together with
+    // the call stack that made them, until they are freed, which is enough to find what grows or churns
+    class AllocationProfiler
+    {
+    public:
+        // called by the allocator
+        static void RecordAllocation(void* ptr, std::size_t size, std::size_t weight, MemoryTag tag);
+        static void RecordFree(void* ptr);
+
+        // live sampled allocations grouped by call stack and tag
+        static HeapSnapshot TakeSnapshot();
+
+        // what changed between two snapshots, sorted by magnitude
+        static HeapSnapshot Diff(const HeapSnapshot& before, const HeapSnapshot& after);
+
+        // symbolized frames of a stack, innermost first
+        static std::vector<std::string> GetStack(uint64_t stack_id);
+
+        // writes a snapshot or a diff, with symbolized stacks, to a text file
+        static bool Export(const HeapSnapshot& snapshot, const std::string& file_path);
+
+        static uint32_t GetLiveSampleCount();
+        static void Clear();
+    };
+}
@@ -23,6 +23,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ====================
 #include "pch.h"
 #include "Allocator.h"
+#include "FrameAllocator.h"
+#include "AllocationProfiler.h"
 #include <cstring>
 #if defined(_WIN32)
 #include <Windows.h>
@@ -30,6 +32,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma comment(lib, "psapi.lib")
 #elif defined(__linux__)
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
 #endif
 //===============================
@@ -50,19 +53,65 @@ namespace spartan
         constexpr unsigned char poison_allocated = 0xCD; // freshly allocated memory
         constexpr unsigned char poison_freed     = 0xDD; // freed memory
 
-        // thread-local cache settings
-        constexpr size_t cache_max_size       = 256;  // max allocation size to cache
-        constexpr size_t cache_max_entries    = 32;   // max entries per size class
-        constexpr size_t cache_size_classes   = 8;    // number of size classes: 32, 64, 96, 128, 160, 192, 224, 256
-        constexpr size_t cache_size_granularity = 32; // size class granularity
+        // slab settings, small untagged allocations are carved out of size-class pages and carry no header
+        constexpr size_t   slab_page_size        = 64 * 1024;                     // pages are aligned to their size, so a block finds its page by masking
+        constexpr size_t   slab_page_header_size = 128;                           // blocks start after the page header
+        constexpr size_t   slab_region_size      = 16ull * 1024 * 1024 * 1024;    // address space reserved up front, backed as pages are touched
+        constexpr size_t   slab_page_count       = slab_region_size / slab_page_size;
+        constexpr size_t   slab_max_size         = 1024;                          // larger allocations take the header path
+        constexpr size_t   slab_max_alignment    = 64;                            // larger alignments take the header path
+        constexpr size_t   slab_granularity      = 16;
+        constexpr size_t   slab_pool_retain      = 64;                            // empty pages kept committed, the rest are returned to the os
+        constexpr uint32_t slab_page_magic       = 0x51AB0064;
+        constexpr uint32_t slab_class_sizes[]    = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024 };
+        constexpr size_t   slab_class_count      = sizeof(slab_class_sizes) / sizeof(slab_class_sizes[0]);
+        constexpr size_t   tag_count             = static_cast<size_t>(MemoryTag::Count);
+        constexpr size_t   slab_bin_count        = slab_class_count * tag_count; // pages are segregated by tag, so blocks know their tag without a header
+
+        // size (in granularity steps) to the smallest class that fits it
+        constexpr array<uint8_t, slab_max_size / slab_granularity + 1> slab_class_lookup = []()
+        {
+            array<uint8_t, slab_max_size / slab_granularity + 1> lookup = {};
+            uint8_t size_class = 0;
+            for (size_t i = 0; i < lookup.size(); i++)
+            {
+                while (slab_class_sizes[size_class] < i * slab_granularity)
+                {
+                    size_class++;
+                }
+                lookup[i] = size_class;
+            }
+            return lookup;
+        }();
+
+        // statistics are accumulated per thread and published in batches
+        constexpr uint32_t stats_flush_interval = 64;
+
+        // nesting depth of scoped tags per thread
+        constexpr uint32_t tag_stack_depth = 16;
+
+        // header flags
+        constexpr uint8_t allocation_flag_sampled = 1 << 0; // known to the allocation profiler
 
         // global counters
         atomic<size_t> bytes_allocated      = 0;
         atomic<size_t> bytes_allocated_peak = 0;
         atomic<size_t> allocation_count     = 0;
 
+        // heap allocations made during the current and the previous frame
+        atomic<uint32_t> allocations_frame      = 0;
+        atomic<uint32_t> allocations_last_frame = 0;
+
         // per-tag counters
-        atomic<size_t> bytes_by_tag[static_cast<size_t>(MemoryTag::Count)] = {};
+        atomic<size_t>   bytes_by_tag[tag_count]                  = {};
+        atomic<uint32_t> allocations_frame_by_tag[tag_count]      = {};
+        atomic<uint32_t> allocations_last_frame_by_tag[tag_count] = {};
+
+        // every this many allocated bytes an allocation is handed to the allocation profiler, 0 disables sampling
+        atomic<size_t> sampling_interval = 0;
+
+        // when off, every allocation takes the header path, blocks already in slabs are still freed to them
+        atomic<bool> slabs_enabled = true;
 
         // header stores allocation metadata
         struct allocation_header
@@ -71,89 +120,519 @@ namespace spartan
             uint32_t  offset; // bytes from raw allocation to user pointer (32-bit is enough)
             size_t    size;   // requested size
             MemoryTag tag;    // memory tag for tracking
-            uint8_t   padding[7]; // pad to maintain alignment
+            uint8_t   flags;
+            uint8_t   padding[6]; // pad to maintain alignment
         };
 
-        // thread-local cache entry
-        struct cache_entry
+        struct slab_block
         {
-            void*  ptr;
-            size_t size;
+            slab_block* next;
         };
 
-        // thread-local free list for small allocations
-        struct thread_cache
+        struct thread_heap;
+
+        // lives at the start of every slab page, all fields but the atomics belong to the owning thread
+        struct slab_page
         {
-            cache_entry entries[cache_size_classes][cache_max_entries];
-            size_t      count[cache_size_classes] = {};
+            uint32_t    magic      = slab_page_magic;
+            uint32_t    size_class = 0;
+            uint32_t    bin        = 0;
+            uint32_t    block_size = 0;
+            uint32_t    capacity   = 0;
+            uint32_t    used       = 0;       // blocks handed out and not yet returned to the owner
+            uint32_t    bump       = 0;       // blocks from here on were never handed out
+            MemoryTag   tag        = MemoryTag::Untagged;
+            bool        full       = false;   // parked in the heap's full list
+            slab_block* free_list  = nullptr;
+            slab_page*  next       = nullptr;
+            slab_page*  prev       = nullptr;
+            atomic<thread_heap*> owner = nullptr; // null while abandoned or pooled
+
+            // blocks freed by other threads, the owner collects them when its own list runs dry
+            alignas(64) atomic<slab_block*> remote_free = nullptr;
         };
+        static_assert(sizeof(slab_page) <= slab_page_header_size, "slab page header doesn't fit");
 
-        thread_local thread_cache tl_cache = {};
+        // per-thread pages, the head of each available list is the page allocations come from
+        struct thread_heap
+        {
+            slab_page* available[slab_bin_count];
+            slab_page* full[slab_bin_count];
+        };
+
+        struct thread_stats
+        {
+            int64_t  bytes;
+            int64_t  count;
+            uint32_t allocations;
+            uint32_t operations;
+            int64_t  bytes_by_tag[tag_count];
+            uint32_t allocations_by_tag[tag_count];
+        };
 
-        // get size class index (0-7 for sizes 1-256)
-        size_t get_size_class(size_t size)
+        enum class thread_state : uint8_t
         {
-            if (size == 0)
-                return 0;
-            return min((size - 1) / cache_size_granularity, cache_size_classes - 1);
+            unattached,
+            attached,
+            detached // the thread is exiting, allocations skip the slabs and statistics are published immediately
+        };
+
+        // hands the heap back when the thread exits
+        struct thread_exit_guard
+        {
+            ~thread_exit_guard();
+            bool armed = false;
+        };
+
+        thread_local thread_heap       tl_heap       = {};
+        thread_local thread_stats      tl_stats      = {};
+        thread_local thread_state      tl_state      = thread_state::unattached;
+        thread_local thread_exit_guard tl_exit_guard;
+        thread_local MemoryTag         tl_tags[tag_stack_depth] = {};
+        thread_local uint32_t          tl_tag_depth             = 0;
+        thread_local int64_t           tl_sample_countdown      = 0;
+        thread_local bool              tl_sampling              = false; // set while the profiler records, its own allocations aren't sampled
+
+        // shared slab state, pages are recycled through the pool and exited threads leave theirs in the abandoned lists
+        atomic<uint8_t*> slab_base = nullptr;
+        atomic<size_t>   slab_pages_reserved = 0;
+        once_flag        slab_once;
+        mutex            slab_mutex;
+        uint32_t         slab_pool[slab_page_count];
+        size_t           slab_pool_count = 0;
+        slab_page*       slab_abandoned[slab_bin_count] = {};
+
+        // atomically update peak if current value is higher
+        void update_peak(size_t current)
+        {
+            size_t peak = bytes_allocated_peak.load(memory_order_relaxed);
+            while (current > peak && !bytes_allocated_peak.compare_exchange_weak(peak, current, memory_order_relaxed, memory_order_relaxed))
+            {
+                // peak is updated by compare_exchange_weak on failure
+            }
         }
 
-        // get actual size for a size class
-        size_t get_size_for_class(size_t size_class)
+        // round up to next multiple of alignment
+        size_t align_up(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        void stats_flush()
+        {
+            thread_stats& stats = tl_stats;
+            if (stats.operations == 0)
+                return;
+
+            // negative deltas wrap around, which unsigned addition undoes, the total can briefly dip below zero
+            // when a thread publishes frees of memory another thread allocated but hasn't published yet
+            const int64_t current = static_cast<int64_t>(bytes_allocated.fetch_add(static_cast<size_t>(stats.bytes), memory_order_relaxed)) + stats.bytes;
+            if (stats.bytes > 0 && current > 0)
+            {
+                update_peak(static_cast<size_t>(current));
+            }
+            allocation_count.fetch_add(static_cast<size_t>(stats.count), memory_order_relaxed);
+            allocations_frame.fetch_add(stats.allocations, memory_order_relaxed);
+            for (size_t i = 0; i < tag_count; i++)
+            {
+                if (stats.bytes_by_tag[i] != 0)
+                {
+                    bytes_by_tag[i].fetch_add(static_cast<size_t>(stats.bytes_by_tag[i]), memory_order_relaxed);
+                }
+
+                if (stats.allocations_by_tag[i] != 0)
+                {
+                    allocations_frame_by_tag[i].fetch_add(stats.allocations_by_tag[i], memory_order_relaxed);
+                }
+            }
+
+            stats = {};
+        }
+
+        bool thread_attach()
+        {
+            if (tl_state == thread_state::attached)
+                return true;
+
+            if (tl_state == thread_state::detached)
+                return false;
+
+            // first allocation of the process reserves the slab region
+            call_once(slab_once, []()
+            {
+                uint8_t* base = nullptr;
+            #if defined(_WIN32)
+                // reservations have 64kb granularity, so pages come out aligned
+                base = static_cast<uint8_t*>(VirtualAlloc(nullptr, slab_region_size, MEM_RESERVE, PAGE_NOACCESS));
+            #elif defined(__linux__)
+                void* memory = mmap(nullptr, slab_region_size + slab_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+                if (memory != MAP_FAILED)
+                {
+                    base = reinterpret_cast<uint8_t*>(align_up(reinterpret_cast<uintptr_t>(memory), slab_page_size));
+                }
+            #endif
+                slab_base.store(base, memory_order_release);
+            });
+
+            tl_exit_guard.armed = true;
+            tl_state            = thread_state::attached;
+            return true;
+        }
+
+        void stats_record(int64_t bytes, int64_t count, MemoryTag tag)
         {
-            return (size_class + 1) * cache_size_granularity;
+            thread_stats& stats = tl_stats;
+            const size_t index  = static_cast<size_t>(tag);
+            stats.bytes                     += bytes;
+            stats.count                     += count;
+            stats.allocations               += count > 0 ? 1 : 0;
+            stats.bytes_by_tag[index]       += bytes;
+            stats.allocations_by_tag[index] += count > 0 ? 1 : 0;
+
+            if (++stats.operations >= stats_flush_interval || !thread_attach())
+            {
+                stats_flush();
+            }
         }
 
-        // try to get from thread-local cache
-        void* cache_try_get(size_t size)
+        bool slab_contains(const void* ptr)
         {
-            if (size > cache_max_size)
+            uint8_t* base = slab_base.load(memory_order_relaxed);
+            return base && static_cast<size_t>(static_cast<const uint8_t*>(ptr) - base) < slab_region_size;
+        }
+
+        slab_page* slab_page_from_block(const void* ptr)
+        {
+            return reinterpret_cast<slab_page*>(reinterpret_cast<uintptr_t>(ptr) & ~(slab_page_size - 1));
+        }
+
+        void slab_list_push(slab_page*& head, slab_page* page)
+        {
+            page->prev = nullptr;
+            page->next = head;
+            if (head)
+            {
+                head->prev = page;
+            }
+            head = page;
+        }
+
+        void slab_list_remove(slab_page*& head, slab_page* page)
+        {
+            if (page->prev)
+            {
+                page->prev->next = page->next;
+            }
+            else
+            {
+                head = page->next;
+            }
+
+            if (page->next)
+            {
+                page->next->prev = page->prev;
+            }
+
+            page->next = nullptr;
+            page->prev = nullptr;
+        }
+
+        slab_page* slab_page_acquire(uint32_t bin)
+        {
+            uint8_t* base   = slab_base.load(memory_order_acquire);
+            uint8_t* memory = nullptr;
+            {
+                lock_guard<mutex> lock(slab_mutex);
+                if (slab_pool_count > 0)
+                {
+                    memory = base + static_cast<size_t>(slab_pool[--slab_pool_count]) * slab_page_size;
+                }
+            }
+
+            if (!memory)
+            {
+                size_t index = slab_pages_reserved.fetch_add(1, memory_order_relaxed);
+                if (index >= slab_page_count)
+                    return nullptr; // region exhausted, callers fall back to the header path
+
+                memory = base + index * slab_page_size;
+            }
+
+        #if defined(_WIN32)
+            if (!VirtualAlloc(memory, slab_page_size, MEM_COMMIT, PAGE_READWRITE))
+            {
+                lock_guard<mutex> lock(slab_mutex);
+                slab_pool[slab_pool_count++] = static_cast<uint32_t>((memory - base) / slab_page_size);
                 return nullptr;
+            }
+        #endif
+
+            slab_page* page  = new (memory) slab_page();
+            page->size_class = bin % slab_class_count;
+            page->bin        = bin;
+            page->tag        = static_cast<MemoryTag>(bin / slab_class_count);
+            page->block_size = slab_class_sizes[page->size_class];
+            page->capacity   = static_cast<uint32_t>((slab_page_size - slab_page_header_size) / page->block_size);
+            return page;
+        }
+
+        void slab_page_release(slab_page* page)
+        {
+            uint8_t* base = slab_base.load(memory_order_acquire);
+            page->magic   = 0;
 
-            size_t size_class = get_size_class(size);
-            if (tl_cache.count[size_class] > 0)
+            lock_guard<mutex> lock(slab_mutex);
+            if (slab_pool_count >= slab_pool_retain)
             {
-                tl_cache.count[size_class]--;
-                return tl_cache.entries[size_class][tl_cache.count[size_class]].ptr;
+            #if defined(_WIN32)
+                VirtualFree(page, slab_page_size, MEM_DECOMMIT);
+            #elif defined(__linux__)
+                madvise(page, slab_page_size, MADV_DONTNEED);
+            #endif
             }
-            return nullptr;
+            slab_pool[slab_pool_count++] = static_cast<uint32_t>((reinterpret_cast<uint8_t*>(page) - base) / slab_page_size);
         }
 
-        // try to put into thread-local cache, returns true if cached
-        bool cache_try_put(void* ptr, size_t size)
+        // move blocks other threads freed onto the local list
+        bool slab_collect_remote(slab_page* page)
         {
-            if (size > cache_max_size)
+            slab_block* blocks = page->remote_free.exchange(nullptr, memory_order_acquire);
+            if (!blocks)
                 return false;
 
-            size_t size_class = get_size_class(size);
-            if (tl_cache.count[size_class] < cache_max_entries)
+            uint32_t count  = 1;
+            slab_block* tail = blocks;
+            while (tail->next)
             {
-                tl_cache.entries[size_class][tl_cache.count[size_class]].ptr  = ptr;
-                tl_cache.entries[size_class][tl_cache.count[size_class]].size = size;
-                tl_cache.count[size_class]++;
-                return true;
+                tail = tail->next;
+                count++;
             }
-            return false;
+
+            tail->next       = page->free_list;
+            page->free_list  = blocks;
+            page->used      -= count;
+            return true;
         }
 
-        // atomically update peak if current value is higher
-        void update_peak(size_t current)
+        void* slab_page_pop(slab_page* page)
         {
-            size_t peak = bytes_allocated_peak.load(memory_order_relaxed);
-            while (current > peak && !bytes_allocated_peak.compare_exchange_weak(peak, current, memory_order_relaxed, memory_order_relaxed))
+            if (slab_block* block = page->free_list)
             {
-                // peak is updated by compare_exchange_weak on failure
+                page->free_list = block->next;
+                page->used++;
+                return block;
+            }
+
+            if (page->bump < page->capacity)
+            {
+                void* block = reinterpret_cast<uint8_t*>(page) + slab_page_header_size + static_cast<size_t>(page->bump) * page->block_size;
+                page->bump++;
+                page->used++;
+                return block;
             }
+
+            return nullptr;
         }
 
-        // round up to next multiple of alignment
-        size_t align_up(size_t value, size_t alignment)
+        void* slab_allocate_slow(thread_heap& heap, uint32_t bin)
         {
-            return (value + alignment - 1) & ~(alignment - 1);
+            // drain the available pages, parking the ones that are out of blocks
+            while (slab_page* page = heap.available[bin])
+            {
+                if (void* block = slab_page_pop(page))
+                    return block;
+
+                if (slab_collect_remote(page))
+                    return slab_page_pop(page);
+
+                slab_list_remove(heap.available[bin], page);
+                slab_list_push(heap.full[bin], page);
+                page->full = true;
+            }
+
+            // full pages that other threads have since freed into
+            for (slab_page* page = heap.full[bin]; page;)
+            {
+                slab_page* next = page->next;
+                if (page->remote_free.load(memory_order_relaxed) && slab_collect_remote(page))
+                {
+                    slab_list_remove(heap.full[bin], page);
+                    slab_list_push(heap.available[bin], page);
+                    page->full = false;
+                }
+                page = next;
+            }
+
+            if (heap.available[bin])
+                return slab_page_pop(heap.available[bin]);
+
+            // pages left behind by threads that exited
+            while (true)
+            {
+                slab_page* page = nullptr;
+                {
+                    lock_guard<mutex> lock(slab_mutex);
+                    page = slab_abandoned[bin];
+                    if (page)
+                    {
+                        slab_abandoned[bin] = page->next;
+                    }
+                }
+
+                if (!page)
+                    break;
+
+                page->next = nullptr;
+                page->prev = nullptr;
+                page->owner.store(&heap, memory_order_relaxed);
+                slab_collect_remote(page);
+                if (void* block = slab_page_pop(page))
+                {
+                    slab_list_push(heap.available[bin], page);
+                    page->full = false;
+                    return block;
+                }
+
+                slab_list_push(heap.full[bin], page);
+                page->full = true;
+            }
+
+            // a fresh page
+            slab_page* page = slab_page_acquire(bin);
+            if (!page)
+                return nullptr;
+
+            page->owner.store(&heap, memory_order_relaxed);
+            slab_list_push(heap.available[bin], page);
+            return slab_page_pop(page);
+        }
+
+        void* slab_allocate(size_t size, size_t alignment, MemoryTag tag, uint32_t& out_size)
+        {
+            if (!thread_attach() || !slab_base.load(memory_order_relaxed))
+                return nullptr;
+
+            // every class is a multiple of the granularity, aligned requests move up to a class that is a multiple of the alignment
+            uint32_t size_class = slab_class_lookup[(size + slab_granularity - 1) / slab_granularity];
+            while (slab_class_sizes[size_class] % alignment != 0)
+            {
+                size_class++;
+            }
+            out_size = slab_class_sizes[size_class];
+
+            const uint32_t bin = static_cast<uint32_t>(static_cast<size_t>(tag) * slab_class_count + size_class);
+            thread_heap& heap  = tl_heap;
+            if (slab_page* page = heap.available[bin])
+            {
+                if (void* block = slab_page_pop(page))
+                    return block;
+            }
+
+            return slab_allocate_slow(heap, bin);
+        }
+
+        void slab_free(void* ptr)
+        {
+            slab_page* page = slab_page_from_block(ptr);
+            if (page->magic != slab_page_magic || (static_cast<uint8_t*>(ptr) - reinterpret_cast<uint8_t*>(page)) < static_cast<ptrdiff_t>(slab_page_header_size))
+            {
+                SP_LOG_ERROR("Memory corruption detected at address %p", ptr);
+                SP_ASSERT(false && "memory corruption detected");
+                return;
+            }
+
+        #if defined(_DEBUG) || defined(DEBUG)
+            // a block that is still fully poisoned was most likely freed already
+            const uint8_t* bytes = static_cast<const uint8_t*>(ptr);
+            size_t poisoned      = sizeof(slab_block);
+            while (poisoned < page->block_size && bytes[poisoned] == poison_freed)
+            {
+                poisoned++;
+            }
+            if (poisoned == page->block_size)
+            {
+                SP_LOG_ERROR("Double-free detected at address %p", ptr);
+                SP_ASSERT(false && "double-free detected");
+                return;
+            }
+
+            // poison freed memory in debug builds to catch use-after-free
+            memset(ptr, poison_freed, page->block_size);
+        #endif
+
+            stats_record(-static_cast<int64_t>(page->block_size), -1, page->tag);
+
+            slab_block* block = static_cast<slab_block*>(ptr);
+            thread_heap& heap = tl_heap;
+            if (page->owner.load(memory_order_relaxed) != &heap)
+            {
+                // another thread owns the page, hand the block back to it
+                slab_block* head = page->remote_free.load(memory_order_relaxed);
+                do
+                {
+                    block->next = head;
+                } while (!page->remote_free.compare_exchange_weak(head, block, memory_order_release, memory_order_relaxed));
+                return;
+            }
+
+            block->next     = page->free_list;
+            page->free_list = block;
+            page->used--;
+
+            const uint32_t bin = page->bin;
+            if (page->full)
+            {
+                slab_list_remove(heap.full[bin], page);
+                slab_list_push(heap.available[bin], page);
+                page->full = false;
+            }
+            else if (page->used == 0 && page != heap.available[bin])
+            {
+                // keep the current page around, return idle ones
+                slab_list_remove(heap.available[bin], page);
+                page->owner.store(nullptr, memory_order_relaxed);
+                slab_page_release(page);
+            }
+        }
+
+        thread_exit_guard::~thread_exit_guard()
+        {
+            tl_state = thread_state::detached;
+
+            // release empty pages and leave the rest to whichever thread needs a page of that class next
+            thread_heap& heap = tl_heap;
+            for (uint32_t bin = 0; bin < slab_bin_count; bin++)
+            {
+                for (slab_page** list : { &heap.available[bin], &heap.full[bin] })
+                {
+                    slab_page* page = *list;
+                    while (page)
+                    {
+                        slab_page* next = page->next;
+                        page->owner.store(nullptr, memory_order_relaxed);
+                        slab_collect_remote(page);
+                        if (page->used == 0)
+                        {
+                            slab_page_release(page);
+                        }
+                        else
+                        {
+                            lock_guard<mutex> lock(slab_mutex);
+                            page->prev                 = nullptr;
+                            page->next                 = slab_abandoned[bin];
+                            slab_abandoned[bin] = page;
+                        }
+                        page = next;
+                    }
+                    *list = nullptr;
+                }
+            }
+
+            stats_flush();
         }
 
-        // perform the actual allocation (bypassing cache)
-        void* allocate_internal(size_t size, size_t alignment, MemoryTag tag)
+        // large, over-aligned and sampled allocations carry a header in front of the user pointer
+        void* allocate_internal(size_t size, size_t alignment, MemoryTag tag, uint8_t flags = 0)
         {
             // ensure minimum alignment for our header
             alignment = max(alignment, alignof(allocation_header));
@@ -183,22 +662,18 @@ namespace spartan
             header->offset = static_cast<uint32_t>(user_addr - raw_addr);
             header->size   = size;
             header->tag    = tag;
+            header->flags  = flags;
 
 #if defined(_DEBUG) || defined(DEBUG)
             // poison allocated memory in debug builds to catch uninitialized reads
             memset(user_ptr, poison_allocated, size);
 #endif
 
-            // update counters
-            size_t current = bytes_allocated.fetch_add(size, memory_order_relaxed) + size;
-            update_peak(current);
-            allocation_count.fetch_add(1, memory_order_relaxed);
-            bytes_by_tag[static_cast<size_t>(tag)].fetch_add(size, memory_order_relaxed);
+            stats_record(static_cast<int64_t>(size), 1, tag);
 
             return user_ptr;
         }
 
-        // perform the actual free (bypassing cache)
         void free_internal(void* ptr)
         {
             const size_t header_size = sizeof(allocation_header);
@@ -226,6 +701,13 @@ namespace spartan
             uint32_t  offset = header->offset;
             MemoryTag tag    = header->tag;
 
+            if (header->flags & allocation_flag_sampled)
+            {
+                tl_sampling = true;
+                AllocationProfiler::RecordFree(ptr);
+                tl_sampling = false;
+            }
+
             // mark as freed before actually freeing
             header->magic = allocation_magic_freed;
 
@@ -237,10 +719,7 @@ namespace spartan
             // calculate original raw pointer
             void* raw = static_cast<char*>(ptr) - offset;
 
-            // update counters
-            bytes_allocated.fetch_sub(size, memory_order_relaxed);
-            allocation_count.fetch_sub(1, memory_order_relaxed);
-            bytes_by_tag[static_cast<size_t>(tag)].fetch_sub(size, memory_order_relaxed);
+            stats_record(-static_cast<int64_t>(size), -1, tag);
 
 #if defined(_MSC_VER)
             _aligned_free(raw);
@@ -252,32 +731,42 @@ namespace spartan
 
     void* Allocator::Allocate(size_t size, size_t alignment, MemoryTag tag)
     {
-        // try thread-local cache first for small allocations with default alignment
-        if (alignment <= alignof(allocation_header) && size <= cache_max_size)
+        // untagged allocations inherit the innermost scoped tag
+        if (tag == MemoryTag::Untagged && tl_tag_depth > 0)
         {
-            size_t size_class   = get_size_class(size);
-            size_t padded_size  = get_size_for_class(size_class);
-            void*  cached       = cache_try_get(padded_size);
-            if (cached)
-            {
-                // update header with new tag (size stays the same since it's from same size class)
-                const size_t header_size  = sizeof(allocation_header);
-                allocation_header* header = reinterpret_cast<allocation_header*>(static_cast<char*>(cached) - header_size);
-                
-                // re-activate the allocation
-                header->magic = allocation_magic_active;
-                header->tag   = tag;
+            tag = tl_tags[tl_tag_depth - 1];
+        }
 
-                // update tag counter (size is already counted from original allocation)
-                bytes_by_tag[static_cast<size_t>(tag)].fetch_add(header->size, memory_order_relaxed);
+        // every n bytes, an allocation takes the header path so its free can be matched
+        if (const size_t interval = sampling_interval.load(memory_order_relaxed); interval != 0 && !tl_sampling)
+        {
+            tl_sample_countdown -= static_cast<int64_t>(size);
+            if (tl_sample_countdown <= 0)
+            {
+                tl_sample_countdown = static_cast<int64_t>(interval);
+
+                void* ptr = allocate_internal(size, alignment, tag, allocation_flag_sampled);
+                if (ptr)
+                {
+                    tl_sampling = true;
+                    AllocationProfiler::RecordAllocation(ptr, size, max(size, interval), tag);
+                    tl_sampling = false;
+                }
+                return ptr;
+            }
+        }
 
+        if (size <= slab_max_size && alignment <= slab_max_alignment && slabs_enabled.load(memory_order_relaxed))
+        {
+            uint32_t block_size = 0;
+            if (void* block = slab_allocate(size, alignment, tag, block_size))
+            {
 #if defined(_DEBUG) || defined(DEBUG)
-                memset(cached, poison_allocated, header->size);
+                memset(block, poison_allocated, block_size);
 #endif
-                return cached;
+                stats_record(block_size, 1, tag);
+                return block;
             }
-            // cache miss - allocate with padded size for future caching
-            return allocate_internal(padded_size, alignment, tag);
         }
 
         return allocate_internal(size, alignment, tag);
@@ -288,53 +777,25 @@ namespace spartan
         if (!ptr)
             return;
 
-        const size_t header_size = sizeof(allocation_header);
-        allocation_header* header = reinterpret_cast<allocation_header*>(static_cast<char*>(ptr) - header_size);
-
-        // validate before accessing other fields
-        if (header->magic == allocation_magic_freed)
-        {
-            SP_LOG_ERROR("Double-free detected at address %p", ptr);
-            SP_ASSERT(false && "double-free detected");
-            return;
-        }
-        if (header->magic != allocation_magic_active)
+        if (slab_contains(ptr))
         {
-            SP_LOG_ERROR("Memory corruption detected at address %p (magic: 0x%08X)", ptr, header->magic);
-            SP_ASSERT(false && "memory corruption detected");
+            slab_free(ptr);
             return;
         }
 
-        size_t size = header->size;
-
-        // update tag counter before potential caching
-        bytes_by_tag[static_cast<size_t>(header->tag)].fetch_sub(size, memory_order_relaxed);
-
-        // try to cache small allocations
-        if (size <= cache_max_size)
-        {
-            // mark as freed but keep in cache
-            header->magic = allocation_magic_freed;
-
-#if defined(_DEBUG) || defined(DEBUG)
-            memset(ptr, poison_freed, size);
-#endif
-
-            if (cache_try_put(ptr, size))
-            {
-                // successfully cached - don't actually free
-                // note: counters stay as-is since memory is still "allocated" from system perspective
-                return;
-            }
-            // cache full - restore magic and fall through to actual free
-            header->magic = allocation_magic_active;
-        }
-
         free_internal(ptr);
     }
 
     void Allocator::Tick()
     {
+        stats_flush();
+        allocations_last_frame.store(allocations_frame.exchange(0, memory_order_relaxed), memory_order_relaxed);
+        for (size_t i = 0; i < tag_count; i++)
+        {
+            allocations_last_frame_by_tag[i].store(allocations_frame_by_tag[i].exchange(0, memory_order_relaxed), memory_order_relaxed);
+        }
+        FrameAllocator::Tick();
+
         static bool has_warned                    = false; // only warn once per threshold crossing
         constexpr float warning_threshold_percent = 90.0f; // 90%
     
@@ -363,7 +824,7 @@ namespace spartan
 
     float Allocator::GetMemoryAllocatedMb()
     {
-         return static_cast<float>(bytes_allocated) / (1024.0f * 1024.0f);
+        return static_cast<float>(max<int64_t>(static_cast<int64_t>(bytes_allocated.load(memory_order_relaxed)), 0)) / (1024.0f * 1024.0f);
     }
 
     float Allocator::GetMemoryProcessUsedMb()
@@ -431,6 +892,56 @@ namespace spartan
 #endif
     }
 
+    uint32_t Allocator::GetAllocationsLastFrame()
+    {
+        return allocations_last_frame.load(memory_order_relaxed);
+    }
+
+    uint32_t Allocator::GetAllocationsLastFrame(MemoryTag tag)
+    {
+        size_t index = static_cast<size_t>(tag);
+        if (index >= tag_count)
+            return 0;
+        return allocations_last_frame_by_tag[index].load(memory_order_relaxed);
+    }
+
+    void Allocator::PushTag(MemoryTag tag)
+    {
+        SP_ASSERT_MSG(tl_tag_depth < tag_stack_depth, "memory tag scopes are nested too deep");
+        tl_tags[tl_tag_depth++] = tag;
+    }
+
+    void Allocator::PopTag()
+    {
+        SP_ASSERT_MSG(tl_tag_depth > 0, "memory tag pop without a push");
+        tl_tag_depth--;
+    }
+
+    MemoryTag Allocator::GetCurrentTag()
+    {
+        return tl_tag_depth > 0 ? tl_tags[tl_tag_depth - 1] : MemoryTag::Untagged;
+    }
+
+    void Allocator::SetSamplingInterval(size_t bytes)
+    {
+        sampling_interval.store(bytes, memory_order_relaxed);
+    }
+
+    size_t Allocator::GetSamplingInterval()
+    {
+        return sampling_interval.load(memory_order_relaxed);
+    }
+
+    void Allocator::SetSlabsEnabled(const bool enabled)
+    {
+        slabs_enabled.store(enabled, memory_order_relaxed);
+    }
+
+    bool Allocator::GetSlabsEnabled()
+    {
+        return slabs_enabled.load(memory_order_relaxed);
+    }
+
     float Allocator::GetMemoryAllocatedPeakMb()
     {
         return static_cast<float>(bytes_allocated_peak) / (1024.0f * 1024.0f);
@@ -441,7 +952,7 @@ namespace spartan
         size_t index = static_cast<size_t>(tag);
         if (index >= static_cast<size_t>(MemoryTag::Count))
             return 0.0f;
-        return static_cast<float>(bytes_by_tag[index].load(memory_order_relaxed)) / (1024.0f * 1024.0f);
+        return static_cast<float>(max<int64_t>(static_cast<int64_t>(bytes_by_tag[index].load(memory_order_relaxed)), 0)) / (1024.0f * 1024.0f);
     }
 
     const char* Allocator::GetTagName(MemoryTag tag)
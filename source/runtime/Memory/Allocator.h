@@ -46,6 +46,8 @@ namespace spartan
     {
     public:
         // allocate aligned memory with optional tag for tracking
+        // untagged allocations up to 1kb with up to 64 byte alignment come from per-thread size-class slabs and carry no header,
+        // anything else gets a header in front of it, statistics are published in batches so they can lag by a few allocations
         static void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t), MemoryTag tag = MemoryTag::Untagged);
 
         // free previously allocated memory
@@ -60,6 +62,23 @@ namespace spartan
         // peak memory allocated by the engine
         static float GetMemoryAllocatedPeakMb();
 
+        // heap allocations made during the previous frame, by any thread
+        static uint32_t GetAllocationsLastFrame();
+        static uint32_t GetAllocationsLastFrame(MemoryTag tag);
+
+        // untagged allocations made by this thread are attributed to the innermost pushed tag
+        static void PushTag(MemoryTag tag);
+        static void PopTag();
+        static MemoryTag GetCurrentTag();
+
+        // hand an allocation to the allocation profiler every this many bytes, 0 disables sampling
+        static void SetSamplingInterval(std::size_t bytes);
+        static std::size_t GetSamplingInterval();
+
+        // routes small allocations through the header path as well, so the two can be compared
+        static void SetSlabsEnabled(const bool enabled);
+        static bool GetSlabsEnabled();
+
         // total memory used by the process including engine, dlls, drivers, os allocations, etc.
         static float GetMemoryProcessUsedMb();
 
@@ -75,4 +94,17 @@ namespace spartan
         // get tag name as string
         static const char* GetTagName(MemoryTag tag);
     };
+
+    // attributes the allocations of a scope to a tag
+    class MemoryTagScope
+    {
+    public:
+        explicit MemoryTagScope(MemoryTag tag) { Allocator::PushTag(tag); }
+        ~MemoryTagScope()                       { Allocator::PopTag(); }
+
+        MemoryTagScope(const MemoryTagScope&)            = delete;
+        MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+    };
 }
+
+#define SP_MEMORY_TAG(tag) spartan::MemoryTagScope memory_tag_scope(tag)
@@ -0,0 +1,144 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ============
+#include "pch.h"
+#include "FrameAllocator.h"
+#include "Allocator.h"
+//=======================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace spartan
+{
+    namespace
+    {
+        constexpr size_t page_size      = 256 * 1024;
+        constexpr size_t page_alignment = 64;
+
+        atomic<uint64_t> frame               = 0;
+        atomic<size_t> bytes_used_frame      = 0;
+        atomic<size_t> bytes_used_last_frame = 0;
+
+        struct page
+        {
+            uint8_t* data = nullptr;
+            size_t size   = 0;
+        };
+
+        struct arena
+        {
+            vector<page> pages;
+            size_t page_index = 0;
+            size_t offset     = 0;
+            uint64_t frame    = numeric_limits<uint64_t>::max();
+
+            void reset(const uint64_t frame_new)
+            {
+                // keep regular pages for reuse, oversized ones were a one-off
+                for (size_t i = 0; i < pages.size();)
+                {
+                    if (pages[i].size > page_size)
+                    {
+                        Allocator::Free(pages[i].data);
+                        pages.erase(pages.begin() + i);
+                        continue;
+                    }
+                    i++;
+                }
+
+                page_index = 0;
+                offset     = 0;
+                frame      = frame_new;
+            }
+
+            ~arena()
+            {
+                for (page& p : pages)
+                {
+                    Allocator::Free(p.data);
+                }
+            }
+        };
+
+        thread_local array<arena, FrameAllocator::buffer_count> arenas;
+    }
+
+    void* FrameAllocator::Allocate(const size_t size, const size_t alignment)
+    {
+        SP_ASSERT_MSG((alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+
+        const uint64_t frame_current = frame.load(memory_order_relaxed);
+        arena& a = arenas[frame_current % buffer_count];
+        if (a.frame != frame_current)
+        {
+            a.reset(frame_current);
+        }
+
+        // bump within the current page, move on to the next one when it's full
+        while (a.page_index < a.pages.size())
+        {
+            page& p           = a.pages[a.page_index];
+            uintptr_t base    = reinterpret_cast<uintptr_t>(p.data);
+            uintptr_t start   = (base + a.offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            size_t offset_end = static_cast<size_t>(start - base) + size;
+            if (offset_end <= p.size)
+            {
+                a.offset = offset_end;
+                bytes_used_frame.fetch_add(size, memory_order_relaxed);
+                return reinterpret_cast<void*>(start);
+            }
+
+            a.page_index++;
+            a.offset = 0;
+        }
+
+        // out of pages, grab a new one (large requests get a page of their own)
+        page p;
+        p.size = max(page_size, size + alignment);
+        p.data = static_cast<uint8_t*>(Allocator::Allocate(p.size, max(alignment, page_alignment)));
+        SP_ASSERT(p.data != nullptr);
+        a.pages.push_back(p);
+        a.page_index = a.pages.size() - 1;
+        a.offset     = size;
+
+        bytes_used_frame.fetch_add(size, memory_order_relaxed);
+        return p.data;
+    }
+
+    void FrameAllocator::Tick()
+    {
+        bytes_used_last_frame.store(bytes_used_frame.exchange(0, memory_order_relaxed), memory_order_relaxed);
+        frame.fetch_add(1, memory_order_relaxed);
+    }
+
+    uint64_t FrameAllocator::GetFrame()
+    {
+        return frame.load(memory_order_relaxed);
+    }
+
+    size_t FrameAllocator::GetBytesUsedLastFrame()
+    {
+        return bytes_used_last_frame.load(memory_order_relaxed);
+    }
+}
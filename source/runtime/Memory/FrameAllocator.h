@@ -0,0 +1,71 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <string>
+//================
+
+namespace spartan
+{
+    // per-thread linear allocator for scratch memory that doesn't outlive the frame
+    // allocating is a pointer bump and nothing is freed individually, every thread owns buffer_count
+    // arenas and recycles one the first time it allocates in a new frame, so memory obtained during
+    // frame n stays valid until the end of frame n + buffer_count - 1
+    class FrameAllocator
+    {
+    public:
+        static constexpr uint32_t buffer_count = 3;
+
+        static void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        // called once per frame by Allocator::Tick()
+        static void Tick();
+
+        // stats
+        static uint64_t GetFrame();
+        static std::size_t GetBytesUsedLastFrame(); // all threads
+    };
+
+    // stl adapter, deallocation is a no-op
+    template<typename T>
+    class FrameStlAllocator
+    {
+    public:
+        using value_type = T;
+
+        FrameStlAllocator() noexcept = default;
+        template<typename U> FrameStlAllocator(const FrameStlAllocator<U>&) noexcept {}
+
+        T* allocate(const std::size_t count)                        { return static_cast<T*>(FrameAllocator::Allocate(count * sizeof(T), alignof(T))); }
+        void deallocate(T*, std::size_t) noexcept                   {}
+        template<typename U> bool operator==(const FrameStlAllocator<U>&) const noexcept { return true; }
+        template<typename U> bool operator!=(const FrameStlAllocator<U>&) const noexcept { return false; }
+    };
+
+    template<typename T>
+    using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+    using FrameString = std::basic_string<char, std::char_traits<char>, FrameStlAllocator<char>>;
+}
@@ -29,6 +29,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World/Components/Camera.h"
 #include "../World/Components/Physics.h"
 #include "../World/World.h"
+#include "../Memory/Allocator.h"
 SP_WARNINGS_OFF
 #ifdef DEBUG
     #define _DEBUG 1
@@ -175,6 +176,21 @@ namespace spartan
         }
     }
 
+    // physx memory goes through the engine allocator so it's attributed to the physics tag
+    class PhysXAllocator : public physx::PxAllocatorCallback
+    {
+    public:
+        void* allocate(size_t size, const char*, const char*, int) override
+        {
+            return Allocator::Allocate(size, 16, MemoryTag::Physics); // physx requires 16 byte alignment
+        }
+
+        void deallocate(void* ptr) override
+        {
+            Allocator::Free(ptr);
+        }
+    };
+
     class PhysXLogging : public physx::PxErrorCallback
     {
     public:
@@ -198,7 +214,7 @@ namespace spartan
 
     namespace
     {
-        static PxDefaultAllocator allocator;
+        static PhysXAllocator allocator;
         static PhysXLogging logger;
         static PxFoundation* foundation           = nullptr;
         static PxPhysics* physics                 = nullptr;
@@ -262,6 +278,7 @@ namespace spartan
     void PhysicsWorld::Tick()
     {
         SP_PROFILE_CPU();
+        SP_MEMORY_TAG(MemoryTag::Physics);
 
         // skip if loading
         if (ProgressTracker::IsLoading())
@@ -0,0 +1,266 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "pch.h"
+#include "HardwareCounters.h"
+#include "../Commands/Console/ConsoleCommands.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+//======================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace spartan
+{
+    namespace
+    {
+        const uint32_t counter_count   = static_cast<uint32_t>(HardwareCounter::Count);
+        const uint32_t counter_invalid = numeric_limits<uint32_t>::max();
+
+        const char* counter_names[] =
+        {
+            "cycles",
+            "instructions",
+            "l1 misses",
+            "llc misses",
+            "branch misses"
+        };
+        static_assert(size(counter_names) == counter_count, "counter_names out of sync with HardwareCounter enum");
+
+        bool enabled   = false;
+        bool attempted = false; // opening is attempted once per enable, a refusal isn't retried every block
+        bool available = false;
+        thread::id owner;
+
+        void close_counters();
+
+        void on_hardware_counters_change(const CVarVariant& value)
+        {
+            enabled = get<float>(value) != 0.0f;
+
+        #ifndef __linux__
+            if (enabled)
+            {
+                SP_LOG_WARNING("Hardware counters are only supported on linux");
+            }
+        #endif
+
+            close_counters();
+        }
+        TConsoleVar<float> cvar_hardware_counters("profiler.hardware_counters", 0.0f, "attach cpu performance counters to cpu time blocks (linux)", on_hardware_counters_change);
+
+    #ifdef __linux__
+        struct event_description
+        {
+            uint32_t type;
+            uint64_t config;
+        };
+
+        // indexed by HardwareCounter
+        const event_description events[] =
+        {
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES }, // the kernel maps this to the last level cache
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+        };
+        static_assert(size(events) == counter_count, "events out of sync with HardwareCounter enum");
+
+        int fds[counter_count]              = { -1, -1, -1, -1, -1 };
+        uint32_t group_index[counter_count] = {}; // position of each counter in a group read
+        int leader_fd                       = -1;
+
+        // layout of a read() with PERF_FORMAT_GROUP
+        struct group_read
+        {
+            uint64_t count;
+            uint64_t time_enabled;
+            uint64_t time_running;
+            uint64_t values[counter_count];
+        };
+
+        int open_event(const event_description& event, const int group_fd)
+        {
+            perf_event_attr attr = {};
+            attr.size            = sizeof(attr);
+            attr.type            = event.type;
+            attr.config          = event.config;
+            attr.disabled        = group_fd == -1 ? 1 : 0; // the leader starts and stops the whole group
+            attr.exclude_kernel  = 1;                      // permitted with perf_event_paranoid 2, the default on most distributions
+            attr.exclude_hv      = 1;
+            attr.read_format     = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // this thread, any cpu
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+        }
+
+        bool open_counters()
+        {
+            uint32_t group_size = 0;
+            int error           = 0;
+            for (uint32_t i = 0; i < counter_count; i++)
+            {
+                fds[i]         = open_event(events[i], leader_fd);
+                group_index[i] = counter_invalid;
+
+                if (fds[i] == -1)
+                {
+                    error = errno;
+                    continue;
+                }
+
+                if (leader_fd == -1)
+                {
+                    leader_fd = fds[i];
+                }
+                group_index[i] = group_size++;
+            }
+
+            if (leader_fd == -1)
+            {
+                if (error == EACCES || error == EPERM)
+                {
+                    SP_LOG_WARNING("Hardware counters are not permitted, lower /proc/sys/kernel/perf_event_paranoid to 2 or run with CAP_PERFMON");
+                }
+                else
+                {
+                    SP_LOG_WARNING("Hardware counters are not supported: %s", strerror(error));
+                }
+
+                return false;
+            }
+
+            // virtual machines and some cpus lack a few of the events, the rest still work
+            for (uint32_t i = 0; i < counter_count; i++)
+            {
+                if (group_index[i] == counter_invalid)
+                {
+                    SP_LOG_INFO("Hardware counter \"%s\" is not supported", counter_names[i]);
+                }
+            }
+
+            ioctl(leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+            return true;
+        }
+
+        void close_counters()
+        {
+            for (int& fd : fds)
+            {
+                if (fd != -1)
+                {
+                    close(fd);
+                    fd = -1;
+                }
+            }
+
+            leader_fd = -1;
+            attempted = false;
+            available = false;
+        }
+    #else
+        void close_counters()
+        {
+            attempted = false;
+            available = false;
+        }
+    #endif
+    }
+
+    void HardwareCounters::SetEnabled(const bool enabled_in)
+    {
+        ConsoleRegistry::Get().SetValueFromString("profiler.hardware_counters", enabled_in ? "1" : "0");
+    }
+
+    bool HardwareCounters::IsEnabled()
+    {
+        return enabled;
+    }
+
+    bool HardwareCounters::IsAvailable()
+    {
+        return available;
+    }
+
+    bool HardwareCounters::IsAvailable(const HardwareCounter counter)
+    {
+    #ifdef __linux__
+        return available && group_index[static_cast<uint32_t>(counter)] != counter_invalid;
+    #else
+        return false;
+    #endif
+    }
+
+    bool HardwareCounters::Read(HardwareCounterValues& values)
+    {
+        if (!enabled)
+            return false;
+
+    #ifdef __linux__
+        // opened lazily, so they belong to the thread that measures
+        if (!attempted)
+        {
+            attempted = true;
+            owner     = this_thread::get_id();
+            available = open_counters();
+        }
+
+        if (!available || this_thread::get_id() != owner)
+            return false;
+
+        group_read data;
+        if (read(leader_fd, &data, sizeof(data)) < static_cast<ssize_t>(3 * sizeof(uint64_t)))
+            return false;
+
+        // with more events than hardware registers the kernel time slices them, extrapolate to the full window
+        double scale = 1.0;
+        if (data.time_running > 0 && data.time_running < data.time_enabled)
+        {
+            scale = static_cast<double>(data.time_enabled) / static_cast<double>(data.time_running);
+        }
+
+        for (uint32_t i = 0; i < counter_count; i++)
+        {
+            const uint32_t index = group_index[i];
+            values[i]            = index < data.count ? static_cast<uint64_t>(static_cast<double>(data.values[index]) * scale) : 0;
+        }
+
+        return true;
+    #else
+        return false;
+    #endif
+    }
+
+    const char* HardwareCounters::GetName(const HardwareCounter counter)
+    {
+        return counter_names[static_cast<uint32_t>(counter)];
+    }
+}
@@ -0,0 +1,60 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====
+#include <array>
+#include <cstdint>
+//================
+
+namespace spartan
+{
+    enum class HardwareCounter : uint8_t
+    {
+        Cycles,
+        Instructions,
+        CacheMissesL1,
+        CacheMissesLlc,
+        BranchMisses,
+        Count
+    };
+
+    using HardwareCounterValues = std::array<uint64_t, static_cast<size_t>(HardwareCounter::Count)>;
+
+    // cpu performance counters, read as one group so the values line up
+    // linux only (perf_event_open), they count the thread that reads them first, which is the main thread for time blocks
+    class HardwareCounters
+    {
+    public:
+        static void SetEnabled(const bool enabled);
+        static bool IsEnabled();
+
+        // false when disabled, not permitted by the kernel or not supported
+        static bool IsAvailable();
+        static bool IsAvailable(const HardwareCounter counter);
+
+        // counts since the counters were opened, scaled when the kernel had to multiplex them
+        static bool Read(HardwareCounterValues& values);
+
+        static const char* GetName(const HardwareCounter counter);
+    };
+}
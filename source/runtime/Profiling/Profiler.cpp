@@ -31,6 +31,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Rendering/Renderer.h"
 #include "../Display/Display.h"
 #include "../Memory/Allocator.h"
+#include "../Memory/FrameAllocator.h"
 //====================================
 
 //= NAMESPACES =====
@@ -85,11 +86,113 @@ namespace spartan
         float weight_history          = (1.0f - weight_delta);
         float m_fps                   = 0.0f;
 
-        // time blocks (double buffered)
-        int m_time_block_index = -1;
+        // time blocks (double buffered), main thread only
+        int m_time_block_index         = -1;
+        uint32_t time_block_generation = 0; // bumped whenever the write array is recycled
         vector<TimeBlock> m_time_blocks_write;
         vector<TimeBlock> m_time_blocks_read;
 
+        // hardware counters, aggregated per time block name whenever the time blocks are read
+        vector<HardwareCounterStats> hardware_counter_stats;
+        unordered_map<string, size_t> hardware_counter_stats_index;
+
+        // every thread keeps its own stack of open blocks, so an end always matches its start
+        const uint32_t open_block_max = 64;
+        struct open_block
+        {
+            const char* name;
+            uint64_t start_ns;
+            int32_t time_block_index;
+            uint32_t time_block_generation;
+            bool traced;
+        };
+        thread_local open_block open_blocks[open_block_max];
+        thread_local uint32_t open_block_count = 0;
+        thread_local uint32_t current_job      = 0;
+        thread_local bool is_main_thread       = false;
+
+        // trace, every thread writes into its own single producer single consumer ring
+        // the main thread drains the rings once per frame and when the capture ends
+        const uint32_t trace_ring_size = 32768; // events, power of two
+        struct thread_timeline
+        {
+            string name;
+            uint32_t index = 0;
+            unique_ptr<TraceEvent[]> ring; // allocated with the first event
+            alignas(64) atomic<uint64_t> write = 0;
+            alignas(64) atomic<uint64_t> read  = 0;
+            atomic<uint64_t> dropped           = 0;
+        };
+
+        mutex timelines_mutex; // registration and draining, never taken when recording
+        vector<unique_ptr<thread_timeline>> timelines;
+        thread_local thread_timeline* timeline = nullptr;
+
+        atomic<bool> tracing            = false;
+        atomic<uint32_t> job_count      = 0;
+        uint64_t trace_start_ns         = 0;
+        uint32_t trace_frames_remaining = 0;
+        string trace_file_path;
+        vector<TraceEvent> trace_events;
+
+        uint64_t now_ns()
+        {
+            return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        thread_timeline* get_timeline()
+        {
+            if (!timeline)
+            {
+                lock_guard<mutex> lock(timelines_mutex);
+                timelines.emplace_back(make_unique<thread_timeline>());
+                timeline        = timelines.back().get();
+                timeline->index = static_cast<uint32_t>(timelines.size() - 1);
+                timeline->name  = "thread " + to_string(timeline->index);
+            }
+
+            return timeline;
+        }
+
+        void trace_record(const TraceEvent& event)
+        {
+            thread_timeline* thread_timeline = get_timeline();
+            if (!thread_timeline->ring)
+            {
+                thread_timeline->ring = make_unique<TraceEvent[]>(trace_ring_size);
+            }
+
+            // a full ring drops the event instead of waiting for the main thread
+            const uint64_t write = thread_timeline->write.load(memory_order_relaxed);
+            if (write - thread_timeline->read.load(memory_order_acquire) >= trace_ring_size)
+            {
+                thread_timeline->dropped.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+
+            thread_timeline->ring[write & (trace_ring_size - 1)] = event;
+            thread_timeline->write.store(write + 1, memory_order_release);
+        }
+
+        string json_escape(const char* text)
+        {
+            string escaped;
+            for (const char* c = text ? text : "unnamed"; *c; c++)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    escaped += '\\';
+                }
+
+                if (static_cast<unsigned char>(*c) >= 0x20)
+                {
+                    escaped += *c;
+                }
+            }
+
+            return escaped;
+        }
+
         // stutter detection
         float stutter_delta_ms = 1.0f;
         bool is_stuttering_cpu = false;
@@ -146,6 +249,9 @@ namespace spartan
         m_time_blocks_write.resize(max_timeblocks);
         m_time_blocks_read.resize(max_timeblocks);
         cpu_name = get_cpu_name();
+
+        is_main_thread = true;
+        SetThreadName("main");
     }
 
     void Profiler::FrameStart()
@@ -226,6 +332,17 @@ namespace spartan
             ReadTimeBlocks();
         }
 
+        if (tracing.load(memory_order_relaxed))
+        {
+            TraceDrain();
+
+            if (trace_frames_remaining > 0 && --trace_frames_remaining == 0)
+            {
+                TraceEnd();
+                TraceExport(trace_file_path);
+            }
+        }
+
         if (cvar_performance_metrics.GetValueAs<bool>())
         {
             DrawPerformanceMetrics();
@@ -236,6 +353,7 @@ namespace spartan
 
     void Profiler::ReadTimeBlocks()
     {
+        time_block_generation++;
         m_time_blocks_read.clear();
         if (m_time_block_index < 0)
         {
@@ -309,6 +427,8 @@ namespace spartan
             }
         }
 
+        UpdateHardwareCounterStats();
+
         // clear write array and tracking state
         m_time_blocks_write.clear();
         m_time_blocks_write.resize(max_timeblocks);
@@ -316,9 +436,71 @@ namespace spartan
         cmd_lists_used.clear();
     }
 
+    void Profiler::UpdateHardwareCounterStats()
+    {
+        if (!HardwareCounters::IsAvailable())
+        {
+            hardware_counter_stats.clear();
+            hardware_counter_stats_index.clear();
+            return;
+        }
+
+        const size_t counter_count = static_cast<size_t>(HardwareCounter::Count);
+
+        // sum this frame's blocks per name
+        const size_t known_count = hardware_counter_stats.size();
+        FrameVector<HardwareCounterValues> frame_totals(known_count, HardwareCounterValues{});
+        for (HardwareCounterStats& stats : hardware_counter_stats)
+        {
+            stats.calls = 0;
+        }
+
+        for (const TimeBlock& time_block : m_time_blocks_read)
+        {
+            if (time_block.GetType() != TimeBlockType::Cpu || !time_block.HasCounters())
+                continue;
+
+            auto [it, inserted] = hardware_counter_stats_index.try_emplace(time_block.GetName() ? time_block.GetName() : "unnamed", hardware_counter_stats.size());
+            if (inserted)
+            {
+                hardware_counter_stats.emplace_back().name = it->first;
+                frame_totals.emplace_back(HardwareCounterValues{});
+            }
+
+            hardware_counter_stats[it->second].calls++;
+            for (size_t i = 0; i < counter_count; i++)
+            {
+                frame_totals[it->second][i] += time_block.GetCounter(static_cast<HardwareCounter>(i));
+            }
+        }
+
+        // smooth with the same weights as the timings, a name seen for the first time starts at its value
+        for (size_t index = 0; index < hardware_counter_stats.size(); index++)
+        {
+            HardwareCounterStats& stats = hardware_counter_stats[index];
+            const bool first            = index >= known_count;
+            for (size_t i = 0; i < counter_count; i++)
+            {
+                const double value = static_cast<double>(frame_totals[index][i]);
+                stats.per_frame[i] = first ? value : stats.per_frame[i] * weight_history + value * weight_delta;
+            }
+        }
+    }
+
     void Profiler::TimeBlockStart(const char* func_name, TimeBlockType type, RHI_CommandList* cmd_list /*= nullptr*/, RHI_Queue_Type queue_type /*= RHI_Queue_Type::Max*/)
     {
-        if (!poll)
+        open_block* block = open_block_count < open_block_max ? &open_blocks[open_block_count] : nullptr;
+        open_block_count++;
+        if (block)
+        {
+            block->name             = func_name;
+            block->traced           = type == TimeBlockType::Cpu && tracing.load(memory_order_relaxed);
+            block->start_ns         = block->traced ? now_ns() : 0;
+            block->time_block_index = -1;
+        }
+
+        // the time blocks are the frame tree of the main thread, other threads only show up in traces
+        if (!poll || !is_main_thread)
             return;
 
         const bool can_profile_cpu = (type == TimeBlockType::Cpu) && profile_cpu;
@@ -343,18 +525,233 @@ namespace spartan
         // get new time block
         TimeBlock& new_time_block = m_time_blocks_write[++m_time_block_index];
         new_time_block.Begin(++m_rhi_timeblock_count, func_name, type, time_block_parent, cmd_list, queue_type);
+
+        if (block)
+        {
+            block->time_block_index      = m_time_block_index;
+            block->time_block_generation = time_block_generation;
+        }
     }
 
     void Profiler::TimeBlockEnd()
     {
-        if (TimeBlock* time_block = GetLastIncompleteTimeBlock(TimeBlockType::Cpu))
+        if (open_block_count == 0)
+        {
+            SP_LOG_WARNING("TimeBlockEnd() was called without a matching TimeBlockStart()");
+            return;
+        }
+
+        // blocks nested deeper than the stack are not tracked
+        if (--open_block_count >= open_block_max)
+            return;
+
+        const open_block& block = open_blocks[open_block_count];
+
+        // skip blocks whose frame was already read back
+        if (block.time_block_index >= 0 && block.time_block_generation == time_block_generation)
+        {
+            m_time_blocks_write[block.time_block_index].End();
+        }
+
+        if (block.traced && tracing.load(memory_order_relaxed))
+        {
+            TraceEvent event;
+            event.name     = block.name;
+            event.start_ns = block.start_ns;
+            event.end_ns   = now_ns();
+            event.job_id   = current_job;
+            trace_record(event);
+        }
+    }
+
+    void Profiler::TraceBegin()
+    {
+        if (tracing.load(memory_order_relaxed))
         {
-            time_block->End();
+            SP_LOG_WARNING("A trace is already being captured");
+            return;
         }
-        if (TimeBlock* time_block = GetLastIncompleteTimeBlock(TimeBlockType::Gpu))
+
         {
-            time_block->End();
+            // discard anything left over from the previous capture
+            lock_guard<mutex> lock(timelines_mutex);
+            for (unique_ptr<thread_timeline>& thread_timeline : timelines)
+            {
+                thread_timeline->read.store(thread_timeline->write.load(memory_order_acquire), memory_order_release);
+                thread_timeline->dropped.store(0, memory_order_relaxed);
+            }
         }
+
+        trace_events.clear();
+        trace_start_ns = now_ns();
+        tracing.store(true, memory_order_release);
+    }
+
+    void Profiler::TraceEnd()
+    {
+        tracing.store(false, memory_order_release);
+        trace_frames_remaining = 0;
+        TraceDrain();
+    }
+
+    void Profiler::TraceCaptureFrames(const uint32_t frame_count, const string& file_path)
+    {
+        if (tracing.load(memory_order_relaxed) || frame_count == 0)
+            return;
+
+        trace_file_path = file_path;
+        TraceBegin();
+        trace_frames_remaining = frame_count;
+    }
+
+    void Profiler::TraceDrain()
+    {
+        lock_guard<mutex> lock(timelines_mutex);
+        for (unique_ptr<thread_timeline>& thread_timeline : timelines)
+        {
+            uint64_t read        = thread_timeline->read.load(memory_order_relaxed);
+            const uint64_t write = thread_timeline->write.load(memory_order_acquire);
+            for (; read < write; read++)
+            {
+                TraceEvent& event  = trace_events.emplace_back(thread_timeline->ring[read & (trace_ring_size - 1)]);
+                event.thread_index = thread_timeline->index;
+            }
+            thread_timeline->read.store(write, memory_order_release);
+        }
+    }
+
+    bool Profiler::TraceExport(const string& file_path)
+    {
+        ofstream file(file_path, ios::out | ios::trunc);
+        if (!file.is_open())
+        {
+            SP_LOG_ERROR("Failed to open \"%s\" for writing", file_path.c_str());
+            return false;
+        }
+
+        // chrome trace event format, loads in chrome://tracing and perfetto
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        const char* separator = "\n";
+        {
+            lock_guard<mutex> lock(timelines_mutex);
+            for (const unique_ptr<thread_timeline>& thread_timeline : timelines)
+            {
+                file << separator << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << thread_timeline->index << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << json_escape(thread_timeline->name.c_str()) << "\"}}";
+                separator = ",\n";
+            }
+        }
+
+        unordered_map<uint32_t, uint32_t> job_parents;
+        for (const TraceEvent& event : trace_events)
+        {
+            if (event.type == TraceEventType::FlowStart)
+            {
+                job_parents[event.job_id] = event.parent_job_id;
+            }
+        }
+
+        char buffer[512];
+        for (const TraceEvent& event : trace_events)
+        {
+            const double start_us = static_cast<double>(static_cast<int64_t>(event.start_ns - trace_start_ns)) / 1000.0;
+            const string name     = json_escape(event.name);
+            int length            = 0;
+
+            if (event.type == TraceEventType::Slice)
+            {
+                const double duration_us = static_cast<double>(event.end_ns - event.start_ns) / 1000.0;
+                auto parent              = job_parents.find(event.job_id);
+                length = snprintf(buffer, sizeof(buffer),
+                    "{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"cat\":\"cpu\",\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"job\":%u,\"parent_job\":%u}}",
+                    event.thread_index, name.c_str(), start_us, duration_us, event.job_id, parent != job_parents.end() ? parent->second : 0);
+            }
+            else
+            {
+                // a flow end binds to the job slice that encloses it
+                length = snprintf(buffer, sizeof(buffer),
+                    "{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"cat\":\"job\",\"id\":%u,\"ts\":%.3f}",
+                    event.type == TraceEventType::FlowStart ? "s" : "f\",\"bp\":\"e", event.thread_index, name.c_str(), event.job_id, start_us);
+            }
+
+            if (length > 0 && length < static_cast<int>(sizeof(buffer)))
+            {
+                file << separator << buffer;
+                separator = ",\n";
+            }
+        }
+        file << "\n]}\n";
+
+        SP_LOG_INFO("Exported %zu trace events to \"%s\"", trace_events.size(), file_path.c_str());
+        return file.good();
+    }
+
+    bool Profiler::IsTracing()
+    {
+        return tracing.load(memory_order_relaxed);
+    }
+
+    const vector<TraceEvent>& Profiler::GetTraceEvents()
+    {
+        return trace_events;
+    }
+
+    uint64_t Profiler::GetTraceDroppedCount()
+    {
+        lock_guard<mutex> lock(timelines_mutex);
+        uint64_t dropped = 0;
+        for (const unique_ptr<thread_timeline>& thread_timeline : timelines)
+        {
+            dropped += thread_timeline->dropped.load(memory_order_relaxed);
+        }
+
+        return dropped;
+    }
+
+    void Profiler::SetThreadName(const char* name)
+    {
+        thread_timeline* thread_timeline = get_timeline();
+        lock_guard<mutex> lock(timelines_mutex);
+        thread_timeline->name = name;
+    }
+
+    uint32_t Profiler::TraceJobSubmit()
+    {
+        if (!tracing.load(memory_order_relaxed))
+            return 0;
+
+        TraceEvent event;
+        event.name          = "job";
+        event.start_ns      = now_ns();
+        event.end_ns        = event.start_ns;
+        event.job_id        = job_count.fetch_add(1, memory_order_relaxed) + 1;
+        event.parent_job_id = current_job;
+        event.type          = TraceEventType::FlowStart;
+        trace_record(event);
+
+        return event.job_id;
+    }
+
+    void Profiler::TraceJobBegin(const uint32_t job_id)
+    {
+        current_job = job_id;
+        TimeBlockStart("job", TimeBlockType::Cpu);
+
+        if (job_id != 0 && tracing.load(memory_order_relaxed))
+        {
+            TraceEvent event;
+            event.name     = "job";
+            event.start_ns = now_ns();
+            event.end_ns   = event.start_ns;
+            event.job_id   = job_id;
+            event.type     = TraceEventType::FlowEnd;
+            trace_record(event);
+        }
+    }
+
+    void Profiler::TraceJobEnd()
+    {
+        TimeBlockEnd();
+        current_job = 0;
     }
 
     void Profiler::ClearMetrics()
@@ -380,6 +777,11 @@ namespace spartan
         return m_time_blocks_read;
     }
 
+    const vector<HardwareCounterStats>& Profiler::GetHardwareCounterStats()
+    {
+        return hardware_counter_stats;
+    }
+
     float Profiler::GetTimeCpuLast()
     {
         return time_cpu_last;
@@ -407,8 +809,9 @@ namespace spartan
 
     void Profiler::SetUpdateInterval(float interval)
     {
-        profiling_interval_sec = interval;
-        frames_to_accumulate   = static_cast<uint32_t>(4.0f / profiling_interval_sec);
+        // an interval of zero reads the time blocks every frame, averages still span a few seconds
+        profiling_interval_sec = max(interval, 0.0f);
+        frames_to_accumulate   = static_cast<uint32_t>(4.0f / max(profiling_interval_sec, 1.0f / 60.0f));
         weight_delta           = 1.0f / static_cast<float>(frames_to_accumulate);
         weight_history         = (1.0f - weight_delta);
     }
@@ -516,9 +919,12 @@ namespace spartan
             offset += snprintf(metrics_buffer + offset, sizeof(metrics_buffer) - offset,
                 "Memory\n"
                 "Allocated:\t%.2f MB (Peak: %.2f MB)\n"
+                "Heap allocs:\t%u per frame (Frame scratch: %.1f KB)\n"
                 "Process:\t\t%.2f MB (Avail: %.2f MB, Total: %.2f MB)\n\n",
                 Allocator::GetMemoryAllocatedMb(),
                 Allocator::GetMemoryAllocatedPeakMb(),
+                Allocator::GetAllocationsLastFrame(),
+                static_cast<float>(FrameAllocator::GetBytesUsedLastFrame()) / 1024.0f,
                 Allocator::GetMemoryProcessUsedMb(),
                 Allocator::GetMemoryAvailableMb(),
                 Allocator::GetMemoryTotalMb());
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <chrono>
 #include <string>
 #include <vector>
+#include <array>
 #include "TimeBlock.h"
 #include <algorithm>
 //====================
@@ -35,6 +36,33 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace spartan
 {
+    enum class TraceEventType : uint8_t
+    {
+        Slice,     // a time block
+        FlowStart, // a job was submitted
+        FlowEnd    // a job started running
+    };
+
+    // an event recorded by one thread while a trace capture is running
+    struct TraceEvent
+    {
+        const char* name       = nullptr;
+        uint64_t start_ns      = 0;
+        uint64_t end_ns        = 0;
+        uint32_t thread_index  = 0;
+        uint32_t job_id        = 0; // job the event belongs to, 0 for work that didn't come from the thread pool
+        uint32_t parent_job_id = 0; // job slices only, the job that submitted them
+        TraceEventType type    = TraceEventType::Slice;
+    };
+
+    // hardware counters of the cpu time blocks that share a name
+    struct HardwareCounterStats
+    {
+        std::string name;
+        uint32_t calls = 0;                                                                 // blocks with this name in the last frame that was read
+        std::array<double, static_cast<size_t>(HardwareCounter::Count)> per_frame = {}; // summed over those blocks, smoothed across frames
+    };
+
     class Profiler
     {
     public:
@@ -45,9 +73,25 @@ namespace spartan
         static void TimeBlockStart(const char* func_name, TimeBlockType type, RHI_CommandList* cmd_list = nullptr, RHI_Queue_Type queue_type = RHI_Queue_Type::Max);
         static void TimeBlockEnd();
         static void ClearMetrics();
+
+        // trace capture, every thread records into its own timeline without locking
+        static void TraceBegin();
+        static void TraceEnd();
+        static void TraceCaptureFrames(const uint32_t frame_count, const std::string& file_path);
+        static bool TraceExport(const std::string& file_path);
+        static bool IsTracing();
+        static const std::vector<TraceEvent>& GetTraceEvents();
+        static uint64_t GetTraceDroppedCount();
+        static void SetThreadName(const char* name);
+
+        // thread pool hooks, link a job to the thread and job that submitted it
+        static uint32_t TraceJobSubmit();
+        static void TraceJobBegin(const uint32_t job_id);
+        static void TraceJobEnd();
         
         // properties
         static const std::vector<TimeBlock>& GetTimeBlocks();
+        static const std::vector<HardwareCounterStats>& GetHardwareCounterStats();
         static float GetTimeCpuLast();
         static float GetTimeGpuLast();
         static float GetTimeFrameLast();
@@ -84,6 +128,8 @@ namespace spartan
 
     private:
         static void ReadTimeBlocks();
+        static void UpdateHardwareCounterStats();
+        static void TraceDrain();
 
         static void ClearRhiMetrics()
         {
@@ -54,6 +54,9 @@ namespace spartan
             m_cmd_list = cmd_list;
         }
 
+        // counters are read outside of the clock reads, so their cost stays out of the duration
+        m_has_counters = type == TimeBlockType::Cpu && HardwareCounters::Read(m_counters);
+
         // record cpu time for timeline position
         m_start    = chrono::high_resolution_clock::now();
         m_start_ms = Profiler::GetCpuOffsetMs(m_start);
@@ -69,6 +72,20 @@ namespace spartan
         if (m_type == TimeBlockType::Cpu)
         {
             m_end = chrono::high_resolution_clock::now();
+
+            HardwareCounterValues counters_end;
+            if (m_has_counters && HardwareCounters::Read(counters_end))
+            {
+                for (size_t i = 0; i < m_counters.size(); i++)
+                {
+                    // scaling of multiplexed counters can make a short block come out slightly negative
+                    m_counters[i] = counters_end[i] > m_counters[i] ? counters_end[i] - m_counters[i] : 0;
+                }
+            }
+            else
+            {
+                m_has_counters = false;
+            }
         }
         else if (m_type == TimeBlockType::Gpu)
         {
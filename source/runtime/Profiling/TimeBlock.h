@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ======================
 #include <chrono>
 #include "../RHI/RHI_Definitions.h"
+#include "HardwareCounters.h"
 //=================================
 
 namespace spartan
@@ -60,6 +61,11 @@ namespace spartan
         float GetEndMs()               const { return m_end_ms; }
         RHI_Queue_Type GetQueueType()  const { return m_queue_type; }
 
+        // cpu blocks, when hardware counters are available
+        bool HasCounters()                                    const { return m_has_counters; }
+        uint64_t GetCounter(const HardwareCounter counter)    const { return m_counters[static_cast<size_t>(counter)]; }
+        const HardwareCounterValues& GetCounters()            const { return m_counters; }
+
     private:    
         static uint32_t FindTreeDepth(const TimeBlock* time_block, uint32_t depth = 0);
         static uint32_t m_max_tree_depth;
@@ -84,5 +90,9 @@ namespace spartan
         // cpu timing
         std::chrono::high_resolution_clock::time_point m_start;
         std::chrono::high_resolution_clock::time_point m_end;
+
+        // hardware counters, the values at begin until end turns them into deltas
+        HardwareCounterValues m_counters = {};
+        bool m_has_counters              = false;
     };
 }
@@ -0,0 +1,134 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "pch.h"
+#include "../RHI_Buffer.h"
+#include "../RHI_Device.h"
+#include "../RHI_CommandList.h"
+#include "../RHI_Implementation.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+// every buffer is host memory, mappable or not, so uploads are plain copies
+
+namespace spartan
+{
+    void RHI_Buffer::RHI_DestroyResource()
+    {
+        if (m_rhi_resource)
+        {
+            RHI_Device::DeletionQueueAdd(RHI_Resource_Type::Buffer, m_rhi_resource);
+            m_rhi_resource = nullptr;
+        }
+    }
+
+    void RHI_Buffer::DestroyResourceImmediate()
+    {
+        if (m_rhi_resource)
+        {
+            RHI_Device::MemoryBufferDestroy(m_rhi_resource);
+            m_data_gpu = nullptr;
+        }
+    }
+
+    void RHI_Buffer::RHI_CreateResource(const void* data)
+    {
+        RHI_DestroyResource();
+
+        // keep the same strides the real backends end up with, so offsets and sizes match
+        if (m_type == RHI_Buffer_Type::Storage || m_type == RHI_Buffer_Type::Constant)
+        {
+            size_t min_alignment = m_type == RHI_Buffer_Type::Storage ? RHI_Device::PropertyGetMinStorageBufferOffsetAlignment() : RHI_Device::PropertyGetMinUniformBufferOffsetAlignment();
+            if (min_alignment > 0 && min_alignment != m_stride)
+            {
+                m_stride      = static_cast<uint32_t>(static_cast<uint64_t>((m_stride + min_alignment - 1) & ~(min_alignment - 1)));
+                m_object_size = m_stride * m_element_count;
+            }
+        }
+        else if (m_type == RHI_Buffer_Type::ShaderBindingTable)
+        {
+            SP_ASSERT_MSG(false, "Ray tracing is not supported by the null backend");
+            return;
+        }
+
+        RHI_Device::MemoryBufferCreate(m_rhi_resource, m_object_size, 0, 0, data, m_object_name.c_str());
+        if (!m_rhi_resource)
+        {
+            SP_LOG_WARNING("failed to create buffer '%s' (%llu bytes)", m_object_name.c_str(), m_object_size);
+            return;
+        }
+
+        m_data_gpu = m_mappable ? RHI_Device::MemoryGetMappedDataFromBuffer(m_rhi_resource) : nullptr;
+    }
+
+    void RHI_Buffer::UploadSubRegion(const void* data, uint64_t offset_bytes, uint64_t size_bytes)
+    {
+        SP_ASSERT(data != nullptr);
+        SP_ASSERT(offset_bytes + size_bytes <= m_object_size);
+
+        memcpy(static_cast<uint8_t*>(m_rhi_resource) + offset_bytes, data, size_bytes);
+    }
+
+    void RHI_Buffer::Update(RHI_CommandList* cmd_list, void* data_cpu, const uint32_t size)
+    {
+        SP_ASSERT(cmd_list);
+        SP_ASSERT_MSG(m_mappable,                           "Can't update unmapped buffer");
+        SP_ASSERT_MSG(data_cpu != nullptr,                  "Invalid cpu data");
+        SP_ASSERT_MSG(m_data_gpu != nullptr,                "Invalid gpu data");
+        SP_ASSERT_MSG(m_offset + m_stride <= m_object_size, "Out of memory");
+
+        // advance offset
+        if (first_update)
+        {
+            first_update = false;
+        }
+        else
+        {
+            m_offset += m_stride;
+        }
+
+        cmd_list->UpdateBuffer(this, m_offset, size != 0 ? size : m_stride, data_cpu);
+    }
+
+    RHI_StridedDeviceAddressRegion RHI_Buffer::GetRegion(const RHI_Shader_Type group_type, const uint32_t stride_extra /*= 0*/) const
+    {
+        uint64_t offset = 0;
+        if (group_type == RHI_Shader_Type::RayGeneration) offset = m_raygen_offset;
+        else if (group_type == RHI_Shader_Type::RayMiss)  offset = m_miss_offset;
+        else if (group_type == RHI_Shader_Type::RayHit)   offset = m_hit_offset;
+
+        RHI_StridedDeviceAddressRegion region = {};
+        region.device_address                 = m_device_address + offset;
+        region.stride                         = m_aligned_handle_size;
+        region.size                           = m_aligned_handle_size;
+
+        return region;
+    }
+
+    void RHI_Buffer::UpdateHandles(RHI_CommandList* cmd_list)
+    {
+        SP_ASSERT(m_type == RHI_Buffer_Type::ShaderBindingTable);
+    }
+}
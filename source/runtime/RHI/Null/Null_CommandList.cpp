@@ -0,0 +1,948 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "pch.h"
+#include "../RHI_Device.h"
+#include "../RHI_Queue.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Pipeline.h"
+#include "../RHI_Buffer.h"
+#include "../RHI_DescriptorSetLayout.h"
+#include "../RHI_SyncPrimitive.h"
+#include "../RHI_SwapChain.h"
+#include "../RHI_RasterizerState.h"
+#include "../Rendering/Renderer.h"
+#include "../../Profiling/Profiler.h"
+#include "../Core/Debugging.h"
+#include "../Core/Breadcrumbs.h"
+#include "../../XR/Xr.h"
+//=====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan::math;
+//============================
+
+// the null command list records nothing, it runs the same state tracking as the real backends
+// (layouts, barriers, bindings, descriptor sets) and feeds the profiler counters, so cpu cost stays honest
+
+namespace spartan
+{
+    namespace barrier_helpers
+    {
+        unordered_map<void*, array<RHI_Image_Layout, rhi_max_mip_count>> image_layouts;
+        mutex image_layouts_mutex;
+
+        RHI_Image_Layout get_layout(void* image, uint32_t mip_index)
+        {
+            SP_ASSERT(image != nullptr);
+            lock_guard<mutex> lock(image_layouts_mutex);
+
+            auto it = image_layouts.find(image);
+            if (it == image_layouts.end())
+                return RHI_Image_Layout::Max;
+
+            SP_ASSERT(mip_index < rhi_max_mip_count);
+            return it->second[mip_index];
+        }
+
+        void set_layout(void* image, uint32_t mip_index, uint32_t mip_range, RHI_Image_Layout layout)
+        {
+            SP_ASSERT(image != nullptr);
+            SP_ASSERT(mip_index < rhi_max_mip_count);
+            SP_ASSERT(mip_index + mip_range <= rhi_max_mip_count);
+            lock_guard<mutex> lock(image_layouts_mutex);
+
+            auto it = image_layouts.find(image);
+            if (it == image_layouts.end())
+            {
+                array<RHI_Image_Layout, rhi_max_mip_count> layouts;
+                layouts.fill(RHI_Image_Layout::Max);
+                image_layouts[image] = layouts;
+                it = image_layouts.find(image);
+            }
+
+            uint32_t mip_end = min(mip_index + mip_range, rhi_max_mip_count);
+            for (uint32_t i = mip_index; i < mip_end; ++i)
+            {
+                it->second[i] = layout;
+            }
+        }
+
+        void remove_layout(void* image)
+        {
+            lock_guard<mutex> lock(image_layouts_mutex);
+            image_layouts.erase(image);
+        }
+    }
+
+    namespace immediate_execution
+    {
+        static const uint32_t queue_type_count = static_cast<uint32_t>(RHI_Queue_Type::Max);
+
+        array<mutex, queue_type_count> mutexes;
+        array<condition_variable, queue_type_count> condition_vars;
+        array<bool, queue_type_count> is_executing = { false, false, false };
+        array<shared_ptr<RHI_Queue>, queue_type_count> queues;
+        once_flag init_flag;
+
+        void ensure_initialized()
+        {
+            call_once(init_flag, []()
+            {
+                queues[static_cast<uint32_t>(RHI_Queue_Type::Graphics)] = make_shared<RHI_Queue>(RHI_Queue_Type::Graphics, "graphics");
+                queues[static_cast<uint32_t>(RHI_Queue_Type::Compute)]  = make_shared<RHI_Queue>(RHI_Queue_Type::Compute,  "compute");
+                queues[static_cast<uint32_t>(RHI_Queue_Type::Copy)]     = make_shared<RHI_Queue>(RHI_Queue_Type::Copy,     "copy");
+            });
+        }
+    }
+
+    RHI_CommandList::RHI_CommandList(RHI_Queue* queue, void* cmd_pool, const char* name)
+    {
+        m_queue                 = queue;
+        m_object_name           = name;
+        m_rhi_cmd_pool_resource = cmd_pool;
+        m_rhi_resource          = this; // non-owning handle
+
+        // semaphores
+        m_rendering_complete_semaphore          = make_shared<RHI_SyncPrimitive>(RHI_SyncPrimitive_Type::Semaphore, (string(name) + "_binary").c_str());
+        m_rendering_complete_semaphore_timeline = make_shared<RHI_SyncPrimitive>(RHI_SyncPrimitive_Type::SemaphoreTimeline, (string(name) + "timeline").c_str());
+    }
+
+    RHI_CommandList::~RHI_CommandList()
+    {
+        m_rhi_resource = nullptr;
+    }
+
+    void RHI_CommandList::Begin()
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Idle);
+
+        // set states
+        m_state     = RHI_CommandListState::Recording;
+        m_pso       = RHI_PipelineState();
+        m_cull_mode = RHI_CullMode::Max;
+
+        // set dynamic states
+        if (m_queue->GetType() == RHI_Queue_Type::Graphics)
+        {
+            // cull mode
+            SetCullMode(RHI_CullMode::Back);
+
+            // scissor rectangle
+            math::Rectangle scissor_rect;
+            scissor_rect.x      = 0.0f;
+            scissor_rect.y      = 0.0f;
+            scissor_rect.width  = static_cast<float>(m_pso.GetWidth());
+            scissor_rect.height = static_cast<float>(m_pso.GetHeight());
+            SetScissorRectangle(scissor_rect);
+        }
+
+        m_timestamp_index = 0;
+    }
+
+    void RHI_CommandList::Submit(RHI_SyncPrimitive* semaphore_wait, const bool is_immediate, RHI_SyncPrimitive* semaphore_signal /*= nullptr*/,
+                                RHI_SyncPrimitive* semaphore_timeline_wait /*= nullptr*/, uint64_t timeline_wait_value /*= 0*/)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        RenderPassEnd();
+        FlushBarriers();
+
+        m_queue->Submit(
+            m_rhi_resource,
+            0,
+            semaphore_wait,                                // wait semaphore (binary)
+            semaphore_signal,                              // signal semaphore (binary)
+            m_rendering_complete_semaphore_timeline.get(), // signal semaphore (timeline)
+            semaphore_timeline_wait,                       // wait semaphore (timeline, for cross-queue sync)
+            timeline_wait_value                            // value to wait on
+        );
+
+        if (semaphore_wait)
+        {
+            semaphore_wait->SetUserCmdList(this);
+        }
+
+        m_state = RHI_CommandListState::Submitted;
+    }
+
+    void RHI_CommandList::WaitForExecution(const bool log_wait_time /*= false*/)
+    {
+        SP_ASSERT_MSG(m_state == RHI_CommandListState::Submitted, "the command list hasn't been submitted, can't wait for it.");
+
+        // completes at submission, so this never blocks
+        m_rendering_complete_semaphore_timeline->Wait(0);
+        m_state = RHI_CommandListState::Idle;
+    }
+
+    void RHI_CommandList::SetPipelineState(RHI_PipelineState& pso)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // early exit if the pipeline state hasn't changed
+        pso.Prepare();
+        if (m_pso.GetHash() == pso.GetHash())
+            return;
+
+        // determine if the new render pass should clear the render targets or not
+        if ((m_pso.shaders[RHI_Shader_Type::Vertex] != nullptr && m_pso.shaders[RHI_Shader_Type::Vertex] == pso.shaders[RHI_Shader_Type::Vertex]) && m_pso.render_target_array_index == pso.render_target_array_index)
+        {
+            m_load_depth_render_target = (pso.render_target_depth_texture == m_pso.render_target_depth_texture);
+            for (uint32_t i = 0; i < rhi_max_render_target_count; i++)
+            {
+                m_load_color_render_targets[i] = (pso.render_target_color_textures[i] == m_pso.render_target_color_textures[i]);
+            }
+        }
+        else
+        {
+            m_load_depth_render_target = false;
+            for (uint32_t i = 0; i < rhi_max_render_target_count; i++)
+            {
+                m_load_color_render_targets[i] = false;
+            }
+        }
+
+        // get (or create) a pipeline which matches the requested pipeline state
+        m_pso = pso;
+        RHI_Device::GetOrCreatePipeline(m_pso, m_pipeline, m_descriptor_layout_current);
+        SP_ASSERT(m_pipeline != nullptr);
+
+        RenderPassBegin();
+        Profiler::m_rhi_bindings_pipeline++;
+
+        if (m_pso.IsGraphics())
+        {
+            m_cull_mode = RHI_CullMode::Max;
+            SetCullMode(m_pso.rasterizer_state->GetPolygonMode() == RHI_PolygonMode::Wireframe ? RHI_CullMode::None : RHI_CullMode::Back);
+
+            // scissor rectangle
+            math::Rectangle scissor_rect;
+            scissor_rect.x      = 0.0f;
+            scissor_rect.y      = 0.0f;
+            scissor_rect.width  = static_cast<float>(m_pso.GetWidth());
+            scissor_rect.height = static_cast<float>(m_pso.GetHeight());
+            SetScissorRectangle(scissor_rect);
+
+            // vertex and index buffer state
+            m_buffer_id_index    = 0;
+            m_buffer_id_vertex   = 0;
+            m_buffer_id_instance = 0;
+        }
+
+        // set standard resources (dynamic descriptors)
+        Renderer::SetStandardResources(this);
+    }
+
+    RHI_CommandList* RHI_CommandList::ImmediateExecutionBegin(const RHI_Queue_Type queue_type)
+    {
+        if (RHI_Device::IsDeviceLost())
+            return nullptr;
+
+        immediate_execution::ensure_initialized();
+
+        uint32_t qi = static_cast<uint32_t>(queue_type);
+
+        // per-queue lock so different queue types can execute concurrently
+        unique_lock<mutex> lock(immediate_execution::mutexes[qi]);
+        immediate_execution::condition_vars[qi].wait(lock, [qi] { return !immediate_execution::is_executing[qi]; });
+        immediate_execution::is_executing[qi] = true;
+
+        RHI_Queue* queue          = immediate_execution::queues[qi].get();
+        RHI_CommandList* cmd_list = queue->NextCommandList();
+        cmd_list->Begin();
+        return cmd_list;
+    }
+
+    void RHI_CommandList::ImmediateExecutionEnd(RHI_CommandList* cmd_list)
+    {
+        cmd_list->Submit(nullptr, true);
+        cmd_list->WaitForExecution();
+
+        uint32_t qi = static_cast<uint32_t>(cmd_list->GetQueue()->GetType());
+        immediate_execution::is_executing[qi] = false;
+        immediate_execution::condition_vars[qi].notify_one();
+    }
+
+    void RHI_CommandList::ImmediateExecutionShutdown()
+    {
+        for (uint32_t i = 0; i < immediate_execution::queue_type_count; i++)
+        {
+            unique_lock<mutex> lock(immediate_execution::mutexes[i]);
+            immediate_execution::condition_vars[i].wait(lock, [i] { return !immediate_execution::is_executing[i]; });
+        }
+
+        immediate_execution::queues.fill(nullptr);
+    }
+
+    void RHI_CommandList::RenderPassBegin()
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        RenderPassEnd();
+
+        if (!m_pso.IsGraphics())
+            return;
+
+        // color attachments
+        if (RHI_SwapChain* swapchain = m_pso.render_target_swapchain)
+        {
+            InsertBarrier(swapchain->GetRhiRt(), swapchain->GetFormat(), 0, 1, 1, RHI_Image_Layout::Attachment);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < rhi_max_render_target_count; i++)
+            {
+                RHI_Texture* rt = m_pso.render_target_color_textures[i];
+                if (rt == nullptr)
+                    break;
+
+                SP_ASSERT_MSG(rt->IsRtv(), "The texture wasn't created with the RHI_Texture_RenderTarget flag and/or isn't a color format");
+                rt->SetLayout(RHI_Image_Layout::Attachment, this);
+            }
+        }
+
+        // depth-stencil attachment
+        if (RHI_Texture* rt = m_pso.render_target_depth_texture)
+        {
+            SP_ASSERT(rt->IsDsv());
+            rt->SetLayout(RHI_Image_Layout::Attachment, this);
+        }
+
+        // variable rate shading
+        if (m_pso.vrs_input_texture)
+        {
+            m_pso.vrs_input_texture->SetLayout(RHI_Image_Layout::Shading_Rate_Attachment, this);
+        }
+
+        FlushBarriers();
+
+        // set viewport
+        RHI_Viewport viewport;
+        viewport.width  = static_cast<float>(m_pso.GetWidth());
+        viewport.height = static_cast<float>(m_pso.GetHeight());
+        SetViewport(viewport);
+
+        // reset
+        m_load_depth_render_target = false;
+        for (uint32_t i = 0; i < rhi_max_render_target_count; i++)
+        {
+            m_load_color_render_targets[i] = false;
+        }
+        m_render_pass_active = true;
+    }
+
+    void* RHI_CommandList::GetRhiResourcePipeline()
+    {
+        return m_pipeline->GetRhiResource();
+    }
+
+    void RHI_CommandList::RenderPassEnd()
+    {
+        m_render_pass_active = false;
+    }
+
+    void RHI_CommandList::ClearPipelineStateRenderTargets(RHI_PipelineState& pipeline_state)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+    }
+
+    void RHI_CommandList::ClearTexture(
+        RHI_Texture* texture,
+        const Color& clear_color     /*= rhi_color_load*/,
+        const float clear_depth      /*= rhi_depth_load*/,
+        const uint32_t clear_stencil /*= rhi_stencil_load*/
+    )
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT_MSG((texture->GetFlags() & RHI_Texture_ClearBlit) != 0, "The texture needs the RHI_Texture_ClearBlit flag");
+        SP_ASSERT(texture && texture->GetRhiSrv());
+
+        // one of the required layouts for clear functions
+        texture->SetLayout(RHI_Image_Layout::Transfer_Destination, this);
+    }
+
+    void RHI_CommandList::Draw(const uint32_t vertex_count, const uint32_t vertex_start_index /*= 0*/)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        PreDraw();
+        Profiler::m_rhi_draw++;
+    }
+
+    void RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_index, const uint32_t instance_count)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        PreDraw();
+        Profiler::m_rhi_draw++;
+        Profiler::m_rhi_instance_count += instance_count == 1 ? 0 : instance_count;
+    }
+
+    void RHI_CommandList::DrawIndexedIndirectCount(RHI_Buffer* args_buffer, const uint32_t args_offset, RHI_Buffer* count_buffer, const uint32_t count_offset, const uint32_t max_draw_count)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT(args_buffer  != nullptr);
+        SP_ASSERT(count_buffer != nullptr);
+
+        PreDraw();
+        Profiler::m_rhi_draw++;
+    }
+
+    void RHI_CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z /*= 1*/)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        PreDraw();
+    }
+
+    void RHI_CommandList::TraceRays(const uint32_t width, const uint32_t height)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // skip if dimensions are invalid (can happen during window minimize/resize)
+        if (width == 0 || height == 0)
+            return;
+
+        PreDraw();
+    }
+
+    void RHI_CommandList::Blit(RHI_Texture* source, RHI_Texture* destination, const bool blit_mips, const float source_scaling)
+    {
+        SP_ASSERT_MSG(source && destination,                                  "Source and destination textures cannot be null");
+        SP_ASSERT_MSG((source->GetFlags() & RHI_Texture_ClearBlit) != 0,      "Blit requires the texture to be created with the RHI_Texture_ClearOrBlit flag");
+        SP_ASSERT_MSG((destination->GetFlags() & RHI_Texture_ClearBlit) != 0, "Blit requires the texture to be created with the RHI_Texture_ClearOrBlit flag");
+        if (blit_mips)
+        {
+            SP_ASSERT_MSG(source->GetMipCount() == destination->GetMipCount(), "If the mips are blitted, then the mip count between the source and the destination textures must match");
+        }
+
+        // save the initial layouts
+        array<RHI_Image_Layout, rhi_max_mip_count> layouts_initial_source      = source->GetLayouts();
+        array<RHI_Image_Layout, rhi_max_mip_count> layouts_initial_destination = destination->GetLayouts();
+
+        // transition to blit appropriate layouts
+        source->SetLayout(RHI_Image_Layout::Transfer_Source, this);
+        destination->SetLayout(RHI_Image_Layout::Transfer_Destination, this);
+
+        // transition to the initial layouts
+        if (blit_mips)
+        {
+            for (uint32_t i = 0; i < source->GetMipCount(); i++)
+            {
+                source->SetLayout(layouts_initial_source[i], this, i, 1);
+                destination->SetLayout(layouts_initial_destination[i], this, i, 1);
+            }
+        }
+        else
+        {
+            source->SetLayout(layouts_initial_source[0], this);
+            destination->SetLayout(layouts_initial_destination[0], this);
+        }
+    }
+
+    void RHI_CommandList::Blit(RHI_Texture* source, RHI_SwapChain* destination)
+    {
+        SP_ASSERT_MSG((source->GetFlags() & RHI_Texture_ClearBlit) != 0, "The texture needs the RHI_Texture_ClearOrBlit flag");
+        SP_ASSERT_MSG(source->GetWidth() <= destination->GetWidth() && source->GetHeight() <= destination->GetHeight(),
+            "The source texture dimension(s) are larger than the those of the destination texture");
+
+        RHI_Image_Layout source_layout_initial = source->GetLayout(0);
+        source->SetLayout(RHI_Image_Layout::Transfer_Source, this);
+        InsertBarrier(destination->GetRhiRt(), destination->GetFormat(), 0, 1, 1, RHI_Image_Layout::Transfer_Destination);
+
+        source->SetLayout(source_layout_initial, this);
+        InsertBarrier(destination->GetRhiRt(), destination->GetFormat(), 0, 1, 1, RHI_Image_Layout::Present_Source);
+    }
+
+    void RHI_CommandList::BlitToXrSwapchain(RHI_Texture* source)
+    {
+        if (!Xr::IsSessionRunning())
+            return;
+    }
+
+    void RHI_CommandList::Copy(RHI_Texture* source, RHI_Texture* destination, const bool blit_mips)
+    {
+        SP_ASSERT_MSG((source->GetFlags() & RHI_Texture_ClearBlit) != 0, "The texture needs the RHI_Texture_ClearOrBlit flag");
+        SP_ASSERT_MSG((destination->GetFlags() & RHI_Texture_ClearBlit) != 0, "The texture needs the RHI_Texture_ClearOrBlit flag");
+        SP_ASSERT(source->GetWidth() == destination->GetWidth());
+        SP_ASSERT(source->GetHeight() == destination->GetHeight());
+        SP_ASSERT(source->GetFormat() == destination->GetFormat());
+
+        // save the initial layouts
+        array<RHI_Image_Layout, rhi_max_mip_count> layouts_initial_source      = source->GetLayouts();
+        array<RHI_Image_Layout, rhi_max_mip_count> layouts_initial_destination = destination->GetLayouts();
+
+        // transition to copy appropriate layouts
+        source->SetLayout(RHI_Image_Layout::Transfer_Source, this);
+        destination->SetLayout(RHI_Image_Layout::Transfer_Destination, this);
+
+        // transition to the initial layouts
+        if (blit_mips)
+        {
+            for (uint32_t i = 0; i < source->GetMipCount(); i++)
+            {
+                source->SetLayout(layouts_initial_source[i], this, i, 1);
+                destination->SetLayout(layouts_initial_destination[i], this, i, 1);
+            }
+        }
+        else
+        {
+            source->SetLayout(layouts_initial_source[0], this);
+            destination->SetLayout(layouts_initial_destination[0], this);
+        }
+    }
+
+    void RHI_CommandList::Copy(RHI_Texture* source, RHI_SwapChain* destination)
+    {
+        SP_ASSERT_MSG((source->GetFlags() & RHI_Texture_ClearBlit) != 0, "The texture needs the RHI_Texture_ClearOrBlit flag");
+        SP_ASSERT(source->GetWidth() == destination->GetWidth());
+        SP_ASSERT(source->GetHeight() == destination->GetHeight());
+        SP_ASSERT(source->GetFormat() == destination->GetFormat());
+
+        RHI_Image_Layout layout_initial_source = source->GetLayout(0);
+        source->SetLayout(RHI_Image_Layout::Transfer_Source, this);
+        InsertBarrier(destination->GetRhiRt(), destination->GetFormat(), 0, 1, 1, RHI_Image_Layout::Transfer_Destination);
+
+        source->SetLayout(layout_initial_source, this);
+        InsertBarrier(destination->GetRhiRt(), destination->GetFormat(), 0, 1, 1, RHI_Image_Layout::Present_Source);
+    }
+
+    void RHI_CommandList::SetViewport(const RHI_Viewport& viewport) const
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT(viewport.width != 0);
+        SP_ASSERT(viewport.height != 0);
+    }
+
+    void RHI_CommandList::SetScissorRectangle(const math::Rectangle& scissor_rectangle) const
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+    }
+
+    void RHI_CommandList::SetCullMode(const RHI_CullMode cull_mode)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        m_cull_mode = cull_mode;
+    }
+
+    void RHI_CommandList::SetBufferVertex(const RHI_Buffer* vertex, RHI_Buffer* instance)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // the instance buffer is optional but always part of the pipeline therefore it can't be null
+        if (!instance)
+        {
+            instance = Renderer::GetBuffer(Renderer_Buffer::DummyInstance);
+        }
+        SP_ASSERT(vertex->GetRhiResource() != nullptr && instance->GetRhiResource() != nullptr);
+
+        if (m_buffer_id_vertex != vertex->GetObjectId() || m_buffer_id_instance != instance->GetObjectId())
+        {
+            m_buffer_id_vertex   = vertex->GetObjectId();
+            m_buffer_id_instance = instance->GetObjectId();
+            Profiler::m_rhi_bindings_buffer_vertex++;
+        }
+    }
+
+    void RHI_CommandList::SetBufferIndex(const RHI_Buffer* buffer)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT(buffer != nullptr);
+        SP_ASSERT(buffer->GetRhiResource() != nullptr);
+
+        if (m_buffer_id_index == buffer->GetObjectId())
+            return;
+
+        m_buffer_id_index = buffer->GetObjectId();
+        Profiler::m_rhi_bindings_buffer_index++;
+    }
+
+    void RHI_CommandList::PushConstants(const uint32_t offset, const uint32_t size, const void* data)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+        SP_ASSERT(size <= RHI_Device::PropertyGetMaxPushConstantSize());
+        SP_ASSERT(m_pipeline != nullptr);
+    }
+
+    void RHI_CommandList::SetConstantBuffer(const uint32_t slot, RHI_Buffer* constant_buffer) const
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (!m_descriptor_layout_current)
+            return;
+
+        m_descriptor_layout_current->SetConstantBuffer(slot, constant_buffer);
+    }
+
+    void RHI_CommandList::SetTexture(const uint32_t slot, RHI_Texture* texture, const uint32_t mip_index /*= all_mips*/, uint32_t mip_range /*= 0*/, const bool uav /*= false*/)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (mip_index != rhi_all_mips)
+        {
+            SP_ASSERT_MSG(mip_range != 0, "If a mip was specified, then mip_range can't be 0");
+        }
+
+        if (!m_descriptor_layout_current)
+            return;
+
+        // if the texture is null or it's still loading, ignore it
+        if (!texture || texture->GetResourceState() != ResourceState::PreparedForGpu)
+            return;
+
+        // get some texture info
+        const uint32_t mip_count        = texture->GetMipCount();
+        const bool mip_specified        = mip_index != rhi_all_mips;
+        const uint32_t mip_start        = mip_specified ? mip_index : 0;
+        RHI_Image_Layout current_layout = texture->GetLayout(mip_start);
+        SP_ASSERT_MSG(current_layout != RHI_Image_Layout::Max && current_layout != RHI_Image_Layout::Preinitialized, "Invalid layout");
+
+        // transition to appropriate layout (if needed)
+        {
+            RHI_Image_Layout target_layout = RHI_Image_Layout::Max;
+            if (uav)
+            {
+                SP_ASSERT(texture->IsUav());
+                target_layout = RHI_Image_Layout::General;
+            }
+            else
+            {
+                SP_ASSERT(texture->IsSrv());
+                target_layout = RHI_Image_Layout::Shader_Read;
+            }
+
+            bool transition_required = current_layout != target_layout;
+            array<RHI_Image_Layout, rhi_max_mip_count> layouts = texture->GetLayouts();
+            for (uint32_t i = mip_start; i < mip_count && !transition_required; i++)
+            {
+                transition_required = target_layout != layouts[i];
+            }
+
+            if (transition_required)
+            {
+                texture->SetLayout(target_layout, this, mip_index, mip_range);
+            }
+        }
+
+        m_descriptor_layout_current->SetTexture(slot, texture, mip_index, mip_range);
+    }
+
+    void RHI_CommandList::SetAccelerationStructure(Renderer_BindingsSrv slot, RHI_AccelerationStructure* tlas)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (m_descriptor_layout_current)
+        {
+            m_descriptor_layout_current->SetAccelerationStructure(static_cast<uint32_t>(slot), tlas);
+        }
+    }
+
+    void RHI_CommandList::SetBuffer(const uint32_t slot, RHI_Buffer* buffer) const
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        if (!m_descriptor_layout_current)
+            return;
+
+        m_descriptor_layout_current->SetBuffer(slot, buffer);
+    }
+
+    void RHI_CommandList::BeginMarker(const char* name)
+    {
+        if (Debugging::IsBreadcrumbsEnabled())
+        {
+            Breadcrumbs::BeginMarker(name);
+        }
+    }
+
+    void RHI_CommandList::EndMarker()
+    {
+        if (Debugging::IsBreadcrumbsEnabled())
+        {
+            Breadcrumbs::EndMarker();
+        }
+    }
+
+    void RHI_CommandList::WriteGpuBreadcrumb(RHI_Buffer* buffer, uint32_t slot, uint32_t value)
+    {
+        SP_ASSERT(buffer && buffer->GetRhiResource());
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // there is no gpu timeline, so the value lands straight in host memory
+        UpdateBuffer(buffer, slot * sizeof(uint32_t), sizeof(uint32_t), &value);
+    }
+
+    uint32_t RHI_CommandList::BeginTimestamp()
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        return m_timestamp_index++;
+    }
+
+    void RHI_CommandList::EndTimestamp()
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        m_timestamp_index++;
+    }
+
+    float RHI_CommandList::GetTimestampResult(const uint32_t index_timestamp)
+    {
+        SP_ASSERT_MSG(index_timestamp + 1 < m_timestamp_data.size(), "index out of range");
+        return 0.0f;
+    }
+
+    float RHI_CommandList::GetTimestampStartMs(const uint32_t index_timestamp)
+    {
+        SP_ASSERT_MSG(index_timestamp < m_timestamp_data.size(), "index out of range");
+        return 0.0f;
+    }
+
+    void RHI_CommandList::ReadbackTimestampsForProfiler()
+    {
+        if (m_state == RHI_CommandListState::Submitted)
+        {
+            WaitForExecution();
+        }
+    }
+
+    void RHI_CommandList::BeginOcclusionQuery(const uint64_t entity_id)
+    {
+        SP_ASSERT_MSG(m_pso.IsGraphics(), "Occlusion queries are only supported in graphics pipelines");
+    }
+
+    void RHI_CommandList::EndOcclusionQuery()
+    {
+
+    }
+
+    bool RHI_CommandList::GetOcclusionQueryResult(const uint64_t entity_id)
+    {
+        // nothing is ever occluded
+        return false;
+    }
+
+    void RHI_CommandList::UpdateOcclusionQueries()
+    {
+
+    }
+
+    void RHI_CommandList::BeginTimeblock(const char* name, const bool gpu_marker, const bool gpu_timing)
+    {
+        SP_ASSERT(name != nullptr);
+
+        // cpu timing only, there is no gpu to time
+        RHI_Queue_Type queue_type = m_queue ? m_queue->GetType() : RHI_Queue_Type::Max;
+        Profiler::TimeBlockStart(name, TimeBlockType::Cpu, this, queue_type);
+
+        m_active_timeblocks.push({ name, false });
+    }
+
+    void RHI_CommandList::EndTimeblock()
+    {
+        SP_ASSERT(!m_active_timeblocks.empty());
+
+        Profiler::TimeBlockEnd(); // cpu
+        m_active_timeblocks.pop();
+    }
+
+    void RHI_CommandList::UpdateBuffer(RHI_Buffer* buffer, const uint64_t offset, const uint64_t size, const void* data)
+    {
+        SP_ASSERT(buffer);
+        SP_ASSERT(size);
+        SP_ASSERT(data);
+        SP_ASSERT(offset + size <= buffer->GetObjectSize());
+        SP_ASSERT(offset % 4 == 0);
+        SP_ASSERT(size % 4 == 0);
+
+        RenderPassEnd();
+
+        memcpy(static_cast<uint8_t*>(buffer->GetRhiResource()) + offset, data, static_cast<size_t>(size));
+        Profiler::m_rhi_pipeline_barriers++;
+    }
+
+    void RHI_CommandList::InsertBarrier(const RHI_Barrier& barrier)
+    {
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        switch (barrier.type)
+        {
+            case RHI_Barrier::Type::ImageLayout:
+            {
+                // get image and format from either texture or raw handle
+                void* image           = barrier.texture ? barrier.texture->GetRhiResource() : barrier.image;
+                uint32_t array_length = barrier.texture ? barrier.texture->GetArrayLength() : barrier.array_length;
+                uint32_t mip_count    = barrier.texture ? barrier.texture->GetMipCount() : rhi_max_mip_count;
+                SP_ASSERT(image != nullptr);
+
+                // handle mip specification
+                bool mip_specified = barrier.mip_index != rhi_all_mips;
+                uint32_t mip_index = mip_specified ? barrier.mip_index : 0;
+                uint32_t mip_range = mip_specified ? barrier.mip_range : mip_count;
+                SP_ASSERT(mip_index < rhi_max_mip_count);
+                SP_ASSERT(mip_index + mip_range <= rhi_max_mip_count);
+
+                // early exit if all mips match target layout
+                RHI_Image_Layout first_layout = barrier_helpers::get_layout(image, mip_index);
+                bool all_mips_match           = true;
+                for (uint32_t i = 0; i < mip_range && all_mips_match; i++)
+                {
+                    all_mips_match = barrier_helpers::get_layout(image, mip_index + i) == barrier.layout;
+                }
+
+                if (all_mips_match)
+                    return;
+
+                // defer barriers and batch them (if eligible)
+                bool immediate = first_layout == RHI_Image_Layout::Max                  ||
+                                 first_layout == RHI_Image_Layout::Preinitialized       ||
+                                 first_layout == RHI_Image_Layout::Transfer_Source      || barrier.layout == RHI_Image_Layout::Transfer_Source      ||
+                                 first_layout == RHI_Image_Layout::Transfer_Destination || barrier.layout == RHI_Image_Layout::Transfer_Destination ||
+                                 first_layout == RHI_Image_Layout::Present_Source       || barrier.layout == RHI_Image_Layout::Present_Source;
+
+                if (!m_render_pass_active && !immediate)
+                {
+                    PendingBarrierInfo pending = {};
+                    pending.barrier            = barrier;
+                    pending.image              = image;
+                    pending.mip_index          = mip_index;
+                    pending.mip_range          = mip_range;
+                    pending.array_length       = array_length;
+                    pending.layout_old         = first_layout;
+                    pending.layout_new         = barrier.layout;
+                    m_pending_barriers.push_back(pending);
+                }
+                else
+                {
+                    RenderPassEnd();
+                    Profiler::m_rhi_pipeline_barriers++;
+                }
+
+                barrier_helpers::set_layout(image, mip_index, mip_range, barrier.layout);
+                break;
+            }
+
+            case RHI_Barrier::Type::ImageSync:
+            {
+                SP_ASSERT(barrier.texture != nullptr);
+
+                PendingBarrierInfo pending = {};
+                pending.barrier            = barrier;
+                pending.image              = barrier.texture->GetRhiResource();
+                m_pending_barriers.push_back(pending);
+                break;
+            }
+
+            case RHI_Barrier::Type::BufferSync:
+            {
+                SP_ASSERT(barrier.buffer != nullptr);
+
+                PendingBarrierInfo pending = {};
+                pending.barrier            = barrier;
+                m_pending_barriers.push_back(pending);
+                break;
+            }
+        }
+    }
+
+    void RHI_CommandList::FlushBarriers()
+    {
+        if (m_pending_barriers.empty())
+            return;
+
+        RenderPassEnd();
+        Profiler::m_rhi_pipeline_barriers++;
+        m_pending_barriers.clear();
+    }
+
+    // convenience overloads
+    void RHI_CommandList::InsertBarrier(RHI_Texture* texture, RHI_Image_Layout layout, uint32_t mip, uint32_t mip_range)
+    {
+        InsertBarrier(RHI_Barrier::image_layout(texture, layout, mip, mip_range));
+    }
+
+    void RHI_CommandList::InsertBarrier(RHI_Texture* texture, RHI_BarrierType sync_type)
+    {
+        InsertBarrier(RHI_Barrier::image_sync(texture, sync_type));
+    }
+
+    void RHI_CommandList::InsertBarrier(RHI_Buffer* buffer)
+    {
+        InsertBarrier(RHI_Barrier::buffer_sync(buffer));
+    }
+
+    void RHI_CommandList::InsertBarrier(void* image, RHI_Format format, uint32_t mip_index, uint32_t mip_range, uint32_t array_length, RHI_Image_Layout layout)
+    {
+        InsertBarrier(RHI_Barrier::image_layout(image, format, mip_index, mip_range, array_length, layout));
+    }
+
+    void RHI_CommandList::RemoveLayout(void* image)
+    {
+        barrier_helpers::remove_layout(image);
+    }
+
+    RHI_Image_Layout RHI_CommandList::GetImageLayout(void* image, const uint32_t mip_index)
+    {
+        return barrier_helpers::get_layout(image, mip_index);
+    }
+
+    void RHI_CommandList::CopyTextureToBuffer(RHI_Texture* source, RHI_Buffer* destination)
+    {
+        SP_ASSERT_MSG(source && destination, "Invalid source/destination");
+        SP_ASSERT_MSG(source->GetWidth() && source->GetHeight(), "Source must have valid dimensions");
+
+        InsertBarrier(source->GetRhiResource(), source->GetFormat(), 0, 1, 1, RHI_Image_Layout::Transfer_Source);
+        InsertBarrier(source->GetRhiResource(), source->GetFormat(), 0, 1, 1, RHI_Image_Layout::Shader_Read);
+    }
+
+    void RHI_CommandList::CopyBufferToBuffer(void* source, RHI_Buffer* destination, uint64_t size)
+    {
+        SP_ASSERT(source && destination && size > 0);
+
+        // both sides are host memory
+        memcpy(destination->GetRhiResource(), source, static_cast<size_t>(size));
+    }
+
+    void RHI_CommandList::CopyBufferToBuffer(RHI_Buffer* source, RHI_Buffer* destination, uint64_t size)
+    {
+        SP_ASSERT(source && destination && size > 0);
+
+        memcpy(destination->GetRhiResource(), source->GetRhiResource(), static_cast<size_t>(size));
+    }
+
+    void RHI_CommandList::PreDraw()
+    {
+        FlushBarriers();
+
+        if (!m_render_pass_active && m_pso.IsGraphics())
+        {
+            RenderPassBegin();
+        }
+
+        // resolve the descriptor set the same way a real backend would before binding it
+        if (m_descriptor_layout_current)
+        {
+            m_descriptor_layout_current->GetOrCreateDescriptorSet();
+        }
+    }
+}
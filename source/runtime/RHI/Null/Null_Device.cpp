@@ -0,0 +1,590 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "pch.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Core/Timer.h"
+#include "../Rendering/Renderer.h"
+#include "../RHI_Device.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Queue.h"
+#include "../RHI_DescriptorSet.h"
+#include "../RHI_Shader.h"
+#include "../RHI_DescriptorSetLayout.h"
+#include "../RHI_Pipeline.h"
+#include "../RHI_Texture.h"
+//=====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan::math;
+//============================
+
+namespace spartan
+{
+    namespace
+    {
+        mutex mutex_deletion_queue;
+        unordered_map<RHI_Resource_Type, vector<void*>> deletion_queue;
+    }
+
+    namespace queues
+    {
+        array<shared_ptr<RHI_Queue>, static_cast<uint32_t>(RHI_Queue_Type::Max)> regular; // graphics, compute, and copy
+
+        void destroy()
+        {
+            regular.fill(nullptr);
+        }
+    }
+
+    // buffers and textures are plain 64-byte aligned host blocks
+    namespace host_memory
+    {
+        constexpr size_t alignment     = 64;
+        constexpr uint64_t nominal_mb  = 8192;
+        mutex allocations_mutex;
+        unordered_map<void*, uint64_t> allocations; // block -> size reported to the memory stats
+        atomic<uint64_t> bytes_allocated = 0;
+
+        void* allocate(const uint64_t size_real, const uint64_t size_reported, const void* data)
+        {
+            const size_t size = static_cast<size_t>(max<uint64_t>(size_real, 1));
+            void* block       = ::operator new(size, align_val_t(alignment));
+            if (data)
+            {
+                memcpy(block, data, static_cast<size_t>(size_real));
+            }
+            else
+            {
+                memset(block, 0, size);
+            }
+
+            lock_guard<mutex> lock(allocations_mutex);
+            allocations[block] = size_reported;
+            bytes_allocated   += size_reported;
+
+            return block;
+        }
+
+        void free(void*& block)
+        {
+            if (!block)
+                return;
+
+            {
+                lock_guard<mutex> lock(allocations_mutex);
+                auto it = allocations.find(block);
+                if (it == allocations.end())
+                    return;
+
+                bytes_allocated -= it->second;
+                allocations.erase(it);
+            }
+
+            ::operator delete(block, align_val_t(alignment));
+            block = nullptr;
+        }
+
+        uint64_t texture_size(RHI_Texture* texture)
+        {
+            uint64_t size         = 0;
+            uint32_t array_length = texture->GetArrayLength();
+            bool is_3d            = texture->GetType() == RHI_Texture_Type::Type3D;
+            for (uint32_t array_index = 0; array_index < array_length; array_index++)
+            {
+                for (uint32_t mip_index = 0; mip_index < texture->GetMipCount(); mip_index++)
+                {
+                    const uint32_t mip_width  = max(1u, texture->GetWidth() >> mip_index);
+                    const uint32_t mip_height = max(1u, texture->GetHeight() >> mip_index);
+                    const uint32_t mip_depth  = is_3d ? max(1u, texture->GetDepth() >> mip_index) : 1;
+
+                    size += RHI_Texture::CalculateMipSize(mip_width, mip_height, mip_depth, texture->GetFormat(), texture->GetBitsPerChannel(), texture->GetChannelCount());
+                }
+            }
+
+            return size;
+        }
+    }
+
+    namespace descriptors
+    {
+        mutex descriptor_pipeline_mutex;
+
+        // cache
+        unordered_map<uint64_t, RHI_DescriptorSet> sets;
+        unordered_map<uint64_t, shared_ptr<RHI_DescriptorSetLayout>> layouts;
+        unordered_map<uint64_t, shared_ptr<RHI_Pipeline>> pipelines;
+
+        // descriptor sets are counters, nothing is ever dereferenced
+        atomic<uint64_t> set_handle = 0;
+
+        shared_ptr<RHI_DescriptorSetLayout> get_or_create_descriptor_set_layout(RHI_PipelineState& pipeline_state)
+        {
+            // shaders are never reflected, so every layout is empty and the hash only separates pipeline types
+            uint64_t hash = 0;
+            hash = rhi_hash_combine(hash, static_cast<uint64_t>(pipeline_state.IsCompute()));
+            hash = rhi_hash_combine(hash, static_cast<uint64_t>(pipeline_state.IsGraphics()));
+            hash = rhi_hash_combine(hash, static_cast<uint64_t>(pipeline_state.IsRayTracing()));
+
+            auto it     = layouts.find(hash);
+            bool cached = it != layouts.end();
+            if (!cached)
+            {
+                it = layouts.emplace(make_pair(hash, make_shared<RHI_DescriptorSetLayout>(nullptr, 0, pipeline_state.name))).first;
+            }
+            shared_ptr<RHI_DescriptorSetLayout> descriptor_set_layout = it->second;
+
+            if (cached)
+            {
+                descriptor_set_layout->ClearBindings();
+            }
+
+            return descriptor_set_layout;
+        }
+
+        void release()
+        {
+            sets.clear();
+            layouts.clear();
+            pipelines.clear();
+        }
+    }
+
+    // what the backend exists for, the cpu cost of a frame without a gpu in the way
+    namespace frame_report
+    {
+        constexpr uint32_t frames_per_report = 1000;
+        double time_ms_window                = 0.0;
+        double time_ms_total                 = 0.0;
+        uint32_t frames_window               = 0;
+        uint64_t frames_total                = 0;
+
+        void log(const char* label, const double time_ms, const uint64_t frames)
+        {
+            if (frames == 0)
+                return;
+
+            double average_ms = time_ms / static_cast<double>(frames);
+            SP_LOG_INFO("Null RHI, %s: %.3f ms average cpu frame time over %llu frames (%.1f fps)", label, average_ms, frames, average_ms > 0.0 ? 1000.0 / average_ms : 0.0);
+        }
+    }
+
+    void RHI_Device::Initialize()
+    {
+        RHI_Context::api_version_cstr = "1.0";
+
+        // physical device
+        {
+            RHI_Device::PhysicalDeviceRegister(RHI_PhysicalDevice
+            (
+                0,                                        // api version
+                0,                                        // driver version
+                nullptr,                                  // driver info
+                0,                                        // vendor id
+                RHI_PhysicalDevice_Type::Cpu,             // type
+                "Null",                                   // name
+                host_memory::nominal_mb * 1024ull * 1024, // memory
+                nullptr                                   // data
+            ));
+            RHI_Device::PhysicalDeviceSetPrimary(0);
+        }
+
+        // properties, generous enough that no limit is ever hit
+        {
+            m_timestamp_period                         = 1.0f;
+            m_min_uniform_buffer_offset_alignment      = 256;
+            m_min_storage_buffer_offset_alignment      = 256;
+            m_min_acceleration_buffer_offset_alignment = 256;
+            m_max_texture_1d_dimension                 = 16384;
+            m_max_texture_2d_dimension                 = 16384;
+            m_max_texture_3d_dimension                 = 2048;
+            m_max_texture_cube_dimension               = 16384;
+            m_max_texture_array_layers                 = 2048;
+            m_max_push_constant_size                   = 256;
+            m_max_shading_rate_texel_size_x            = 0;
+            m_max_shading_rate_texel_size_y            = 0;
+            m_optimal_buffer_copy_offset_alignment     = 256;
+            m_shader_group_handle_size                 = 32;
+            m_shader_group_handle_alignment            = 32;
+            m_shader_group_base_alignment              = 64;
+            m_is_shading_rate_supported                = false;
+            m_xess_supported                           = false;
+            m_is_ray_tracing_supported                 = false;
+        }
+
+        // create queues
+        {
+            queues::regular[static_cast<uint32_t>(RHI_Queue_Type::Graphics)] = make_shared<RHI_Queue>(RHI_Queue_Type::Graphics, "graphics");
+            queues::regular[static_cast<uint32_t>(RHI_Queue_Type::Compute)]  = make_shared<RHI_Queue>(RHI_Queue_Type::Compute,  "compute");
+            queues::regular[static_cast<uint32_t>(RHI_Queue_Type::Copy)]     = make_shared<RHI_Queue>(RHI_Queue_Type::Copy,     "copy");
+        }
+
+        Profiler::m_rhi_descriptor_set_count = 0;
+    }
+
+    void RHI_Device::Tick(const uint64_t frame_count)
+    {
+        double delta_time_ms = Timer::GetDeltaTimeMs();
+        frame_report::time_ms_window += delta_time_ms;
+        frame_report::time_ms_total  += delta_time_ms;
+        frame_report::frames_window++;
+        frame_report::frames_total++;
+
+        if (frame_report::frames_window == frame_report::frames_per_report)
+        {
+            frame_report::log("last frames", frame_report::time_ms_window, frame_report::frames_window);
+            frame_report::time_ms_window = 0.0;
+            frame_report::frames_window  = 0;
+        }
+    }
+
+    void RHI_Device::Destroy()
+    {
+        frame_report::log("session", frame_report::time_ms_total, frame_report::frames_total);
+
+        // destroy queues
+        QueueWaitAll();
+        queues::destroy();
+
+        // descriptors
+        descriptors::release();
+
+        // the destructor of all the resources enqueues their memory for de-allocation
+        RHI_Device::DeletionQueueParse();
+
+        if (host_memory::bytes_allocated != 0)
+        {
+            SP_LOG_WARNING("%llu bytes of host memory were never released", host_memory::bytes_allocated.load());
+        }
+    }
+
+    // queues
+
+    uint32_t RHI_Device::GetQueueIndex(const RHI_Queue_Type type)
+    {
+        return static_cast<uint32_t>(type);
+    }
+
+    RHI_Queue* RHI_Device::GetQueue(const RHI_Queue_Type type)
+    {
+        if (type == RHI_Queue_Type::Graphics)
+            return queues::regular[static_cast<uint32_t>(RHI_Queue_Type::Graphics)].get();
+
+        if (type == RHI_Queue_Type::Compute)
+            return queues::regular[static_cast<uint32_t>(RHI_Queue_Type::Compute)].get();
+
+        return nullptr;
+    }
+
+    void* RHI_Device::GetQueueRhiResource(const RHI_Queue_Type type)
+    {
+        if (type == RHI_Queue_Type::Max)
+            return nullptr;
+
+        return queues::regular[static_cast<uint32_t>(type)].get();
+    }
+
+    void RHI_Device::QueueWaitAll(const bool flush)
+    {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(RHI_Queue_Type::Max); i++)
+        {
+            if (queues::regular[i])
+            {
+                queues::regular[i]->Wait(flush);
+            }
+        }
+    }
+
+    // deletion queue
+
+    void RHI_Device::DeletionQueueAdd(const RHI_Resource_Type resource_type, void* resource)
+    {
+        if (!resource)
+            return;
+
+        lock_guard<mutex> guard(mutex_deletion_queue);
+        deletion_queue[resource_type].emplace_back(resource);
+    }
+
+    void RHI_Device::DeletionQueueParse()
+    {
+        lock_guard<mutex> guard(mutex_deletion_queue);
+
+        for (auto& it : deletion_queue)
+        {
+            RHI_Resource_Type resource_type = it.first;
+
+            for (uint32_t i = 0; i < static_cast<uint32_t>(it.second.size()); i++)
+            {
+                void* resource = it.second[i];
+
+                // only images and buffers own memory, everything else is a non-owning handle
+                if (resource_type == RHI_Resource_Type::Image)
+                {
+                    MemoryTextureDestroy(resource);
+                }
+                else if (resource_type == RHI_Resource_Type::Buffer)
+                {
+                    MemoryBufferDestroy(resource);
+                }
+
+                // delete descriptor sets which are now invalid (because they are referring to a deleted resource)
+                if (resource_type == RHI_Resource_Type::ImageView || resource_type == RHI_Resource_Type::Buffer)
+                {
+                    for (auto it = descriptors::sets.begin(); it != descriptors::sets.end();)
+                    {
+                        if (it->second.IsReferingToResource(resource))
+                        {
+                            it = descriptors::sets.erase(it);
+                        }
+                        else
+                        {
+                            ++it;
+                        }
+                    }
+                }
+            }
+        }
+
+        deletion_queue.clear();
+    }
+
+    bool RHI_Device::DeletionQueueNeedsToParse()
+    {
+        static uint32_t frames_equilibrium         = 0;
+        static uint32_t objects_to_delete_previous = 0;
+    
+        // count deletions in the queue
+        uint32_t objects_to_delete = 0;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(RHI_Resource_Type::Max); i++)
+        {
+            objects_to_delete += static_cast<uint32_t>(deletion_queue[static_cast<RHI_Resource_Type>(i)].size());
+        }
+    
+        // check if the number of objects to delete has remained unchanged
+        if (objects_to_delete > 0 && objects_to_delete == objects_to_delete_previous)
+        {
+            frames_equilibrium++;
+
+            // if it’s been stable for frame_selflife frames, reset counter and delete
+            if (frames_equilibrium >= renderer_resource_frame_lifetime)
+            {
+                frames_equilibrium = 0;
+                return true;
+            }
+        }
+        else
+        {
+            // reset counter if the count changed or if nothing is in the queue
+            frames_equilibrium = 0;
+        }
+    
+        // update the previous object count to the current count
+        objects_to_delete_previous = objects_to_delete;
+    
+        return false;
+    }
+
+    // descriptors
+
+    void RHI_Device::AllocateDescriptorSet(void*& resource, RHI_DescriptorSetLayout* descriptor_set_layout, const vector<RHI_DescriptorWithBinding>& descriptors)
+    {
+        SP_ASSERT(resource == nullptr);
+
+        // a unique non-null handle
+        resource = reinterpret_cast<void*>(static_cast<uintptr_t>(++descriptors::set_handle));
+
+        Profiler::m_rhi_descriptor_set_count++;
+    }
+
+    void* RHI_Device::GetDescriptorSet(const RHI_Device_Bindless_Resource resource_type)
+    {
+        return nullptr;
+    }
+
+    void* RHI_Device::GetDescriptorSetLayout(const RHI_Device_Bindless_Resource resource_type)
+    {
+        return nullptr;
+    }
+
+    unordered_map<uint64_t, RHI_DescriptorSet>& RHI_Device::GetDescriptorSets()
+    {
+        return descriptors::sets;
+    }
+
+    uint32_t RHI_Device::GetDescriptorType(const RHI_Descriptor& descriptor)
+    {
+        return static_cast<uint32_t>(descriptor.type);
+    }
+
+    // bindless resources are never read, so there is nothing to update
+    void RHI_Device::UpdateBindlessMaterials(array<RHI_Texture*, rhi_max_array_size>* textures, RHI_Buffer* parameters) {}
+    void RHI_Device::UpdateBindlessLights(RHI_Buffer* parameters) {}
+    void RHI_Device::UpdateBindlessSamplers(const array<shared_ptr<RHI_Sampler>, static_cast<uint32_t>(Renderer_Sampler::Max)>* samplers) {}
+    void RHI_Device::UpdateBindlessAABBs(RHI_Buffer* buffer) {}
+    void RHI_Device::UpdateBindlessDrawData(RHI_Buffer* buffer) {}
+    void RHI_Device::UpdateBindlessGeometryVertices(RHI_Buffer* buffer) {}
+    void RHI_Device::UpdateBindlessGeometryIndices(RHI_Buffer* buffer) {}
+    void RHI_Device::UpdateBindlessInstances(RHI_Buffer* buffer) {}
+
+    // pipelines
+
+    void RHI_Device::GetOrCreatePipeline(RHI_PipelineState& pso, RHI_Pipeline*& pipeline, RHI_DescriptorSetLayout*& descriptor_set_layout)
+    {
+        pso.Prepare();
+
+        lock_guard<mutex> lock(descriptors::descriptor_pipeline_mutex);
+
+        descriptor_set_layout = descriptors::get_or_create_descriptor_set_layout(pso).get();
+
+        // if no pipeline exists, create one
+        uint64_t hash = pso.GetHash();
+        auto it = descriptors::pipelines.find(hash);
+        if (it == descriptors::pipelines.end())
+        {
+            it = descriptors::pipelines.emplace(make_pair(hash, make_shared<RHI_Pipeline>(pso, descriptor_set_layout))).first;
+        }
+
+        pipeline = it->second.get();
+    }
+
+    uint32_t RHI_Device::GetPipelineCount()
+    {
+        return static_cast<uint32_t>(descriptors::pipelines.size());
+    }
+
+    // memory
+
+    void* RHI_Device::MemoryGetMappedDataFromBuffer(void* resource)
+    {
+        // host memory is always mapped, at the same address
+        return resource;
+    }
+
+    void RHI_Device::MemoryBufferCreate(void*& resource, const uint64_t size, uint32_t flags_usage, uint32_t flags_memory, const void* data, const char* name)
+    {
+        resource = host_memory::allocate(size, size, data);
+    }
+
+    void RHI_Device::MemoryBufferDestroy(void*& resource)
+    {
+        host_memory::free(resource);
+    }
+
+    void RHI_Device::MemoryTextureCreate(RHI_Texture* texture)
+    {
+        // only textures the cpu can see get backing memory, render targets are never written
+        // so they get a handle, while still being reported at their full size
+        uint64_t size   = host_memory::texture_size(texture);
+        bool is_backed  = (texture->GetFlags() & RHI_Texture_Mappable) || texture->HasData();
+        void*& resource = texture->GetRhiResource();
+        resource        = host_memory::allocate(is_backed ? size : host_memory::alignment, size, nullptr);
+
+        if (texture->GetFlags() & RHI_Texture_Mappable)
+        {
+            texture->GetMappedData() = resource;
+        }
+
+        // initial data, slices and their mips back to back
+        if (texture->HasData())
+        {
+            uint8_t* destination = static_cast<uint8_t*>(resource);
+            uint64_t offset      = 0;
+            for (uint32_t array_index = 0; array_index < texture->GetArrayLength(); array_index++)
+            {
+                for (uint32_t mip_index = 0; mip_index < texture->GetMipCount(); mip_index++)
+                {
+                    RHI_Texture_Mip* mip = texture->GetMip(array_index, mip_index);
+                    if (!mip || mip->bytes.empty())
+                        continue;
+
+                    uint64_t bytes = min<uint64_t>(mip->bytes.size(), size - offset);
+                    memcpy(destination + offset, mip->bytes.data(), static_cast<size_t>(bytes));
+                    offset += bytes;
+                }
+            }
+        }
+    }
+
+    void RHI_Device::MemoryTextureDestroy(void*& resource)
+    {
+        host_memory::free(resource);
+    }
+
+    void RHI_Device::MemoryMap(void* resource, void*& mapped_data)
+    {
+        mapped_data = resource;
+    }
+
+    void RHI_Device::MemoryUnmap(void* resource)
+    {
+
+    }
+
+    uint64_t RHI_Device::MemoryGetAllocatedMb()
+    {
+        // never round a live allocation down to nothing
+        uint64_t bytes = host_memory::bytes_allocated.load();
+        return bytes == 0 ? 0 : max<uint64_t>(1, bytes / (1024ull * 1024ull));
+    }
+
+    uint64_t RHI_Device::MemoryGetAvailableMb()
+    {
+        uint64_t allocated = MemoryGetAllocatedMb();
+        return allocated < host_memory::nominal_mb ? host_memory::nominal_mb - allocated : 0;
+    }
+
+    uint64_t RHI_Device::MemoryGetTotalMb()
+    {
+        return host_memory::nominal_mb;
+    }
+
+    // markers
+
+    void RHI_Device::MarkerBegin(RHI_CommandList* cmd_list, const char* name, const math::Vector4& color)
+    {
+
+    }
+
+    void RHI_Device::MarkerEnd(RHI_CommandList* cmd_list)
+    {
+
+    }
+
+    // misc
+
+    uint64_t RHI_Device::GetBufferDeviceAddress(void* buffer)
+    {
+        return reinterpret_cast<uint64_t>(buffer);
+    }
+
+    void RHI_Device::SetResourceName(void* resource, const RHI_Resource_Type resource_type, const char* name)
+    {
+
+    }
+
+    void RHI_Device::SetVariableRateShading(const RHI_CommandList* cmd_list, const bool enabled)
+    {
+
+    }
+}
@@ -0,0 +1,134 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =======================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Device.h"
+#include "../RHI_Queue.h"
+#include "../RHI_SyncPrimitive.h"
+//==================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace spartan
+{
+    namespace
+    {
+        array<mutex, 3> mutexes;
+
+        mutex& get_mutex(RHI_Queue* queue)
+        {
+            return mutexes[static_cast<uint32_t>(queue->GetType())];
+        }
+    }
+
+    RHI_Queue::RHI_Queue(const RHI_Queue_Type queue_type, const char* name) : SpartanObject()
+    {
+        m_object_name  = name;
+        m_type         = queue_type;
+        m_rhi_resource = this; // stands in for the command pool
+
+        // command lists
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_cmd_lists.size()); i++)
+        {
+            m_cmd_lists[i] = make_shared<RHI_CommandList>(this, m_rhi_resource, (("cmd_list_") + to_string(i)).c_str());
+        }
+    }
+
+    RHI_Queue::~RHI_Queue()
+    {
+        Wait();
+
+        m_rhi_resource = nullptr;
+    }
+
+    RHI_CommandList* RHI_Queue::NextCommandList()
+    {
+        m_index        = (m_index + 1) % static_cast<uint32_t>(m_cmd_lists.size());
+        auto& cmd_list = m_cmd_lists[m_index];
+
+        // submit any pending work (toggling between fullscreen and windowed mode can leave work)
+        if (cmd_list->GetState() == RHI_CommandListState::Recording)
+        {
+            cmd_list->Submit(0, false);
+        }
+
+        if (cmd_list->GetState() == RHI_CommandListState::Submitted)
+        {
+            cmd_list->WaitForExecution();
+        }
+
+        SP_ASSERT(cmd_list->GetState() == RHI_CommandListState::Idle);
+
+        return cmd_list.get();
+    }
+
+    void RHI_Queue::Wait(const bool flush)
+    {
+        for (auto& cmd_list : m_cmd_lists)
+        {
+            bool got_flushed = false;
+            if (cmd_list->GetState() == RHI_CommandListState::Recording && flush)
+            {
+                cmd_list->Submit(0, false);
+                got_flushed = true;
+            }
+
+            if (cmd_list->GetState() == RHI_CommandListState::Submitted)
+            {
+                cmd_list->WaitForExecution();
+            }
+
+            if (got_flushed)
+            {
+                cmd_list->Begin();
+            }
+        }
+
+        // nothing executes asynchronously, the lock only orders this against a concurrent submit
+        lock_guard<mutex> lock(get_mutex(this));
+    }
+
+    void RHI_Queue::Submit(
+        void* cmd_buffer, const uint32_t wait_flags,
+        RHI_SyncPrimitive* semaphore_wait, RHI_SyncPrimitive* semaphore_signal, RHI_SyncPrimitive* semaphore_timeline_signal,
+        RHI_SyncPrimitive* semaphore_timeline_wait, uint64_t timeline_wait_value
+    )
+    {
+        lock_guard<mutex> lock(get_mutex(this));
+
+        // the work is complete the moment it's submitted, so signal right away
+        if (semaphore_timeline_signal)
+        {
+            semaphore_timeline_signal->Signal(semaphore_timeline_signal->GetNextSignalValue());
+        }
+    }
+
+    bool RHI_Queue::Present(void* swapchain, const uint32_t image_index, RHI_SyncPrimitive* semaphore_wait)
+    {
+        lock_guard<mutex> lock(get_mutex(this));
+
+        return true;
+    }
+}
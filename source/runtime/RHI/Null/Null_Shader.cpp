@@ -0,0 +1,67 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ================
+#include "pch.h"
+#include "../RHI_Device.h"
+#include "../RHI_Shader.h"
+#include "../RHI_InputLayout.h"
+//===========================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+// shaders are preprocessed and hashed like on the other backends, but never compiled, there is no
+// bytecode to reflect either, so pipelines end up with empty descriptor set layouts
+
+namespace spartan
+{
+    void* RHI_Shader::RHI_Compile()
+    {
+        if (m_input_layout)
+        {
+            m_input_layout->Create(m_vertex_type);
+        }
+
+        // non-owning token, the deletion queue ignores shaders
+        return static_cast<void*>(this);
+    }
+
+    void RHI_Shader::Reflect(const RHI_Shader_Type shader_stage, const uint32_t* ptr, const uint32_t size)
+    {
+
+    }
+
+    void RHI_Shader::CompileFromSpirv(const RHI_Shader_Type type, const void* spirv_bytecode, uint64_t spirv_size, const string& name)
+    {
+        if (!spirv_bytecode || spirv_size == 0)
+        {
+            m_compilation_state = RHI_ShaderCompilationState::Failed;
+            return;
+        }
+
+        m_shader_type       = type;
+        m_object_name       = name;
+        m_rhi_resource      = static_cast<void*>(this);
+        m_compilation_state = RHI_ShaderCompilationState::Succeeded;
+    }
+}
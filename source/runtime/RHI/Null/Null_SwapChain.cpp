@@ -0,0 +1,222 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "pch.h"
+#include "Window.h"
+#include "../RHI_Device.h"
+#include "../RHI_SwapChain.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_SyncPrimitive.h"
+#include "../RHI_Queue.h"
+#include "../Display/Display.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+// there is no surface, the back buffers are opaque handles that only exist so layouts can be tracked
+
+namespace spartan
+{
+    RHI_SwapChain::RHI_SwapChain(
+        void* sdl_window,
+        const uint32_t width,
+        const uint32_t height,
+        const RHI_Present_Mode present_mode,
+        const uint32_t buffer_count,
+        const bool hdr,
+        const char* name
+    )
+    {
+        SP_ASSERT_MSG(RHI_Device::IsValidResolution(width, height), "Invalid resolution");
+        SP_ASSERT_MSG(buffer_count >= 2, "Buffer count can't be less than 2");
+
+        m_format       = hdr ? format_hdr : format_sdr;
+        m_buffer_count = buffer_count;
+        m_width        = width;
+        m_height       = height;
+        m_sdl_window   = sdl_window;
+        m_object_name  = name;
+        m_present_mode = present_mode;
+        m_rhi_surface  = this;
+
+        Create();
+
+        m_window_resize_event_handle = SP_SUBSCRIBE_TO_EVENT(EventType::WindowResized, SP_EVENT_HANDLER(ResizeToWindowSize));
+    }
+
+    RHI_SwapChain::~RHI_SwapChain()
+    {
+        SP_UNSUBSCRIBE_FROM_EVENT(EventType::WindowResized, m_window_resize_event_handle);
+        m_window_resize_event_handle = 0;
+
+        for (uint32_t i = 0; i < buffer_count; i++)
+        {
+            if (m_rhi_rt[i])
+            {
+                RHI_CommandList::RemoveLayout(m_rhi_rt[i]);
+            }
+            m_rhi_rt[i]  = nullptr;
+            m_rhi_rtv[i] = nullptr;
+        }
+
+        m_rhi_swapchain = nullptr;
+        m_rhi_surface   = nullptr;
+    }
+
+    RHI_SyncPrimitive* RHI_SwapChain::GetImageAcquiredSemaphore() const
+    {
+        return m_image_acquired ? m_image_acquired_semaphore[m_image_index].get() : nullptr;
+    }
+
+    RHI_SyncPrimitive* RHI_SwapChain::GetRenderingCompleteSemaphore() const
+    {
+        return m_image_acquired ? m_rendering_complete_semaphore[m_image_index].get() : nullptr;
+    }
+
+    void RHI_SwapChain::Create()
+    {
+        SP_ASSERT(m_rhi_surface != nullptr);
+
+        // apply pending format change now that we're actually recreating the swapchain
+        if (m_format_pending != RHI_Format::Max)
+        {
+            m_format         = m_format_pending;
+            m_format_pending = RHI_Format::Max;
+        }
+
+        RHI_Device::QueueWaitAll();
+
+        // the address of each slot is a unique, stable handle for the lifetime of the swapchain
+        for (uint32_t i = 0; i < m_buffer_count; i++)
+        {
+            if (m_rhi_rt[i])
+            {
+                RHI_CommandList::RemoveLayout(m_rhi_rt[i]);
+            }
+
+            m_rhi_rt[i]  = &m_rhi_rt[i];
+            m_rhi_rtv[i] = &m_rhi_rtv[i];
+        }
+        m_rhi_swapchain = this;
+
+        // sync primitives
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_image_acquired_semaphore.size()); i++)
+        {
+            m_image_acquired_semaphore[i]     = make_shared<RHI_SyncPrimitive>(RHI_SyncPrimitive_Type::Semaphore, ("swapchain_acquire_" + to_string(i)).c_str());
+            m_rendering_complete_semaphore[i] = make_shared<RHI_SyncPrimitive>(RHI_SyncPrimitive_Type::Semaphore, ("swapchain_present_" + to_string(i)).c_str());
+        }
+
+        SP_LOG_INFO(
+            "Swapchain created with resolution: %dx%d, HDR: %s (%s), VSync: %s",
+            m_width,
+            m_height,
+            m_format == format_hdr ? "enabled" : "disabled",
+            rhi_format_to_string(m_format),
+            m_present_mode == RHI_Present_Mode::Fifo ? "enabled" : "disabled"
+        );
+
+        // reset state after swapchain recreation
+        m_image_index    = 0;
+        semaphore_index  = 0;
+        m_image_acquired = false;
+    }
+
+    void RHI_SwapChain::Resize(const uint32_t width, const uint32_t height)
+    {
+        SP_ASSERT(RHI_Device::IsValidResolution(width, height));
+
+        if (m_width == width && m_height == height)
+            return;
+
+        m_width  = width;
+        m_height = height;
+
+        Create();
+
+        SP_LOG_INFO("Resolution has been set to %dx%d", width, height);
+    }
+
+    void RHI_SwapChain::ResizeToWindowSize()
+    {
+        Resize(Window::GetWidth(), Window::GetHeight());
+    }
+
+    void RHI_SwapChain::AcquireNextImage()
+    {
+        m_image_acquired = false;
+
+        if (!m_rhi_swapchain)
+            return;
+
+        // round robin, there is no presentation engine to hand images back out of order
+        m_image_index    = semaphore_index;
+        semaphore_index  = (semaphore_index + 1) % m_buffer_count;
+        m_image_acquired = true;
+    }
+
+    void RHI_SwapChain::Present(RHI_CommandList* cmd_list_frame)
+    {
+        if (!m_image_acquired)
+            return;
+
+        cmd_list_frame->GetQueue()->Present(m_rhi_swapchain, m_image_index, m_rendering_complete_semaphore[m_image_index].get());
+        m_image_acquired = false;
+
+        if (m_is_dirty)
+        {
+            Create();
+            m_is_dirty = false;
+        }
+    }
+
+    void RHI_SwapChain::SetHdr(const bool enabled)
+    {
+        if (enabled)
+        {
+            SP_ASSERT_MSG(Display::GetHdr(), "This display doesn't support HDR");
+        }
+
+        RHI_Format new_format = enabled ? format_hdr : format_sdr;
+        if (new_format != m_format)
+        {
+            m_format_pending = new_format;
+            m_is_dirty       = true;
+        }
+    }
+
+    void RHI_SwapChain::SetVsync(const bool enabled)
+    {
+        if ((m_present_mode == RHI_Present_Mode::Fifo) != enabled)
+        {
+            m_present_mode = enabled ? RHI_Present_Mode::Fifo : RHI_Present_Mode::Immediate;
+            m_is_dirty     = true;
+            Timer::OnVsyncToggled(enabled);
+        }
+    }
+
+    bool RHI_SwapChain::GetVsync()
+    {
+        return m_present_mode == RHI_Present_Mode::Fifo;
+    }
+}
@@ -0,0 +1,68 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "pch.h"
+#include "../RHI_Device.h"
+#include "../RHI_SyncPrimitive.h"
+#include "../RHI_Implementation.h"
+//================================
+
+// queues complete work at submission, so every primitive is already signaled when anyone looks at it
+
+namespace spartan
+{
+    RHI_SyncPrimitive::RHI_SyncPrimitive(const RHI_SyncPrimitive_Type type, const char* name)
+    {
+        m_type         = type;
+        m_object_name  = name;
+        m_rhi_resource = this;
+    }
+
+    RHI_SyncPrimitive::~RHI_SyncPrimitive()
+    {
+        m_rhi_resource = nullptr;
+    }
+
+    void RHI_SyncPrimitive::Wait(const uint64_t timeout_nanoseconds)
+    {
+        SP_ASSERT(m_type == RHI_SyncPrimitive_Type::Fence || m_type == RHI_SyncPrimitive_Type::SemaphoreTimeline);
+    }
+
+    void RHI_SyncPrimitive::Signal(const uint64_t value)
+    {
+        SP_ASSERT(m_type == RHI_SyncPrimitive_Type::SemaphoreTimeline);
+
+        m_value = value;
+    }
+
+    bool RHI_SyncPrimitive::IsSignaled()
+    {
+        SP_ASSERT(m_type != RHI_SyncPrimitive_Type::Semaphore);
+
+        return true;
+    }
+
+    void RHI_SyncPrimitive::Reset()
+    {
+        SP_ASSERT(m_type == RHI_SyncPrimitive_Type::Fence);
+    }
+}
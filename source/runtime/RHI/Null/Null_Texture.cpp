@@ -0,0 +1,133 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include "pch.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_Device.h"
+#include "../RHI_Texture.h"
+#include "../RHI_CommandList.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace spartan
+{
+    namespace
+    {
+        RHI_Image_Layout GetAppropriateLayout(RHI_Texture* texture)
+        {
+            if (texture->IsUav())
+                return RHI_Image_Layout::General;
+
+            if (texture->IsRt())
+                return RHI_Image_Layout::Attachment;
+
+            if (texture->IsSrv())
+                return RHI_Image_Layout::Shader_Read;
+
+            return RHI_Image_Layout::Preinitialized;
+        }
+    }
+
+    bool RHI_Texture::RHI_CreateResource()
+    {
+        SP_ASSERT_MSG(m_width  != 0, "Width can't be zero");
+        SP_ASSERT_MSG(m_height != 0, "Height can't be zero");
+
+        // host memory, initial data is copied in and only textures the cpu can observe are backed
+        RHI_Device::MemoryTextureCreate(this);
+
+        // transition to target layout, so the layout tracking behaves like it does with a gpu
+        if (RHI_CommandList* cmd_list = RHI_CommandList::ImmediateExecutionBegin(RHI_Queue_Type::Graphics))
+        {
+            RHI_Image_Layout target_layout = GetAppropriateLayout(this);
+            if (!HasData() && target_layout == RHI_Image_Layout::Shader_Read)
+            {
+                target_layout = RHI_Image_Layout::General;
+            }
+
+            cmd_list->InsertBarrier(m_rhi_resource, m_format, 0, m_mip_count, GetArrayLength(), target_layout);
+            RHI_CommandList::ImmediateExecutionEnd(cmd_list);
+        }
+
+        // views alias the image, they are only ever compared against null
+        if (IsSrv() || IsUav())
+        {
+            m_rhi_srv = m_rhi_resource;
+
+            if (HasPerMipViews())
+            {
+                for (uint32_t i = 0; i < m_mip_count; i++)
+                {
+                    m_rhi_srv_mips[i] = m_rhi_resource;
+                }
+            }
+        }
+
+        if (m_type == RHI_Texture_Type::Type3D)
+        {
+            if (IsRtv())
+            {
+                m_rhi_rtv[0] = m_rhi_resource;
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < m_depth; i++)
+            {
+                if (IsRtv())
+                {
+                    m_rhi_rtv[i] = m_rhi_resource;
+                }
+
+                if (IsDsv())
+                {
+                    m_rhi_dsv[i] = m_rhi_resource;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void RHI_Texture::RHI_DestroyResource()
+    {
+        m_rhi_srv = nullptr;
+        for (uint32_t i = 0; i < m_mip_count; i++)
+        {
+            m_rhi_srv_mips[i] = nullptr;
+        }
+
+        for (uint32_t i = 0; i < rhi_max_render_target_count; i++)
+        {
+            m_rhi_dsv[i] = nullptr;
+            m_rhi_rtv[i] = nullptr;
+        }
+
+        // descriptor sets referencing the image are dropped when the deletion queue is parsed
+        RHI_CommandList::RemoveLayout(m_rhi_resource);
+        RHI_Device::DeletionQueueAdd(RHI_Resource_Type::Image, m_rhi_resource);
+        m_rhi_resource = nullptr;
+    }
+}
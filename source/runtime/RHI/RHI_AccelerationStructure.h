@@ -83,9 +83,9 @@ namespace spartan
         void* m_rhi_resource         = nullptr;
         void* m_rhi_resource_results = nullptr;
 
-        // reusable buffers - double buffered to avoid frame-to-frame synchronization issues
-        // when frame N is being processed by the GPU while frame N+1 updates the buffers
-        static const uint32_t buffer_count = 2;
+        // reusable buffers - one per frame in flight, so the cpu never writes instances
+        // that a frame still being processed by the gpu reads
+        static const uint32_t buffer_count = rhi_max_frames_in_flight;
         uint32_t m_buffer_index            = 0;
         void* m_scratch_buffer                                    = nullptr;
         uint64_t m_scratch_buffer_size                            = 0;
@@ -224,7 +224,7 @@ namespace spartan
         std::atomic<RHI_CommandListState> m_state            = RHI_CommandListState::Idle;
         RHI_CullMode m_cull_mode                             = RHI_CullMode::Back;
         bool m_render_pass_active                            = false;
-        std::stack<const char*> m_active_timeblocks;
+        std::stack<std::pair<const char*, bool>> m_active_timeblocks; // name, gpu timed
         std::stack<const char*> m_debug_label_stack;
         std::stack<int32_t> m_breadcrumb_gpu_slots;
         std::mutex m_mutex_reset;
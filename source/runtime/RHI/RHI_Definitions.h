@@ -72,6 +72,7 @@ namespace spartan
     {
         D3d12,
         Vulkan,
+        Null,
         Max
     };
 
@@ -617,4 +618,6 @@ namespace spartan
     const uint32_t rhi_all_mips                  = std::numeric_limits<uint32_t>::max();
     const uint32_t rhi_dynamic_offset_empty      = std::numeric_limits<uint32_t>::max();
     const uint32_t rhi_max_buffer_update_size    = 65536; // vkCmdUpdateBuffer has a limit of 65536 bytes
+    const uint8_t  rhi_max_frames_in_flight      = 3;     // frames the cpu can record ahead of the gpu, r.frames_in_flight picks how many are used
+    const uint8_t  rhi_max_cmd_lists_per_frame   = 4;     // pre-gbuffer, shadows, lighting+present and an editor viewport
 }
@@ -47,11 +47,11 @@ namespace spartan
         RHI_Queue_Type GetType() const { return m_type; }
 
     private:
-        // 4 command lists: supports 3 submissions per frame (pre-gbuffer, shadows, lighting+present)
-        // plus slack for the previous frame's in-flight work to complete without stalling
-        std::array<std::shared_ptr<RHI_CommandList>, 4> m_cmd_lists = { nullptr };
-        void* m_rhi_resource                                        = nullptr;
-        std::atomic<uint32_t> m_index                               = 0;
-        RHI_Queue_Type m_type                                       = RHI_Queue_Type::Max;
+        // enough command lists for every frame in flight, so recycling one never waits,
+        // the renderer paces frames explicitly instead (see Renderer::RotateFrameBuffers)
+        std::array<std::shared_ptr<RHI_CommandList>, rhi_max_frames_in_flight * rhi_max_cmd_lists_per_frame> m_cmd_lists = { nullptr };
+        void* m_rhi_resource                                                                                              = nullptr;
+        std::atomic<uint32_t> m_index                                                                                     = 0;
+        RHI_Queue_Type m_type                                                                                             = RHI_Queue_Type::Max;
     };
 }
@@ -29,6 +29,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RHI_Implementation.h"
 #include "ThreadPool.h"
 #include "../Rendering/Renderer.h"
+#include "../World/World.h"
 #include "../Resource/Import/ImageImporter.h"
 #include "../Core/ProgressTracker.h"
 #include "../Core/Debugging.h"
@@ -1006,6 +1007,12 @@ namespace spartan
         if (m_rhi_resource)
         {
             m_resource_state = ResourceState::PreparedForGpu;
+
+            // materials bind a fallback until their textures are ready, so they have to be uploaded again
+            if (IsSrv() && !IsRtv() && !IsDsv())
+            {
+                World::MarkMaterialTexturesReady();
+            }
         }
         else
         {
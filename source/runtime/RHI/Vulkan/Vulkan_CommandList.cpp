@@ -2018,8 +2018,9 @@ namespace spartan
     
         // timing - pass the queue type so the profiler knows which lane this block belongs to
         RHI_Queue_Type queue_type = m_queue ? m_queue->GetType() : RHI_Queue_Type::Max;
+        const bool gpu_timed = Debugging::IsGpuTimingEnabled() && gpu_timing;
         Profiler::TimeBlockStart(name, TimeBlockType::Cpu, this, queue_type);
-        if (Debugging::IsGpuTimingEnabled() && gpu_timing)
+        if (gpu_timed)
         {
             Profiler::TimeBlockStart(name, TimeBlockType::Gpu, this, queue_type);
         }
@@ -2050,7 +2051,7 @@ namespace spartan
         }
     
         // track active time blocks (for nesting)
-        m_active_timeblocks.push(name);
+        m_active_timeblocks.push({ name, gpu_timed });
     }
 
     void RHI_CommandList::EndTimeblock()
@@ -2082,8 +2083,8 @@ namespace spartan
             }
         }
     
-        // timing
-        if (Debugging::IsGpuTimingEnabled())
+        // timing, ends are matched to starts in reverse order
+        if (m_active_timeblocks.top().second)
         {
             Profiler::TimeBlockEnd(); // gpu
         }
@@ -43,13 +43,114 @@ namespace spartan
     bool GeometryBuffer::m_dirty                      = false;
     bool GeometryBuffer::m_was_rebuilt                = false;
     mutex GeometryBuffer::m_mutex;
+    vector<GeometryBuffer::FreeRange> GeometryBuffer::m_vertex_ranges_free;
+    vector<GeometryBuffer::FreeRange> GeometryBuffer::m_index_ranges_free;
+    vector<GeometryBuffer::FreeRange> GeometryBuffer::m_vertex_ranges_retired;
+    vector<GeometryBuffer::FreeRange> GeometryBuffer::m_index_ranges_retired;
+    uint64_t GeometryBuffer::m_build_count        = 0;
+    uint32_t GeometryBuffer::m_vertex_dirty_begin = numeric_limits<uint32_t>::max();
+    uint32_t GeometryBuffer::m_vertex_dirty_end   = 0;
+    uint32_t GeometryBuffer::m_index_dirty_begin  = numeric_limits<uint32_t>::max();
+    uint32_t GeometryBuffer::m_index_dirty_end    = 0;
+
+    namespace
+    {
+        constexpr uint32_t invalid_offset = numeric_limits<uint32_t>::max();
+
+        // first fit, the remainder of a larger range stays free
+        template <typename Range>
+        uint32_t allocate_range(vector<Range>& ranges, uint32_t count)
+        {
+            for (size_t i = 0; i < ranges.size(); i++)
+            {
+                Range& range = ranges[i];
+                if (range.count < count)
+                    continue;
+
+                uint32_t offset = range.offset;
+                range.offset   += count;
+                range.count    -= count;
+                if (range.count == 0)
+                {
+                    ranges.erase(ranges.begin() + i);
+                }
+
+                return offset;
+            }
+
+            return invalid_offset;
+        }
+
+        // keeps the list sorted by offset and merges neighbors so streamed ranges don't fragment
+        template <typename Range>
+        void free_range(vector<Range>& ranges, const Range& range)
+        {
+            auto it = lower_bound(ranges.begin(), ranges.end(), range, [](const Range& a, const Range& b) { return a.offset < b.offset; });
+            it      = ranges.insert(it, range);
+
+            auto next = it + 1;
+            if (next != ranges.end() && it->offset + it->count == next->offset)
+            {
+                it->count += next->count;
+                ranges.erase(next);
+            }
+
+            if (it != ranges.begin())
+            {
+                auto previous = it - 1;
+                if (previous->offset + previous->count == it->offset)
+                {
+                    previous->count += it->count;
+                    ranges.erase(it);
+                }
+            }
+        }
+
+        template <typename Range>
+        void retire_ranges(vector<Range>& retired, vector<Range>& ranges_free, uint64_t build_count, uint64_t delay)
+        {
+            for (size_t i = 0; i < retired.size();)
+            {
+                if (build_count - retired[i].frame >= delay)
+                {
+                    free_range(ranges_free, retired[i]);
+                    retired[i] = retired.back();
+                    retired.pop_back();
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+
+        void mark_dirty(uint32_t& dirty_begin, uint32_t& dirty_end, uint32_t offset, uint32_t count, uint32_t count_committed)
+        {
+            // only committed data needs a re-upload, anything past it goes up with the new tail
+            if (offset >= count_committed)
+                return;
+
+            dirty_begin = min(dirty_begin, offset);
+            dirty_end   = max(dirty_end, min(offset + count, count_committed));
+        }
+    }
 
     uint32_t GeometryBuffer::AppendVertices(const RHI_Vertex_PosTexNorTan* data, uint32_t count)
     {
         lock_guard<mutex> lock(m_mutex);
 
-        uint32_t base_offset = static_cast<uint32_t>(m_vertices.size());
-        m_vertices.insert(m_vertices.end(), data, data + count);
+        // reuse a released range if one fits
+        uint32_t base_offset = allocate_range(m_vertex_ranges_free, count);
+        if (base_offset != invalid_offset)
+        {
+            copy(data, data + count, m_vertices.begin() + base_offset);
+            mark_dirty(m_vertex_dirty_begin, m_vertex_dirty_end, base_offset, count, m_vertex_count_committed);
+        }
+        else
+        {
+            base_offset = static_cast<uint32_t>(m_vertices.size());
+            m_vertices.insert(m_vertices.end(), data, data + count);
+        }
         m_dirty = true;
 
         return base_offset;
@@ -59,17 +160,53 @@ namespace spartan
     {
         lock_guard<mutex> lock(m_mutex);
 
-        uint32_t base_offset = static_cast<uint32_t>(m_indices.size());
-        m_indices.insert(m_indices.end(), data, data + count);
+        // reuse a released range if one fits
+        uint32_t base_offset = allocate_range(m_index_ranges_free, count);
+        if (base_offset != invalid_offset)
+        {
+            copy(data, data + count, m_indices.begin() + base_offset);
+            mark_dirty(m_index_dirty_begin, m_index_dirty_end, base_offset, count, m_index_count_committed);
+        }
+        else
+        {
+            base_offset = static_cast<uint32_t>(m_indices.size());
+            m_indices.insert(m_indices.end(), data, data + count);
+        }
         m_dirty = true;
 
         return base_offset;
     }
 
+    void GeometryBuffer::ReleaseVertices(uint32_t offset, uint32_t count)
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        // ranges from before a shutdown no longer exist
+        if (count == 0 || static_cast<uint64_t>(offset) + count > m_vertices.size())
+            return;
+
+        m_vertex_ranges_retired.push_back({ offset, count, m_build_count });
+    }
+
+    void GeometryBuffer::ReleaseIndices(uint32_t offset, uint32_t count)
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        if (count == 0 || static_cast<uint64_t>(offset) + count > m_indices.size())
+            return;
+
+        m_index_ranges_retired.push_back({ offset, count, m_build_count });
+    }
+
     void GeometryBuffer::BuildIfDirty()
     {
         lock_guard<mutex> lock(m_mutex);
 
+        // called once per frame, so released ranges age here
+        m_build_count++;
+        retire_ranges(m_vertex_ranges_retired, m_vertex_ranges_free, m_build_count, release_delay);
+        retire_ranges(m_index_ranges_retired, m_index_ranges_free, m_build_count, release_delay);
+
         if (!m_dirty || m_vertices.empty() || m_indices.empty())
             return;
 
@@ -115,6 +252,10 @@ namespace spartan
 
             m_vertex_count_committed = vertex_count;
             m_index_count_committed  = index_count;
+            m_vertex_dirty_begin     = numeric_limits<uint32_t>::max();
+            m_vertex_dirty_end       = 0;
+            m_index_dirty_begin      = numeric_limits<uint32_t>::max();
+            m_index_dirty_end        = 0;
 
             m_was_rebuilt = true;
 
@@ -147,12 +288,35 @@ namespace spartan
                 m_index_buffer->UploadSubRegion(m_indices.data() + m_index_count_committed, offset, size);
             }
 
+            // recycled ranges inside the committed region
+            if (m_vertex_dirty_begin < m_vertex_dirty_end)
+            {
+                uint64_t offset = static_cast<uint64_t>(m_vertex_dirty_begin) * sizeof(RHI_Vertex_PosTexNorTan);
+                uint64_t size   = static_cast<uint64_t>(m_vertex_dirty_end - m_vertex_dirty_begin) * sizeof(RHI_Vertex_PosTexNorTan);
+                m_vertex_buffer->UploadSubRegion(m_vertices.data() + m_vertex_dirty_begin, offset, size);
+            }
+
+            if (m_index_dirty_begin < m_index_dirty_end)
+            {
+                uint64_t offset = static_cast<uint64_t>(m_index_dirty_begin) * sizeof(uint32_t);
+                uint64_t size   = static_cast<uint64_t>(m_index_dirty_end - m_index_dirty_begin) * sizeof(uint32_t);
+                m_index_buffer->UploadSubRegion(m_indices.data() + m_index_dirty_begin, offset, size);
+            }
+
             m_vertex_count_committed = vertex_count;
             m_index_count_committed  = index_count;
+            m_vertex_dirty_begin     = numeric_limits<uint32_t>::max();
+            m_vertex_dirty_end       = 0;
+            m_index_dirty_begin      = numeric_limits<uint32_t>::max();
+            m_index_dirty_end        = 0;
 
-            SP_LOG_INFO("Global geometry buffer updated: +%u vertices, +%u indices (sub-region upload, no rebuild)",
-                new_vertices, new_indices
-            );
+            // recycled ranges are routine while streaming, only log growth
+            if (new_vertices > 0 || new_indices > 0)
+            {
+                SP_LOG_INFO("Global geometry buffer updated: +%u vertices, +%u indices (sub-region upload, no rebuild)",
+                    new_vertices, new_indices
+                );
+            }
         }
 
         m_dirty = false;
@@ -179,6 +343,15 @@ namespace spartan
         m_index_capacity         = 0;
         m_dirty                  = false;
         m_was_rebuilt            = false;
+        m_build_count            = 0;
+        m_vertex_dirty_begin     = numeric_limits<uint32_t>::max();
+        m_vertex_dirty_end       = 0;
+        m_index_dirty_begin      = numeric_limits<uint32_t>::max();
+        m_index_dirty_end        = 0;
+        m_vertex_ranges_free.clear();
+        m_index_ranges_free.clear();
+        m_vertex_ranges_retired.clear();
+        m_index_ranges_retired.clear();
     }
 
     RHI_Buffer* GeometryBuffer::GetVertexBuffer()
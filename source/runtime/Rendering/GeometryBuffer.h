@@ -36,6 +36,7 @@ namespace spartan
     // meshes append their data here during loading and receive base offsets.
     // gpu buffers are pre-allocated with headroom so that late-arriving meshes
     // can be uploaded via sub-region copies without recreating the entire buffer.
+    // released ranges are recycled after a few frames, so streamed geometry doesn't grow the buffers forever.
     class GeometryBuffer
     {
     public:
@@ -45,6 +46,10 @@ namespace spartan
         // append indices to the global buffer, returns the base index offset
         static uint32_t AppendIndices(const uint32_t* data, uint32_t count);
 
+        // return ranges to the buffer, they are reused once the gpu can no longer be reading them
+        static void ReleaseVertices(uint32_t offset, uint32_t count);
+        static void ReleaseIndices(uint32_t offset, uint32_t count);
+
         // synchronize gpu buffers with cpu data:
         //  - if no gpu buffer exists, create one with headroom and upload everything
         //  - if new data fits within existing capacity, upload only the new portion
@@ -63,6 +68,13 @@ namespace spartan
         static bool WasRebuilt();
 
     private:
+        struct FreeRange
+        {
+            uint32_t offset;
+            uint32_t count;
+            uint64_t frame; // build at which the range was released
+        };
+
         // cpu-side accumulators
         static std::vector<RHI_Vertex_PosTexNorTan> m_vertices;
         static std::vector<uint32_t> m_indices;
@@ -77,6 +89,19 @@ namespace spartan
         static uint32_t m_vertex_capacity;        // total gpu buffer capacity
         static uint32_t m_index_capacity;
 
+        // recycled ranges, retired ones wait for in-flight frames before they become free
+        static std::vector<FreeRange> m_vertex_ranges_free;
+        static std::vector<FreeRange> m_index_ranges_free;
+        static std::vector<FreeRange> m_vertex_ranges_retired;
+        static std::vector<FreeRange> m_index_ranges_retired;
+        static uint64_t m_build_count;
+
+        // committed regions overwritten in place by recycled ranges, [begin, end)
+        static uint32_t m_vertex_dirty_begin;
+        static uint32_t m_vertex_dirty_end;
+        static uint32_t m_index_dirty_begin;
+        static uint32_t m_index_dirty_end;
+
         // state
         static bool m_dirty;
         static bool m_was_rebuilt;
@@ -84,5 +109,8 @@ namespace spartan
 
         // growth factor applied when allocating gpu buffers
         static constexpr float growth_factor = 1.25f;
+
+        // builds a released range waits before it can be reused, covers every frame in flight
+        static constexpr uint64_t release_delay = 8;
     };
 }
@@ -711,6 +711,10 @@ namespace spartan
         bool texture_changed = (previous_texture != texture);
         
         m_textures[array_index] = texture;
+        if (texture_changed)
+        {
+            World::MarkMaterialChanged(this);
+        }
 
         // mark for repacking if this texture type contributes to the packed texture and actually changed
         if (texture_changed && IsPackableTextureType(texture_type))
@@ -829,6 +833,7 @@ namespace spartan
                 return;
 
             m_resource_state = ResourceState::PreparingForGpu;
+            World::MarkMaterialChanged(this);
 
             // pack textures (this happens synchronously to ensure data is ready)
             for (uint8_t slot = 0; slot < GetUsedSlotCount(); slot++)
@@ -856,6 +861,9 @@ namespace spartan
                 m_resource_state = ResourceState::PreparedForGpu;
             }
 
+            // the material's own state changed, textures that finish preparing later report themselves
+            World::MarkMaterialChanged(this);
+
             // check if textures were set during preparation (async texture loading race condition)
             // if so, trigger another preparation cycle to repack with the new textures
             if (m_needs_repack)
@@ -896,6 +904,7 @@ namespace spartan
         if (m_properties[static_cast<uint32_t>(property_type)] == value)
             return;
 
+        bool cull_mode_changed = property_type == MaterialProperty::CullMode;
         if (property_type == MaterialProperty::ColorA)
         {
             // if an object switches from opaque to transparent or vice versa, make the world update so that the renderer
@@ -905,6 +914,7 @@ namespace spartan
             {
                 RHI_CullMode cull_mode = value < 1.0f ? RHI_CullMode::None : RHI_CullMode::Back;
                 m_properties[static_cast<uint32_t>(MaterialProperty::CullMode)] = static_cast<float>(cull_mode);
+                cull_mode_changed = true;
             }
 
             // transparent objects are typically see-through (low roughness) so use the alpha as the roughness multiplier.
@@ -912,6 +922,7 @@ namespace spartan
         }
 
         m_properties[static_cast<uint32_t>(property_type)] = value;
+        World::MarkMaterialChanged(this, cull_mode_changed);
 
         // save on change
         SaveToFile(GetResourceFilePath());
@@ -0,0 +1,321 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "pch.h"
+#include "RenderWorld.h"
+#include "Material.h"
+#include "../World/World.h"
+#include "../World/Entity.h"
+#include "../World/Components/Light.h"
+#include "../World/Components/Renderable.h"
+#include "../Profiling/Profiler.h"
+//======================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan::math;
+//============================
+
+namespace spartan
+{
+    namespace
+    {
+        // where each snapshot entry is read from, kept apart so the hot arrays stay dense
+        struct RenderObjectSource
+        {
+            Entity* entity         = nullptr;
+            Renderable* renderable = nullptr;
+        };
+
+        vector<RenderObject> objects;
+        vector<RenderObjectSource> sources;
+        vector<RenderLight> lights;
+        vector<Material*> materials;
+        uint64_t world_revision    = numeric_limits<uint64_t>::max();
+        atomic<bool> dirty         = true;
+        uint32_t transform_updates = 0;
+        bool was_rebuilt           = false;
+
+        void extract_material(RenderObject& object, Material* material)
+        {
+            object.material = material;
+            object.flags   &= RenderObject_Active | RenderObject_Visible | RenderObject_Instanced;
+            if (!material)
+                return;
+
+            object.material_id    = material->GetObjectId();
+            object.material_index = material->GetIndex();
+            object.cull_mode      = static_cast<uint32_t>(material->GetProperty(MaterialProperty::CullMode));
+            object.flags         |= material->IsTransparent()                                       ? static_cast<uint32_t>(RenderObject_Transparent) : 0u;
+            object.flags         |= material->IsAlphaTested()                                       ? static_cast<uint32_t>(RenderObject_AlphaTested) : 0u;
+            object.flags         |= material->GetProperty(MaterialProperty::Tessellation) > 0.0f      ? static_cast<uint32_t>(RenderObject_Tessellated) : 0u;
+            object.flags         |= static_cast<RHI_CullMode>(object.cull_mode) == RHI_CullMode::Back ? static_cast<uint32_t>(RenderObject_CullBack)    : 0u;
+        }
+
+        void extract_light(RenderLight& render_light, Light* light)
+        {
+            Entity* entity = light->GetEntity();
+
+            render_light.light         = light;
+            render_light.active        = entity->GetActive();
+            render_light.directional   = light->GetLightType() == LightType::Directional;
+            render_light.position      = entity->GetPosition();
+            render_light.direction     = entity->GetForward();
+            render_light.aabb          = light->GetBoundingBox();
+            render_light.color         = light->GetColor();
+            render_light.intensity     = light->GetIntensityWatt();
+            render_light.range         = light->GetRange();
+            render_light.angle         = light->GetAngle();
+            render_light.area_width    = light->GetAreaWidth();
+            render_light.area_height   = light->GetAreaHeight();
+            render_light.draw_distance = light->GetDrawDistance();
+            render_light.slice_count   = min(light->GetSliceCount(), static_cast<uint32_t>(render_light.view_projection.size()));
+
+            for (uint32_t i = 0; i < render_light.slice_count; i++)
+            {
+                render_light.view_projection[i] = light->GetViewProjectionMatrix(i);
+            }
+
+            render_light.flags  = 0;
+            render_light.flags |= light->GetLightType() == LightType::Directional ? (1 << 0) : 0;
+            render_light.flags |= light->GetLightType() == LightType::Point       ? (1 << 1) : 0;
+            render_light.flags |= light->GetLightType() == LightType::Spot        ? (1 << 2) : 0;
+            render_light.flags |= light->GetFlag(LightFlags::Shadows)             ? (1 << 3) : 0;
+            render_light.flags |= light->GetFlag(LightFlags::ShadowsScreenSpace)  ? (1 << 4) : 0;
+            render_light.flags |= light->GetFlag(LightFlags::Volumetric)          ? (1 << 5) : 0;
+            render_light.flags |= light->GetLightType() == LightType::Area        ? (1 << 6) : 0;
+        }
+
+        // returns true if the set of unique materials differs from the previous one
+        bool rebuild_materials()
+        {
+            static vector<Material*> materials_previous;
+            materials_previous.swap(materials);
+            materials.clear();
+
+            // unique, in first-use order, only active objects take up material slots
+            static unordered_set<uint64_t> seen;
+            seen.clear();
+            for (const RenderObject& object : objects)
+            {
+                if (object.HasFlag(RenderObject_Active) && object.material && seen.insert(object.material_id).second)
+                {
+                    materials.push_back(object.material);
+                }
+            }
+
+            return materials != materials_previous;
+        }
+
+        void rebuild()
+        {
+            // keep per-object history across rebuilds so that spawning or deleting
+            // one entity doesn't reset the motion vectors of everything else
+            static vector<RenderObject> objects_previous;
+            static unordered_map<uint64_t, uint32_t> index_previous;
+            objects_previous.swap(objects);
+            index_previous.clear();
+            for (uint32_t i = 0; i < static_cast<uint32_t>(objects_previous.size()); i++)
+            {
+                index_previous[objects_previous[i].entity_id] = i;
+            }
+
+            objects.clear();
+            sources.clear();
+            lights.clear();
+
+            // renderables regardless of their active state, activation is picked up per frame
+            for (Entity* entity : World::GetEntities())
+            {
+                if (Renderable* renderable = entity->GetComponent<Renderable>())
+                {
+                    auto it = index_previous.find(entity->GetObjectId());
+                    if (it != index_previous.end())
+                    {
+                        objects.push_back(objects_previous[it->second]);
+                    }
+                    else
+                    {
+                        RenderObject& object = objects.emplace_back();
+                        object.entity_id     = entity->GetObjectId();
+                    }
+
+                    objects.back().renderable = renderable;
+                    sources.push_back({ entity, renderable });
+                }
+            }
+
+            for (Entity* entity : World::GetEntitiesLights())
+            {
+                if (Light* light = entity->GetComponent<Light>())
+                {
+                    extract_light(lights.emplace_back(), light);
+                }
+            }
+        }
+    }
+
+    bool RenderWorld::Extract(const bool materials_changed, const bool lights_changed)
+    {
+        SP_PROFILE_CPU();
+
+        // membership, only when entities or their renderable/light components came and went
+        was_rebuilt = dirty.exchange(false) || world_revision != World::GetRevision();
+        if (was_rebuilt)
+        {
+            world_revision = World::GetRevision();
+            rebuild();
+        }
+
+        // per object state
+        bool material_set_dirty = was_rebuilt || materials_changed;
+        transform_updates       = 0;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(objects.size()); i++)
+        {
+            RenderObject& object             = objects[i];
+            const RenderObjectSource& source = sources[i];
+            Entity* entity                   = source.entity;
+            Renderable* renderable           = source.renderable;
+
+            // active state
+            bool was_active = object.HasFlag(RenderObject_Active);
+            bool active     = entity->GetActive();
+            if (active != was_active)
+            {
+                object.flags       = active ? (object.flags | RenderObject_Active) : (object.flags & ~RenderObject_Active);
+                material_set_dirty = true;
+            }
+            if (!active)
+                continue;
+
+            // transform, the previous transform is what the snapshot held last frame, which is what motion vectors need
+            uint64_t revision = entity->GetTransformRevision();
+            if (!was_active)
+            {
+                object.transform          = entity->GetMatrix();
+                object.transform_previous = object.transform;
+                object.transform_revision = revision;
+                transform_updates++;
+            }
+            else if (revision != object.transform_revision)
+            {
+                object.transform_previous = object.transform;
+                object.transform          = entity->GetMatrix();
+                object.transform_revision = revision;
+                transform_updates++;
+            }
+            else
+            {
+                object.transform_previous = object.transform;
+            }
+
+            // material
+            Material* material = renderable->GetMaterial();
+            if (!was_active || was_rebuilt || materials_changed || material != object.material)
+            {
+                material_set_dirty |= material != object.material;
+                extract_material(object, material);
+            }
+
+            // culling outputs, these are produced by the world tick every frame
+            object.distance_squared = renderable->GetDistanceSquared();
+            object.lod_index        = renderable->GetLodIndex();
+            object.instance_count   = renderable->GetInstanceCount();
+            object.aabb             = renderable->GetBoundingBox();
+            object.flags            = renderable->IsVisible()     ? (object.flags | RenderObject_Visible)   : (object.flags & ~RenderObject_Visible);
+            object.flags            = renderable->HasInstancing() ? (object.flags | RenderObject_Instanced) : (object.flags & ~RenderObject_Instanced);
+
+            // mesh ranges follow the lod selection
+            if (renderable->GetMesh())
+            {
+                object.index_count        = renderable->GetIndexCount(object.lod_index);
+                object.index_offset       = renderable->GetIndexOffset(object.lod_index);
+                object.vertex_offset      = renderable->GetVertexOffset(object.lod_index);
+                object.index_offset_lod0  = renderable->GetIndexOffset(0);
+                object.vertex_offset_lod0 = renderable->GetVertexOffset(0);
+            }
+        }
+
+        // lights
+        if (!was_rebuilt && lights_changed)
+        {
+            for (RenderLight& render_light : lights)
+            {
+                extract_light(render_light, render_light.light);
+            }
+        }
+
+        // materials need re-uploading if any of them changed or the set of them did
+        bool material_set_changed = material_set_dirty && rebuild_materials();
+        return materials_changed || material_set_changed;
+    }
+
+    void RenderWorld::Clear()
+    {
+        objects.clear();
+        sources.clear();
+        lights.clear();
+        materials.clear();
+        dirty = true;
+    }
+
+    void RenderWorld::MarkDirty()
+    {
+        dirty = true;
+    }
+
+    void RenderWorld::RefreshMaterialIndices()
+    {
+        for (RenderObject& object : objects)
+        {
+            if (object.HasFlag(RenderObject_Active) && object.material)
+            {
+                object.material_index = object.material->GetIndex();
+            }
+        }
+    }
+
+    vector<RenderObject>& RenderWorld::GetObjects()
+    {
+        return objects;
+    }
+
+    const vector<RenderLight>& RenderWorld::GetLights()
+    {
+        return lights;
+    }
+
+    const vector<Material*>& RenderWorld::GetMaterials()
+    {
+        return materials;
+    }
+
+    uint32_t RenderWorld::GetTransformUpdateCount()
+    {
+        return transform_updates;
+    }
+
+    bool RenderWorld::WasRebuilt()
+    {
+        return was_rebuilt;
+    }
+}
@@ -0,0 +1,131 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <array>
+#include "Color.h"
+#include "../Math/Matrix.h"
+#include "../Math/BoundingBox.h"
+//================================
+
+namespace spartan
+{
+    class Entity;
+    class Renderable;
+    class Material;
+    class Light;
+
+    enum RenderObjectFlags : uint32_t
+    {
+        RenderObject_Active      = 1U << 0,
+        RenderObject_Visible     = 1U << 1, // survived frustum and distance culling this frame
+        RenderObject_Transparent = 1U << 2,
+        RenderObject_AlphaTested = 1U << 3,
+        RenderObject_Tessellated = 1U << 4,
+        RenderObject_CullBack    = 1U << 5, // standard culling, anything else needs the cpu path
+        RenderObject_Instanced   = 1U << 6
+    };
+
+    // everything the cpu side of the renderer needs to know about a renderable,
+    // copied out of the entity graph so the renderer never chases entity pointers
+    struct RenderObject
+    {
+        math::Matrix transform          = math::Matrix::Identity;
+        math::Matrix transform_previous = math::Matrix::Identity;
+        math::BoundingBox aabb;
+        uint64_t entity_id              = 0;
+        uint64_t material_id            = 0;
+        uint64_t transform_revision     = 0;
+        float distance_squared          = 0.0f;
+        uint32_t material_index         = 0;
+        uint32_t cull_mode              = 0;
+        uint32_t lod_index              = 0;
+        uint32_t instance_count         = 1;
+        uint32_t index_count            = 0; // of the selected lod
+        uint32_t index_offset           = 0;
+        uint32_t vertex_offset          = 0;
+        uint32_t index_offset_lod0      = 0; // acceleration structures are always built from lod 0
+        uint32_t vertex_offset_lod0     = 0;
+        uint32_t flags                  = 0;
+
+        // gpu resource handles only (vertex/index/instance buffers, blas), never read for state
+        Renderable* renderable = nullptr;
+        Material* material     = nullptr;
+
+        bool HasFlag(const RenderObjectFlags flag) const { return flags & flag; }
+        // true if this can't go through the gpu-driven indirect path
+        bool IsCpuDriven() const
+        {
+            return HasFlag(RenderObject_Tessellated) || HasFlag(RenderObject_AlphaTested) || instance_count > 1 || !HasFlag(RenderObject_CullBack);
+        }
+    };
+
+    struct RenderLight
+    {
+        std::array<math::Matrix, 6> view_projection;
+        math::Vector3 position;
+        math::Vector3 direction;
+        math::BoundingBox aabb;
+        Color color;
+        float intensity     = 0.0f;
+        float range         = 0.0f;
+        float angle         = 0.0f;
+        float area_width    = 0.0f;
+        float area_height   = 0.0f;
+        float draw_distance = 0.0f;
+        uint32_t slice_count = 0;
+        uint32_t flags       = 0; // same layout as Sb_Light::flags
+        bool active          = false;
+        bool directional     = false;
+
+        // shadow atlas allocations and the light index are renderer outputs stored on the light
+        Light* light = nullptr;
+    };
+
+    // a compact copy of the render-relevant world state, extracted once per frame.
+    // membership is rebuilt when the world revision changes, transforms are copied
+    // only for entities whose transform revision moved, materials and lights only
+    // when the world reports a change, culling outputs (lod, distance, visibility) every frame.
+    class RenderWorld
+    {
+    public:
+        // returns true if material parameters or the set of materials in use changed
+        static bool Extract(const bool materials_changed, const bool lights_changed);
+        static void Clear();
+
+        // renderable and light components call this when they are created or destroyed
+        static void MarkDirty();
+
+        // call after material indices have been (re)assigned
+        static void RefreshMaterialIndices();
+
+        static std::vector<RenderObject>& GetObjects();
+        static const std::vector<RenderLight>& GetLights();
+        static const std::vector<Material*>& GetMaterials(); // unique, in first-use order
+
+        // stats for the last extraction
+        static uint32_t GetTransformUpdateCount();
+        static bool WasRebuilt();
+    };
+}
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Renderer.h"
 #include "Material.h"
 #include "GeometryBuffer.h"
+#include "RenderWorld.h"
 #include "ThreadPool.h"
 #include "../Profiling/RenderDoc.h"
 #include "../Profiling/Profiler.h"
@@ -49,6 +50,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Commands/Console/ConsoleCommands.h"
 #include "../Core/Breadcrumbs.h"
 #include "../XR/Xr.h"
+#include "../Memory/Allocator.h"
+#include "../Memory/FrameAllocator.h"
 //==============================================
 
 //= NAMESPACES ===============
@@ -138,6 +141,8 @@ namespace spartan
 
     void Renderer::Initialize()
     {
+        SP_MEMORY_TAG(MemoryTag::Rendering);
+
         // device
         {
             if (Debugging::IsRenderdocEnabled())
@@ -266,6 +271,7 @@ namespace spartan
 
     void Renderer::Tick()
     {
+        SP_MEMORY_TAG(MemoryTag::Rendering);
         Profiler::FrameStart();
 
         {
@@ -361,9 +367,27 @@ namespace spartan
                 DestroyAccelerationStructures();
             }
 
+            // extract the render-relevant world state, the cpu passes below only read this snapshot
+            bool initialize        = GetFrameNumber() == 0;
+            bool lights_changed    = false;
+            bool materials_changed = false;
+            if (!is_loading)
+            {
+                lights_changed    = initialize || World::HaveLightsChangedThisFrame();
+                materials_changed = initialize || World::HaveMaterialsChangedThisFrame();
+                materials_changed = RenderWorld::Extract(materials_changed, lights_changed);
+            }
+
             // rotate per-frame buffers to avoid cpu-gpu races
             RotateFrameBuffers();
 
+            // materials go first so that this frame's draw data sees their new indices
+            if (materials_changed)
+            {
+                UpdateMaterials(m_cmd_list_present);
+                RHI_Device::UpdateBindlessMaterials(&m_bindless_textures, GetBuffer(Renderer_Buffer::MaterialParameters));
+            }
+
             UpdateDrawCalls(m_cmd_list_present);
 
             if (!is_loading)
@@ -392,23 +416,14 @@ namespace spartan
             // bindless resource updates
             if (!is_loading)
             {
-                bool initialize = GetFrameNumber() == 0;
-
                 // lights
-                if (initialize || World::HaveLightsChangedThisFrame())
+                if (lights_changed)
                 {
                     UpdateShadowAtlas();
                     UpdateLights(m_cmd_list_present);
                     RHI_Device::UpdateBindlessLights(GetBuffer(Renderer_Buffer::LightParameters));
                 }
 
-                // materials
-                if (initialize || World::HaveMaterialsChangedThisFrame())
-                {
-                    UpdateMaterials(m_cmd_list_present);
-                    RHI_Device::UpdateBindlessMaterials(&m_bindless_textures, GetBuffer(Renderer_Buffer::MaterialParameters));
-                }
-
                 // samplers
                 if (m_bindless_samplers_dirty)
                 {
@@ -812,6 +827,8 @@ namespace spartan
             {
                 m_cmd_list_present->Submit(nullptr, true);
             }
+
+            SignalFrameBuffers();
         }
         Profiler::TimeBlockEnd();
     }
@@ -826,13 +843,9 @@ namespace spartan
         return frame_num;
     }
 
-    bool Renderer::IsCpuDrivenDraw(const Renderer_DrawCall& draw_call, Material* material)
+    uint32_t Renderer::GetFramesInFlight()
     {
-        bool is_tessellated  = material->GetProperty(MaterialProperty::Tessellation) > 0.0f;
-        bool is_instanced    = draw_call.instance_count > 1;
-        bool is_alpha_tested = material->IsAlphaTested();
-        bool is_non_standard_cull = static_cast<RHI_CullMode>(material->GetProperty(MaterialProperty::CullMode)) != RHI_CullMode::Back;
-        return is_tessellated || is_instanced || is_alpha_tested || is_non_standard_cull;
+        return clamp(cvar_frames_in_flight.GetValueAs<uint32_t>(), 1u, static_cast<uint32_t>(rhi_max_frames_in_flight));
     }
 
     void Renderer::SetCommonTextures(RHI_CommandList* cmd_list)
@@ -879,15 +892,10 @@ namespace spartan
     void Renderer::UpdateMaterials(RHI_CommandList* cmd_list)
     {
         static array<Sb_Material, rhi_max_array_size> properties;
-        static unordered_set<uint64_t> unique_material_ids;
         uint32_t count = 0;
     
         auto update_material = [&count](Material* material)
         {
-            if (unique_material_ids.find(material->GetObjectId()) != unique_material_ids.end())
-                return;
-    
-            unique_material_ids.insert(material->GetObjectId());
             {
                 SP_ASSERT(count < rhi_max_array_size);
 
@@ -952,29 +960,15 @@ namespace spartan
             count += static_cast<uint32_t>(MaterialTextureType::Max) * Material::slots_per_texture;
         };
     
-        auto update_entities = [update_material]()
-        {
-            for (Entity* entity : World::GetEntities())
-            {
-                if (entity->GetActive())
-                {
-                    if (Renderable* renderable = entity->GetComponent<Renderable>())
-                    {
-                        if (Material* material = renderable->GetMaterial())
-                        {
-                            update_material(material);
-                        }
-                    }
-                }
-            }
-        };
-    
-        // cpu
+        // cpu (the snapshot's material list is already unique)
         {
             properties.fill(Sb_Material{});
             m_bindless_textures.fill(nullptr);
-            unique_material_ids.clear();
-            update_entities();
+            for (Material* material : RenderWorld::GetMaterials())
+            {
+                update_material(material);
+            }
+            RenderWorld::RefreshMaterialIndices();
         }
     
         // gpu
@@ -992,42 +986,37 @@ namespace spartan
     
         m_bindless_lights.fill(Sb_Light());
         
-        m_count_active_lights    = 0; 
-        Light* first_directional = nullptr;
+        m_count_active_lights                = 0; 
+        const RenderLight* first_directional = nullptr;
     
-        auto fill_light = [&](Light* light_component)
+        auto fill_light = [&](const RenderLight& render_light)
         {
             const uint32_t index = m_count_active_lights++;
             
+            Light* light_component = render_light.light;
             light_component->SetIndex(index);
             Sb_Light& light_buffer_entry = m_bindless_lights[index];
     
-            for (uint32_t i = 0; i < light_component->GetSliceCount(); i++)
+            for (uint32_t i = 0; i < render_light.slice_count; i++)
             {
-                light_buffer_entry.view_projection[i] = light_component->GetViewProjectionMatrix(i);
+                light_buffer_entry.view_projection[i] = render_light.view_projection[i];
             }
     
-            light_buffer_entry.screen_space_shadows_slice_index  = light_component->GetScreenSpaceShadowsSliceIndex();
-            light_buffer_entry.intensity                         = light_component->GetIntensityWatt();
-            light_buffer_entry.range                             = light_component->GetRange();
-            light_buffer_entry.angle                             = light_component->GetAngle();
-            light_buffer_entry.color                             = light_component->GetColor();
-            light_buffer_entry.position                          = light_component->GetEntity()->GetPosition();
-            light_buffer_entry.direction                         = light_component->GetEntity()->GetForward();
-            light_buffer_entry.area_width                        = light_component->GetAreaWidth();
-            light_buffer_entry.area_height                       = light_component->GetAreaHeight();
-            light_buffer_entry.flags                             = 0;
-            light_buffer_entry.flags                            |= light_component->GetLightType() == LightType::Directional ? (1 << 0) : 0;
-            light_buffer_entry.flags                            |= light_component->GetLightType() == LightType::Point       ? (1 << 1) : 0;
-            light_buffer_entry.flags                            |= light_component->GetLightType() == LightType::Spot        ? (1 << 2) : 0;
-            light_buffer_entry.flags                            |= light_component->GetFlag(LightFlags::Shadows)             ? (1 << 3) : 0;
-            light_buffer_entry.flags                            |= light_component->GetFlag(LightFlags::ShadowsScreenSpace)  ? (1 << 4) : 0;
-            light_buffer_entry.flags                            |= light_component->GetFlag(LightFlags::Volumetric)          ? (1 << 5) : 0;
-            light_buffer_entry.flags                            |= light_component->GetLightType() == LightType::Area        ? (1 << 6) : 0;
+            light_buffer_entry.screen_space_shadows_slice_index  = index;
+            light_buffer_entry.intensity                         = render_light.intensity;
+            light_buffer_entry.range                             = render_light.range;
+            light_buffer_entry.angle                             = render_light.angle;
+            light_buffer_entry.color                             = render_light.color;
+            light_buffer_entry.position                          = render_light.position;
+            light_buffer_entry.direction                         = render_light.direction;
+            light_buffer_entry.area_width                        = render_light.area_width;
+            light_buffer_entry.area_height                       = render_light.area_height;
+            light_buffer_entry.flags                             = render_light.flags;
     
+            // atlas placement is a renderer output, it lives on the light
             for (uint32_t i = 0; i < 6; i++)
             {
-                if (i < light_component->GetSliceCount())
+                if (i < render_light.slice_count)
                 {
                     light_buffer_entry.atlas_offsets[i]      = light_component->GetAtlasOffset(i);
                     light_buffer_entry.atlas_scales[i]       = light_component->GetAtlasScale(i);
@@ -1044,57 +1033,51 @@ namespace spartan
         };
     
         // directional light always goes in slot 0
-        for (Entity* entity : World::GetEntitiesLights())
+        for (const RenderLight& render_light : RenderWorld::GetLights())
         {
-            if (Light* light_component = entity->GetComponent<Light>())
+            if (render_light.directional)
             {
-                if (light_component->GetLightType() == LightType::Directional)
-                {
-                    first_directional = light_component;
+                first_directional = &render_light;
     
-                    // slot 0 is always the sun, even if disabled
-                    fill_light(light_component);
-                    if (!light_component->GetEntity()->GetActive())
-                    {
-                        m_bindless_lights[0].intensity = 0.0f;
-                    }
-                    break;
+                // slot 0 is always the sun, even if disabled
+                fill_light(render_light);
+                if (!render_light.active)
+                {
+                    m_bindless_lights[0].intensity = 0.0f;
                 }
+                break;
             }
         }
     
         // remaining lights
-        for (Entity* entity : World::GetEntitiesLights())
+        for (const RenderLight& render_light : RenderWorld::GetLights())
         {
-            if (Light* light_component = entity->GetComponent<Light>())
-            {
-                if (light_component == first_directional)
-                    continue;
+            if (&render_light == first_directional)
+                continue;
     
-                light_component->SetIndex(numeric_limits<uint32_t>::max());
+            render_light.light->SetIndex(numeric_limits<uint32_t>::max());
     
-                if (!light_component->GetEntity()->GetActive())
-                    continue;
-    
-                if (light_component->GetIntensityWatt() <= 0.0f)
-                    continue;
+            if (!render_light.active)
+                continue;
     
-                if (Camera* camera = World::GetCamera())
-                {
-                    if (!camera->IsInViewFrustum(light_component->GetBoundingBox()))
-                        continue;
-                }
+            if (render_light.intensity <= 0.0f)
+                continue;
     
-                if (light_component->GetLightType() != LightType::Directional)
-                {
-                    const float distance_squared      = Vector3::DistanceSquared(light_component->GetEntity()->GetPosition(), camera_pos);
-                    const float draw_distance_squared = light_component->GetDrawDistance() * light_component->GetDrawDistance();
-                    if (distance_squared > draw_distance_squared)
-                        continue;
-                }
+            if (Camera* camera = World::GetCamera())
+            {
+                if (!camera->IsInViewFrustum(render_light.aabb))
+                    continue;
+            }
     
-                fill_light(light_component);
+            if (!render_light.directional)
+            {
+                const float distance_squared      = Vector3::DistanceSquared(render_light.position, camera_pos);
+                const float draw_distance_squared = render_light.draw_distance * render_light.draw_distance;
+                if (distance_squared > draw_distance_squared)
+                    continue;
             }
+    
+            fill_light(render_light);
         }
     
         // gpu upload
@@ -1109,14 +1092,15 @@ namespace spartan
 
     void Renderer::UpdateBoundingBoxes(RHI_CommandList* cmd_list)
     {
+        const vector<RenderObject>& objects = RenderWorld::GetObjects();
+
         m_bindless_aabbs.fill(Sb_Aabb());
 
         // prepass aabbs (must match the indexing in indirect_cull.hlsl)
         for (uint32_t i = 0; i < m_draw_calls_prepass_count; i++)
         {
             const Renderer_DrawCall& draw_call = m_draw_calls_prepass[i];
-            Renderable* renderable             = draw_call.renderable;
-            const BoundingBox& aabb            = renderable->GetBoundingBox();
+            const BoundingBox& aabb            = objects[draw_call.object_index].aabb;
             m_bindless_aabbs[i].min            = aabb.GetMin();
             m_bindless_aabbs[i].max            = aabb.GetMax();
             m_bindless_aabbs[i].is_occluder    = draw_call.is_occluder;
@@ -1128,19 +1112,16 @@ namespace spartan
             for (uint32_t i = 0; i < m_draw_call_count && indirect_idx < m_indirect_draw_count; i++)
             {
                 const Renderer_DrawCall& dc = m_draw_calls[i];
-                Material* material          = dc.renderable->GetMaterial();
+                const RenderObject& object  = objects[dc.object_index];
 
-                if (!material || material->IsTransparent())
-                    continue;
-                if (IsCpuDrivenDraw(dc, material))
+                if (object.HasFlag(RenderObject_Transparent) || dc.is_cpu_driven)
                     continue;
 
                 uint32_t aabb_slot = m_draw_calls_prepass_count + indirect_idx;
                 if (aabb_slot < rhi_max_array_size)
                 {
-                    const BoundingBox& aabb       = dc.renderable->GetBoundingBox();
-                    m_bindless_aabbs[aabb_slot].min = aabb.GetMin();
-                    m_bindless_aabbs[aabb_slot].max = aabb.GetMax();
+                    m_bindless_aabbs[aabb_slot].min = object.aabb.GetMin();
+                    m_bindless_aabbs[aabb_slot].max = object.aabb.GetMax();
                 }
                 indirect_idx++;
             }
@@ -1166,58 +1147,58 @@ namespace spartan
         if (ProgressTracker::IsLoading())
             return;
 
+        const vector<RenderObject>& objects = RenderWorld::GetObjects();
+
         // collect draw calls
         {
-            for (Entity* entity : World::GetEntities())
+            for (uint32_t object_index = 0; object_index < static_cast<uint32_t>(objects.size()); object_index++)
             {
-                if (!entity->GetActive())
+                const RenderObject& object = objects[object_index];
+                if (!object.HasFlag(RenderObject_Active) || !object.material)
                     continue;
 
-                if (Renderable* renderable = entity->GetComponent<Renderable>())
+                bool is_transparent = object.HasFlag(RenderObject_Transparent);
+                if (is_transparent)
                 {
-                    Material* material = renderable->GetMaterial();
-                    if (!material)
-                        continue;
-
-                    if (material->IsTransparent())
-                    {
-                        m_transparents_present = true;
-                    }
-
-                    uint32_t draw_data_index = WriteDrawData(
-                        entity->GetMatrix(),
-                        entity->GetMatrixPrevious(),
-                        material->GetIndex(),
-                        material->IsTransparent() ? 1 : 0
-                    );
-
-                    Renderer_DrawCall& draw_call = m_draw_calls[m_draw_call_count++];
-                    draw_call.renderable         = renderable;
-                    draw_call.distance_squared   = renderable->GetDistanceSquared();
-                    draw_call.lod_index          = renderable->GetLodIndex();
-                    draw_call.is_occluder        = false;
-                    draw_call.camera_visible     = renderable->IsVisible();
-                    draw_call.instance_index     = 0;
-                    draw_call.instance_count     = renderable->GetInstanceCount();
-                    draw_call.draw_data_index    = draw_data_index;
+                    m_transparents_present = true;
                 }
+
+                uint32_t draw_data_index = WriteDrawData(
+                    object.transform,
+                    object.transform_previous,
+                    object.material_index,
+                    is_transparent ? 1 : 0
+                );
+
+                Renderer_DrawCall& draw_call = m_draw_calls[m_draw_call_count++];
+                draw_call.renderable         = object.renderable;
+                draw_call.object_index       = object_index;
+                draw_call.distance_squared   = object.distance_squared;
+                draw_call.lod_index          = object.lod_index;
+                draw_call.is_occluder        = false;
+                draw_call.camera_visible     = object.HasFlag(RenderObject_Visible);
+                draw_call.is_cpu_driven      = object.IsCpuDriven();
+                draw_call.instance_index     = 0;
+                draw_call.instance_count     = object.instance_count;
+                draw_call.draw_data_index    = draw_data_index;
             }
 
             // sort: opaque before transparent, then material, then distance
-            sort(m_draw_calls.begin(), m_draw_calls.begin() + m_draw_call_count, [](const Renderer_DrawCall& a, const Renderer_DrawCall& b)
+            sort(m_draw_calls.begin(), m_draw_calls.begin() + m_draw_call_count, [&objects](const Renderer_DrawCall& a, const Renderer_DrawCall& b)
             {
-                bool a_transparent = a.renderable->GetMaterial()->IsTransparent();
-                bool b_transparent = b.renderable->GetMaterial()->IsTransparent();
+                const RenderObject& object_a = objects[a.object_index];
+                const RenderObject& object_b = objects[b.object_index];
+
+                bool a_transparent = object_a.HasFlag(RenderObject_Transparent);
+                bool b_transparent = object_b.HasFlag(RenderObject_Transparent);
                 if (a_transparent != b_transparent)
                 {
                     return !a_transparent;
                 }
 
-                uint64_t a_material_id = a.renderable->GetMaterial()->GetObjectId();
-                uint64_t b_material_id = b.renderable->GetMaterial()->GetObjectId();
-                if (a_material_id != b_material_id)
+                if (object_a.material_id != object_b.material_id)
                 {
-                    return a_material_id < b_material_id;
+                    return object_a.material_id < object_b.material_id;
                 }
 
                 if (!a_transparent)
@@ -1236,16 +1217,16 @@ namespace spartan
             for (uint32_t i = 0; i < m_draw_call_count; ++i)
             {
                 const Renderer_DrawCall& dc = m_draw_calls[i];
-                if (!dc.renderable->GetMaterial()->IsTransparent() && dc.camera_visible)
+                if (!objects[dc.object_index].HasFlag(RenderObject_Transparent) && dc.camera_visible)
                 {
                     m_draw_calls_prepass[m_draw_calls_prepass_count++] = dc;
                 }
             }
 
-            sort(m_draw_calls_prepass.begin(), m_draw_calls_prepass.begin() + m_draw_calls_prepass_count, [](const Renderer_DrawCall& a, const Renderer_DrawCall& b)
+            sort(m_draw_calls_prepass.begin(), m_draw_calls_prepass.begin() + m_draw_calls_prepass_count, [&objects](const Renderer_DrawCall& a, const Renderer_DrawCall& b)
             {
-                bool a_alpha = a.renderable->GetMaterial()->IsAlphaTested();
-                bool b_alpha = b.renderable->GetMaterial()->IsAlphaTested();
+                bool a_alpha = objects[a.object_index].HasFlag(RenderObject_AlphaTested);
+                bool b_alpha = objects[b.object_index].HasFlag(RenderObject_AlphaTested);
                 if (a_alpha != b_alpha)
                 {
                     return !a_alpha;
@@ -1260,12 +1241,9 @@ namespace spartan
             for (uint32_t i = 0; i < m_draw_call_count; i++)
             {
                 const Renderer_DrawCall& dc = m_draw_calls[i];
-                Renderable* renderable      = dc.renderable;
-                Material* material          = renderable->GetMaterial();
+                const RenderObject& object  = objects[dc.object_index];
 
-                if (!material || material->IsTransparent())
-                    continue;
-                if (IsCpuDrivenDraw(dc, material))
+                if (object.HasFlag(RenderObject_Transparent) || dc.is_cpu_driven)
                     continue;
 
                 uint32_t idx = m_indirect_draw_count++;
@@ -1273,19 +1251,18 @@ namespace spartan
                     break;
 
                 Sb_IndirectDrawArgs& args = m_indirect_draw_args[idx];
-                args.index_count          = renderable->GetIndexCount(dc.lod_index);
+                args.index_count          = object.index_count;
                 args.instance_count       = dc.instance_count;
-                args.first_index          = renderable->GetIndexOffset(dc.lod_index);
-                args.vertex_offset        = static_cast<int32_t>(renderable->GetVertexOffset(dc.lod_index));
+                args.first_index          = object.index_offset;
+                args.vertex_offset        = static_cast<int32_t>(object.vertex_offset);
                 args.first_instance       = dc.instance_index;
 
                 // per-draw data (aabb_index includes the frame offset into the shared aabb buffer)
                 uint32_t aabb_frame_offset = m_frame_resource_index * rhi_max_array_size;
                 Sb_DrawData& data       = m_indirect_draw_data[idx];
-                Entity* entity          = renderable->GetEntity();
-                data.transform          = entity->GetMatrix();
-                data.transform_previous = entity->GetMatrixPrevious();
-                data.material_index     = material->GetIndex();
+                data.transform          = object.transform;
+                data.transform_previous = object.transform_previous;
+                data.material_index     = object.material_index;
                 data.is_transparent     = 0;
                 data.aabb_index         = aabb_frame_offset + m_draw_calls_prepass_count + idx;
                 data.padding            = 0;
@@ -1294,7 +1271,7 @@ namespace spartan
 
         // select occluders (top N by screen area, with temporal hysteresis)
         {
-            static unordered_set<Renderable*> previous_occluders;
+            static unordered_set<uint64_t> previous_occluders; // entity ids, stable across snapshot rebuilds
 
             auto compute_screen_space_area = [&](const BoundingBox& aabb_world) -> float
             {
@@ -1312,23 +1289,21 @@ namespace spartan
                 uint32_t index;
                 float area;
             };
-            static vector<DrawCallArea> areas;
-            areas.clear();
+            FrameVector<DrawCallArea> areas;
             areas.reserve(m_draw_calls_prepass_count);
 
             for (uint32_t i = 0; i < m_draw_calls_prepass_count; i++)
             {
                 Renderer_DrawCall& draw_call = m_draw_calls_prepass[i];
-                Renderable* renderable = draw_call.renderable;
-                Material* material = renderable->GetMaterial();
+                const RenderObject& object   = objects[draw_call.object_index];
 
-                if (!material || material->IsTransparent() || renderable->HasInstancing() || !draw_call.camera_visible)
+                if (object.HasFlag(RenderObject_Transparent) || object.HasFlag(RenderObject_Instanced) || !draw_call.camera_visible)
                     continue;
 
-                float screen_area = compute_screen_space_area(renderable->GetBoundingBox());
+                float screen_area = compute_screen_space_area(object.aabb);
 
                 // temporal hysteresis: bonus for previous occluders
-                if (previous_occluders.find(renderable) != previous_occluders.end())
+                if (previous_occluders.find(object.entity_id) != previous_occluders.end())
                 {
                     screen_area *= 1.5f;
                 }
@@ -1348,7 +1323,7 @@ namespace spartan
             for (uint32_t i = 0; i < occluder_count; i++)
             {
                 m_draw_calls_prepass[areas[i].index].is_occluder = true;
-                previous_occluders.insert(m_draw_calls_prepass[areas[i].index].renderable);
+                previous_occluders.insert(objects[m_draw_calls_prepass[areas[i].index].object_index].entity_id);
             }
         }
     }
@@ -1369,24 +1344,22 @@ namespace spartan
         {
             uint32_t blas_built   = 0;
             uint32_t blas_skipped = 0;
-            for (Entity* entity : World::GetEntities())
+            for (const RenderObject& object : RenderWorld::GetObjects())
             {
-                if (!entity->GetActive())
+                if (!object.HasFlag(RenderObject_Active))
                     continue;
 
-                if (Renderable* renderable = entity->GetComponent<Renderable>())
+                Renderable* renderable = object.renderable;
+                if (!renderable->HasAccelerationStructure())
                 {
-                    if (!renderable->HasAccelerationStructure())
+                    renderable->BuildAccelerationStructure(cmd_list);
+                    if (renderable->HasAccelerationStructure())
                     {
-                        renderable->BuildAccelerationStructure(cmd_list);
-                        if (renderable->HasAccelerationStructure())
-                        {
-                            blas_built++;
-                        }
-                        else
-                        { 
-                            blas_skipped++;
-                        }
+                        blas_built++;
+                    }
+                    else
+                    { 
+                        blas_skipped++;
                     }
                 }
             }
@@ -1406,52 +1379,46 @@ namespace spartan
 
             constexpr uint32_t RHI_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT = 0x00000002; // VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR
 
-            static vector<RHI_AccelerationStructureInstance> instances; // static to avoid per-frame heap alloc
-            static vector<Sb_GeometryInfo> geometry_infos;
+            static vector<RHI_AccelerationStructureInstance> instances; // static to avoid per-frame heap alloc, BuildTopLevel() takes a std::vector
+            FrameVector<Sb_GeometryInfo> geometry_infos;
             instances.clear();
-            geometry_infos.clear();
 
-            for (Entity* entity : World::GetEntities())
+            for (const RenderObject& object : RenderWorld::GetObjects())
             {
-                if (!entity->GetActive())
+                if (!object.HasFlag(RenderObject_Active) || !object.material)
                     continue;
-    
-               if (Renderable* renderable = entity->GetComponent<Renderable>())
-                {
-                    if (Material* material = renderable->GetMaterial())
-                    {
-                        uint64_t device_address = renderable->GetAccelerationStructureDeviceAddress();
-                        if (device_address == 0)
-                            continue;
-
-                        RHI_Buffer* vertex_buffer = renderable->GetVertexBuffer();
-                        RHI_Buffer* index_buffer  = renderable->GetIndexBuffer();
-                        if (!vertex_buffer || !index_buffer)
-                            continue;
-
-                        RHI_CullMode cull_mode = static_cast<RHI_CullMode>(material->GetProperty(MaterialProperty::CullMode));
-
-                        RHI_AccelerationStructureInstance instance           = {};
-                        instance.instance_custom_index                       = material->GetIndex(); // for hit shader material lookup
-                        instance.mask                                        = 0xFF;                 // visible to all rays
-                        instance.instance_shader_binding_table_record_offset = 0;                    // sbt hit group offset
-                        instance.flags                                       = cull_mode == RHI_CullMode::None ? RHI_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT : 0;
-                        instance.device_address                              = device_address;
-
-                        // row-major 3x4 transform (transpose 3x3 because vulkan uses column vectors)
-                        const Matrix& m = renderable->GetEntity()->GetMatrix();
-                        instance.transform[0]  = m.m00; instance.transform[1]  = m.m10; instance.transform[2]  = m.m20; instance.transform[3]  = m.m30;
-                        instance.transform[4]  = m.m01; instance.transform[5]  = m.m11; instance.transform[6]  = m.m21; instance.transform[7]  = m.m31;
-                        instance.transform[8]  = m.m02; instance.transform[9]  = m.m12; instance.transform[10] = m.m22; instance.transform[11] = m.m32;
-
-                        instances.push_back(instance);
-
-                        Sb_GeometryInfo geo_info = {};
-                        geo_info.vertex_offset  = renderable->GetVertexOffset(0);
-                        geo_info.index_offset   = renderable->GetIndexOffset(0);
-                        geometry_infos.push_back(geo_info);
-                    }
-                }
+
+                Renderable* renderable  = object.renderable;
+                uint64_t device_address = renderable->GetAccelerationStructureDeviceAddress();
+                if (device_address == 0)
+                    continue;
+
+                RHI_Buffer* vertex_buffer = renderable->GetVertexBuffer();
+                RHI_Buffer* index_buffer  = renderable->GetIndexBuffer();
+                if (!vertex_buffer || !index_buffer)
+                    continue;
+
+                RHI_CullMode cull_mode = static_cast<RHI_CullMode>(object.cull_mode);
+
+                RHI_AccelerationStructureInstance instance           = {};
+                instance.instance_custom_index                       = object.material_index; // for hit shader material lookup
+                instance.mask                                        = 0xFF;                  // visible to all rays
+                instance.instance_shader_binding_table_record_offset = 0;                     // sbt hit group offset
+                instance.flags                                       = cull_mode == RHI_CullMode::None ? RHI_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT : 0;
+                instance.device_address                              = device_address;
+
+                // row-major 3x4 transform (transpose 3x3 because vulkan uses column vectors)
+                const Matrix& m = object.transform;
+                instance.transform[0]  = m.m00; instance.transform[1]  = m.m10; instance.transform[2]  = m.m20; instance.transform[3]  = m.m30;
+                instance.transform[4]  = m.m01; instance.transform[5]  = m.m11; instance.transform[6]  = m.m21; instance.transform[7]  = m.m31;
+                instance.transform[8]  = m.m02; instance.transform[9]  = m.m12; instance.transform[10] = m.m22; instance.transform[11] = m.m32;
+
+                instances.push_back(instance);
+
+                Sb_GeometryInfo geo_info = {};
+                geo_info.vertex_offset  = object.vertex_offset_lod0;
+                geo_info.index_offset   = object.index_offset_lod0;
+                geometry_infos.push_back(geo_info);
             }
     
             static uint32_t last_instance_count = 0;
@@ -85,6 +85,7 @@ namespace spartan
     extern TConsoleVar<float> cvar_auto_exposure_adaptation_speed;
     extern TConsoleVar<float> cvar_cloud_coverage;
     extern TConsoleVar<float> cvar_cloud_shadows;
+    extern TConsoleVar<float> cvar_frames_in_flight;
 
     struct ShadowSlice
     {
@@ -132,6 +133,7 @@ namespace spartan
         // misc
         static void SetStandardResources(RHI_CommandList* cmd_list);
         static uint64_t GetFrameNumber();
+        static uint32_t GetFramesInFlight();
         static RHI_Api_Type GetRhiApiType();
         static void Screenshot();
         static RHI_CommandList* GetCommandListPresent() { return m_cmd_list_present; }
@@ -250,9 +252,6 @@ namespace spartan
         static void UpdateLights(RHI_CommandList* cmd_lis);
         static void UpdateBoundingBoxes(RHI_CommandList* cmd_list);
 
-        // true if this draw can't go through the gpu-driven indirect path
-        static bool IsCpuDrivenDraw(const Renderer_DrawCall& draw_call, Material* material);
-
         // misc
         static void AddLinesToBeRendered();
         static void UpdatePersistentLines();
@@ -262,6 +261,8 @@ namespace spartan
         static void UpdateDrawCalls(RHI_CommandList* cmd_list);
         static void UpdateAccelerationStructures(RHI_CommandList* cmd_list);
         static void RotateFrameBuffers();
+        static void SignalFrameBuffers();
+        static void WaitForFrameBuffers(const uint32_t index);
 
         // draw calls
         static std::array<Renderer_DrawCall, renderer_max_draw_calls> m_draw_calls;
@@ -282,6 +283,15 @@ namespace spartan
             std::shared_ptr<RHI_Buffer> indirect_draw_args_out;
             std::shared_ptr<RHI_Buffer> indirect_draw_data_out;
             std::shared_ptr<RHI_Buffer> indirect_draw_count;
+
+            // the last submissions of the frame that owns the slot, the gpu is done with it once they complete
+            // a command list that has been recycled since was already waited for, the timeline value tells them apart
+            struct Fence
+            {
+                RHI_CommandList* cmd_list = nullptr;
+                uint64_t value            = 0;
+            };
+            std::array<Fence, 2> fences; // graphics, compute
         };
         static std::array<FrameResource, renderer_draw_data_buffer_count> m_frame_resources;
         static uint32_t m_frame_resource_index;
@@ -121,6 +121,12 @@ namespace spartan
             }
         }
 
+        void on_frames_in_flight_change(const CVarVariant& value)
+        {
+            float v = clamp(round(get<float>(value)), 1.0f, static_cast<float>(rhi_max_frames_in_flight));
+            *ConsoleRegistry::Get().Find("r.frames_in_flight")->m_value_ptr = v;
+        }
+
         void on_performance_metrics_change(const CVarVariant& value)
         {
             static bool was_enabled = false;
@@ -170,6 +176,7 @@ namespace spartan
     TConsoleVar<float> cvar_variable_rate_shading          ("r.variable_rate_shading",          0.0f,                                                    "variable rate shading",                   on_vrs_change);
     TConsoleVar<float> cvar_resolution_scale               ("r.resolution_scale",               1.0f,                                                    "render resolution scale (0.5-1.0)",       on_resolution_scale_change);
     TConsoleVar<float> cvar_dynamic_resolution             ("r.dynamic_resolution",             0.0f,                                                    "automatic resolution scaling");
+    TConsoleVar<float> cvar_frames_in_flight               ("r.frames_in_flight",               2.0f,                                                    "frames the cpu can record ahead of the gpu (1-3)", on_frames_in_flight_change);
     // misc
     TConsoleVar<float> cvar_hiz_occlusion                  ("r.hiz_occlusion",                  1.0f,                                                    "hi-z occlusion culling for gpu-driven rendering");
     TConsoleVar<float> cvar_auto_exposure_adaptation_speed ("r.auto_exposure_adaptation_speed", 0.5f,                                                    "auto exposure adaptation speed, negative disables");
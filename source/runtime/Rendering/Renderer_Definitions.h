@@ -30,7 +30,7 @@ namespace spartan
     const uint32_t renderer_resource_frame_lifetime    = 100;
     const uint32_t renderer_max_draw_calls            = 20000;
     const uint32_t renderer_max_instance_count        = 1024;
-    const uint32_t renderer_draw_data_buffer_count    = 4; // matches the command list pool size to avoid cpu-gpu memcpy races
+    const uint32_t renderer_draw_data_buffer_count    = 4; // frame slots, at least rhi_max_frames_in_flight so a slot is never written while the gpu reads it
 
     enum class Renderer_Option : uint32_t
     {
@@ -432,6 +432,7 @@ namespace spartan
     struct Renderer_DrawCall
     {
         Renderable* renderable   = nullptr;
+        uint32_t object_index    = 0; // index into the render world snapshot
         uint32_t instance_index  = 0;
         uint32_t instance_count  = 0;
         uint32_t lod_index       = 0;
@@ -439,6 +440,7 @@ namespace spartan
         float distance_squared   = 0.0f;
         bool is_occluder         = false;
         bool camera_visible      = false;
+        bool is_cpu_driven       = false; // tessellated, instanced, alpha tested or non-standard culling
     };
 
 }
@@ -546,7 +546,7 @@ namespace spartan
                         continue;
 
                     // skip indirect-path draws
-                    if (!IsCpuDrivenDraw(draw_call, material))
+                    if (!draw_call.is_cpu_driven)
                         continue;
                     {
                         bool is_alpha_tested = material->IsAlphaTested();
@@ -649,17 +649,6 @@ namespace spartan
                     0,
                     m_indirect_draw_count
                 );
-
-                // update previous transforms for motion vectors
-                for (uint32_t i = 0; i < m_draw_call_count; i++)
-                {
-                    Renderer_DrawCall& draw_call = m_draw_calls[i];
-                    if (draw_call.renderable->GetMaterial() && !draw_call.renderable->GetMaterial()->IsTransparent())
-                    {
-                        Entity* entity = draw_call.renderable->GetEntity();
-                        entity->SetMatrixPrevious(entity->GetMatrix());
-                    }
-                }
             }
 
             {
@@ -702,7 +691,7 @@ namespace spartan
                         if (material->IsTransparent())
                             continue;
 
-                        if (!IsCpuDrivenDraw(draw_call, material))
+                        if (!draw_call.is_cpu_driven)
                             continue;
                     }
 
@@ -721,13 +710,10 @@ namespace spartan
                     }
 
                     {
-                        Entity* entity = renderable->GetEntity();
                         m_pcb_pass_cpu.draw_index     = draw_call.draw_data_index;
                         m_pcb_pass_cpu.is_transparent = is_transparent_pass ? 1 : 0;
                         m_pcb_pass_cpu.material_index = material->GetIndex();
                         cmd_list->PushConstants(m_pcb_pass_cpu);
-
-                        entity->SetMatrixPrevious(entity->GetMatrix());
                     }
 
                     {
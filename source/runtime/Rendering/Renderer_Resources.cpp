@@ -36,6 +36,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_DepthStencilState.h"
 #include "../RHI/RHI_Buffer.h"
 #include "../RHI/RHI_Device.h"
+#include "../RHI/RHI_CommandList.h"
+#include "../Profiling/Profiler.h"
 #ifdef _MSC_VER
 #include "../RHI/RHI_VendorTechnology.h"
 #endif
@@ -965,7 +967,21 @@ namespace spartan
 
     void Renderer::RotateFrameBuffers()
     {
-        m_frame_resource_index = (m_frame_resource_index + 1) % renderer_draw_data_buffer_count;
+        static_assert(renderer_draw_data_buffer_count >= rhi_max_frames_in_flight, "every frame in flight needs its own frame resources");
+
+        SP_PROFILE_CPU_START("wait_for_gpu");
+        {
+            // pace the cpu, this frame can only be recorded once the gpu has retired the frame that is frames_in_flight behind it
+            // what overlaps is cpu recording with gpu execution, simulation still runs before recording (see Engine::Tick)
+            const uint32_t index_next = (m_frame_resource_index + 1) % renderer_draw_data_buffer_count;
+            WaitForFrameBuffers((index_next + renderer_draw_data_buffer_count - GetFramesInFlight()) % renderer_draw_data_buffer_count);
+
+            // and take ownership of the slot, already retired by the wait above unless frames complete out of order
+            WaitForFrameBuffers(index_next);
+            m_frame_resource_index = index_next;
+        }
+        SP_PROFILE_CPU_END();
+
         const FrameResource& fr = m_frame_resources[m_frame_resource_index];
 
         buffers[static_cast<uint8_t>(Renderer_Buffer::IndirectDrawArgs)]    = fr.indirect_draw_args;
@@ -975,6 +991,33 @@ namespace spartan
         buffers[static_cast<uint8_t>(Renderer_Buffer::IndirectDrawCount)]   = fr.indirect_draw_count;
     }
 
+    void Renderer::SignalFrameBuffers()
+    {
+        // hand the slot to the gpu, the fences tell the next owner when it's safe to write again
+        FrameResource& fr = m_frame_resources[m_frame_resource_index];
+        fr.fences[0]      = { m_cmd_list_present, m_cmd_list_present->GetLastTimelineSignalValue() };
+        fr.fences[1]      = {};
+        if (m_cmd_list_compute && m_cmd_list_compute->GetState() == RHI_CommandListState::Submitted)
+        {
+            fr.fences[1] = { m_cmd_list_compute, m_cmd_list_compute->GetLastTimelineSignalValue() };
+        }
+    }
+
+    void Renderer::WaitForFrameBuffers(const uint32_t index)
+    {
+        for (FrameResource::Fence& fence : m_frame_resources[index].fences)
+        {
+            // a recycled command list has a newer timeline value, NextCommandList() already waited for it
+            bool in_flight = fence.cmd_list && fence.cmd_list->GetState() == RHI_CommandListState::Submitted && fence.cmd_list->GetLastTimelineSignalValue() == fence.value;
+            if (in_flight)
+            {
+                fence.cmd_list->WaitForExecution();
+            }
+
+            fence = {};
+        }
+    }
+
     RHI_Texture* Renderer::GetStandardTexture(const Renderer_StandardTexture type)
     {
         return standard_textures[static_cast<uint8_t>(type)].get();
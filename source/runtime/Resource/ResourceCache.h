@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include "IResource.h"
 #include "../Logging/Log.h"
+#include "../Memory/Allocator.h"
 #include <mutex>
 #include "../Rendering/Material.h"
 #include "../RHI/RHI_Texture.h"
@@ -147,6 +148,8 @@ namespace spartan
         template <class T>
         static std::shared_ptr<T> Load(const std::string& file_path, uint32_t flags = 0)
         {
+            SP_MEMORY_TAG(MemoryTag::Resources);
+
             if (!FileSystem::Exists(file_path))
             {
                 SP_LOG_ERROR("\"%s\" doesn't exist.", file_path.c_str());
@@ -0,0 +1,1101 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================================
+#include "pch.h"
+#include "Benchmark.h"
+#include "../Core/Engine.h"
+#include "../Core/Timer.h"
+#include "../Core/Window.h"
+#include "../Core/ProgressTracker.h"
+#include "../Game/Game.h"
+#include "../World/World.h"
+#include "../World/Entity.h"
+#include "../World/Prefab.h"
+#include "../World/Components/Camera.h"
+#include "../World/Components/Script.h"
+#include "../World/Components/Volume.h"
+#include "../World/Components/Light.h"
+#include "../World/Components/ParticleSystem.h"
+#include "../World/Components/SplineFollower.h"
+#include "../Profiling/Profiler.h"
+#include "../Profiling/HardwareCounters.h"
+#include "../Memory/Allocator.h"
+#include "../Commands/Console/ConsoleCommands.h"
+#include "../Physics/PhysicsWorld.h"
+#include "../FileSystem/FileSystem.h"
+#include <fstream>
+#include <sstream>
+#include <charconv>
+SP_WARNINGS_OFF
+#ifdef DEBUG
+    #define _DEBUG 1
+    #undef NDEBUG
+#else
+    #define NDEBUG 1
+    #undef _DEBUG
+#endif
+#define PX_PHYSX_STATIC_LIB
+#include <physx/PxPhysicsAPI.h>
+SP_WARNINGS_ON
+//============================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace spartan::math;
+using namespace physx;
+//============================
+
+namespace spartan
+{
+    namespace
+    {
+        enum class State
+        {
+            Idle,
+            Loading,
+            Warmup,
+            Measuring
+        };
+
+        // indexed by DefaultWorld
+        const char* world_names[] =
+        {
+            "showroom",
+            "forest",
+            "liminal_space",
+            "sponza",
+            "cornell",
+            "san_miguel",
+            "basic"
+        };
+        static_assert(size(world_names) == static_cast<size_t>(DefaultWorld::Max), "world_names out of sync with DefaultWorld enum");
+
+        const uint32_t frames_warmup       = 60;    // pipelines and streaming settle in
+        const uint32_t frames_loading_min  = 2;     // the load task may not have started yet
+        const double loading_timeout_sec   = 600.0;
+        const float path_radius            = 8.0f;  // meters, the camera orbits a point this far ahead of its start
+
+        // settings
+        uint32_t frames_measured  = 600;
+        double tolerance_percent  = 10.0;
+        double tolerance_ms       = 0.1;
+        string path_baseline      = "benchmark_baseline.json";
+        const string path_results = "benchmark.json";
+
+        // state
+        State state              = State::Idle;
+        uint32_t world_index     = 0;
+        uint32_t frame_index     = 0;
+        double loading_start_sec = 0.0;
+        Vector3 path_start       = Vector3::Zero;
+        Vector3 path_center      = Vector3::Zero;
+        Benchmark::Results results;
+        vector<string> failures;
+
+        // per world accumulation
+        double frame_ms_sum    = 0.0;
+        double cpu_ms_sum      = 0.0;
+        double allocations_sum = 0.0;
+        vector<float> frame_ms;
+        map<string, double> subsystem_ms_sum;
+        map<string, double> subsystem_counters_sum;
+
+        string sanitize(const char* name)
+        {
+            string out = name ? name : "unnamed";
+            replace(out.begin(), out.end(), '"', '_');
+            replace(out.begin(), out.end(), '\\', '_');
+            return out;
+        }
+
+        // leaves value untouched when the argument is missing or malformed
+        template<typename T>
+        void parse_argument(const char* name, T& value)
+        {
+            const string text = Engine::GetArgumentValue(name);
+            if (text.empty())
+                return;
+
+            T parsed          = T();
+            const char* last  = text.data() + text.size();
+            auto [end, error] = from_chars(text.data(), last, parsed);
+            if (error != errc() || end != last)
+            {
+                SP_LOG_WARNING("Benchmark: ignoring malformed %s \"%s\", keeping the default", name, text.c_str());
+                return;
+            }
+
+            value = parsed;
+        }
+
+        Entity* get_camera_entity()
+        {
+            Camera* camera = World::GetCamera();
+            return camera ? camera->GetEntity() : nullptr;
+        }
+
+        void world_load(const uint32_t index)
+        {
+            SP_LOG_INFO("Benchmark: loading \"%s\"", world_names[index]);
+
+            Game::Load(static_cast<DefaultWorld>(index));
+
+            state             = State::Loading;
+            frame_index       = 0;
+            loading_start_sec = Timer::GetTimeSec();
+        }
+
+        void camera_fly(Entity* entity, const uint32_t frame)
+        {
+            // one full orbit over warmup and measurement, a function of the frame only so every run sees the same views
+            float t     = static_cast<float>(frame) / static_cast<float>(frames_warmup + frames_measured);
+            float angle = t * pi_2;
+
+            Vector3 offset   = Vector3(-sin(angle), 0.0f, -cos(angle)) * path_radius;
+            offset.y         = sin(angle * 2.0f) * path_radius * 0.125f;
+            Vector3 position = path_center + offset;
+
+            entity->SetPosition(position);
+            entity->SetRotation(Quaternion::FromLookRotation((path_center - position).Normalized()));
+        }
+
+        void world_finish()
+        {
+            const string world = world_names[world_index];
+            const double count = static_cast<double>(frames_measured);
+
+            sort(frame_ms.begin(), frame_ms.end());
+            size_t p95_index = min(frame_ms.size() - 1, static_cast<size_t>(static_cast<double>(frame_ms.size()) * 0.95));
+
+            results[world + "/frame_ms"]         = frame_ms_sum / count;
+            results[world + "/frame_p95_ms"]     = frame_ms[p95_index];
+            results[world + "/cpu_ms"]           = cpu_ms_sum / count;
+            results[world + "/heap_allocations"] = allocations_sum / count; // per frame, a count rather than milliseconds
+            for (const auto& [name, sum] : subsystem_ms_sum)
+            {
+                results[world + "/cpu/" + name] = sum / count;
+            }
+            for (const auto& [name, sum] : subsystem_counters_sum)
+            {
+                results[world + "/counters/" + name] = sum / count;
+            }
+
+            SP_LOG_INFO("Benchmark: \"%s\" %.3f ms average frame time, %.3f ms cpu, %.3f ms p95", world.c_str(), frame_ms_sum / count, cpu_ms_sum / count, frame_ms[p95_index]);
+        }
+
+        void finish()
+        {
+            state = State::Idle;
+
+            Benchmark::WriteResults(path_results, results, frames_measured);
+            SP_LOG_INFO("Benchmark: results written to \"%s\"", path_results.c_str());
+
+            bool passed = failures.empty();
+            if (Engine::HasArgument("-benchmark_save_baseline"))
+            {
+                Benchmark::WriteResults(path_baseline, results, frames_measured);
+                SP_LOG_INFO("Benchmark: baseline saved to \"%s\"", path_baseline.c_str());
+            }
+            else
+            {
+                Benchmark::Results baseline;
+                if (Benchmark::ReadResults(path_baseline, baseline))
+                {
+                    passed = Benchmark::Compare(baseline, results, tolerance_percent, tolerance_ms, failures) && passed;
+                }
+                else
+                {
+                    SP_LOG_WARNING("Benchmark: no baseline at \"%s\", nothing to compare against", path_baseline.c_str());
+                }
+            }
+
+            for (const string& failure : failures)
+            {
+                SP_LOG_ERROR("Benchmark: %s", failure.c_str());
+            }
+
+            // same convention as the smoke tests, 0 on the first line means success
+            ofstream file("benchmark_result.txt");
+            if (file.is_open())
+            {
+                file << (passed ? "0" : "1") << endl;
+                for (const string& failure : failures)
+                {
+                    file << failure << endl;
+                }
+            }
+
+            if (passed)
+            {
+                SP_LOG_INFO("Benchmark: passed");
+            }
+            else
+            {
+                SP_LOG_ERROR("Benchmark: failed with %zu issue(s)", failures.size());
+            }
+
+            Window::Close();
+        }
+
+        // terrain collision, a height field against the cooked triangle mesh it replaced
+        // measured once on synthetic hills the size of a terrain chunk, so the numbers don't depend on any world
+        void measure_terrain_collision()
+        {
+            PxPhysics* physics = static_cast<PxPhysics*>(PhysicsWorld::GetPhysics());
+            if (!physics)
+                return;
+
+            const uint32_t size         = 257;  // samples per side, a terrain chunk
+            const float spacing         = 2.0f; // meters between samples
+            const uint32_t ray_count    = 10'000;
+            const uint32_t sweep_count  = 1'000;
+            const float extent          = static_cast<float>(size - 1) * spacing;
+
+            vector<float> heights(size * size);
+            for (uint32_t row = 0; row < size; row++)
+            {
+                for (uint32_t column = 0; column < size; column++)
+                {
+                    float x = static_cast<float>(row), z = static_cast<float>(column);
+                    heights[row * size + column] = sin(x * 0.05f) * cos(z * 0.07f) * 40.0f + sin(x * 0.31f + z * 0.17f) * 4.0f;
+                }
+            }
+
+            // triangle mesh, the same grid and split as the height field
+            vector<PxVec3> vertices(size * size);
+            vector<uint32_t> indices;
+            indices.reserve((size - 1) * (size - 1) * 6);
+            for (uint32_t row = 0; row < size; row++)
+            {
+                for (uint32_t column = 0; column < size; column++)
+                {
+                    vertices[row * size + column] = PxVec3(row * spacing, heights[row * size + column], column * spacing);
+
+                    if (row < size - 1 && column < size - 1)
+                    {
+                        uint32_t i00 = row * size + column, i10 = i00 + size, i01 = i00 + 1, i11 = i10 + 1;
+                        indices.insert(indices.end(), { i00, i01, i10, i10, i01, i11 });
+                    }
+                }
+            }
+
+            PxTolerancesScale tolerances;
+            tolerances.length = 1.0f;
+            tolerances.speed  = PhysicsWorld::GetGravity().Length();
+            PxCookingParams params(tolerances);
+            params.buildTriangleAdjacencies = true;
+            params.meshPreprocessParams    |= PxMeshPreprocessingFlag::eWELD_VERTICES;
+            params.meshWeldTolerance        = 0.01f;
+
+            PxTriangleMeshDesc mesh_desc;
+            mesh_desc.points.count     = static_cast<PxU32>(vertices.size());
+            mesh_desc.points.stride    = sizeof(PxVec3);
+            mesh_desc.points.data      = vertices.data();
+            mesh_desc.triangles.count  = static_cast<PxU32>(indices.size() / 3);
+            mesh_desc.triangles.stride = 3 * sizeof(uint32_t);
+            mesh_desc.triangles.data   = indices.data();
+
+            Stopwatch stopwatch;
+            PxTriangleMesh* mesh = PxCreateTriangleMesh(params, mesh_desc, *PxGetStandaloneInsertionCallback());
+            double mesh_cook_ms  = stopwatch.GetElapsedTimeMs();
+
+            // height field, quantized the way the physics component does it
+            stopwatch.Start();
+            float height_scale  = 0.0f;
+            float height_center = 0.0f;
+            vector<PxHeightFieldSample> samples(size * size);
+            {
+                auto [height_min, height_max] = minmax_element(heights.begin(), heights.end());
+                height_center = (*height_min + *height_max) * 0.5f;
+                height_scale  = max((*height_max - *height_min) * 0.5f / 32767.0f, PX_MIN_HEIGHTFIELD_Y_SCALE);
+                for (uint32_t i = 0; i < size * size; i++)
+                {
+                    samples[i].height = static_cast<PxI16>(roundf((heights[i] - height_center) / height_scale));
+                    samples[i].clearTessFlag();
+                }
+            }
+            PxHeightFieldDesc field_desc;
+            field_desc.format         = PxHeightFieldFormat::eS16_TM;
+            field_desc.nbRows         = size;
+            field_desc.nbColumns      = size;
+            field_desc.samples.data   = samples.data();
+            field_desc.samples.stride = sizeof(PxHeightFieldSample);
+            PxHeightField* field      = PxCreateHeightField(field_desc, *PxGetStandaloneInsertionCallback());
+            double field_cook_ms      = stopwatch.GetElapsedTimeMs();
+
+            if (!mesh || !field)
+            {
+                failures.emplace_back("terrain_collision: failed to create the collision shapes");
+                if (mesh)  mesh->release();
+                if (field) field->release();
+                return;
+            }
+
+            // memory, the serialized size is what each shape keeps resident
+            PxDefaultMemoryOutputStream stream_mesh;
+            PxDefaultMemoryOutputStream stream_field;
+            PxCookTriangleMesh(params, mesh_desc, stream_mesh);
+            PxCookHeightField(field_desc, stream_field);
+
+            PxTriangleMeshGeometry geometry_mesh(mesh);
+            PxHeightFieldGeometry geometry_field(field, PxMeshGeometryFlags(), height_scale, spacing, spacing);
+            PxTransform pose_mesh(PxIdentity);
+            PxTransform pose_field(PxVec3(0.0f, height_center, 0.0f));
+
+            // the same pseudo random rays against both, away from the border, a hit count mismatch means the shapes disagree
+            auto measure_raycasts = [&](const PxGeometry& geometry, const PxTransform& pose, uint32_t& hit_count)
+            {
+                uint32_t seed = 1;
+                hit_count     = 0;
+                Stopwatch stopwatch_rays;
+                for (uint32_t i = 0; i < ray_count; i++)
+                {
+                    seed    = seed * 1664525u + 1013904223u;
+                    float x = (0.01f + static_cast<float>(seed >> 16) / 65535.0f * 0.98f) * extent;
+                    seed    = seed * 1664525u + 1013904223u;
+                    float z = (0.01f + static_cast<float>(seed >> 16) / 65535.0f * 0.98f) * extent;
+
+                    PxGeomRaycastHit hit;
+                    hit_count += PxGeometryQuery::raycast(PxVec3(x, 100.0f, z), PxVec3(0.0f, -1.0f, 0.0f), geometry, pose, 200.0f, PxHitFlag::eDEFAULT, 1, &hit);
+                }
+                return static_cast<double>(stopwatch_rays.GetElapsedTimeMs());
+            };
+
+            auto measure_sweeps = [&](const PxGeometry& geometry, const PxTransform& pose)
+            {
+                PxSphereGeometry sphere(0.5f);
+                PxVec3 direction = PxVec3(1.0f, -1.0f, 0.5f).getNormalized();
+                Stopwatch stopwatch_sweeps;
+                for (uint32_t i = 0; i < sweep_count; i++)
+                {
+                    float t = static_cast<float>(i) / static_cast<float>(sweep_count);
+                    PxGeomSweepHit hit;
+                    PxGeometryQuery::sweep(direction, 100.0f, sphere, PxTransform(PxVec3(t * extent * 0.5f, 60.0f, t * extent)), geometry, pose, hit);
+                }
+                return static_cast<double>(stopwatch_sweeps.GetElapsedTimeMs());
+            };
+
+            uint32_t hits_mesh  = 0;
+            uint32_t hits_field = 0;
+            results["terrain_collision/triangle_mesh_cook_ms"]   = mesh_cook_ms;
+            results["terrain_collision/height_field_cook_ms"]    = field_cook_ms;
+            results["terrain_collision/triangle_mesh_kb"]        = stream_mesh.getSize() / 1024.0;
+            results["terrain_collision/height_field_kb"]         = stream_field.getSize() / 1024.0;
+            results["terrain_collision/triangle_mesh_raycast_ms"] = measure_raycasts(geometry_mesh, pose_mesh, hits_mesh);
+            results["terrain_collision/height_field_raycast_ms"]  = measure_raycasts(geometry_field, pose_field, hits_field);
+            results["terrain_collision/triangle_mesh_sweep_ms"]   = measure_sweeps(geometry_mesh, pose_mesh);
+            results["terrain_collision/height_field_sweep_ms"]    = measure_sweeps(geometry_field, pose_field);
+
+            if (hits_mesh != hits_field)
+            {
+                failures.emplace_back("terrain_collision: " + to_string(hits_field) + " height field hits vs " + to_string(hits_mesh) + " triangle mesh hits");
+            }
+
+            SP_LOG_INFO("Benchmark: terrain collision, triangle mesh %.1f ms cook, %.0f KB, height field %.1f ms cook, %.0f KB",
+                mesh_cook_ms, stream_mesh.getSize() / 1024.0, field_cook_ms, stream_field.getSize() / 1024.0);
+
+            mesh->release();
+            field->release();
+        }
+
+        // events, the cost of firing and delivering to a few subscribers, immediately and through the deferred queue
+        void measure_allocator()
+        {
+            const uint32_t iterations = 1'000'000;
+
+            // random small sizes freed in random order, the same sequence for every allocator
+            auto churn = [iterations](void* (*allocate)(size_t), void (*free_)(void*))
+            {
+                array<void*, 1024> slots = {};
+                mt19937 rng(7);
+                Stopwatch stopwatch;
+                for (uint32_t i = 0; i < iterations; i++)
+                {
+                    uint32_t random = rng();
+                    void*& slot     = slots[(random >> 10) & 1023];
+                    free_(slot);
+                    slot = allocate(8 + random % 500);
+                }
+                for (void* slot : slots)
+                {
+                    free_(slot);
+                }
+                return static_cast<double>(stopwatch.GetElapsedTimeMs());
+            };
+
+            auto allocate = [](size_t size) { return Allocator::Allocate(size); };
+            auto free_    = [](void* ptr)   { Allocator::Free(ptr); };
+
+            double slab_ms = churn(allocate, free_);
+
+            // the same calls with the slabs off, what every allocation cost before them
+            const bool slabs_enabled = Allocator::GetSlabsEnabled();
+            Allocator::SetSlabsEnabled(false);
+            double header_ms = churn(allocate, free_);
+            Allocator::SetSlabsEnabled(slabs_enabled);
+
+            double system_ms = churn([](size_t size) { return malloc(size); }, [](void* ptr) { free(ptr); });
+
+            results["allocator/slab_churn_ms"]   = slab_ms;
+            results["allocator/header_churn_ms"] = header_ms;
+            results["allocator/system_churn_ms"] = system_ms;
+
+            const double ns_per_iteration = 1e6 / iterations;
+            SP_LOG_INFO("Benchmark: small allocation churn, %.1f ns slabs, %.1f ns header path, %.1f ns system allocator (per allocation and free)",
+                slab_ms * ns_per_iteration, header_ms * ns_per_iteration, system_ms * ns_per_iteration);
+        }
+
+        void measure_events()
+        {
+            const uint32_t event_count      = 100'000;
+            const uint32_t subscriber_count = 4;
+
+            uint64_t sum = 0;
+            vector<subscription_handle> handles;
+            for (uint32_t i = 0; i < subscriber_count; i++)
+            {
+                handles.push_back(Event::Subscribe(EventType::Test, [&sum](const sp_variant& data)
+                {
+                    sum += Event::GetPayload<EventType::Test>(data);
+                }));
+            }
+
+            Stopwatch stopwatch_immediate;
+            for (uint32_t i = 0; i < event_count; i++)
+            {
+                SP_FIRE_EVENT_DATA(EventType::Test, static_cast<uint64_t>(i));
+            }
+            double immediate_ms = stopwatch_immediate.GetElapsedTimeMs();
+
+            Stopwatch stopwatch_fire;
+            for (uint32_t i = 0; i < event_count; i++)
+            {
+                SP_FIRE_EVENT_DATA_DEFERRED(EventType::Test, static_cast<uint64_t>(i));
+            }
+            double deferred_fire_ms = stopwatch_fire.GetElapsedTimeMs();
+
+            Stopwatch stopwatch_dispatch;
+            Event::Dispatch();
+            double deferred_dispatch_ms = stopwatch_dispatch.GetElapsedTimeMs();
+
+            for (subscription_handle handle : handles)
+            {
+                Event::Unsubscribe(EventType::Test, handle);
+            }
+
+            // both paths deliver every payload to every subscriber
+            uint64_t expected = 2ull * subscriber_count * (static_cast<uint64_t>(event_count) * (event_count - 1) / 2);
+            if (sum != expected)
+            {
+                failures.emplace_back("events: payload sum " + to_string(sum) + ", expected " + to_string(expected));
+            }
+
+            results["events/immediate_ms"]         = immediate_ms;
+            results["events/deferred_fire_ms"]     = deferred_fire_ms;
+            results["events/deferred_dispatch_ms"] = deferred_dispatch_ms;
+
+            SP_LOG_INFO("Benchmark: %u events to %u subscribers, %.2f ms immediate, %.2f ms deferred (%.2f ms fire, %.2f ms dispatch)",
+                event_count, subscriber_count, immediate_ms, deferred_fire_ms + deferred_dispatch_ms, deferred_fire_ms, deferred_dispatch_ms);
+        }
+
+        // lua scripts, the batched tick with cached function references against looking them up by name every call
+        // the entities are not added to the world, so nothing else is ticked or rendered with them
+        void measure_scripts()
+        {
+            const uint32_t entity_count = 10'000;
+            const uint32_t frame_count  = 60;
+            const string path           = "benchmark_script.lua";
+
+            {
+                ofstream file(path);
+                file << "local BenchmarkScript = { ticks = 0 }\n"
+                        "function BenchmarkScript:Tick(entity) self.ticks = self.ticks + 1 end\n"
+                        "return BenchmarkScript\n";
+            }
+
+            vector<unique_ptr<Entity>> entities(entity_count);
+            vector<Script*> scripts(entity_count);
+            for (uint32_t i = 0; i < entity_count; i++)
+            {
+                entities[i] = make_unique<Entity>();
+                scripts[i]  = entities[i]->AddComponent<Script>();
+                scripts[i]->LoadScriptFile(path);
+            }
+            FileSystem::Delete(path);
+
+            Stopwatch stopwatch_lookup;
+            for (uint32_t frame = 0; frame < frame_count; frame++)
+            {
+                for (uint32_t i = 0; i < entity_count; i++)
+                {
+                    sol::protected_function tick = scripts[i]->script["Tick"];
+                    tick(scripts[i]->script, entities[i].get());
+                }
+            }
+            double lookup_ms = stopwatch_lookup.GetElapsedTimeMs() / frame_count;
+
+            Stopwatch stopwatch_batched;
+            for (uint32_t frame = 0; frame < frame_count; frame++)
+            {
+                Script::PreTickAll();
+                Script::TickAll();
+            }
+            double batched_ms = stopwatch_batched.GetElapsedTimeMs() / frame_count;
+
+            // every script should have been ticked by both paths
+            uint32_t mismatches = 0;
+            for (Script* script : scripts)
+            {
+                mismatches += script->script.get_or("ticks", 0) != static_cast<int>(frame_count * 2) ? 1 : 0;
+            }
+            if (mismatches != 0)
+            {
+                failures.emplace_back("scripts: " + to_string(mismatches) + " of " + to_string(entity_count) + " scripts missed ticks");
+            }
+
+            results["scripts/lookup_tick_ms"]  = lookup_ms;
+            results["scripts/batched_tick_ms"] = batched_ms;
+
+            SP_LOG_INFO("Benchmark: %u scripts, %.2f ms per frame looked up by name, %.2f ms batched", entity_count, lookup_ms, batched_ms);
+        }
+
+        // play mode snapshots, saving a large world into one buffer and restoring it in bulk against restoring it entity by entity
+        // the entities go into the world, the world load that follows shuts it down and deletes them
+        void measure_snapshot()
+        {
+            const uint32_t root_count   = 10'000;
+            const uint32_t children     = 9;
+            const uint32_t entity_count = root_count * (children + 1);
+
+            vector<Entity*> created;
+            created.reserve(entity_count);
+            for (uint32_t i = 0; i < root_count; i++)
+            {
+                Entity* root = World::CreateEntity();
+                root->SetPositionLocal(Vector3(static_cast<float>(i % 100) * 4.0f, 0.0f, static_cast<float>(i / 100) * 4.0f));
+                created.push_back(root);
+
+                for (uint32_t j = 0; j < children; j++)
+                {
+                    Entity* child = World::CreateEntity();
+                    child->SetParent(root);
+                    child->SetPositionLocal(Vector3(static_cast<float>(j), 1.0f, 0.0f));
+                    created.push_back(child);
+                }
+            }
+            World::ProcessPendingAdditions();
+
+            // what play mode moves, every root drifts away from where it was saved
+            auto move = [&created]()
+            {
+                for (Entity* entity : created)
+                {
+                    if (!entity->GetParent())
+                    {
+                        entity->SetPositionLocal(entity->GetPositionLocal() + Vector3(0.0f, 10.0f, 0.0f));
+                    }
+                }
+            };
+
+            vector<Vector3> expected(entity_count);
+            for (uint32_t i = 0; i < entity_count; i++)
+            {
+                expected[i] = created[i]->GetPosition();
+            }
+
+            // one buffer, one bulk restore
+            vector<uint8_t> snapshot;
+            Stopwatch stopwatch_save;
+            World::SaveSnapshot(snapshot);
+            double save_ms = stopwatch_save.GetElapsedTimeMs();
+
+            move();
+            Stopwatch stopwatch_load;
+            bool restored = World::LoadSnapshot(snapshot);
+            double load_ms = stopwatch_load.GetElapsedTimeMs();
+
+            uint32_t mismatches = 0;
+            for (uint32_t i = 0; i < entity_count; i++)
+            {
+                mismatches += created[i]->GetPosition() == expected[i] ? 0 : 1;
+            }
+            if (!restored || mismatches != 0)
+            {
+                failures.emplace_back("snapshot: " + to_string(mismatches) + " of " + to_string(entity_count) + " entities were not restored");
+            }
+
+            // the previous approach, a map by id and a transform setter per property, each propagating down the hierarchy
+            struct TransformState
+            {
+                Vector3 position;
+                Quaternion rotation;
+                Vector3 scale;
+            };
+            unordered_map<uint64_t, TransformState> states;
+            Stopwatch stopwatch_save_map;
+            for (Entity* entity : World::GetEntities())
+            {
+                states[entity->GetObjectId()] = { entity->GetPositionLocal(), entity->GetRotationLocal(), entity->GetScaleLocal() };
+            }
+            double save_map_ms = stopwatch_save_map.GetElapsedTimeMs();
+
+            move();
+            Stopwatch stopwatch_load_map;
+            for (Entity* entity : World::GetEntities())
+            {
+                auto it = states.find(entity->GetObjectId());
+                if (it != states.end())
+                {
+                    entity->SetPositionLocal(it->second.position);
+                    entity->SetRotationLocal(it->second.rotation);
+                    entity->SetScaleLocal(it->second.scale);
+                }
+            }
+            double load_map_ms = stopwatch_load_map.GetElapsedTimeMs();
+
+            results["snapshot/save_ms"]        = save_ms;
+            results["snapshot/restore_ms"]     = load_ms;
+            results["snapshot/map_save_ms"]    = save_map_ms;
+            results["snapshot/map_restore_ms"] = load_map_ms;
+
+            SP_LOG_INFO("Benchmark: %u entities, snapshot %.2f ms saved (%.1f MB), %.2f ms restored, per entity map %.2f ms saved, %.2f ms restored",
+                entity_count, save_ms, static_cast<double>(snapshot.size()) / (1024.0 * 1024.0), load_ms, save_map_ms, load_map_ms);
+        }
+
+        // prefabs, spawning instances from the shared template in parallel against cloning an instance attribute by attribute
+        // the instances go into the world, the world load that follows shuts it down and deletes them
+        void measure_prefabs()
+        {
+            const uint32_t instance_count = 10'000;
+            const string path             = "benchmark.prefab";
+
+            {
+                ofstream file(path);
+                file << "<?xml version=\"1.0\"?>\n"
+                        "<Prefab name=\"benchmark_prop\">\n"
+                        " <volume />\n"
+                        " <Entity name=\"body\" active=\"true\" position=\"0 1 0\" rotation=\"0 0 0 1\" scale=\"1 1 1\">\n"
+                        "  <Entity name=\"wheel\" active=\"true\" position=\"1 0 0\" rotation=\"0 0 0 1\" scale=\"0.5 0.5 0.5\" />\n"
+                        "  <Entity name=\"wheel\" active=\"true\" position=\"-1 0 0\" rotation=\"0 0 0 1\" scale=\"0.5 0.5 0.5\" />\n"
+                        " </Entity>\n"
+                        " <Entity name=\"path\" active=\"true\" position=\"0 0 0\" rotation=\"0 0 0 1\" scale=\"1 1 1\">\n"
+                        "  <spline closed_loop=\"true\" />\n"
+                        " </Entity>\n"
+                        "</Prefab>\n";
+            }
+
+            vector<Matrix> transforms(instance_count);
+            for (uint32_t i = 0; i < instance_count; i++)
+            {
+                transforms[i] = Matrix::CreateTranslation(Vector3(static_cast<float>(i % 100) * 4.0f, 0.0f, static_cast<float>(i / 100) * 4.0f));
+            }
+
+            Stopwatch stopwatch_batch;
+            vector<Entity*> instances = World::SpawnBatch(path, transforms);
+            double batch_ms = stopwatch_batch.GetElapsedTimeMs();
+            FileSystem::Delete(path);
+
+            if (instances.size() != instance_count)
+            {
+                failures.emplace_back("prefabs: spawned " + to_string(instances.size()) + " of " + to_string(instance_count) + " instances");
+                return;
+            }
+
+            Stopwatch stopwatch_clone;
+            for (uint32_t i = 0; i < instance_count; i++)
+            {
+                instances[0]->Clone();
+            }
+            double clone_ms = stopwatch_clone.GetElapsedTimeMs();
+
+            // every instance should have the full hierarchy at its own transform
+            uint32_t mismatches = 0;
+            for (uint32_t i = 0; i < instance_count; i++)
+            {
+                vector<Entity*> descendants;
+                instances[i]->GetDescendants(&descendants);
+                bool hierarchy_ok = descendants.size() == 4 && instances[i]->GetComponent<Volume>() != nullptr;
+                bool position_ok  = instances[i]->GetPosition() == transforms[i].GetTranslation();
+                mismatches       += (hierarchy_ok && position_ok) ? 0 : 1;
+            }
+            if (mismatches != 0)
+            {
+                failures.emplace_back("prefabs: " + to_string(mismatches) + " of " + to_string(instance_count) + " instances differ from the template");
+            }
+
+            results["prefabs/spawn_batch_ms"] = batch_ms;
+            results["prefabs/clone_ms"]       = clone_ms;
+
+            SP_LOG_INFO("Benchmark: %u prefab instances, %.2f ms spawned in a batch, %.2f ms cloned", instance_count, batch_ms, clone_ms);
+        }
+
+        // component attributes, copying, snapshotting and cloning a large entity through the per type attribute tables
+        // the source entities are not added to the world, the clones are and the world load that follows deletes them
+        void measure_attributes()
+        {
+            const uint32_t child_count = 1'000;
+            const uint32_t iterations  = 20;
+            const uint32_t clones      = 5;
+
+            unique_ptr<Entity> root = make_unique<Entity>();
+            vector<unique_ptr<Entity>> sources(child_count);
+            vector<unique_ptr<Entity>> targets(child_count);
+            for (uint32_t i = 0; i < child_count; i++)
+            {
+                for (vector<unique_ptr<Entity>>* entities : { &sources, &targets })
+                {
+                    (*entities)[i] = make_unique<Entity>();
+                    (*entities)[i]->AddComponent<Light>();
+                    (*entities)[i]->AddComponent<ParticleSystem>();
+                    (*entities)[i]->AddComponent<SplineFollower>();
+                    (*entities)[i]->AddComponent<Volume>();
+                }
+
+                sources[i]->SetParent(root.get());
+                sources[i]->GetComponent<Light>()->SetRange(static_cast<float>(i % 100) + 1.0f);
+                sources[i]->GetComponent<SplineFollower>()->SetSpeed(static_cast<float>(i));
+            }
+
+            auto for_each_component = [&](auto&& function)
+            {
+                for (uint32_t i = 0; i < child_count; i++)
+                {
+                    for (const shared_ptr<Component>& component : sources[i]->GetAllComponents())
+                    {
+                        if (component)
+                        {
+                            function(component.get(), targets[i]->GetComponentByType(component->GetType()));
+                        }
+                    }
+                }
+            };
+
+            Stopwatch stopwatch_copy;
+            for (uint32_t iteration = 0; iteration < iterations; iteration++)
+            {
+                for_each_component([](Component* source, Component* target) { target->CopyAttributesFrom(source); });
+            }
+            double copy_ms = stopwatch_copy.GetElapsedTimeMs() / iterations;
+
+            // a snapshot of every component, then restored onto the targets
+            vector<uint8_t> snapshot;
+            Stopwatch stopwatch_save;
+            for (uint32_t iteration = 0; iteration < iterations; iteration++)
+            {
+                snapshot.clear();
+                for_each_component([&snapshot](Component* source, Component*) { source->SaveAttributes(snapshot); });
+            }
+            double save_ms = stopwatch_save.GetElapsedTimeMs() / iterations;
+
+            bool restored = true;
+            Stopwatch stopwatch_load;
+            for (uint32_t iteration = 0; iteration < iterations; iteration++)
+            {
+                const uint8_t* data     = snapshot.data();
+                const uint8_t* data_end = data + snapshot.size();
+                for_each_component([&](Component*, Component* target) { restored = target->LoadAttributes(data, data_end) && restored; });
+                restored = restored && data == data_end;
+            }
+            double load_ms = stopwatch_load.GetElapsedTimeMs() / iterations;
+
+            // the targets should now serialize to the same bytes as the sources
+            vector<uint8_t> snapshot_targets;
+            for_each_component([&snapshot_targets](Component*, Component* target) { target->SaveAttributes(snapshot_targets); });
+            if (!restored || snapshot_targets != snapshot)
+            {
+                failures.emplace_back("attributes: restored components differ from their sources");
+            }
+
+            Stopwatch stopwatch_clone;
+            for (uint32_t i = 0; i < clones; i++)
+            {
+                root->Clone();
+            }
+            double clone_ms = stopwatch_clone.GetElapsedTimeMs() / clones;
+
+            results["attributes/copy_ms"]  = copy_ms;
+            results["attributes/save_ms"]  = save_ms;
+            results["attributes/load_ms"]  = load_ms;
+            results["attributes/clone_ms"] = clone_ms;
+
+            SP_LOG_INFO("Benchmark: attributes of %u entities, %.2f ms copy, %.2f ms save, %.2f ms load (%llu bytes), %.2f ms per clone",
+                child_count, copy_ms, save_ms, load_ms, static_cast<unsigned long long>(snapshot.size()), clone_ms);
+        }
+
+        void next_world()
+        {
+            world_index++;
+            if (world_index < static_cast<uint32_t>(DefaultWorld::Max))
+            {
+                world_load(world_index);
+            }
+            else
+            {
+                finish();
+            }
+        }
+    }
+
+    void Benchmark::Initialize()
+    {
+        if (!Engine::HasArgument("-benchmark"))
+            return;
+
+        parse_argument("-benchmark_frames", frames_measured);
+        frames_measured = max(1u, frames_measured);
+        parse_argument("-benchmark_tolerance", tolerance_percent);
+        parse_argument("-benchmark_tolerance_ms", tolerance_ms);
+
+        string value;
+        if (!(value = Engine::GetArgumentValue("-benchmark_baseline")).empty())
+        {
+            path_baseline = value;
+        }
+
+        // measure the engine, not the display
+        ConsoleRegistry::Get().SetValueFromString("r.vsync", "0");
+        Timer::SetFpsLimit(numeric_limits<float>::max());
+
+        // read the time blocks every frame instead of a few times per second
+        Profiler::SetUpdateInterval(0.0f);
+
+        // opt in, reading the counters costs a system call per time block
+        if (Engine::HasArgument("-benchmark_counters"))
+        {
+            HardwareCounters::SetEnabled(true);
+        }
+
+        SP_LOG_INFO("Benchmark: %u frames per world, %.1f%% tolerance", frames_measured, tolerance_percent);
+
+        results.clear();
+        failures.clear();
+        measure_allocator();
+        measure_terrain_collision();
+        measure_scripts();
+        measure_events();
+        measure_snapshot();
+        measure_prefabs();
+        measure_attributes();
+        world_index = 0;
+        world_load(world_index);
+    }
+
+    void Benchmark::Tick()
+    {
+        if (state == State::Idle)
+            return;
+
+        Entity* camera = get_camera_entity();
+
+        if (state == State::Loading)
+        {
+            frame_index++;
+            if (frame_index >= frames_loading_min && !ProgressTracker::IsLoading() && camera)
+            {
+                // keep the scripted path free of input and head bob
+                Camera* component = World::GetCamera();
+                component->SetFlag(CameraFlags::CanBeControlled, false);
+                component->SetFlag(CameraFlags::PhysicalBodyAnimation, false);
+
+                path_start  = camera->GetPosition();
+                path_center = path_start + camera->GetForward() * path_radius;
+
+                frame_ms_sum    = 0.0;
+                cpu_ms_sum      = 0.0;
+                allocations_sum = 0.0;
+                frame_ms.clear();
+                frame_ms.reserve(frames_measured);
+                subsystem_ms_sum.clear();
+                subsystem_counters_sum.clear();
+
+                state       = State::Warmup;
+                frame_index = 0;
+            }
+            else if (Timer::GetTimeSec() - loading_start_sec > loading_timeout_sec)
+            {
+                failures.emplace_back(string(world_names[world_index]) + ": timed out while loading");
+                next_world();
+            }
+
+            return;
+        }
+
+        // the world can be torn down underneath us (e.g. the user loads another one)
+        if (!camera)
+        {
+            failures.emplace_back(string(world_names[world_index]) + ": camera disappeared");
+            next_world();
+            return;
+        }
+
+        camera_fly(camera, frame_index);
+        frame_index++;
+
+        if (state == State::Warmup)
+        {
+            if (frame_index == frames_warmup)
+            {
+                state = State::Measuring;
+            }
+
+            return;
+        }
+
+        // the profiler reads the time blocks in its post tick, so these belong to the previous frame
+        frame_ms_sum    += Timer::GetDeltaTimeMs();
+        cpu_ms_sum      += Profiler::GetTimeCpuLast();
+        allocations_sum += Allocator::GetAllocationsLastFrame();
+        frame_ms.push_back(static_cast<float>(Timer::GetDeltaTimeMs()));
+        for (const TimeBlock& time_block : Profiler::GetTimeBlocks())
+        {
+            // top level cpu blocks are the subsystems
+            if (time_block.IsComplete() && time_block.GetType() == TimeBlockType::Cpu && !time_block.GetParent())
+            {
+                subsystem_ms_sum[sanitize(time_block.GetName())] += time_block.GetDuration();
+
+                if (time_block.HasCounters())
+                {
+                    for (uint32_t i = 0; i < static_cast<uint32_t>(HardwareCounter::Count); i++)
+                    {
+                        HardwareCounter counter = static_cast<HardwareCounter>(i);
+                        if (!HardwareCounters::IsAvailable(counter))
+                            continue;
+
+                        string counter_name = HardwareCounters::GetName(counter);
+                        replace(counter_name.begin(), counter_name.end(), ' ', '_');
+                        subsystem_counters_sum[sanitize(time_block.GetName()) + "/" + counter_name] += static_cast<double>(time_block.GetCounter(counter));
+                    }
+                }
+            }
+        }
+
+        if (frame_index == frames_warmup + frames_measured)
+        {
+            world_finish();
+            next_world();
+        }
+    }
+
+    bool Benchmark::IsRunning()
+    {
+        return state != State::Idle;
+    }
+
+    bool Benchmark::WriteResults(const string& file_path, const Results& results, const uint32_t frame_count)
+    {
+        ofstream file(file_path, ios::out | ios::trunc);
+        if (!file.is_open())
+        {
+            SP_LOG_ERROR("Failed to open \"%s\" for writing", file_path.c_str());
+            return false;
+        }
+
+        // one flat object of metrics, so the baseline can be diffed and edited by hand
+        file << "{\n";
+        file << "    \"frames\": " << frame_count << ",\n";
+        file << "    \"results\": {\n";
+        size_t index = 0;
+        for (const auto& [name, value] : results)
+        {
+            file << "        \"" << name << "\": " << fixed << setprecision(4) << value << (++index < results.size() ? ",\n" : "\n");
+        }
+        file << "    }\n";
+        file << "}\n";
+
+        return true;
+    }
+
+    bool Benchmark::ReadResults(const string& file_path, Results& results)
+    {
+        ifstream file(file_path);
+        if (!file.is_open())
+            return false;
+
+        stringstream buffer;
+        buffer << file.rdbuf();
+        const string text = buffer.str();
+
+        // only understands what WriteResults produces: "name": number pairs inside "results"
+        size_t position = text.find("\"results\"");
+        if (position == string::npos)
+            return false;
+
+        position = text.find('{', position);
+        if (position == string::npos)
+            return false;
+
+        results.clear();
+        while (true)
+        {
+            size_t key_start = text.find_first_of("\"}", position + 1);
+            if (key_start == string::npos || text[key_start] == '}')
+                break;
+
+            size_t key_end = text.find('"', key_start + 1);
+            size_t colon   = key_end == string::npos ? string::npos : text.find(':', key_end);
+            if (colon == string::npos)
+                return false;
+
+            char* number_end = nullptr;
+            double value     = strtod(text.c_str() + colon + 1, &number_end);
+            if (number_end == text.c_str() + colon + 1)
+                return false;
+
+            results[text.substr(key_start + 1, key_end - key_start - 1)] = value;
+            position = static_cast<size_t>(number_end - text.c_str());
+        }
+
+        return true;
+    }
+
+    bool Benchmark::Compare(const Results& baseline, const Results& results, const double tolerance_percent, const double tolerance_ms, vector<string>& regressions)
+    {
+        bool passed = true;
+        char message[512];
+
+        for (const auto& [name, value_baseline] : baseline)
+        {
+            // hardware counters are informational, they vary with the cpu and the kernel more than timings do
+            if (name.find("/counters/") != string::npos)
+                continue;
+
+            auto it = results.find(name);
+            if (it == results.end())
+            {
+                SP_LOG_WARNING("Benchmark: \"%s\" is in the baseline but wasn't measured", name.c_str());
+                continue;
+            }
+
+            // a slowdown has to exceed both the relative and the absolute tolerance
+            double value   = it->second;
+            double allowed = max(value_baseline * tolerance_percent / 100.0, tolerance_ms);
+            if (value - value_baseline > allowed)
+            {
+                snprintf(message, sizeof(message), "%s regressed: %.3f ms -> %.3f ms (+%.1f%%)", name.c_str(), value_baseline, value, value_baseline > 0.0 ? (value / value_baseline - 1.0) * 100.0 : 100.0);
+                regressions.emplace_back(message);
+                passed = false;
+            }
+        }
+
+        return passed;
+    }
+}
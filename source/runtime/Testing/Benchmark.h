@@ -0,0 +1,57 @@
+/*
+Copyright(c) 2015-2026 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ========
+#include <string>
+#include <vector>
+#include <map>
+//===================
+
+namespace spartan
+{
+    // frame-time benchmark, enabled with -benchmark
+    // flies a scripted camera through every default world, writes the per-subsystem cpu timings
+    // to benchmark.json and compares them against a stored baseline
+    // terrain collision as a height field and as a cooked triangle mesh is measured once up front (terrain_collision/*)
+    //
+    // -benchmark_frames <n>          frames measured per world (default 600)
+    // -benchmark_baseline <path>     baseline to compare against (default benchmark_baseline.json)
+    // -benchmark_tolerance <percent> allowed slowdown per metric (default 10)
+    // -benchmark_tolerance_ms <ms>   slowdowns smaller than this are noise (default 0.1)
+    // -benchmark_save_baseline       write the results as the new baseline instead of comparing
+    // -benchmark_counters            add per-subsystem hardware counters (linux), reported but not compared
+    class Benchmark
+    {
+    public:
+        static void Initialize();
+        static void Tick();
+        static bool IsRunning();
+
+        // metric name (world/metric) to average milliseconds
+        using Results = std::map<std::string, double>;
+
+        static bool WriteResults(const std::string& file_path, const Results& results, const uint32_t frame_count);
+        static bool ReadResults(const std::string& file_path, Results& results);
+        static bool Compare(const Results& baseline, const Results& results, const double tolerance_percent, const double tolerance_ms, std::vector<std::string>& regressions);
+    };
+}
@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Logging/Log.h"
 #include "../Rendering/Renderer.h"
 #include "../Rendering/Material.h"
+#include "../Rendering/RenderWorld.h"
 #include "../Resource/Import/ImageImporter.h"
 #include "../Resource/IResource.h"
 #include "../RHI/RHI_Shader.h"
@@ -42,11 +43,24 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World/Components/Renderable.h"
 #include "../World/Components/Physics.h"
 #include "../FileSystem/FileSystem.h"
+#include "../Audio/AudioMixer.h"
+#include "../Car/CarEngineSoundSynthesis.h"
+#include "../Geometry/Mesh.h"
+#include "../Geometry/GeometryGeneration.h"
+#include "../Core/ThreadPool.h"
+#include "../Profiling/Profiler.h"
+#include "../Profiling/HardwareCounters.h"
+#include "Benchmark.h"
+#include "../Memory/Allocator.h"
+#include "../Memory/AllocationProfiler.h"
+#include "../Memory/FrameAllocator.h"
+#include <random>
 #include <fstream>
 #include <iostream>
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <mutex>
 //================================
 
 namespace spartan
@@ -61,6 +75,37 @@ namespace spartan
     namespace
     {
         std::chrono::steady_clock::time_point start_time;
+
+        // records what reaches the logger and passes it on, so the console keeps working while a test listens
+        class capture_logger : public ILogger
+        {
+        public:
+            explicit capture_logger(ILogger* forward) : m_forward(forward) {}
+
+            void Log(const std::string& log, const uint32_t type) override
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_logs.push_back(log);
+                }
+
+                if (m_forward)
+                {
+                    m_forward->Log(log, type);
+                }
+            }
+
+            bool Contains(const std::string& text)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return std::any_of(m_logs.begin(), m_logs.end(), [&text](const std::string& log) { return log.find(text) != std::string::npos; });
+            }
+
+        private:
+            ILogger* m_forward = nullptr;
+            std::mutex m_mutex;
+            std::vector<std::string> m_logs;
+        };
     }
 
     void SmokeTest::Initialize()
@@ -128,6 +173,18 @@ namespace spartan
         RunTest("RHI.CommandListRecording",   Test_RHI_CommandListRecording);
         RunTest("RHI.ResourceTransitions",      Test_RHI_ResourceTransitions);
         RunTest("Threading.ResourceCreation",  Test_Threading_ResourceCreation);
+        RunTest("Audio.MixerVoices",           Test_Audio_MixerVoices);
+        RunTest("Audio.StreamingClip",         Test_Audio_StreamingClip);
+        RunTest("Audio.SynthesisBenchmark",    Test_Audio_SynthesisBenchmark);
+        RunTest("Geometry.RaycastBenchmark",   Test_Geometry_RaycastBenchmark);
+        RunTest("Profiling.ParallelTrace",     Test_Profiling_ParallelTrace);
+        RunTest("Profiling.HardwareCounters",  Test_Profiling_HardwareCounters);
+        RunTest("Memory.FrameAllocator",       Test_Memory_FrameAllocator);
+        RunTest("Memory.SlabAllocator",        Test_Memory_SlabAllocator);
+        RunTest("Memory.AllocationProfiler",   Test_Memory_AllocationProfiler);
+        RunTest("Logging.RateLimit",           Test_Logging_RateLimit);
+        RunTest("Event.DeferredQueue",         Test_Event_DeferredQueue);
+        RunTest("Benchmark.BaselineComparison", Test_Benchmark_BaselineComparison);
 
         m_delayedTestsPending = true;
     }
@@ -381,6 +438,851 @@ namespace spartan
         return true;
     }
 
+    bool SmokeTest::Test_Audio_MixerVoices(std::string& out_error)
+    {
+        // ci runs on the dummy audio driver, which still pulls from the mixer at real-time rate
+        if (!AudioMixer::IsRunning())
+        {
+            out_error = "Audio mixer is not running";
+            return false;
+        }
+
+        // a 440hz sine, generated on the mixer thread
+        auto phase = std::make_shared<float>(0.0f);
+        SynthesisCallback sine = [phase](float* buffer, int frame_count)
+        {
+            const float step = 2.0f * math::pi * 440.0f / static_cast<float>(AudioMixer::GetSampleRate());
+            for (int i = 0; i < frame_count; i++)
+            {
+                float sample      = 0.5f * sinf(*phase);
+                buffer[i * 2]     = sample;
+                buffer[i * 2 + 1] = sample;
+                *phase            = fmodf(*phase + step, 2.0f * math::pi);
+            }
+        };
+
+        const uint32_t voices_before = AudioMixer::GetVoiceCount();
+        AudioVoice voice             = AudioMixer::PlaySynthesis(sine, AudioVoiceParameters());
+        if (voice == 0 || !AudioMixer::IsPlaying(voice) || AudioMixer::GetVoiceCount() != voices_before + 1)
+        {
+            out_error = "Failed to acquire a voice";
+            return false;
+        }
+
+        // wait for the mixer to render a few blocks of it
+        const uint64_t frames_start = AudioMixer::GetFramesMixed();
+        const auto time_start       = std::chrono::steady_clock::now();
+        float peak                  = 0.0f;
+        while (std::chrono::steady_clock::now() - time_start < std::chrono::seconds(2))
+        {
+            peak = std::max(peak, AudioMixer::GetPeak());
+            if (AudioMixer::GetFramesMixed() - frames_start >= AudioMixer::GetSampleRate() / 10 && peak > 0.0f)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        bool still_playing = AudioMixer::IsPlaying(voice);
+        AudioMixer::Stop(voice);
+
+        if (AudioMixer::GetFramesMixed() == frames_start)
+        {
+            out_error = "The mixer thread did not render any audio";
+            return false;
+        }
+
+        if (peak <= 0.0f)
+        {
+            out_error = "The mixed output is silent";
+            return false;
+        }
+
+        if (!still_playing || AudioMixer::IsPlaying(voice) || AudioMixer::GetVoiceCount() != voices_before)
+        {
+            out_error = "Voice state is inconsistent after stopping";
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SmokeTest::Test_Audio_StreamingClip(std::string& out_error)
+    {
+        if (!AudioMixer::IsRunning())
+        {
+            out_error = "Audio mixer is not running";
+            return false;
+        }
+
+        // write a 60 second 16-bit stereo clip, large enough to be streamed instead of decoded up front
+        const std::string file_path = "smoke_audio_stream.wav";
+        {
+            const uint32_t rate        = 44100;
+            const uint32_t frame_count = rate * 60;
+            const uint16_t channels    = 2;
+            const uint16_t bits        = 16;
+            const uint32_t data_size   = frame_count * channels * (bits / 8);
+            const uint32_t riff_size   = 36 + data_size;
+            const uint32_t fmt_size    = 16;
+            const uint16_t pcm         = 1;
+            const uint32_t byte_rate   = rate * channels * (bits / 8);
+            const uint16_t block_align = channels * (bits / 8);
+
+            std::ofstream file(file_path, std::ios::binary);
+            file.write("RIFF", 4);
+            file.write(reinterpret_cast<const char*>(&riff_size), 4);
+            file.write("WAVEfmt ", 8);
+            file.write(reinterpret_cast<const char*>(&fmt_size), 4);
+            file.write(reinterpret_cast<const char*>(&pcm), 2);
+            file.write(reinterpret_cast<const char*>(&channels), 2);
+            file.write(reinterpret_cast<const char*>(&rate), 4);
+            file.write(reinterpret_cast<const char*>(&byte_rate), 4);
+            file.write(reinterpret_cast<const char*>(&block_align), 2);
+            file.write(reinterpret_cast<const char*>(&bits), 2);
+            file.write("data", 4);
+            file.write(reinterpret_cast<const char*>(&data_size), 4);
+
+            std::vector<int16_t> samples(rate * channels);
+            for (uint32_t second = 0; second < 60; second++)
+            {
+                for (uint32_t i = 0; i < rate; i++)
+                {
+                    int16_t sample     = static_cast<int16_t>(16000.0f * sinf(2.0f * math::pi * 220.0f * static_cast<float>(i) / static_cast<float>(rate)));
+                    samples[i * 2]         = sample;
+                    samples[i * 2 + 1]     = sample;
+                }
+                file.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(int16_t));
+            }
+
+            if (!file)
+            {
+                out_error = "Failed to write the test clip";
+                return false;
+            }
+        }
+
+        bool passed = true;
+        {
+            const uint64_t resident_before  = AudioClip::GetResidentBytes();
+            const uint64_t underruns_before = AudioMixer::GetStreamUnderruns();
+            std::shared_ptr<AudioClip> clip = AudioClip::Load(file_path);
+
+            if (!clip || clip->storage != AudioClipStorage::Streamed)
+            {
+                out_error = "The clip was not streamed";
+                passed    = false;
+            }
+            else if (AudioClip::GetResidentBytes() != resident_before)
+            {
+                out_error = "A streamed clip was counted against the resident budget";
+                passed    = false;
+            }
+            else
+            {
+                AudioVoice voice = AudioMixer::PlayClip(clip, false, AudioVoiceParameters());
+
+                // play well past the first ring buffer, so refills from disk are exercised
+                const uint64_t frames_start = AudioMixer::GetFramesMixed();
+                const auto time_start       = std::chrono::steady_clock::now();
+                float peak                  = 0.0f;
+                while (std::chrono::steady_clock::now() - time_start < std::chrono::seconds(4))
+                {
+                    peak = std::max(peak, AudioMixer::GetPeak());
+                    if (AudioMixer::GetFramesMixed() - frames_start >= AudioMixer::GetSampleRate() * 3 / 2)
+                        break;
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+
+                float progress     = AudioMixer::GetProgress(voice);
+                bool still_playing = AudioMixer::IsPlaying(voice);
+                AudioMixer::Stop(voice);
+
+                if (!still_playing || progress <= 0.0f)
+                {
+                    out_error = "The streamed clip did not play";
+                    passed    = false;
+                }
+                else if (peak <= 0.0f)
+                {
+                    out_error = "The streamed clip is silent";
+                    passed    = false;
+                }
+                else if (AudioMixer::GetStreamUnderruns() != underruns_before)
+                {
+                    out_error = "The stream underran " + std::to_string(AudioMixer::GetStreamUnderruns() - underruns_before) + " times";
+                    passed    = false;
+                }
+            }
+        }
+
+        // the streaming thread closes the file shortly after the voice stops
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        for (uint32_t attempt = 0; attempt < 100 && FileSystem::Exists(file_path); attempt++)
+        {
+            if (!FileSystem::Delete(file_path))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        return passed;
+    }
+
+    bool SmokeTest::Test_Audio_SynthesisBenchmark(std::string& out_error)
+    {
+        constexpr int sample_rate  = 48000;
+        constexpr int block_frames = 512;
+        constexpr int block_count  = sample_rate * 2 / block_frames;
+        constexpr float tolerance  = 1e-4f;
+
+        // the same parameter sweep goes through the scalar reference and the vector path, stereo interleaved
+        auto run = [](auto& synthesizer, bool simd, auto&& set_parameters, std::vector<float>& output) -> double
+        {
+            synthesizer.initialize(sample_rate);
+            synthesizer.set_simd(simd);
+            output.resize(static_cast<size_t>(block_count) * block_frames * 2);
+
+            const auto time_start = std::chrono::steady_clock::now();
+            for (int block = 0; block < block_count; block++)
+            {
+                set_parameters(synthesizer, static_cast<float>(block) / static_cast<float>(block_count));
+                synthesizer.generate(output.data() + static_cast<size_t>(block) * block_frames * 2, block_frames, true);
+            }
+
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+        };
+
+        auto compare = [&out_error](const char* name, const std::vector<float>& reference, const std::vector<float>& result, double seconds_scalar, double seconds_simd) -> bool
+        {
+            float max_error = 0.0f;
+            for (size_t i = 0; i < reference.size(); i++)
+            {
+                max_error = std::max(max_error, fabsf(reference[i] - result[i]));
+            }
+
+            // voices a single core can synthesize in real time
+            const double audio_seconds = static_cast<double>(block_count) * block_frames / sample_rate;
+            SP_LOG_INFO("%s synthesis: %.1f voices per core scalar, %.1f voices per core simd, max error %g",
+                name, audio_seconds / seconds_scalar, audio_seconds / seconds_simd, max_error);
+
+            if (max_error > tolerance)
+            {
+                out_error = std::string(name) + " simd output differs from the scalar reference by " + std::to_string(max_error);
+                return false;
+            }
+
+            return true;
+        };
+
+        // engine: rpm sweep with throttle lifts, so combustion, crackle and the turbo all get exercised
+        auto engine_parameters = [](engine_sound::synthesizer& synthesizer, float t)
+        {
+            float throttle = fmodf(t * 6.0f, 1.0f) < 0.7f ? 1.0f : 0.0f;
+            synthesizer.set_parameters(engine_sound::tuning::idle_rpm + t * 8000.0f, throttle, throttle * 0.8f, throttle * 1.5f);
+        };
+
+        std::vector<float> reference, result;
+        auto engine_scalar    = std::make_unique<engine_sound::synthesizer>();
+        auto engine_simd      = std::make_unique<engine_sound::synthesizer>();
+        double seconds_scalar = run(*engine_scalar, false, engine_parameters, reference);
+        double seconds_simd   = run(*engine_simd, true, engine_parameters, result);
+        if (!compare("Engine", reference, result, seconds_scalar, seconds_simd))
+            return false;
+
+        // tire squeal: intensity swell at rising speed
+        auto tire_parameters = [](tire_squeal_sound::synthesizer& synthesizer, float t)
+        {
+            synthesizer.set_parameters(0.5f + 0.5f * sinf(t * 8.0f), t);
+        };
+
+        auto tire_scalar = std::make_unique<tire_squeal_sound::synthesizer>();
+        auto tire_simd   = std::make_unique<tire_squeal_sound::synthesizer>();
+        seconds_scalar   = run(*tire_scalar, false, tire_parameters, reference);
+        seconds_simd     = run(*tire_simd, true, tire_parameters, result);
+        return compare("Tire squeal", reference, result, seconds_scalar, seconds_simd);
+    }
+
+    bool SmokeTest::Test_Geometry_RaycastBenchmark(std::string& out_error)
+    {
+        // a rippled grid of ~500k triangles
+        std::vector<RHI_Vertex_PosTexNorTan> vertices;
+        std::vector<uint32_t> indices;
+        geometry_generation::generate_grid(&vertices, &indices, 513, 100.0f);
+        for (RHI_Vertex_PosTexNorTan& vertex : vertices)
+        {
+            vertex.pos[1] = sinf(vertex.pos[0] * 0.7f) * cosf(vertex.pos[2] * 0.5f) * 2.0f;
+        }
+        const uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+
+        auto mesh = std::make_unique<Mesh>();
+        mesh->AddGeometry(vertices, indices, false);
+        mesh->GetGeometry(0, &indices, &vertices); // as stored, after optimization
+
+        // steep rays from above and below, the triangle test is single sided so one set faces the grid
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> tilt(-0.3f, 0.3f);
+        std::vector<math::Ray> rays;
+        for (uint32_t i = 0; i < 200; i++)
+        {
+            float side = (i % 2 == 0) ? 1.0f : -1.0f;
+            rays.emplace_back(math::Vector3(position(generator), 10.0f * side, position(generator)), math::Vector3(tilt(generator), -side, tilt(generator)));
+        }
+
+        // reference: every triangle against every ray
+        std::vector<float> reference(rays.size(), std::numeric_limits<float>::infinity());
+        auto time_start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rays.size(); r++)
+        {
+            for (uint32_t i = 0; i < triangle_count; i++)
+            {
+                float distance = rays[r].HitDistance(
+                    math::Vector3(vertices[indices[i * 3]].pos[0], vertices[indices[i * 3]].pos[1], vertices[indices[i * 3]].pos[2]),
+                    math::Vector3(vertices[indices[i * 3 + 1]].pos[0], vertices[indices[i * 3 + 1]].pos[1], vertices[indices[i * 3 + 1]].pos[2]),
+                    math::Vector3(vertices[indices[i * 3 + 2]].pos[0], vertices[indices[i * 3 + 2]].pos[1], vertices[indices[i * 3 + 2]].pos[2]));
+                reference[r] = std::min(reference[r], distance);
+            }
+        }
+        double seconds_brute = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+        // the first query builds the triangle bvh
+        time_start = std::chrono::steady_clock::now();
+        mesh->Raycast(0, rays[0], std::numeric_limits<float>::infinity());
+        double seconds_build = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+        constexpr uint32_t repeats = 50;
+        uint32_t hit_count         = 0;
+        time_start                 = std::chrono::steady_clock::now();
+        for (uint32_t repeat = 0; repeat < repeats; repeat++)
+        {
+            for (size_t r = 0; r < rays.size(); r++)
+            {
+                float distance = mesh->Raycast(0, rays[r], std::numeric_limits<float>::infinity());
+                if (distance != reference[r])
+                {
+                    out_error = "Ray " + std::to_string(r) + " hit at " + std::to_string(distance) + " instead of " + std::to_string(reference[r]);
+                    return false;
+                }
+                hit_count += distance != std::numeric_limits<float>::infinity() ? 1 : 0;
+            }
+        }
+        double seconds_bvh = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+        if (hit_count == 0)
+        {
+            out_error = "No ray hit the grid";
+            return false;
+        }
+
+        SP_LOG_INFO("Raycast against %u triangles: %.0f rays/s brute force, %.0f rays/s bvh, bvh built in %.1f ms",
+            triangle_count, rays.size() / seconds_brute, rays.size() * repeats / seconds_bvh, seconds_build * 1000.0);
+
+        return true;
+    }
+
+    bool SmokeTest::Test_Profiling_HardwareCounters(std::string& out_error)
+    {
+        const bool enabled_previous = HardwareCounters::IsEnabled();
+        HardwareCounters::SetEnabled(true);
+
+        // ci machines and virtual machines often don't expose the counters, that has to degrade quietly
+        HardwareCounterValues before = {};
+        HardwareCounterValues after  = {};
+        bool available = HardwareCounters::Read(before);
+        if (available != HardwareCounters::IsAvailable())
+        {
+            HardwareCounters::SetEnabled(enabled_previous);
+            out_error = "Read() and IsAvailable() disagree";
+            return false;
+        }
+
+        // some work that retires a known minimum of instructions
+        volatile uint64_t sink = 0;
+        for (uint64_t i = 0; i < 1000000; i++)
+        {
+            sink = sink + i;
+        }
+
+        if (available)
+        {
+            HardwareCounters::Read(after);
+            for (uint32_t i = 0; i < static_cast<uint32_t>(HardwareCounter::Count); i++)
+            {
+                if (after[i] < before[i])
+                {
+                    HardwareCounters::SetEnabled(enabled_previous);
+                    out_error = std::string("Counter \"") + HardwareCounters::GetName(static_cast<HardwareCounter>(i)) + "\" went backwards";
+                    return false;
+                }
+            }
+
+            const uint64_t instructions = after[static_cast<size_t>(HardwareCounter::Instructions)] - before[static_cast<size_t>(HardwareCounter::Instructions)];
+            if (HardwareCounters::IsAvailable(HardwareCounter::Instructions) && instructions < 1000000)
+            {
+                HardwareCounters::SetEnabled(enabled_previous);
+                out_error = "Only " + std::to_string(instructions) + " instructions were counted for a loop of a million iterations";
+                return false;
+            }
+
+            SP_LOG_INFO("Hardware counters: %llu instructions, %llu cycles", static_cast<unsigned long long>(instructions),
+                static_cast<unsigned long long>(after[static_cast<size_t>(HardwareCounter::Cycles)] - before[static_cast<size_t>(HardwareCounter::Cycles)]));
+        }
+        else
+        {
+            SP_LOG_INFO("Hardware counters are not available on this machine, skipping");
+        }
+
+        HardwareCounters::SetEnabled(enabled_previous);
+        return true;
+    }
+
+    bool SmokeTest::Test_Profiling_ParallelTrace(std::string& out_error)
+    {
+        static const char* name_outer = "smoke_test_outer";
+        static const char* name_inner = "smoke_test_inner";
+        constexpr uint32_t work_count = 2000; // fits a single thread ring even if one thread ends up doing all the work
+        constexpr uint32_t loop_count = 4;
+
+        Profiler::TraceBegin();
+        {
+            // parallel loops submitted from the main thread and from inside jobs
+            std::vector<std::future<void>> futures;
+            for (uint32_t loop = 0; loop < loop_count; loop++)
+            {
+                auto work = [](uint32_t start, uint32_t end)
+                {
+                    for (uint32_t i = start; i < end; i++)
+                    {
+                        ScopedTimeBlock outer(name_outer);
+                        ScopedTimeBlock inner(name_inner);
+                    }
+                };
+
+                if (loop % 2 == 0)
+                {
+                    ThreadPool::ParallelLoop(work, work_count);
+                }
+                else
+                {
+                    futures.emplace_back(ThreadPool::AddTask([work]() { ThreadPool::ParallelLoop(work, work_count); }));
+                }
+            }
+
+            for (std::future<void>& future : futures)
+            {
+                future.get();
+            }
+            ThreadPool::Flush();
+        }
+        Profiler::TraceEnd();
+
+        const std::vector<TraceEvent>& events = Profiler::GetTraceEvents();
+        uint32_t count_outer = 0;
+        uint32_t count_inner = 0;
+        std::unordered_set<uint32_t> jobs_submitted;
+        std::unordered_set<uint32_t> jobs_started;
+        for (const TraceEvent& event : events)
+        {
+            if (event.type == TraceEventType::FlowStart)
+            {
+                jobs_submitted.insert(event.job_id);
+            }
+            else if (event.type == TraceEventType::FlowEnd)
+            {
+                jobs_started.insert(event.job_id);
+            }
+            else if (event.name == name_outer || event.name == name_inner)
+            {
+                (event.name == name_outer ? count_outer : count_inner)++;
+                if (event.end_ns < event.start_ns)
+                {
+                    out_error = "Event ends before it starts";
+                    return false;
+                }
+            }
+        }
+
+        uint64_t dropped = Profiler::GetTraceDroppedCount();
+        if (dropped != 0 || count_outer != work_count * loop_count || count_inner != work_count * loop_count)
+        {
+            out_error = "Lost events: " + std::to_string(count_outer) + " outer and " + std::to_string(count_inner) + " inner of " +
+                        std::to_string(work_count * loop_count) + ", " + std::to_string(dropped) + " dropped";
+            return false;
+        }
+
+        if (jobs_submitted.empty() || jobs_submitted != jobs_started)
+        {
+            out_error = "Flow events don't pair up: " + std::to_string(jobs_submitted.size()) + " jobs submitted, " + std::to_string(jobs_started.size()) + " started";
+            return false;
+        }
+
+        // export and make sure something was written
+        const std::string file_path = "smoke_test_trace.json";
+        if (!Profiler::TraceExport(file_path) || !FileSystem::Exists(file_path) || std::filesystem::file_size(file_path) == 0)
+        {
+            out_error = "Failed to export the trace";
+            return false;
+        }
+        FileSystem::Delete(file_path);
+
+        SP_LOG_INFO("Traced %zu events across %u threads", events.size(), ThreadPool::GetThreadCount() + 1);
+        return true;
+    }
+
+    bool SmokeTest::Test_Memory_FrameAllocator(std::string& out_error)
+    {
+        // alignment is honoured for over-aligned types
+        struct alignas(64) aligned_block { float data[16]; };
+        FrameVector<aligned_block> blocks(8);
+        if (reinterpret_cast<uintptr_t>(blocks.data()) % 64 != 0)
+        {
+            out_error = "Over-aligned allocation isn't aligned";
+            return false;
+        }
+
+        // growth keeps contents, including past a page boundary
+        FrameVector<uint32_t> values;
+        const uint32_t value_count = 200000;
+        for (uint32_t i = 0; i < value_count; i++)
+        {
+            values.push_back(i);
+        }
+        for (uint32_t i = 0; i < value_count; i++)
+        {
+            if (values[i] != i)
+            {
+                out_error = "Contents lost while growing at index " + std::to_string(i);
+                return false;
+            }
+        }
+
+        FrameString text = "frame scratch ";
+        text += "string that is long enough to skip the small string buffer";
+        if (text.size() != 72)
+        {
+            out_error = "Unexpected string length " + std::to_string(text.size());
+            return false;
+        }
+
+        // workers allocate from their own arenas
+        std::atomic<uint32_t> corrupt = 0;
+        ThreadPool::ParallelLoop([&corrupt](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                FrameVector<uint64_t> local(1024, i);
+                for (uint64_t value : local)
+                {
+                    if (value != i)
+                    {
+                        corrupt++;
+                        break;
+                    }
+                }
+            }
+        }, 256);
+
+        if (corrupt != 0)
+        {
+            out_error = std::to_string(corrupt.load()) + " worker allocation(s) were corrupted";
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SmokeTest::Test_Memory_SlabAllocator(std::string& out_error)
+    {
+        // every size and alignment the slabs serve, plus a few that fall through to the header path
+        for (size_t alignment : { 1, 8, 16, 32, 64, 128 })
+        {
+            for (size_t size : { 0, 1, 15, 16, 17, 100, 255, 256, 700, 1024, 1025, 8192 })
+            {
+                uint8_t* ptr = static_cast<uint8_t*>(Allocator::Allocate(size, alignment));
+                if (!ptr || reinterpret_cast<uintptr_t>(ptr) % alignment != 0)
+                {
+                    out_error = "Bad allocation for size " + std::to_string(size) + " and alignment " + std::to_string(alignment);
+                    return false;
+                }
+                memset(ptr, 0xAB, size);
+                Allocator::Free(ptr);
+            }
+        }
+
+        // blocks allocated on workers and freed on this thread, then the other way around
+        const uint32_t block_count = 4096;
+        std::vector<uint32_t*> blocks(block_count, nullptr);
+        ThreadPool::ParallelLoop([&blocks](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                blocks[i]    = static_cast<uint32_t*>(Allocator::Allocate(sizeof(uint32_t) * (1 + i % 64)));
+                blocks[i][0] = i;
+            }
+        }, block_count);
+
+        for (uint32_t i = 0; i < block_count; i++)
+        {
+            if (blocks[i][0] != i)
+            {
+                out_error = "Block " + std::to_string(i) + " was overwritten";
+                return false;
+            }
+            Allocator::Free(blocks[i]);
+            blocks[i] = static_cast<uint32_t*>(Allocator::Allocate(sizeof(uint32_t) * (1 + i % 64)));
+        }
+
+        ThreadPool::ParallelLoop([&blocks](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                Allocator::Free(blocks[i]);
+            }
+        }, block_count);
+
+        return true;
+    }
+
+    bool SmokeTest::Test_Memory_AllocationProfiler(std::string& out_error)
+    {
+        const size_t interval_previous = Allocator::GetSamplingInterval();
+        const size_t interval          = 4096;
+        Allocator::SetSamplingInterval(interval);
+
+        HeapSnapshot before = AllocationProfiler::TakeSnapshot();
+
+        // 4 mb attributed to a tag through a scope, roughly one sample per interval
+        std::vector<std::unique_ptr<uint8_t[]>> blocks;
+        {
+            SP_MEMORY_TAG(MemoryTag::Ui);
+            for (uint32_t i = 0; i < 4096; i++)
+            {
+                blocks.emplace_back(new uint8_t[1024]);
+            }
+        }
+
+        HeapSnapshot diff = AllocationProfiler::Diff(before, AllocationProfiler::TakeSnapshot());
+        blocks.clear();
+        Allocator::SetSamplingInterval(interval_previous);
+
+        int64_t bytes_tagged = 0;
+        for (const AllocationSite& site : diff.sites)
+        {
+            if (site.tag == MemoryTag::Ui)
+            {
+                bytes_tagged += site.bytes;
+            }
+        }
+
+        // sampling is an estimate, allow a generous margin
+        const int64_t bytes_expected = 4096 * 1024;
+        if (bytes_tagged < bytes_expected / 2 || bytes_tagged > bytes_expected * 2)
+        {
+            out_error = "Sampled " + std::to_string(bytes_tagged) + " bytes under the ui tag, expected about " + std::to_string(bytes_expected);
+            return false;
+        }
+
+        if (Allocator::GetCurrentTag() != MemoryTag::Untagged)
+        {
+            out_error = "Memory tag scope didn't pop";
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SmokeTest::Test_Event_DeferredQueue(std::string& out_error)
+    {
+        std::vector<uint64_t> received;
+        subscription_handle handle = Event::Subscribe(EventType::Test, [&received](const sp_variant& data)
+        {
+            received.push_back(Event::GetPayload<EventType::Test>(data));
+        });
+
+        // immediate events are delivered inside the fire call
+        SP_FIRE_EVENT_DATA(EventType::Test, uint64_t(7));
+        bool delivered_immediately = received.size() == 1 && received[0] == 7;
+        received.clear();
+
+        // deferred events wait for the dispatch and keep the order they were fired in
+        for (uint64_t i = 0; i < 100; i++)
+        {
+            SP_FIRE_EVENT_DATA_DEFERRED(EventType::Test, i);
+        }
+        bool held_until_dispatch = received.empty();
+        Event::Dispatch();
+        bool ordered = received.size() == 100;
+        for (size_t i = 0; ordered && i < received.size(); i++)
+        {
+            ordered = received[i] == i;
+        }
+        received.clear();
+
+        // workers fire concurrently, every event arrives exactly once
+        const uint32_t event_count = 10000;
+        ThreadPool::ParallelLoop([](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                SP_FIRE_EVENT_DATA_DEFERRED(EventType::Test, static_cast<uint64_t>(i));
+            }
+        }, event_count);
+        Event::Dispatch();
+        std::sort(received.begin(), received.end());
+        bool complete = received.size() == event_count;
+        for (size_t i = 0; complete && i < received.size(); i++)
+        {
+            complete = received[i] == i;
+        }
+
+        Event::Unsubscribe(EventType::Test, handle);
+
+        if (!delivered_immediately)
+        {
+            out_error = "Immediate event wasn't delivered inside the fire call";
+            return false;
+        }
+        if (!held_until_dispatch)
+        {
+            out_error = "Deferred event was delivered before the dispatch";
+            return false;
+        }
+        if (!ordered)
+        {
+            out_error = "Deferred events arrived out of order";
+            return false;
+        }
+        if (!complete)
+        {
+            out_error = "Expected each of " + std::to_string(event_count) + " worker events once, received " + std::to_string(received.size());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SmokeTest::Test_Logging_RateLimit(std::string& out_error)
+    {
+        // a single call site gets a fixed budget per second, the rest is dropped before formatting
+        LogSite site;
+        uint32_t allowed = 0;
+        for (uint32_t i = 0; i < 1000; i++)
+        {
+            allowed += Log::ShouldLog(site, LogType::Info, __FUNCTION__) ? 1 : 0;
+        }
+
+        // the loop can straddle a second boundary, which grants one more budget
+        if (allowed < Log::rate_limit_per_second || allowed > Log::rate_limit_per_second * 2)
+        {
+            out_error = "Call site was allowed " + std::to_string(allowed) + " messages, expected " + std::to_string(Log::rate_limit_per_second);
+            return false;
+        }
+
+        // messages below the runtime level never reach the queue
+        const LogType level_previous = Log::GetLevel();
+        Log::SetLevel(LogType::Error);
+        LogSite site_filtered;
+        const bool info_filtered  = !Log::ShouldLog(site_filtered, LogType::Info, __FUNCTION__);
+        const bool error_accepted = Log::ShouldLog(site_filtered, LogType::Error, __FUNCTION__);
+        Log::SetLevel(level_previous);
+
+        if (!info_filtered || !error_accepted)
+        {
+            out_error = "Runtime log level was not respected";
+            return false;
+        }
+
+        // listen in on the logger for the rest of the test
+        ILogger* logger_previous = Log::GetLogger();
+        capture_logger capture(logger_previous);
+        Log::SetLogger(&capture);
+        Log::SetLevel(LogType::Info);
+
+        // the first message of a later second reports what the call site dropped, pretend the budget above is a second old
+        const uint32_t suppressed = site.suppressed.load();
+        site.second.fetch_sub(1);
+        Log::ShouldLog(site, LogType::Info, __FUNCTION__);
+
+        // queued messages are delivered by the time flush returns
+        SP_LOG_INFO("Smoke test flush marker");
+        Log::Flush();
+
+        const bool reported  = suppressed > 0 && capture.Contains(std::to_string(suppressed) + " similar messages were suppressed");
+        const bool delivered = capture.Contains("Smoke test flush marker");
+
+        Log::SetLevel(level_previous);
+        Log::SetLogger(logger_previous);
+
+        if (!reported)
+        {
+            out_error = "Expected a report of " + std::to_string(suppressed) + " suppressed messages";
+            return false;
+        }
+        if (!delivered)
+        {
+            out_error = "Queued message wasn't delivered by the flush";
+            return false;
+        }
+
+        return true;
+    }
+
+    bool SmokeTest::Test_Benchmark_BaselineComparison(std::string& out_error)
+    {
+        Benchmark::Results baseline;
+        baseline["showroom/frame_ms"]           = 10.0;
+        baseline["showroom/cpu/World::Tick"]    = 2.0;
+        baseline["showroom/cpu/Renderer::Tick"] = 0.05;
+
+        // round trip through the file format
+        const std::string file_path = "smoke_test_benchmark.json";
+        Benchmark::Results baseline_read;
+        if (!Benchmark::WriteResults(file_path, baseline, 600) || !Benchmark::ReadResults(file_path, baseline_read))
+        {
+            out_error = "Failed to write or read back the results";
+            return false;
+        }
+        FileSystem::Delete(file_path);
+
+        if (baseline_read.size() != baseline.size())
+        {
+            out_error = "Read " + std::to_string(baseline_read.size()) + " metrics, expected " + std::to_string(baseline.size());
+            return false;
+        }
+
+        for (const auto& [name, value] : baseline)
+        {
+            auto it = baseline_read.find(name);
+            if (it == baseline_read.end() || std::abs(it->second - value) > 0.0001)
+            {
+                out_error = "Metric \"" + name + "\" didn't survive the round trip";
+                return false;
+            }
+        }
+
+        // within tolerance: +5% overall, and a tiny block that doubled but stays under the absolute floor
+        Benchmark::Results results = baseline;
+        results["showroom/frame_ms"]           = 10.5;
+        results["showroom/cpu/Renderer::Tick"] = 0.1;
+        std::vector<std::string> regressions;
+        if (!Benchmark::Compare(baseline_read, results, 10.0, 0.1, regressions) || !regressions.empty())
+        {
+            out_error = "Reported a regression within tolerance";
+            return false;
+        }
+
+        // a real slowdown
+        results["showroom/cpu/World::Tick"] = 3.0;
+        if (Benchmark::Compare(baseline_read, results, 10.0, 0.1, regressions) || regressions.size() != 1)
+        {
+            out_error = "Missed a 50% slowdown";
+            return false;
+        }
+
+        return true;
+    }
+
     bool SmokeTest::Test_Renderer_PipelineStates(std::string& out_error)
     {
         for (uint32_t i = 0; i < static_cast<uint32_t>(Renderer_RasterizerState::Max); ++i)
@@ -531,6 +1433,28 @@ namespace spartan
             return false;
         }
 
+        // the renderer only sees the world through its snapshot, which has to agree with the entity
+        {
+            const RenderObject* snapshot = nullptr;
+            for (const RenderObject& object : RenderWorld::GetObjects())
+            {
+                if (object.entity_id == entity_cube->GetObjectId())
+                {
+                    snapshot = &object;
+                    break;
+                }
+            }
+
+            if (!snapshot || snapshot->transform != entity_cube->GetMatrix())
+            {
+                out_error = snapshot ? "Render world snapshot holds a stale transform for the cube" : "Render world snapshot is missing the cube";
+                World::RemoveEntity(entity_cube);
+                World::RemoveEntity(entity_light);
+                World::RemoveEntity(entity_camera);
+                return false;
+            }
+        }
+
         std::unique_ptr<RHI_Buffer> staging = CreateStagingBuffer(frame_output, out_error);
         if (!staging)
         {
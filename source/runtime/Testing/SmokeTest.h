@@ -62,6 +62,18 @@ namespace spartan
         static bool Test_RHI_CommandListRecording(std::string& out_error);
         static bool Test_RHI_ResourceTransitions(std::string& out_error);
         static bool Test_Threading_ResourceCreation(std::string& out_error);
+        static bool Test_Audio_MixerVoices(std::string& out_error);
+        static bool Test_Audio_StreamingClip(std::string& out_error);
+        static bool Test_Audio_SynthesisBenchmark(std::string& out_error);
+        static bool Test_Geometry_RaycastBenchmark(std::string& out_error);
+        static bool Test_Profiling_ParallelTrace(std::string& out_error);
+        static bool Test_Profiling_HardwareCounters(std::string& out_error);
+        static bool Test_Memory_FrameAllocator(std::string& out_error);
+        static bool Test_Memory_SlabAllocator(std::string& out_error);
+        static bool Test_Memory_AllocationProfiler(std::string& out_error);
+        static bool Test_Logging_RateLimit(std::string& out_error);
+        static bool Test_Event_DeferredQueue(std::string& out_error);
+        static bool Test_Benchmark_BaselineComparison(std::string& out_error);
         static bool Test_Render_BasicCube(std::string& out_error);
 
     private:
@@ -25,8 +25,8 @@ connection with the software or the use or other dealings in the software.
 #include "Component.h"
 #include <string>
 #include <vector>
-#include <functional>
 #include <sol/sol.hpp>
+#include "../../Audio/AudioMixer.h"
 //====================
 
 namespace sol
@@ -34,18 +34,9 @@ namespace sol
     class state_view;
 }
 
-struct SDL_AudioStream;
-struct SDL_AudioSpec;
-namespace audio_clip_cache
-{
-    struct AudioClip;
-}
-
 namespace spartan
 {
-    // callback type for audio synthesis: generates stereo samples into buffer
-    // parameters: output buffer (stereo interleaved), number of sample frames
-    using SynthesisCallback     = std::function<void(float*, int)>;
+    class Volume;
 
     class AudioSource : public Component
     {
@@ -112,10 +103,8 @@ namespace spartan
         void SetReverbWet(const float wet);
 
     private:
-        void FeedAudioChunk();
-        void FeedSynthesizedChunk();
+        AudioVoiceParameters BuildVoiceParameters() const;
 
-        std::vector<float> m_stereo_chunk; // reused to avoid per-call allocation
         std::string m_name                             = "N/A";
         bool m_is_3d                                   = false;
         bool m_mute                                    = false;
@@ -126,11 +115,10 @@ namespace spartan
         float m_attenuation                            = 1.0f;
         float m_pan                                    = 0.0f; // -1.0 (left) to 1.0 (right)
         bool m_is_playing                              = false;
-        uint32_t m_position                            = 0; // in bytes
-        SDL_AudioStream* m_stream                      = nullptr;
+        AudioVoice m_voice                             = 0;
         float m_doppler_ratio                          = 1.0f;
         math::Vector3 position_previous                = math::Vector3::Zero;
-        std::shared_ptr<audio_clip_cache::AudioClip> m_clip = nullptr;
+        std::shared_ptr<AudioClip> m_clip              = nullptr;
         std::string m_file_path;
 
         // synthesis mode
@@ -141,13 +129,10 @@ namespace spartan
         bool m_reverb_enabled         = false;
         float m_reverb_room_size      = 0.5f;  // 0.0 to 1.0, affects delay times
         float m_reverb_decay          = 0.5f;  // 0.0 to 1.0, feedback factor
-        float m_reverb_wet            = 0.3f;  // 0.0 to 1.0, wet/dry mix
-        std::vector<float> m_reverb_buffer_l;  // circular buffer for left channel
-        std::vector<float> m_reverb_buffer_r;  // circular buffer for right channel
-        uint32_t m_reverb_write_pos   = 0;     // write position in reverb buffers
-        static constexpr uint32_t reverb_buffer_size = 48000; // ~1 second at 48khz
+        float m_reverb_wet            = 0.3f;  // 0.0 to 1.0, send level into the mixer's reverb bus
 
         // volume-driven reverb override
         bool m_volume_reverb_active = false;
+        std::vector<Volume*> m_volumes; // scratch for the volume query, kept to avoid allocating every tick
     };
 }
@@ -49,9 +49,6 @@ namespace spartan
         m_entity_ptr->SetPosition(Vector3(0.0f, 3.0f, -5.0f));
         SetFlag(CameraFlags::CanBeControlled, true);
         SetFlag(CameraFlags::PhysicalBodyAnimation, true);
-        m_pick_hits.reserve(256);
-        m_pick_indices.reserve(65536);
-        m_pick_vertices.reserve(65536);
     }
 
     void Camera::Initialize()
@@ -173,8 +170,9 @@ namespace spartan
     {
         static Ray ray;
 
-        ray.m_origin    = GetEntity()->GetPosition();
-        ray.m_direction = ScreenToWorldCoordinates(Input::GetMousePositionRelativeToEditorViewport(), 1.0f);
+        // from the camera towards the cursor on the far plane
+        Vector3 origin = GetEntity()->GetPosition();
+        ray            = Ray(origin, ScreenToWorldCoordinates(Input::GetMousePositionRelativeToEditorViewport(), 1.0f) - origin);
 
         return ray;
     }
@@ -188,98 +186,11 @@ namespace spartan
         }
 
         const Ray& ray = ComputePickingRay();
-        m_pick_hits.clear();
 
-        const vector<Entity*>& entities = World::GetEntities();
-        for (Entity* entity : entities)
-        {
-            if (!entity->GetComponent<Renderable>())
-                continue;
-
-            const BoundingBox& aabb = entity->GetComponent<Renderable>()->GetBoundingBox();
-            float distance          = ray.HitDistance(aabb);
-            if (distance == numeric_limits<float>::infinity())
-                continue;
-
-            m_pick_hits.emplace_back(entity, Vector3::Zero, distance, distance == 0.0f);
-        }
-
-        Vector2 cursor         = Input::GetMousePosition();
-        float best_screen_dist = numeric_limits<float>::max();
-        float best_depth       = numeric_limits<float>::max();
-        Entity* best_entity    = nullptr;
-
-        // mesh-based triangle picking
-        if (!m_pick_hits.empty())
-        {
-            for (RayHitResult& broad_hit : m_pick_hits)
-            {
-                Renderable* renderable = broad_hit.m_entity->GetComponent<Renderable>();
-
-                // query mesh size first to reserve exact capacity and avoid allocations
-                uint32_t index_count  = renderable->GetIndexCount();
-                uint32_t vertex_count = renderable->GetVertexCount();
-                
-                // reserve exact capacity needed to avoid heap allocations in GetGeometry::resize()
-                // only reserve if current capacity is insufficient
-                if (m_pick_indices.capacity() < index_count)
-                {
-                    m_pick_indices.reserve(index_count);
-                }
-                if (m_pick_vertices.capacity() < vertex_count)
-                {
-                    m_pick_vertices.reserve(vertex_count);
-                }
-                
-                // clear and reuse pre-allocated buffers 
-                m_pick_indices.clear();
-                m_pick_vertices.clear();
-
-                renderable->GetGeometry(&m_pick_indices, &m_pick_vertices);
-                if (m_pick_indices.empty() || m_pick_vertices.empty())
-                    continue;
-
-                const Matrix& transform = broad_hit.m_entity->GetMatrix();
-
-                for (uint32_t i = 0; i < m_pick_indices.size(); i += 3)
-                {
-                    Vector3 p1(m_pick_vertices[m_pick_indices[i]].pos);
-                    Vector3 p2(m_pick_vertices[m_pick_indices[i + 1]].pos);
-                    Vector3 p3(m_pick_vertices[m_pick_indices[i + 2]].pos);
-
-                    p1 = p1 * transform;
-                    p2 = p2 * transform;
-                    p3 = p3 * transform;
-
-                    float distance = ray.HitDistance(p1, p2, p3);
-                    if (distance == numeric_limits<float>::infinity())
-                        continue;
-
-                    Vector3 world_hit = ray.GetStart() + ray.GetDirection() * distance;
-
-                    // project to clip space
-                    Vector4 clip = Vector4(world_hit, 1.0f) * GetViewProjectionMatrix();
-                    if (clip.w == 0.0f)
-                        continue;
-
-                    // ndc → screen
-                    Vector2 screen_pos(
-                        (clip.x / clip.w * 0.5f + 0.5f) * Renderer::GetViewport().width,
-                        (clip.y / clip.w * 0.5f + 0.5f) * Renderer::GetViewport().height
-                    );
-
-                    float screen_dist = (screen_pos - cursor).Length();
-
-                    // prefer smallest screen distance, then depth
-                    if (screen_dist < best_screen_dist || (screen_dist == best_screen_dist && distance < best_depth))
-                    {
-                        best_screen_dist = screen_dist;
-                        best_depth       = distance;
-                        best_entity      = broad_hit.m_entity;
-                    }
-                }
-            }
-        }
+        // closest renderable under the cursor, through the world and mesh bvhs
+        RayHitResult hit(nullptr, Vector3::Zero, numeric_limits<float>::infinity(), false);
+        World::Raycast(ray, hit);
+        Entity* best_entity = hit.m_entity;
 
         // spline control point picking
         {
@@ -287,13 +198,10 @@ namespace spartan
             float best_spline_dist     = numeric_limits<float>::max();
             Entity* best_spline_entity = nullptr;
 
-            // ray.m_direction is set to a world-space position (from ScreenToWorldCoordinates),
-            // not a normalized direction, so compute the actual direction ourselves
-            Vector3 ray_origin = ray.GetStart();
-            Vector3 ray_dir    = ray.GetDirection() - ray_origin;
-            ray_dir.Normalize();
+            const Vector3& ray_origin = ray.GetStart();
+            const Vector3& ray_dir    = ray.GetDirection();
 
-            for (Entity* entity : entities)
+            for (Entity* entity : World::GetEntities())
             {
                 Spline* spline = entity->GetComponent<Spline>();
                 if (!spline)
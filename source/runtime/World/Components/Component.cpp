@@ -40,12 +40,141 @@ using namespace std;
 
 namespace spartan
 {
+    AttributeTable::AttributeTable(initializer_list<Attribute> attributes) : m_attributes(attributes)
+    {
+        // trivial members are copied as byte ranges, neighbours merge into one range
+        vector<const Attribute*> trivial;
+        for (const Attribute& attribute : m_attributes)
+        {
+            if (attribute.trivial)
+            {
+                trivial.push_back(&attribute);
+            }
+            else
+            {
+                m_attributes_other.push_back(&attribute);
+            }
+        }
+
+        sort(trivial.begin(), trivial.end(), [](const Attribute* a, const Attribute* b) { return a->offset < b->offset; });
+        for (const Attribute* attribute : trivial)
+        {
+            if (!m_spans.empty() && m_spans.back().offset + m_spans.back().size == attribute->offset)
+            {
+                m_spans.back().size += attribute->size;
+            }
+            else
+            {
+                m_spans.push_back({ attribute->offset, attribute->size });
+            }
+        }
+    }
+
+    void AttributeTable::Copy(const Component* from, Component* to) const
+    {
+        const uint8_t* source = reinterpret_cast<const uint8_t*>(from);
+        uint8_t* destination  = reinterpret_cast<uint8_t*>(to);
+        for (const Span& span : m_spans)
+        {
+            memcpy(destination + span.offset, source + span.offset, span.size);
+        }
+
+        for (const Attribute* attribute : m_attributes_other)
+        {
+            attribute->copy(from, to, *attribute);
+        }
+    }
+
+    void AttributeTable::Save(const Component* from, vector<uint8_t>& out) const
+    {
+        const uint8_t* source = reinterpret_cast<const uint8_t*>(from);
+        for (const Span& span : m_spans)
+        {
+            out.insert(out.end(), source + span.offset, source + span.offset + span.size);
+        }
+
+        for (const Attribute* attribute : m_attributes_other)
+        {
+            if (attribute->save)
+            {
+                attribute->save(from, *attribute, out);
+            }
+        }
+    }
+
+    bool AttributeTable::Load(Component* to, const uint8_t*& data, const uint8_t* data_end) const
+    {
+        uint8_t* destination = reinterpret_cast<uint8_t*>(to);
+        for (const Span& span : m_spans)
+        {
+            if (static_cast<size_t>(data_end - data) < span.size)
+                return false;
+
+            memcpy(destination + span.offset, data, span.size);
+            data += span.size;
+        }
+
+        for (const Attribute* attribute : m_attributes_other)
+        {
+            if (attribute->load && !attribute->load(to, *attribute, data, data_end))
+                return false;
+        }
+
+        return true;
+    }
+
     Component::Component(Entity* entity)
     {
         m_entity_ptr = entity;
         m_enabled    = true;
     }
 
+    void Component::CopyAttributesFrom(const Component* other)
+    {
+        SP_ASSERT(other != nullptr && other->m_attributes == m_attributes);
+
+        if (m_attributes)
+        {
+            m_attributes->Copy(other, this);
+            OnAttributesChanged();
+        }
+    }
+
+    void Component::SaveAttributes(vector<uint8_t>& out) const
+    {
+        if (m_attributes)
+        {
+            m_attributes->Save(this, out);
+        }
+    }
+
+    bool Component::LoadAttributes(const uint8_t*& data, const uint8_t* data_end)
+    {
+        if (!m_attributes)
+            return true;
+
+        if (!m_attributes->Load(this, data, data_end))
+            return false;
+
+        OnAttributesChanged();
+        return true;
+    }
+
+    bool Component::IsCopyableFromPrototype(ComponentType type)
+    {
+        switch (type)
+        {
+            case ComponentType::Light:
+            case ComponentType::Physics:
+            case ComponentType::Volume:
+            case ComponentType::ParticleSystem:
+            case ComponentType::SplineFollower:
+                return true;
+            default:
+                return false;
+        }
+    }
+
     template <typename T>
     ComponentType Component::TypeToEnum() { return ComponentType::Max; }
 
@@ -22,9 +22,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ========================
-#include <any>
 #include <vector>
-#include <functional>
+#include <cstring>
+#include <type_traits>
 #include <sol/sol.hpp>
 
 #include "../../Core/SpartanObject.h"
@@ -66,12 +66,202 @@ namespace spartan
         Max
     };
 
+    class Component;
+
+    // describes one attribute of a component type, built once per type and shared by all of its instances
     struct Attribute
     {
-        std::function<std::any()> getter;
-        std::function<void(std::any)> setter;
+        const char* name = nullptr;
+        uint32_t offset  = 0;     // from the component, for attributes backed by a member
+        uint32_t size    = 0;
+        bool trivial     = false; // a member that can be copied and serialized as raw bytes
+
+        // generated per attribute, save and load are null for attributes that own resources (copied but not serialized)
+        void (*copy)(const Component* from, Component* to, const Attribute& attribute)                        = nullptr;
+        void (*save)(const Component* from, const Attribute& attribute, std::vector<uint8_t>& out)            = nullptr;
+        bool (*load)(Component* to, const Attribute& attribute, const uint8_t*& data, const uint8_t* data_end) = nullptr;
     };
 
+    // the attributes of a component type, trivial members that sit next to each other are copied with one memcpy
+    class AttributeTable
+    {
+    public:
+        AttributeTable(std::initializer_list<Attribute> attributes);
+
+        void Copy(const Component* from, Component* to) const;
+        void Save(const Component* from, std::vector<uint8_t>& out) const;
+        bool Load(Component* to, const uint8_t*& data, const uint8_t* data_end) const;
+
+        const std::vector<Attribute>& GetAttributes() const { return m_attributes; }
+
+    private:
+        struct Span
+        {
+            uint32_t offset = 0;
+            uint32_t size   = 0;
+        };
+
+        std::vector<Attribute> m_attributes;
+        std::vector<Span> m_spans;                   // merged trivial members, in offset order
+        std::vector<const Attribute*> m_attributes_other; // everything else, in registration order so setters run last
+    };
+
+    namespace attribute
+    {
+        template <typename T>
+        T& member(Component* component, const Attribute& attribute) { return *reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(component) + attribute.offset); }
+
+        template <typename T>
+        const T& member(const Component* component, const Attribute& attribute) { return *reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(component) + attribute.offset); }
+
+        // binary io, raw bytes for trivially copyable values, a count followed by the elements for vectors of them
+        // pointers are copied but never serialized, what they point to can be gone by the time the data is read back
+        template <typename T> struct io { static constexpr bool supported = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>; };
+        template <typename T> struct io<std::vector<T>> { static constexpr bool supported = io<T>::supported; };
+
+        template <typename T>
+        void write(const T& value, std::vector<uint8_t>& out)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                out.insert(out.end(), bytes, bytes + sizeof(T));
+            }
+            else
+            {
+                uint32_t count = static_cast<uint32_t>(value.size());
+                write(count, out);
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(value.data());
+                out.insert(out.end(), bytes, bytes + count * sizeof(typename T::value_type));
+            }
+        }
+
+        template <typename T>
+        bool read(T& value, const uint8_t*& data, const uint8_t* data_end)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                if (static_cast<size_t>(data_end - data) < sizeof(T))
+                    return false;
+
+                memcpy(&value, data, sizeof(T));
+                data += sizeof(T);
+            }
+            else
+            {
+                uint32_t count = 0;
+                if (!read(count, data, data_end))
+                    return false;
+
+                size_t size = count * sizeof(typename T::value_type);
+                if (static_cast<size_t>(data_end - data) < size)
+                    return false;
+
+                value.resize(count);
+                memcpy(value.data(), data, size);
+                data += size;
+            }
+
+            return true;
+        }
+
+        // a member that is copied directly
+        template <typename T>
+        Attribute make_value(const char* name, const Component* component, const T* value)
+        {
+            Attribute attribute;
+            attribute.name    = name;
+            attribute.offset  = static_cast<uint32_t>(reinterpret_cast<const uint8_t*>(value) - reinterpret_cast<const uint8_t*>(component));
+            attribute.size    = static_cast<uint32_t>(sizeof(T));
+            attribute.trivial = std::is_trivially_copyable_v<T> && io<T>::supported;
+            attribute.copy    = [](const Component* from, Component* to, const Attribute& attr)
+            {
+                member<T>(to, attr) = member<T>(from, attr);
+            };
+
+            if constexpr (io<T>::supported)
+            {
+                attribute.save = [](const Component* from, const Attribute& attr, std::vector<uint8_t>& out)
+                {
+                    write(member<T>(from, attr), out);
+                };
+                attribute.load = [](Component* to, const Attribute& attr, const uint8_t*& data, const uint8_t* data_end)
+                {
+                    return read(member<T>(to, attr), data, data_end);
+                };
+            }
+
+            return attribute;
+        }
+
+        // a member the component recomputes on its own (per frame renderer outputs, caches), copied but left out of snapshots
+        template <typename T>
+        Attribute make_transient(const char* name, const Component* component, const T* value)
+        {
+            Attribute attribute = make_value(name, component, value);
+            attribute.trivial   = false;
+            attribute.save      = nullptr;
+            attribute.load      = nullptr;
+            return attribute;
+        }
+
+        // a member that is read directly but written through a setter, for values with side effects
+        template <typename C, auto Setter, typename T>
+        Attribute make_value_set(const char* name, const Component* component, const T* value)
+        {
+            static_assert(io<T>::supported, "attributes written through a setter must be serializable");
+
+            Attribute attribute = make_value(name, component, value);
+            attribute.trivial   = false;
+            attribute.copy      = [](const Component* from, Component* to, const Attribute& attr)
+            {
+                (static_cast<C*>(to)->*Setter)(member<T>(from, attr));
+            };
+            attribute.load = [](Component* to, const Attribute& attr, const uint8_t*& data, const uint8_t* data_end)
+            {
+                T loaded;
+                if (!read(loaded, data, data_end))
+                    return false;
+
+                (static_cast<C*>(to)->*Setter)(loaded);
+                return true;
+            };
+
+            return attribute;
+        }
+
+        // a value that is only reachable through a getter and a setter
+        template <typename C, auto Getter, auto Setter>
+        Attribute make_get_set(const char* name)
+        {
+            using T = std::decay_t<decltype((std::declval<C&>().*Getter)())>;
+            static_assert(io<T>::supported, "attributes accessed through a getter and a setter must be serializable");
+
+            Attribute attribute;
+            attribute.name = name;
+            attribute.size = static_cast<uint32_t>(sizeof(T));
+            attribute.copy = [](const Component* from, Component* to, const Attribute&)
+            {
+                (static_cast<C*>(to)->*Setter)((const_cast<C*>(static_cast<const C*>(from))->*Getter)());
+            };
+            attribute.save = [](const Component* from, const Attribute&, std::vector<uint8_t>& out)
+            {
+                write((const_cast<C*>(static_cast<const C*>(from))->*Getter)(), out);
+            };
+            attribute.load = [](Component* to, const Attribute&, const uint8_t*& data, const uint8_t* data_end)
+            {
+                T loaded;
+                if (!read(loaded, data, data_end))
+                    return false;
+
+                (static_cast<C*>(to)->*Setter)(loaded);
+                return true;
+            };
+
+            return attribute;
+        }
+    }
+
     class Component : public SpartanObject
     {
     public:
@@ -133,39 +323,40 @@ namespace spartan
         ComponentType GetType()          const { return m_type; }
         void SetType(ComponentType type)       { m_type = type; }
 
-        const auto& GetAttributes() const { return m_attributes; }
-        void SetAttributes(const std::vector<Attribute>& attributes)
-        {
-            for (uint32_t i = 0; i < static_cast<uint32_t>(m_attributes.size()); i++)
-            {
-                m_attributes[i].setter(attributes[i].getter());
-            }
-        }
+        // attributes, used by cloning, copy/paste and snapshots
+        const AttributeTable* GetAttributeTable() const { return m_attributes; }
+        void CopyAttributesFrom(const Component* other);
+        void SaveAttributes(std::vector<uint8_t>& out) const;
+        bool LoadAttributes(const uint8_t*& data, const uint8_t* data_end);
 
-        Entity* GetEntity() const { return m_entity_ptr; }
+        // called after a copy or load wrote the attributes by value, to rebuild and notify what depends on them
+        virtual void OnAttributesChanged() {}
 
-    protected:
-        #define SP_REGISTER_ATTRIBUTE_GET_SET(getter, setter, type) RegisterAttribute(  \
-        [this]()                        { return getter(); },                           \
-        [this](const std::any& valueIn) { setter(std::any_cast<type>(valueIn)); });     \
+        // runtime state that lives outside the attributes (e.g. physics poses and velocities), captured by world snapshots
+        virtual void SaveRuntimeState(std::vector<uint8_t>& out) const {}
+        virtual bool LoadRuntimeState(const uint8_t*& data, const uint8_t* data_end) { return true; }
 
-        #define SP_REGISTER_ATTRIBUTE_VALUE_SET(value, setter, type) RegisterAttribute( \
-        [this]()                        { return value; },                              \
-        [this](const std::any& valueIn) { setter(std::any_cast<type>(valueIn)); });     \
+        // prefab templates load a component once and their instances copy it, types that resolve resources while loading are loaded per instance
+        static bool IsCopyableFromPrototype(ComponentType type);
+        virtual void CopyFromPrototype(const Component* prototype) {}
 
-        #define SP_REGISTER_ATTRIBUTE_VALUE_VALUE(value, type) RegisterAttribute(       \
-        [this]()                        { return value; },                              \
-        [this](const std::any& valueIn) { value = std::any_cast<type>(valueIn); });     \
+        Entity* GetEntity() const { return m_entity_ptr; }
 
-        // registers an attribute
-        void RegisterAttribute(std::function<std::any()>&& getter, std::function<void(std::any)>&& setter)
-        {
-            Attribute attribute;
-            attribute.getter = std::move(getter);
-            attribute.setter = std::move(setter);
-            m_attributes.emplace_back(attribute);
+    protected:
+        // declares the attributes of a component, the table is built once per type from the first instance
+        // usage: SP_REGISTER_ATTRIBUTES(SP_ATTRIBUTE_VALUE(m_range), SP_ATTRIBUTE_GET_SET(GetLightType, SetLightType));
+        #define SP_REGISTER_ATTRIBUTES(...)                                                     \
+        {                                                                                       \
+            using self_type [[maybe_unused]] = std::remove_pointer_t<decltype(this)>;           \
+            static const AttributeTable attribute_table = AttributeTable({ __VA_ARGS__ });       \
+            m_attributes = &attribute_table;                                                    \
         }
 
+        #define SP_ATTRIBUTE_VALUE(value)             attribute::make_value(#value, this, &value)
+        #define SP_ATTRIBUTE_TRANSIENT(value)         attribute::make_transient(#value, this, &value)
+        #define SP_ATTRIBUTE_VALUE_SET(value, setter) attribute::make_value_set<self_type, &self_type::setter>(#value, this, &value)
+        #define SP_ATTRIBUTE_GET_SET(getter, setter)  attribute::make_get_set<self_type, &self_type::getter, &self_type::setter>(#getter)
+
         // the type of the component
         ComponentType m_type = ComponentType::Max;
         // the state of the component
@@ -173,8 +364,7 @@ namespace spartan
         // the owner of the component
         Entity* m_entity_ptr = nullptr;
 
-    private:
-        // the attributes of the component
-        std::vector<Attribute> m_attributes;
+        // the attributes of the component, shared by all components of the same type
+        const AttributeTable* m_attributes = nullptr;
     };
 }
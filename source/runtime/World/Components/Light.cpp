@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World.h"
 #include "../Entity.h"
 #include "../../Rendering/Renderer.h"
+#include "../../Rendering/RenderWorld.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -93,22 +94,24 @@ namespace spartan
 
     Light::Light(Entity* entity) : Component(entity)
     {
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_flags, uint32_t);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_range, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_intensity_lumens_lux, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_angle_rad, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_color_rgb, Color);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_temperature_kelvin, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_draw_distance, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_bounding_box, math::BoundingBox);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_far_cascade_min, math::Vector3);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_far_cascade_max, math::Vector3);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_is_active_previous_frame, bool);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_changed_this_frame, bool);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_index, uint32_t);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_area_width, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_area_height, float);
-        SP_REGISTER_ATTRIBUTE_GET_SET(GetLightType, SetLightType, LightType);
+        SP_REGISTER_ATTRIBUTES(
+            SP_ATTRIBUTE_VALUE(m_flags),
+            SP_ATTRIBUTE_VALUE(m_light_type),
+            SP_ATTRIBUTE_VALUE(m_range),
+            SP_ATTRIBUTE_VALUE(m_intensity_lumens_lux),
+            SP_ATTRIBUTE_VALUE(m_angle_rad),
+            SP_ATTRIBUTE_VALUE(m_color_rgb),
+            SP_ATTRIBUTE_VALUE(m_temperature_kelvin),
+            SP_ATTRIBUTE_VALUE(m_draw_distance),
+            SP_ATTRIBUTE_VALUE(m_bounding_box),
+            SP_ATTRIBUTE_VALUE(m_far_cascade_min),
+            SP_ATTRIBUTE_VALUE(m_far_cascade_max),
+            SP_ATTRIBUTE_VALUE(m_area_width),
+            SP_ATTRIBUTE_VALUE(m_area_height),
+            SP_ATTRIBUTE_TRANSIENT(m_is_active_previous_frame),
+            SP_ATTRIBUTE_TRANSIENT(m_changed_this_frame),
+            SP_ATTRIBUTE_TRANSIENT(m_index)
+        );
 
         m_matrix_view.fill(Matrix::Identity);
         m_matrix_projection.fill(Matrix::Identity);
@@ -118,11 +121,13 @@ namespace spartan
         SetRange(get_sensible_range(m_light_type));
         SetFlag(LightFlags::Shadows);
         SetFlag(LightFlags::ShadowsScreenSpace);
+
+        RenderWorld::MarkDirty();
     }
 
     Light::~Light()
     {
-
+        RenderWorld::MarkDirty();
     }
 
     void Light::PreTick()
@@ -212,6 +217,33 @@ namespace spartan
         UpdateMatrices(); // regenerate view/projection after loading
     }
 
+    void Light::OnAttributesChanged()
+    {
+        // the type is written by value, so that the defaults SetLightType() applies don't overwrite the color and range
+        World::MarkEntityChanged(GetEntity()); // the directional light may change
+        UpdateMatrices();
+    }
+
+    void Light::CopyFromPrototype(const Component* prototype)
+    {
+        const Light* light = static_cast<const Light*>(prototype);
+
+        m_flags                = light->m_flags;
+        m_light_type           = light->m_light_type;
+        m_color_rgb            = light->m_color_rgb;
+        m_temperature_kelvin   = light->m_temperature_kelvin;
+        m_intensity            = light->m_intensity;
+        m_intensity_lumens_lux = light->m_intensity_lumens_lux;
+        m_range                = light->m_range;
+        m_angle_rad            = light->m_angle_rad;
+        m_index                = light->m_index;
+        m_preset               = light->m_preset;
+        m_area_width           = light->m_area_width;
+        m_area_height          = light->m_area_height;
+
+        UpdateMatrices(); // the matrices depend on this entity's transform
+    }
+
     void Light::RegisterForScripting(sol::state_view State)
     {
         State.new_enum("LightType",
@@ -315,7 +347,7 @@ namespace spartan
                 }
             }
 
-            m_changed_this_frame = true;
+            MarkChanged();
         }
     }
 
@@ -325,6 +357,7 @@ namespace spartan
             return;
 
         m_light_type = type;
+        World::MarkEntityChanged(GetEntity()); // the directional light may change
 
         SetColor(get_sensible_color(m_light_type));
         SetRange(get_sensible_range(m_light_type));
@@ -337,7 +370,7 @@ namespace spartan
         m_temperature_kelvin = temperature_kelvin;
         m_color_rgb          = Color(temperature_kelvin);
 
-        m_changed_this_frame = true;
+        MarkChanged();
     }
 
     void Light::SetColor(const Color& rgb)
@@ -367,7 +400,7 @@ namespace spartan
         else if (rgb == Color::light_photo_flash)
             m_temperature_kelvin = 5500.0f;
 
-        m_changed_this_frame = true;
+        MarkChanged();
     }
 
     void Light::SetIntensity(const LightIntensity intensity)
@@ -407,7 +440,7 @@ namespace spartan
             m_intensity_lumens_lux = 0.0f;
         }
 
-        m_changed_this_frame = true;
+        MarkChanged();
     }
 
     void Light::SetIntensity(const float lumens_lux)
@@ -415,7 +448,7 @@ namespace spartan
         m_intensity_lumens_lux = lumens_lux;
         m_intensity            = LightIntensity::custom;
 
-        m_changed_this_frame = true;
+        MarkChanged();
     }
 
     void Light::SetPreset(const LightPreset preset)
@@ -493,7 +526,7 @@ namespace spartan
             UpdateMatrices();
         }
 
-        m_changed_this_frame = true;
+        MarkChanged();
     }
 
     float Light::GetIntensityWatt() const
@@ -610,13 +643,19 @@ namespace spartan
         return 1; // spot and area lights use a single slice
     }
 
+    void Light::MarkChanged()
+    {
+        m_changed_this_frame = true;
+        World::MarkLightChanged(this);
+    }
+
     void Light::UpdateMatrices()
     {
         UpdateViewMatrix();
         UpdateProjectionMatrix();
         UpdateBoundingBox();
 
-        m_changed_this_frame = true;
+        MarkChanged();
     }
 
     void Light::UpdateViewMatrix()
@@ -88,6 +88,8 @@ namespace spartan
         void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void CopyFromPrototype(const Component* prototype) override;
+        void OnAttributesChanged() override;
         //============================================
 
         static void RegisterForScripting(sol::state_view State);
@@ -164,6 +166,7 @@ namespace spartan
         math::BoundingBox GetBoundingBox() const { return m_bounding_box; }
 
     private:
+        void MarkChanged();
         void UpdateMatrices();
         void UpdateViewMatrix();
         void UpdateProjectionMatrix();
@@ -36,16 +36,18 @@ namespace spartan
 {
     ParticleSystem::ParticleSystem(Entity* entity) : Component(entity)
     {
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_max_particles, uint32_t);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_emission_rate, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_lifetime, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_start_speed, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_start_size, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_end_size, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_start_color, Color);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_end_color, Color);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_gravity_modifier, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_emission_radius, float);
+        SP_REGISTER_ATTRIBUTES(
+            SP_ATTRIBUTE_VALUE(m_max_particles),
+            SP_ATTRIBUTE_VALUE(m_emission_rate),
+            SP_ATTRIBUTE_VALUE(m_lifetime),
+            SP_ATTRIBUTE_VALUE(m_start_speed),
+            SP_ATTRIBUTE_VALUE(m_start_size),
+            SP_ATTRIBUTE_VALUE(m_end_size),
+            SP_ATTRIBUTE_VALUE(m_start_color),
+            SP_ATTRIBUTE_VALUE(m_end_color),
+            SP_ATTRIBUTE_VALUE(m_gravity_modifier),
+            SP_ATTRIBUTE_VALUE(m_emission_radius)
+        );
 
         ApplyPreset(ParticlePreset::Fire);
     }
@@ -317,4 +319,21 @@ namespace spartan
         m_gravity_modifier = node.attribute("gravity_modifier").as_float(-1.0f);
         m_emission_radius = node.attribute("emission_radius").as_float(0.5f);
     }
+
+    void ParticleSystem::CopyFromPrototype(const Component* prototype)
+    {
+        const ParticleSystem* particles = static_cast<const ParticleSystem*>(prototype);
+
+        m_preset           = particles->m_preset;
+        m_max_particles    = particles->m_max_particles;
+        m_emission_rate    = particles->m_emission_rate;
+        m_lifetime         = particles->m_lifetime;
+        m_start_speed      = particles->m_start_speed;
+        m_start_size       = particles->m_start_size;
+        m_end_size         = particles->m_end_size;
+        m_start_color      = particles->m_start_color;
+        m_end_color        = particles->m_end_color;
+        m_gravity_modifier = particles->m_gravity_modifier;
+        m_emission_radius  = particles->m_emission_radius;
+    }
 }
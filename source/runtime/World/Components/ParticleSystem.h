@@ -60,6 +60,7 @@ namespace spartan
         void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void CopyFromPrototype(const Component* prototype) override;
         //============================================
 
         // preset
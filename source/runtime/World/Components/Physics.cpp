@@ -84,6 +84,53 @@ namespace spartan
             return flags;
         }
 
+        // heights are stored as 16-bit integers, so they are centered around the middle of their range to keep precision
+        PxHeightField* create_height_field(const PhysicsHeightField& height_field, const Vector3& scale, float& height_scale, float& height_center)
+        {
+            float height_min = numeric_limits<float>::max();
+            float height_max = numeric_limits<float>::lowest();
+            for (float height : height_field.heights)
+            {
+                height_min = min(height_min, height * scale.y);
+                height_max = max(height_max, height * scale.y);
+            }
+            height_center = (height_min + height_max) * 0.5f;
+            height_scale  = max((height_max - height_min) * 0.5f / static_cast<float>(numeric_limits<PxI16>::max()), PX_MIN_HEIGHTFIELD_Y_SCALE);
+
+            const uint32_t cell_columns = height_field.columns - 1;
+            vector<PxHeightFieldSample> samples(static_cast<size_t>(height_field.rows) * height_field.columns);
+            for (uint32_t row = 0; row < height_field.rows; row++)
+            {
+                for (uint32_t column = 0; column < height_field.columns; column++)
+                {
+                    uint32_t index            = row * height_field.columns + column;
+                    PxHeightFieldSample& sample = samples[index];
+                    float height              = (height_field.heights[index] * scale.y - height_center) / height_scale;
+                    sample.height             = static_cast<PxI16>(clamp(roundf(height), -32767.0f, 32767.0f));
+                    sample.materialIndex0     = 0;
+                    sample.materialIndex1     = 0;
+                    sample.clearTessFlag(); // split along the same diagonal as the terrain's render mesh
+
+                    // the last row and column don't start a cell
+                    if (!height_field.surfaces_indices.empty() && row < height_field.rows - 1 && column < cell_columns)
+                    {
+                        uint32_t cell         = row * cell_columns + column;
+                        sample.materialIndex0 = height_field.surfaces_indices[cell * 2];
+                        sample.materialIndex1 = height_field.surfaces_indices[cell * 2 + 1];
+                    }
+                }
+            }
+
+            PxHeightFieldDesc desc;
+            desc.format             = PxHeightFieldFormat::eS16_TM;
+            desc.nbRows             = height_field.rows;
+            desc.nbColumns          = height_field.columns;
+            desc.samples.data       = samples.data();
+            desc.samples.stride     = sizeof(PxHeightFieldSample);
+
+            return PxCreateHeightField(desc, *PxGetStandaloneInsertionCallback());
+        }
+
         // transform conversion helpers
         PxTransform to_px_transform(const Vector3& pos, const Quaternion& rot)
         {
@@ -116,21 +163,23 @@ namespace spartan
 
     Physics::Physics(Entity* entity) : Component(entity)
     {
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_is_static, bool);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_is_kinematic, bool);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_mass, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_friction, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_friction_rolling, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_restitution, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_position_lock, Vector3);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotation_lock, Vector3);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_center_of_mass, Vector3);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_velocity, Vector3);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_controller, void*);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_material, void*);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_mesh, void*);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_actors, vector<void*>);
-        SP_REGISTER_ATTRIBUTE_VALUE_SET(m_body_type, SetBodyType, BodyType);
+        SP_REGISTER_ATTRIBUTES(
+            SP_ATTRIBUTE_VALUE(m_is_static),
+            SP_ATTRIBUTE_VALUE(m_is_kinematic),
+            SP_ATTRIBUTE_VALUE(m_mass),
+            SP_ATTRIBUTE_VALUE(m_friction),
+            SP_ATTRIBUTE_VALUE(m_friction_rolling),
+            SP_ATTRIBUTE_VALUE(m_restitution),
+            SP_ATTRIBUTE_VALUE(m_position_lock),
+            SP_ATTRIBUTE_VALUE(m_rotation_lock),
+            SP_ATTRIBUTE_VALUE(m_center_of_mass),
+            SP_ATTRIBUTE_VALUE(m_velocity),
+            SP_ATTRIBUTE_VALUE(m_controller),
+            SP_ATTRIBUTE_VALUE(m_material),
+            SP_ATTRIBUTE_VALUE(m_mesh),
+            SP_ATTRIBUTE_VALUE(m_actors),
+            SP_ATTRIBUTE_VALUE_SET(m_body_type, SetBodyType)
+        );
     }
 
     Physics::~Physics()
@@ -220,6 +269,22 @@ namespace spartan
             static_cast<PxMaterial*>(m_material)->release();
             m_material = nullptr;
         }
+
+        // height field, the shapes that used it are gone with the actors
+        if (PhysicsWorld::GetPhysics())
+        {
+            for (void* material : m_materials_height_field)
+            {
+                static_cast<PxMaterial*>(material)->release();
+            }
+
+            if (m_px_height_field)
+            {
+                static_cast<PxHeightField*>(m_px_height_field)->release();
+            }
+        }
+        m_materials_height_field.clear();
+        m_px_height_field = nullptr;
     }
 
     void Physics::PreTick()
@@ -560,6 +625,25 @@ namespace spartan
         m_needs_creation = true;
     }
 
+    void Physics::CopyFromPrototype(const Component* prototype)
+    {
+        const Physics* physics = static_cast<const Physics*>(prototype);
+
+        m_mass             = physics->m_mass;
+        m_friction         = physics->m_friction;
+        m_friction_rolling = physics->m_friction_rolling;
+        m_restitution      = physics->m_restitution;
+        m_is_static        = physics->m_is_static;
+        m_is_kinematic     = physics->m_is_kinematic;
+        m_position_lock    = physics->m_position_lock;
+        m_rotation_lock    = physics->m_rotation_lock;
+        m_center_of_mass   = physics->m_center_of_mass;
+        m_body_type        = physics->m_body_type;
+
+        // the prototype never creates bodies, each instance creates its own on the first tick like a loaded one
+        m_needs_creation = true;
+    }
+
     void Physics::RegisterForScripting(sol::state_view State)
     {
 
@@ -572,6 +656,7 @@ namespace spartan
             "MeshConvex",   BodyType::MeshConvex,
             "Controller",   BodyType::Controller,
             "Vehicle",      BodyType::Vehicle,
+            "HeightField",  BodyType::HeightField,
             "Max",          BodyType::Max);
 
 
@@ -993,6 +1078,20 @@ namespace spartan
         Create();
     }
 
+    void Physics::SetHeightField(PhysicsHeightField&& height_field)
+    {
+        SP_ASSERT(height_field.rows >= 2 && height_field.columns >= 2);
+        SP_ASSERT(height_field.heights.size() == static_cast<size_t>(height_field.rows) * height_field.columns);
+        SP_ASSERT(height_field.surfaces_indices.empty() || height_field.surfaces_indices.size() == static_cast<size_t>(height_field.rows - 1) * (height_field.columns - 1) * 2);
+
+        m_height_field = move(height_field);
+
+        if (m_body_type == BodyType::HeightField)
+        {
+            Create();
+        }
+    }
+
     bool Physics::IsGrounded() const
     {
         return GetGroundEntity() != nullptr; // eCOLLISION_DOWN is not very reliable (it can flicker), so we use raycasting as a fallback
@@ -1206,6 +1305,132 @@ namespace spartan
         }
     }
 
+    void Physics::SaveRuntimeState(vector<uint8_t>& out) const
+    {
+        // the controller position, then the pose and velocities of every actor
+        Vector3 controller_position = Vector3::Zero;
+        if (m_controller)
+        {
+            PxExtendedVec3 position = static_cast<PxController*>(m_controller)->getPosition();
+            controller_position     = Vector3(static_cast<float>(position.x), static_cast<float>(position.y), static_cast<float>(position.z));
+        }
+        attribute::write(controller_position, out);
+
+        attribute::write(static_cast<uint32_t>(m_actors.size()), out);
+        for (void* body : m_actors)
+        {
+            Vector3 position         = Vector3::Zero;
+            Quaternion rotation      = Quaternion::Identity;
+            Vector3 velocity_linear  = Vector3::Zero;
+            Vector3 velocity_angular = Vector3::Zero;
+            if (PxRigidActor* actor = static_cast<PxRigidActor*>(body))
+            {
+                from_px_transform(actor->getGlobalPose(), position, rotation);
+                if (PxRigidDynamic* dynamic = actor->is<PxRigidDynamic>())
+                {
+                    velocity_linear  = from_px_vec3(dynamic->getLinearVelocity());
+                    velocity_angular = from_px_vec3(dynamic->getAngularVelocity());
+                }
+            }
+
+            attribute::write(position, out);
+            attribute::write(rotation, out);
+            attribute::write(velocity_linear, out);
+            attribute::write(velocity_angular, out);
+        }
+    }
+
+    bool Physics::LoadRuntimeState(const uint8_t*& data, const uint8_t* data_end)
+    {
+        Vector3 controller_position;
+        uint32_t actor_count = 0;
+        if (!attribute::read(controller_position, data, data_end) || !attribute::read(actor_count, data, data_end))
+            return false;
+
+        // the attributes were restored by value, so the bodies still carry the properties they were created with
+        // a different static or kinematic state needs new bodies, everything else is applied to the existing ones
+        if (m_body_type != BodyType::Controller && m_body_type != BodyType::Vehicle && !m_actors.empty())
+        {
+            bool recreate = false;
+            for (void* body : m_actors)
+            {
+                PxRigidActor* actor = static_cast<PxRigidActor*>(body);
+                if (!actor)
+                    continue;
+
+                PxRigidDynamic* dynamic = actor->is<PxRigidDynamic>();
+                const bool is_kinematic = dynamic && (dynamic->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC);
+                recreate               |= (dynamic == nullptr) != m_is_static || is_kinematic != m_is_kinematic;
+            }
+
+            if (recreate)
+            {
+                Create();
+            }
+            else
+            {
+                if (PxMaterial* material = static_cast<PxMaterial*>(m_material))
+                {
+                    material->setStaticFriction(m_friction);
+                    material->setDynamicFriction(m_friction_rolling);
+                    material->setRestitution(m_restitution);
+                }
+
+                for (void* body : m_actors)
+                {
+                    PxRigidDynamic* dynamic = body ? static_cast<PxRigidActor*>(body)->is<PxRigidDynamic>() : nullptr;
+                    if (!dynamic)
+                        continue;
+
+                    // same as when the bodies are created
+                    dynamic->setMass(m_mass);
+                    if (m_center_of_mass != Vector3::Zero)
+                    {
+                        PxVec3 p(m_center_of_mass.x, m_center_of_mass.y, m_center_of_mass.z);
+                        PxRigidBodyExt::setMassAndUpdateInertia(*dynamic, m_mass, &p);
+                    }
+                    dynamic->setRigidDynamicLockFlags(build_lock_flags(m_position_lock, m_rotation_lock));
+                }
+            }
+        }
+
+        if (m_controller)
+        {
+            static_cast<PxController*>(m_controller)->setPosition(PxExtendedVec3(controller_position.x, controller_position.y, controller_position.z));
+        }
+
+        if (actor_count != m_actors.size())
+        {
+            SP_LOG_WARNING("%s: the snapshot has %u physics actors but the entity has %zu, only the ones that line up are restored", GetEntity()->GetObjectName().c_str(), actor_count, m_actors.size());
+        }
+
+        for (uint32_t i = 0; i < actor_count; i++)
+        {
+            Vector3 position, velocity_linear, velocity_angular;
+            Quaternion rotation;
+            if (!attribute::read(position, data, data_end) || !attribute::read(rotation, data, data_end) ||
+                !attribute::read(velocity_linear, data, data_end) || !attribute::read(velocity_angular, data, data_end))
+                return false;
+
+            PxRigidActor* actor = i < m_actors.size() ? static_cast<PxRigidActor*>(m_actors[i]) : nullptr;
+            if (!actor)
+                continue;
+
+            actor->setGlobalPose(PxTransform(PxVec3(position.x, position.y, position.z), PxQuat(rotation.x, rotation.y, rotation.z, rotation.w)));
+            PxRigidDynamic* dynamic = actor->is<PxRigidDynamic>();
+            if (dynamic && !(dynamic->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
+            {
+                dynamic->setLinearVelocity(PxVec3(velocity_linear.x, velocity_linear.y, velocity_linear.z));
+                dynamic->setAngularVelocity(PxVec3(velocity_angular.x, velocity_angular.y, velocity_angular.z));
+            }
+        }
+
+        // don't interpolate from the pose before the restore
+        m_interpolation_initialized = false;
+
+        return true;
+    }
+
     void Physics::SetVehicleThrottle(float value)
     {
         if (m_body_type != BodyType::Vehicle)
@@ -2472,6 +2697,30 @@ namespace spartan
 
             SP_LOG_INFO("MeshConvex created: %d convex shapes from %zu entities", shapes_created, renderable_entities.size());
         }
+        else if (m_body_type == BodyType::HeightField)
+        {
+            if (m_height_field.heights.empty())
+            {
+                SP_LOG_ERROR("No height field data, call SetHeightField() first");
+                return;
+            }
+
+            // samples go straight into the height field, there is no triangle mesh to cook
+            m_px_height_field = create_height_field(m_height_field, GetEntity()->GetScale(), m_height_field_scale, m_height_field_center);
+            if (!m_px_height_field)
+            {
+                SP_LOG_ERROR("Failed to create height field");
+                return;
+            }
+
+            // one material per surface, cells without surfaces use the body's material
+            for (const PhysicsSurface& surface : m_height_field.surfaces)
+            {
+                m_materials_height_field.push_back(physics->createMaterial(surface.friction, surface.friction_rolling, surface.restitution));
+            }
+
+            CreateBodies();
+        }
         else
         {
             // mesh
@@ -2721,6 +2970,34 @@ namespace spartan
                     }
                     break;
                 }
+                case BodyType::HeightField:
+                {
+                    Vector3 scale = GetEntity()->GetScale();
+                    PxHeightFieldGeometry geometry(
+                        static_cast<PxHeightField*>(m_px_height_field),
+                        PxMeshGeometryFlags(),
+                        m_height_field_scale,
+                        m_height_field.spacing_x * scale.x,
+                        m_height_field.spacing_z * scale.z
+                    );
+
+                    if (m_materials_height_field.empty())
+                    {
+                        shape = physics->createShape(geometry, *material);
+                    }
+                    else
+                    {
+                        PxMaterial* const* materials = reinterpret_cast<PxMaterial* const*>(m_materials_height_field.data());
+                        shape = physics->createShape(geometry, materials, static_cast<PxU16>(m_materials_height_field.size()));
+                    }
+
+                    if (shape)
+                    {
+                        Vector3 origin = m_height_field.origin * scale;
+                        shape->setLocalPose(PxTransform(PxVec3(origin.x, origin.y + m_height_field_center, origin.z)));
+                    }
+                    break;
+                }
             }
 
             if (shape)
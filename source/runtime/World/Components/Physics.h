@@ -55,6 +55,7 @@ namespace spartan
         MeshConvex, // compound shape built from convex hulls of entity hierarchy meshes
         Controller,
         Vehicle,
+        HeightField, // regular grid of heights, set with SetHeightField()
         Max
     };
 
@@ -68,6 +69,28 @@ namespace spartan
         Count      = 4
     };
 
+    // friction and restitution of one of a height field's surfaces
+    struct PhysicsSurface
+    {
+        float friction         = 0.4f;
+        float friction_rolling = 0.4f;
+        float restitution      = 0.2f;
+    };
+
+    // a regular grid of heights, collides without cooking a triangle mesh
+    // sample (row, column) sits at origin + (row * spacing_x, height, column * spacing_z) in entity space
+    struct PhysicsHeightField
+    {
+        std::vector<float> heights;            // rows * columns, row major
+        std::vector<uint8_t> surfaces_indices; // two per cell (one per triangle), indices into surfaces, empty to use the body's material
+        std::vector<PhysicsSurface> surfaces;
+        uint32_t rows         = 0;
+        uint32_t columns      = 0;
+        float spacing_x       = 1.0f;
+        float spacing_z       = 1.0f;
+        math::Vector3 origin  = math::Vector3::Zero;
+    };
+
     class Physics : public Component
     {
     public:
@@ -81,6 +104,9 @@ namespace spartan
         void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void CopyFromPrototype(const Component* prototype) override;
+        void SaveRuntimeState(std::vector<uint8_t>& out) const override;
+        bool LoadRuntimeState(const uint8_t*& data, const uint8_t* data_end) override;
 
         static void RegisterForScripting(sol::state_view State);
         sol::reference AsLua(sol::state_view state) override;
@@ -130,6 +156,10 @@ namespace spartan
         void SetBodyType(BodyType type);
         BodyType DetectBodyType();
 
+        // height field, used by BodyType::HeightField
+        void SetHeightField(PhysicsHeightField&& height_field);
+        const PhysicsHeightField& GetHeightField() const { return m_height_field; }
+
         // ground
         bool IsGrounded() const;
         Entity* GetGroundEntity() const;
@@ -302,6 +332,11 @@ namespace spartan
         void* m_material                 = nullptr;
         void* m_mesh                     = nullptr;
         std::vector<void*> m_actors      = { nullptr };
+        std::vector<void*> m_materials_height_field;
+        void* m_px_height_field          = nullptr;
+        float m_height_field_scale       = 1.0f; // meters per quantized height step
+        float m_height_field_center      = 0.0f; // height the quantized samples are centered around
+        PhysicsHeightField m_height_field;
         std::vector<bool> m_actors_active; // tracks which actors are currently in the scene (for distance-based activation)
 
         // vehicle wheel entities and state
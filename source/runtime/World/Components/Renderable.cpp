@@ -29,6 +29,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_AccelerationStructure.h"
 #include "../../Resource/ResourceCache.h"
 #include "../../Rendering/Renderer.h"
+#include "../../Rendering/RenderWorld.h"
 #include "../../Rendering/Material.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
@@ -44,28 +45,34 @@ namespace spartan
 {
     Renderable::Renderable(Entity* entity) : Component(entity)
     {
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_material_default, bool);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_material, Material*);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_flags, uint32_t);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_mesh, Mesh*);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_bounding_box, BoundingBox);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_bounding_box_mesh, BoundingBox);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_sub_mesh_index, uint32_t);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_bounding_box_dirty, bool);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_instances, vector<Instance>);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_instance_buffer, shared_ptr<RHI_Buffer>);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_transform_previous, Matrix);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_max_distance_render, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_max_distance_shadow, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_distance_squared, float);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_is_visible, bool);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_lod_index, uint32_t);
-        SP_REGISTER_ATTRIBUTE_VALUE_VALUE(m_previous_lights, uint64_t);
+        SP_REGISTER_ATTRIBUTES(
+            SP_ATTRIBUTE_VALUE(m_material_default),
+            SP_ATTRIBUTE_VALUE(m_material),
+            SP_ATTRIBUTE_VALUE(m_flags),
+            SP_ATTRIBUTE_VALUE(m_mesh),
+            SP_ATTRIBUTE_VALUE(m_bounding_box),
+            SP_ATTRIBUTE_VALUE(m_bounding_box_mesh),
+            SP_ATTRIBUTE_VALUE(m_sub_mesh_index),
+            SP_ATTRIBUTE_VALUE(m_bounding_box_dirty),
+            SP_ATTRIBUTE_VALUE(m_instances),
+            SP_ATTRIBUTE_VALUE(m_instance_buffer),
+            SP_ATTRIBUTE_VALUE(m_max_distance_render),
+            SP_ATTRIBUTE_VALUE(m_max_distance_shadow),
+            SP_ATTRIBUTE_TRANSIENT(m_transform_previous),
+            SP_ATTRIBUTE_TRANSIENT(m_distance_squared),
+            SP_ATTRIBUTE_TRANSIENT(m_is_visible),
+            SP_ATTRIBUTE_TRANSIENT(m_lod_index),
+            SP_ATTRIBUTE_TRANSIENT(m_previous_lights)
+        );
+
+        RenderWorld::MarkDirty();
     }
 
     Renderable::~Renderable()
     {
         m_mesh = nullptr;
+
+        RenderWorld::MarkDirty();
     }
 
     void Renderable::Save(pugi::xml_node& node)
@@ -284,6 +291,28 @@ namespace spartan
         m_mesh->GetGeometry(m_sub_mesh_index, indices, vertices);
     }
 
+    float Renderable::Raycast(const Ray& ray, float max_distance, Vector3* out_normal) const
+    {
+        if (!m_mesh)
+            return numeric_limits<float>::infinity();
+
+        // an affine transform keeps the ray parameter, so the mesh space distance is also the world space one
+        const Matrix inverse = GetEntity()->GetMatrix().Inverted();
+        Ray ray_mesh;
+        ray_mesh.m_origin    = ray.GetStart() * inverse;
+        ray_mesh.m_direction = (ray.GetStart() + ray.GetDirection()) * inverse - ray_mesh.m_origin;
+
+        float distance = m_mesh->Raycast(m_sub_mesh_index, ray_mesh, max_distance, out_normal);
+        if (out_normal && distance != numeric_limits<float>::infinity())
+        {
+            // normals go through the inverse transpose
+            const Matrix inverse_transpose = inverse.Transposed();
+            *out_normal = (*out_normal * inverse_transpose - Vector3::Zero * inverse_transpose).Normalized();
+        }
+
+        return distance;
+    }
+
     void Renderable::SetMaterial(const shared_ptr<Material>& material)
     {
         SP_ASSERT(material != nullptr);
@@ -304,6 +333,10 @@ namespace spartan
             m_material->PrepareForGpu();
         }
 
+        // the entity now draws with a different material
+        World::MarkMaterialChanged(m_material);
+        World::MarkEntityChanged(GetEntity());
+
         // compute world dimensions (skip if no mesh is available yet, e.g. procedural meshes like roads)
         {
             vector<RHI_Vertex_PosTexNorTan> vertices;
@@ -444,17 +477,36 @@ namespace spartan
 
         // store instance data
         m_instances = instances;
+        UpdateInstanceBuffer();
+
+        m_bounding_box_dirty = true;
+        Tick(); // update bounding boxes, frustum and distance culling
+    }
+
+    void Renderable::UpdateInstanceBuffer()
+    {
+        if (m_instances.empty())
+        {
+            m_instance_buffer = nullptr;
+            return;
+        }
+
         m_instance_buffer = make_shared<RHI_Buffer>(
             RHI_Buffer_Type::Instance,
             sizeof(Instance),
-            static_cast<uint32_t>(instances.size()),
-            static_cast<const void*>(instances.data()),
+            static_cast<uint32_t>(m_instances.size()),
+            static_cast<const void*>(m_instances.data()),
             false,
             ("instance_buffer_" + GetObjectName()).c_str()
         );
+    }
 
+    void Renderable::OnAttributesChanged()
+    {
+        // the instances were written by value, the gpu copy and the world space box are derived from them
+        UpdateInstanceBuffer();
         m_bounding_box_dirty = true;
-        Tick(); // update bounding boxes, frustum and distance culling
+        RenderWorld::MarkDirty();
     }
 
     void Renderable::SetInstances(const vector<Matrix>& transforms)
@@ -526,6 +578,7 @@ namespace spartan
             }
             m_transform_previous = transform;
             m_bounding_box_dirty = false;
+            World::MarkRenderableBoundsChanged();
         }
     }
 
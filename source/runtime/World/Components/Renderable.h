@@ -50,6 +50,7 @@ namespace spartan
         // icomponent
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void OnAttributesChanged() override;
         void Tick() override;
 
         static void RegisterForScripting(sol::state_view State);
@@ -58,7 +59,9 @@ namespace spartan
         // mesh
         void SetMesh(Mesh* mesh, const uint32_t sub_mesh_index = 0);
         void SetMesh(const MeshType type);
+        Mesh* GetMesh() const { return m_mesh; }
         void GetGeometry(std::vector<uint32_t>* indices, std::vector<RHI_Vertex_PosTexNorTan>* vertices) const;
+        float Raycast(const math::Ray& ray, float max_distance, math::Vector3* out_normal = nullptr) const; // world space, returns the hit distance or infinity
         uint32_t GetLodCount() const;
         uint32_t GetLodIndex() const { return m_lod_index; }
         uint32_t GetIndexOffset(const uint32_t lod = 0) const;
@@ -113,6 +116,7 @@ namespace spartan
         void SetPreviousLights(uint64_t lights) { m_previous_lights = lights; }
 
     private:
+        void UpdateInstanceBuffer();
         void UpdateAabb();
         void UpdateFrustumAndDistanceCulling();
         void UpdateLodIndices();
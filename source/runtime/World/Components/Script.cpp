@@ -3,12 +3,93 @@
 #include "IO/pugixml.hpp"
 #include "World/Entity.h"
 #include "World/World.h"
+#include "Memory/Allocator.h"
+#include "Profiling/Profiler.h"
+#include "Commands/Console/ConsoleCommands.h"
 
 using namespace spartan;
+using namespace std;
+
+namespace
+{
+    TConsoleVar<float> cvar_script_budget ("script.budget_ms",  1.0f,   "per frame time a script can take before it gets flagged as over budget");
+    TConsoleVar<float> cvar_script_timeout("script.timeout_ms", 250.0f, "a single script call running longer than this is aborted and the script stops ticking");
+
+    const char* function_names[] =
+    {
+        "Initialize",
+        "Start",
+        "Stop",
+        "Remove",
+        "PreTick",
+        "Tick",
+        "Save",
+        "Load"
+    };
+    static_assert(size(function_names) == static_cast<size_t>(ScriptFunction::Max), "function_names out of sync with ScriptFunction enum");
+
+    // what a coroutine yielded, passed to it by the wait functions
+    enum class CoroutineWait : int
+    {
+        Seconds,
+        Frames
+    };
+
+    // every script, in creation order, the world ticks them in one loop
+    // destroyed scripts leave a null slot which is compacted before the next batch
+    vector<Script*> scripts;
+    bool scripts_dirty = false;
+    mutex scripts_mutex;
+
+    // the script whose lua code is running, coroutines started from lua attach to it
+    Script* current_script = nullptr;
+
+    // runaway detection, the hook runs every few thousand instructions and aborts the call past its deadline
+    const int hook_instruction_count = 10'000;
+    chrono::steady_clock::time_point call_deadline;
+    bool call_active    = false;
+    bool call_timed_out = false;
+
+    void budget_hook(lua_State* state, lua_Debug*)
+    {
+        if (call_active && chrono::steady_clock::now() > call_deadline)
+        {
+            call_active    = false;
+            call_timed_out = true;
+            luaL_error(state, "exceeded the %f ms timeout", static_cast<lua_Number>(cvar_script_timeout.GetValue()));
+        }
+    }
+
+    void call_begin(Script* script)
+    {
+        current_script = script;
+        call_deadline  = chrono::steady_clock::now() + chrono::microseconds(static_cast<int64_t>(cvar_script_timeout.GetValue() * 1000.0f));
+        call_active    = true;
+        call_timed_out = false;
+    }
+
+    // returns false if the call had to be aborted
+    bool call_end()
+    {
+        current_script = nullptr;
+        call_active    = false;
+        return !call_timed_out;
+    }
+}
 
 Script::Script(Entity* Entity)
     :Component(Entity)
 {
+    lock_guard<mutex> lock(scripts_mutex);
+    m_registry_index = scripts.size();
+    scripts.push_back(this);
+}
+
+Script::~Script()
+{
+    lock_guard<mutex> lock(scripts_mutex);
+    scripts[m_registry_index] = nullptr;
+    scripts_dirty             = true;
 }
 
 sol::reference Script::AsLua(sol::state_view state)
@@ -18,6 +99,8 @@ sol::reference Script::AsLua(sol::state_view state)
 
 void Script::LoadScriptFile(std::string_view path)
 {
+    SP_MEMORY_TAG(MemoryTag::Scripting);
+
     if (!FileSystem::Exists(std::string(path.data(), path.length())))
     {
         return;
@@ -41,85 +124,229 @@ void Script::LoadScriptFile(std::string_view path)
 
     script = ReturnValue;
 
+    // look the lifecycle functions up once, instead of by name on every call
+    for (size_t i = 0; i < m_functions.size(); i++)
+    {
+        m_functions[i] = script[function_names[i]];
+    }
+
+    m_coroutines.clear();
+    m_over_budget = false;
+    m_faulted     = false;
 }
 
 void Script::Initialize()
 {
-    if (script.valid())
-    {
-        sol::protected_function TickFunction = script["Initialize"];
-        if (TickFunction.valid())
-        {
-            (void)TickFunction(script, GetEntity());
-        }
-    }
+    Call(ScriptFunction::Initialize);
 }
 
 void Script::Start()
 {
-    if (script.valid())
+    Call(ScriptFunction::Start);
+}
+
+void Script::Stop()
+{
+    Call(ScriptFunction::Stop);
+
+    // coroutines belong to the simulation that started them
+    m_coroutines.clear();
+}
+
+void Script::Remove()
+{
+    Call(ScriptFunction::Remove);
+}
+
+void Script::PreTickAll()
+{
+    SP_PROFILE_CPU();
+    SP_MEMORY_TAG(MemoryTag::Scripting);
+
+    // drop the slots of destroyed scripts
     {
-        sol::protected_function TickFunction = script["Stop"];
-        if (TickFunction.valid())
+        lock_guard<mutex> lock(scripts_mutex);
+        if (scripts_dirty)
         {
-            (void)TickFunction(script, GetEntity());
+            scripts.erase(remove(scripts.begin(), scripts.end(), nullptr), scripts.end());
+            for (size_t i = 0; i < scripts.size(); i++)
+            {
+                scripts[i]->m_registry_index = i;
+            }
+            scripts_dirty = false;
         }
     }
-}
 
-void Script::Stop()
-{
-    if (script.valid())
+    // scripts created during the loop are picked up next frame, the ones destroyed leave a null slot
+    for (size_t i = 0, count = scripts.size(); i < count; i++)
     {
-        sol::protected_function TickFunction = script["Stop"];
-        if (TickFunction.valid())
+        Script* script = scripts[i];
+        if (!script || script->m_faulted || !script->GetEntity()->GetActive())
+            continue;
+
+        Stopwatch stopwatch;
+        script->Call(ScriptFunction::PreTick);
+        if (scripts[i] == script)
         {
-            (void)TickFunction(script, GetEntity());
+            script->m_time_ms = stopwatch.GetElapsedTimeMs();
         }
     }
 }
 
-void Script::Remove()
+void Script::TickAll()
 {
-    if (script.valid())
+    SP_PROFILE_CPU();
+    SP_MEMORY_TAG(MemoryTag::Scripting);
+
+    const float budget_ms = cvar_script_budget.GetValue();
+    for (size_t i = 0, count = scripts.size(); i < count; i++)
     {
-        sol::protected_function TickFunction = script["Remove"];
-        if (TickFunction.valid())
+        Script* script = scripts[i];
+        if (!script || script->m_faulted || !script->GetEntity()->GetActive())
+            continue;
+
+        Stopwatch stopwatch;
+        script->Call(ScriptFunction::Tick);
+        if (scripts[i] == script)
         {
-            (void)TickFunction(script, GetEntity());
+            script->ResumeCoroutines();
+        }
+        if (scripts[i] != script)
+            continue;
+
+        script->m_time_ms += stopwatch.GetElapsedTimeMs();
+        if (!script->m_over_budget && script->m_time_ms > budget_ms)
+        {
+            script->m_over_budget = true;
+            SP_LOG_WARNING("[LUA SCRIPT] - %s took %.2f ms in a frame, over the %.2f ms budget, consider spreading its work over frames with a coroutine",
+                script->file_path.c_str(), script->m_time_ms, budget_ms);
         }
     }
 }
 
-void Script::PreTick()
+bool Script::Call(ScriptFunction function)
 {
-    if (script.valid())
+    sol::protected_function& Function = m_functions[static_cast<size_t>(function)];
+    if (!script.valid() || !Function.valid())
+        return true;
+
+    call_begin(this);
+    sol::protected_function_result Result = Function(script, GetEntity());
+    bool in_time = call_end();
+
+    if (!Result.valid())
     {
-        sol::protected_function TickFunction = script["PreTick"];
-        if (TickFunction.valid())
-        {
-            (void)TickFunction(script, GetEntity());
-        }
+        sol::error Error = Result;
+        SP_LOG_ERROR("[LUA SCRIPT ERROR] - %s", Error.what())
+    }
+
+    if (!in_time)
+    {
+        m_faulted = true;
+        SP_LOG_ERROR("[LUA SCRIPT ERROR] - %s is a runaway script and won't tick until it's reloaded", file_path.c_str());
     }
+
+    return Result.valid();
 }
 
-void Script::Tick()
+void Script::ResumeCoroutines()
 {
-    if (script.valid())
+    const double time_sec = Timer::GetTimeSec();
+
+    // indexed, since a coroutine can start more coroutines
+    for (size_t i = 0; i < m_coroutines.size() && !m_faulted;)
     {
-        sol::protected_function TickFunction = script["Tick"];
-        if (TickFunction.valid())
+        if (m_coroutines[i].wake_frames > 0)
+        {
+            m_coroutines[i].wake_frames--;
+            i++;
+            continue;
+        }
+
+        if (time_sec < m_coroutines[i].wake_time_sec)
+        {
+            i++;
+            continue;
+        }
+
+        sol::coroutine Coroutine = m_coroutines[i].coroutine;
+        call_begin(this);
+        sol::protected_function_result Result = Coroutine();
+        bool in_time = call_end();
+
+        if (!in_time)
+        {
+            m_faulted = true;
+            SP_LOG_ERROR("[LUA SCRIPT ERROR] - %s has a runaway coroutine and won't tick until it's reloaded", file_path.c_str());
+        }
+
+        if (!Result.valid())
+        {
+            sol::error Error = Result;
+            SP_LOG_ERROR("[LUA SCRIPT ERROR] - %s", Error.what())
+            m_coroutines.erase(m_coroutines.begin() + i);
+            continue;
+        }
+
+        if (Result.status() != sol::call_status::yielded)
         {
-            sol::protected_function_result Result = TickFunction(script, GetEntity());
-            if (!Result.valid())
+            m_coroutines.erase(m_coroutines.begin() + i);
+            continue;
+        }
+
+        // a bare coroutine.yield() waits a frame, the wait functions say for how long
+        m_coroutines[i].wake_frames   = 0;
+        m_coroutines[i].wake_time_sec = 0.0;
+        if (Result.return_count() >= 2)
+        {
+            CoroutineWait wait = static_cast<CoroutineWait>(Result.get<int>(0));
+            double amount      = Result.get<double>(1);
+            if (wait == CoroutineWait::Seconds)
+            {
+                m_coroutines[i].wake_time_sec = time_sec + amount;
+            }
+            else if (wait == CoroutineWait::Frames && amount > 1.0)
             {
-                sol::error Error = Result;
-                SP_LOG_ERROR("[LUA SCRIPT ERROR] - %s", Error.what())
+                m_coroutines[i].wake_frames = static_cast<uint32_t>(amount) - 1;
             }
         }
+        i++;
     }
 }
 
+void Script::RegisterForScripting(sol::state_view state)
+{
+    // all lua threads, coroutines included, inherit the hook from the main state
+    lua_sethook(state.lua_state(), budget_hook, LUA_MASKCOUNT, hook_instruction_count);
+
+    sol::table Coroutines = state.create_named_table("Coroutine");
+
+    // runs the function as a coroutine of the calling script, resumed after the script's tick
+    Coroutines.set_function("Start", [](sol::this_state this_state, sol::function function)
+    {
+        if (!current_script)
+        {
+            SP_LOG_ERROR("[LUA SCRIPT ERROR] - Coroutine.Start can only be called from a script");
+            return;
+        }
+
+        Coroutine coroutine;
+        coroutine.thread    = sol::thread::create(this_state);
+        coroutine.coroutine = sol::coroutine(coroutine.thread.thread_state(), function);
+        current_script->m_coroutines.push_back(move(coroutine));
+    });
+
+    Coroutines.set_function("WaitSeconds", sol::yielding([](double seconds)
+    {
+        return make_tuple(static_cast<int>(CoroutineWait::Seconds), seconds);
+    }));
+
+    Coroutines.set_function("WaitFrames", sol::yielding([](uint32_t frames)
+    {
+        return make_tuple(static_cast<int>(CoroutineWait::Frames), static_cast<double>(frames));
+    }));
+}
+
 void Script::Save(pugi::xml_node& node)
 {
     node.append_attribute("file_path") = file_path.c_str();
@@ -147,16 +374,7 @@ void Script::Save(pugi::xml_node& node)
             }
         }
 
-        sol::protected_function TickFunction = script["Save"];
-        if (TickFunction.valid())
-        {
-            sol::protected_function_result Result = TickFunction(script, GetEntity());
-            if (!Result.valid())
-            {
-                sol::error Error = Result;
-                SP_LOG_ERROR("[LUA SCRIPT ERROR] - %s", Error.what())
-            }
-        }
+        Call(ScriptFunction::Save);
     }
 }
 
@@ -194,15 +412,6 @@ void Script::Load(pugi::xml_node& node)
             }
         }
 
-        sol::protected_function TickFunction = script["Load"];
-        if (TickFunction.valid())
-        {
-            sol::protected_function_result Result = TickFunction(script, GetEntity());
-            if (!Result.valid())
-            {
-                sol::error Error = Result;
-                SP_LOG_ERROR("[LUA SCRIPT ERROR] - %s", Error.what())
-            }
-        }
+        Call(ScriptFunction::Load);
     }
 }
@@ -1,15 +1,32 @@
 ﻿#pragma once
 
+#include <array>
+#include <vector>
 #include "Component.h"
 #include "sol/sol.hpp"
 
 namespace spartan
 {
+    // lifecycle functions a script table can define, looked up once when the script is loaded
+    enum class ScriptFunction : uint8_t
+    {
+        Initialize,
+        Start,
+        Stop,
+        Remove,
+        PreTick,
+        Tick,
+        Save,
+        Load,
+        Max
+    };
+
     class Script : public Component
     {
     public:
 
         Script(Entity* Entity);
+        ~Script();
 
         sol::reference AsLua(sol::state_view state) override;
 
@@ -18,14 +35,39 @@ namespace spartan
         void Start() override;
         void Stop() override;
         void Remove() override;
-        void PreTick() override;
-        void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
 
+        // scripts are not ticked by their entity, the world ticks all of them in one batch
+        static void PreTickAll();
+        static void TickAll();
+        static void RegisterForScripting(sol::state_view state);
+
+        // profiling
+        float GetTimeMs() const   { return m_time_ms; }
+        bool IsOverBudget() const { return m_over_budget; }
+        bool IsFaulted() const    { return m_faulted; }
 
         std::string file_path;
         sol::table  script;
 
+    private:
+        struct Coroutine
+        {
+            sol::thread thread;
+            sol::coroutine coroutine;
+            double wake_time_sec  = 0.0; // resumed once the engine time passes this
+            uint32_t wake_frames  = 0;   // or once this many frames have been skipped
+        };
+
+        bool Call(ScriptFunction function);
+        void ResumeCoroutines();
+
+        std::array<sol::protected_function, static_cast<size_t>(ScriptFunction::Max)> m_functions;
+        std::vector<Coroutine> m_coroutines;
+        size_t m_registry_index = 0;
+        float m_time_ms         = 0.0f;
+        bool m_over_budget      = false;
+        bool m_faulted          = false; // exceeded the timeout, not ticked until reloaded
     };
 }
@@ -46,6 +46,9 @@ namespace spartan
     static const string prefix_control_point = "spline_point_";
     static const string prefix_instance      = "spline_instance_";
 
+    // arc length table resolution, lookups interpolate linearly between samples
+    static const uint32_t arc_samples_per_span = 32;
+
     Spline::Spline(Entity* entity) : Component(entity)
     {
 
@@ -63,6 +66,8 @@ namespace spartan
 
     void Spline::Tick()
     {
+        ValidateCache();
+
         // if the spline had a mesh when saved, regenerate it now that child entities are loaded
         if (m_needs_road_regeneration)
         {
@@ -74,43 +79,22 @@ namespace spartan
         if (Engine::IsFlagSet(EngineMode::Playing))
             return;
 
-        vector<Vector3> points = GetControlPoints();
-        if (points.size() < 2)
+        const Cache& cache = GetCache();
+        if (cache.points.size() < 2)
             return;
 
         const Color color_curve = Color(0.3f, 0.85f, 0.75f, 1.0f);
         const Color color_point = Color(1.0f, 0.8f, 0.3f, 1.0f);
 
         // draw the interpolated curve
-        uint32_t span_count = m_closed_loop ? static_cast<uint32_t>(points.size()) : static_cast<uint32_t>(points.size()) - 1;
-        for (uint32_t span = 0; span < span_count; span++)
+        for (size_t i = 1; i < cache.samples.size(); i++)
         {
-            Vector3 prev_point;
-            for (uint32_t seg = 0; seg <= m_resolution; seg++)
-            {
-                float local_t = static_cast<float>(seg) / static_cast<float>(m_resolution);
-
-                // determine the four control points for this span
-                int32_t point_count = static_cast<int32_t>(points.size());
-                int32_t i1 = static_cast<int32_t>(span);
-                int32_t i2 = m_closed_loop ? (i1 + 1) % point_count : min(i1 + 1, point_count - 1);
-                int32_t i0 = m_closed_loop ? (i1 - 1 + point_count) % point_count : max(i1 - 1, 0);
-                int32_t i3 = m_closed_loop ? (i2 + 1) % point_count : min(i2 + 1, point_count - 1);
-
-                Vector3 current_point = CatmullRom(points[i0], points[i1], points[i2], points[i3], local_t);
-
-                if (seg > 0)
-                {
-                    Renderer::DrawLine(prev_point, current_point, color_curve, color_curve);
-                }
-
-                prev_point = current_point;
-            }
+            Renderer::DrawLine(cache.samples[i - 1], cache.samples[i], color_curve, color_curve);
         }
 
         // draw markers at each control point
         float marker_size = 0.15f;
-        for (const Vector3& point : points)
+        for (const Vector3& point : cache.points)
         {
             // draw a small cross at each control point
             Renderer::DrawLine(point - Vector3(marker_size, 0, 0), point + Vector3(marker_size, 0, 0), color_point, color_point);
@@ -175,56 +159,99 @@ namespace spartan
 
     Vector3 Spline::GetPoint(float t) const
     {
-        return EvaluatePoint(GetControlPoints(), t);
+        return EvaluatePoint(GetCache().points, t);
     }
 
     Vector3 Spline::GetTangent(float t) const
     {
-        return EvaluateTangent(GetControlPoints(), t);
+        return EvaluateTangent(GetCache().points, t);
     }
 
-    float Spline::GetLength(uint32_t samples_per_span) const
+    float Spline::GetLength() const
     {
-        vector<Vector3> points = GetControlPoints();
-        if (points.size() < 2)
-            return 0.0f;
+        const Cache& cache = GetCache();
+        return cache.distances.empty() ? 0.0f : cache.distances.back();
+    }
 
-        uint32_t span_count    = m_closed_loop ? static_cast<uint32_t>(points.size()) : static_cast<uint32_t>(points.size()) - 1;
-        uint32_t total_samples = span_count * samples_per_span;
-        float length           = 0.0f;
-        Vector3 prev_point     = EvaluatePoint(points, 0.0f);
+    float Spline::GetTAtDistance(float distance) const
+    {
+        const vector<float>& distances = GetCache().distances;
+        if (distances.size() < 2 || distances.back() <= 0.0f)
+            return 0.0f;
 
-        for (uint32_t i = 1; i <= total_samples; i++)
+        const float length = distances.back();
+        if (m_closed_loop)
+        {
+            distance = fmodf(distance, length);
+            distance = distance < 0.0f ? distance + length : distance;
+        }
+        else
         {
-            float t            = static_cast<float>(i) / static_cast<float>(total_samples);
-            Vector3 curr_point = EvaluatePoint(points, t);
-            length            += prev_point.Distance(curr_point);
-            prev_point         = curr_point;
+            distance = clamp(distance, 0.0f, length);
         }
 
-        return length;
+        // binary search for the sample pair that brackets the distance
+        size_t index = static_cast<size_t>(upper_bound(distances.begin(), distances.end(), distance) - distances.begin());
+        index        = clamp<size_t>(index, 1, distances.size() - 1);
+
+        float distance_start = distances[index - 1];
+        float distance_end   = distances[index];
+        float fraction       = distance_end > distance_start ? (distance - distance_start) / (distance_end - distance_start) : 0.0f;
+
+        return (static_cast<float>(index - 1) + fraction) / static_cast<float>(distances.size() - 1);
     }
 
-    uint32_t Spline::GetControlPointCount() const
+    float Spline::GetDistanceAtT(float t) const
     {
-        if (!m_entity_ptr)
-            return 0;
+        const vector<float>& distances = GetCache().distances;
+        if (distances.size() < 2)
+            return 0.0f;
 
-        // count only children that are control points (not instances)
-        uint32_t count       = 0;
-        uint32_t child_count = m_entity_ptr->GetChildrenCount();
-        for (uint32_t i = 0; i < child_count; i++)
+        float position = clamp(t, 0.0f, 1.0f) * static_cast<float>(distances.size() - 1);
+        size_t index   = min(static_cast<size_t>(position), distances.size() - 2);
+        return lerp(distances[index], distances[index + 1], position - static_cast<float>(index));
+    }
+
+    Vector3 Spline::GetPointAtDistance(float distance) const
+    {
+        return EvaluatePoint(GetCache().points, GetTAtDistance(distance));
+    }
+
+    SplineFrame Spline::GetFrameAtDistance(float distance) const
+    {
+        return EvaluateFrame(GetCache().points, GetTAtDistance(distance));
+    }
+
+    float Spline::GetClosestDistance(const Vector3& position) const
+    {
+        const Cache& cache = GetCache();
+        if (cache.samples.size() < 2)
+            return 0.0f;
+
+        // project onto each segment of the sampled curve, the table is dense enough for the chords to follow the curve closely
+        float distance_squared_min = numeric_limits<float>::max();
+        float distance_along       = 0.0f;
+        for (size_t i = 1; i < cache.samples.size(); i++)
         {
-            if (Entity* child = m_entity_ptr->GetChildByIndex(i))
+            const Vector3& start   = cache.samples[i - 1];
+            Vector3 segment        = cache.samples[i] - start;
+            float segment_length_2 = segment.LengthSquared();
+            float fraction         = segment_length_2 > 0.0f ? clamp(Vector3::Dot(position - start, segment) / segment_length_2, 0.0f, 1.0f) : 0.0f;
+            float distance_squared = Vector3::DistanceSquared(start + segment * fraction, position);
+
+            if (distance_squared < distance_squared_min)
             {
-                if (child->GetObjectName().find(prefix_control_point) == 0)
-                {
-                    count++;
-                }
+                distance_squared_min = distance_squared;
+                distance_along       = lerp(cache.distances[i - 1], cache.distances[i], fraction);
             }
         }
 
-        return count;
+        return distance_along;
+    }
+
+    uint32_t Spline::GetControlPointCount() const
+    {
+        return static_cast<uint32_t>(GetCache().points.size());
     }
 
     void Spline::AddControlPoint(const Vector3& local_position)
@@ -239,6 +266,9 @@ namespace spartan
         point->SetObjectName(prefix_control_point + to_string(index));
         point->SetParent(m_entity_ptr);
         point->SetPositionLocal(local_position);
+
+        // callers may query right away, before the next tick validates
+        m_cache.valid = false;
     }
 
     void Spline::RemoveLastControlPoint()
@@ -264,14 +294,14 @@ namespace spartan
         if (last_point)
         {
             World::RemoveEntity(last_point);
+            m_cache.valid = false;
         }
     }
 
     void Spline::GenerateRoadMesh()
     {
         // need at least 2 control points
-        vector<Vector3> spline_points = GetControlPointsLocal();
-        if (spline_points.size() < 2)
+        if (GetCache().points.size() < 2)
         {
             SP_LOG_WARNING("need at least 2 control points to generate a mesh");
             return;
@@ -295,7 +325,7 @@ namespace spartan
         // resolve the profile and extrude it along the spline
         vector<Vector2> profile_points = GetProfilePoints();
         bool close_profile             = IsProfileClosed();
-        GenerateMesh(spline_points, profile_points, close_profile);
+        GenerateMesh(profile_points, close_profile);
     }
 
     void Spline::ClearRoadMesh()
@@ -321,8 +351,8 @@ namespace spartan
         // clear any existing instances first
         ClearInstances();
 
-        vector<Vector3> points = GetControlPointsLocal();
-        if (points.size() < 2)
+        const Cache& cache = GetCache();
+        if (cache.points.size() < 2)
         {
             SP_LOG_WARNING("need at least 2 control points to spawn instances");
             return;
@@ -335,51 +365,37 @@ namespace spartan
             return;
         }
 
-        // walk along the spline at arc-length intervals and place instances
-        uint32_t instance_count = static_cast<uint32_t>(spline_length / m_instance_spacing);
-        uint32_t total_samples  = static_cast<uint32_t>(points.size()) * m_resolution * 4; // dense sampling for arc-length
-        float step              = 1.0f / static_cast<float>(total_samples);
-
-        float accumulated_distance  = 0.0f;
-        float next_spawn_distance   = 0.0f;
-        Vector3 prev_position       = EvaluatePoint(points, 0.0f);
-        uint32_t spawned            = 0;
-
-        for (uint32_t i = 0; i <= total_samples; i++)
+        // walk along the spline at arc-length intervals, a closed loop's end is its start
+        // everything is looked up before spawning, since new children invalidate the cache
+        uint32_t instance_count = static_cast<uint32_t>(spline_length / m_instance_spacing) + (m_closed_loop ? 0 : 1);
+        vector<float> t_values(instance_count);
+        for (uint32_t i = 0; i < instance_count; i++)
         {
-            float t         = static_cast<float>(i) * step;
-            Vector3 position = EvaluatePoint(points, t);
+            t_values[i] = GetTAtDistance(static_cast<float>(i) * m_instance_spacing);
+        }
+        const vector<Vector3> points = cache.points_local;
 
-            if (i > 0)
+        uint32_t spawned = 0;
+        for (float t : t_values)
+        {
+            // spawn an instance entity as a child of the spline
+            Entity* instance = World::CreateEntity();
+            instance->SetObjectName(prefix_instance + to_string(spawned));
+            instance->SetParent(m_entity_ptr);
+            instance->SetPositionLocal(EvaluatePoint(points, t));
+
+            // align to spline tangent if enabled
+            if (m_align_instances_to_spline)
             {
-                accumulated_distance += position.Distance(prev_position);
+                instance->SetRotationLocal(Quaternion::FromLookRotation(EvaluateTangent(points, t), Vector3::Up));
             }
-            prev_position = position;
-
-            if (accumulated_distance >= next_spawn_distance)
-            {
-                // spawn an instance entity as a child of the spline
-                Entity* instance = World::CreateEntity();
-                instance->SetObjectName(prefix_instance + to_string(spawned));
-                instance->SetParent(m_entity_ptr);
-                instance->SetPositionLocal(position);
-
-                // align to spline tangent if enabled
-                if (m_align_instances_to_spline)
-                {
-                    Vector3 tangent = EvaluateTangent(points, t);
-                    tangent.Normalize();
-                    instance->SetRotationLocal(Quaternion::FromLookRotation(tangent, Vector3::Up));
-                }
 
-                // add a renderable with a default cylinder mesh (useful for posts, pillars, etc.)
-                Renderable* renderable = instance->AddComponent<Renderable>();
-                renderable->SetMesh(MeshType::Cylinder);
-                renderable->SetDefaultMaterial();
+            // add a renderable with a default cylinder mesh (useful for posts, pillars, etc.)
+            Renderable* renderable = instance->AddComponent<Renderable>();
+            renderable->SetMesh(MeshType::Cylinder);
+            renderable->SetDefaultMaterial();
 
-                spawned++;
-                next_spawn_distance += m_instance_spacing;
-            }
+            spawned++;
         }
 
         SP_LOG_INFO("spawned %u instances along spline (%.1f m, spacing %.1f m)", spawned, spline_length, m_instance_spacing);
@@ -410,54 +426,73 @@ namespace spartan
         }
     }
 
-    vector<Vector3> Spline::GetControlPoints() const
+    const Spline::Cache& Spline::GetCache() const
     {
-        vector<Vector3> points;
+        if (m_cache.valid && m_cache.closed_loop == m_closed_loop)
+            return m_cache;
+
+        m_cache.child_count = 0;
+        m_cache.control_point_indices.clear();
+        m_cache.control_points.clear();
+        m_cache.control_point_revisions.clear();
+        m_cache.points.clear();
+        m_cache.points_local.clear();
+        m_cache.samples.clear();
+        m_cache.distances.clear();
+        m_cache.closed_loop = m_closed_loop;
+        m_cache.valid       = true;
 
         if (!m_entity_ptr)
-            return points;
+            return m_cache;
 
-        uint32_t child_count = m_entity_ptr->GetChildrenCount();
-        points.reserve(child_count);
-
-        for (uint32_t i = 0; i < child_count; i++)
+        // only control point children shape the curve, instances are skipped
+        const vector<Entity*>& children = m_entity_ptr->GetChildren();
+        m_cache.child_count             = children.size();
+        for (uint32_t i = 0; i < static_cast<uint32_t>(children.size()); i++)
         {
-            if (Entity* child = m_entity_ptr->GetChildByIndex(i))
+            Entity* child = children[i];
+            if (child->GetObjectName().find(prefix_control_point) == 0)
             {
-                // only include control point children, not instances
-                if (child->GetObjectName().find(prefix_control_point) == 0)
-                {
-                    points.push_back(child->GetPosition());
-                }
+                m_cache.control_point_indices.push_back(i);
+                m_cache.control_points.push_back(child);
+                m_cache.control_point_revisions.push_back(child->GetTransformRevision());
+                m_cache.points.push_back(child->GetPosition());
+                m_cache.points_local.push_back(child->GetPositionLocal());
             }
         }
 
-        return points;
-    }
+        if (m_cache.points.size() < 2)
+            return m_cache;
 
-    vector<Vector3> Spline::GetControlPointsLocal() const
-    {
-        vector<Vector3> points;
+        // sample at uniform steps in t and accumulate the chord lengths
+        uint32_t span_count   = m_closed_loop ? static_cast<uint32_t>(m_cache.points.size()) : static_cast<uint32_t>(m_cache.points.size()) - 1;
+        uint32_t sample_count = span_count * arc_samples_per_span;
+        m_cache.samples.resize(sample_count + 1);
+        m_cache.distances.resize(sample_count + 1);
+        for (uint32_t i = 0; i <= sample_count; i++)
+        {
+            m_cache.samples[i]   = EvaluatePoint(m_cache.points, static_cast<float>(i) / static_cast<float>(sample_count));
+            m_cache.distances[i] = i == 0 ? 0.0f : m_cache.distances[i - 1] + m_cache.samples[i].Distance(m_cache.samples[i - 1]);
+        }
 
-        if (!m_entity_ptr)
-            return points;
+        return m_cache;
+    }
 
-        uint32_t child_count = m_entity_ptr->GetChildrenCount();
-        points.reserve(child_count);
+    void Spline::ValidateCache()
+    {
+        if (!m_cache.valid || !m_entity_ptr)
+            return;
 
-        for (uint32_t i = 0; i < child_count; i++)
+        // the child count catches additions and removals, the control points are checked by pointer and revision
+        const vector<Entity*>& children = m_entity_ptr->GetChildren();
+        bool valid = children.size() == m_cache.child_count;
+        for (size_t i = 0; valid && i < m_cache.control_points.size(); i++)
         {
-            if (Entity* child = m_entity_ptr->GetChildByIndex(i))
-            {
-                // only include control point children, not instances
-                if (child->GetObjectName().find(prefix_control_point) == 0)
-                {
-                    points.push_back(child->GetPositionLocal());
-                }
-            }
+            Entity* child = children[m_cache.control_point_indices[i]];
+            valid         = child == m_cache.control_points[i] && child->GetTransformRevision() == m_cache.control_point_revisions[i];
         }
 
-        return points;
+        m_cache.valid = valid;
     }
 
     vector<Vector2> Spline::GetProfilePoints() const
@@ -527,9 +562,12 @@ namespace spartan
         return m_profile == SplineProfile::Tube;
     }
 
-    void Spline::GenerateMesh(const vector<Vector3>& spline_points, const vector<Vector2>& profile_points, bool close_profile)
+    void Spline::GenerateMesh(const vector<Vector2>& profile_points, bool close_profile)
     {
-        if (spline_points.size() < 2 || profile_points.size() < 2)
+        // copied, the cache is rebuilt if the hierarchy changes while the mesh is being generated
+        const vector<Vector3> spline_points = GetCache().points_local;
+        float spline_length                 = GetLength();
+        if (spline_points.size() < 2 || profile_points.size() < 2 || spline_length <= 0.0f)
             return;
 
         uint32_t span_count    = m_closed_loop ? static_cast<uint32_t>(spline_points.size()) : static_cast<uint32_t>(spline_points.size()) - 1;
@@ -555,44 +593,20 @@ namespace spartan
         if (profile_perimeter < 0.001f)
             profile_perimeter = 1.0f;
 
-        // accumulate distance along the spline for the v coordinate
-        float accumulated_distance = 0.0f;
-        Vector3 prev_position;
-
         for (uint32_t i = 0; i <= total_samples; i++)
         {
-            float t = static_cast<float>(i) / static_cast<float>(total_samples);
-
-            // evaluate position and tangent on the spline
-            Vector3 position = EvaluatePoint(spline_points, t);
-            Vector3 tangent  = EvaluateTangent(spline_points, t);
-            tangent.Normalize();
+            // samples are spaced evenly by distance, so the cross-sections don't bunch up where control points are dense
+            float distance = spline_length * static_cast<float>(i) / static_cast<float>(total_samples);
+            float t        = (i == total_samples) ? 1.0f : GetTAtDistance(distance);
 
-            // build a coordinate frame: forward (tangent), right, up
-            Vector3 up = Vector3::Up;
-
-            // handle near-vertical tangents: fall back to world forward
-            if (abs(tangent.Dot(Vector3::Up)) > 0.99f)
-            {
-                up = Vector3::Forward;
-            }
-
-            Vector3 right = tangent.Cross(up);
-            right.Normalize();
-
-            // recompute up to be perpendicular to both
-            up = right.Cross(tangent);
-            up.Normalize();
-
-            // accumulate distance for the v coordinate
-            if (i > 0)
-            {
-                accumulated_distance += position.Distance(prev_position);
-            }
-            prev_position = position;
+            SplineFrame frame = EvaluateFrame(spline_points, t);
+            Vector3 position  = frame.position;
+            Vector3 tangent   = frame.tangent;
+            Vector3 right     = frame.right;
+            Vector3 up        = frame.up;
 
             // v tiles along the spline proportionally to the road width
-            float v = accumulated_distance / m_road_width;
+            float v = distance / m_road_width;
 
             // emit one vertex per profile point at this cross-section
             float accumulated_profile_distance = 0.0f;
@@ -720,7 +734,7 @@ namespace spartan
 
         SP_LOG_INFO("generated spline mesh: %u vertices, %u indices, %.1f m long, %.1f m wide",
             static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(indices.size()),
-            accumulated_distance, m_road_width);
+            spline_length, m_road_width);
     }
 
     Vector3 Spline::CatmullRom(const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3, float t)
@@ -789,6 +803,26 @@ namespace spartan
         return tangent;
     }
 
+    SplineFrame Spline::EvaluateFrame(const vector<Vector3>& points, float t) const
+    {
+        SplineFrame frame;
+        frame.position = EvaluatePoint(points, t);
+        frame.tangent  = EvaluateTangent(points, t);
+
+        // handle near-vertical tangents: fall back to world forward
+        Vector3 up = abs(frame.tangent.Dot(Vector3::Up)) > 0.99f ? Vector3::Forward : Vector3::Up;
+
+        // build a coordinate frame: forward (tangent), right, up
+        frame.right = frame.tangent.Cross(up);
+        frame.right.Normalize();
+
+        // recompute up to be perpendicular to both
+        frame.up = frame.right.Cross(frame.tangent);
+        frame.up.Normalize();
+
+        return frame;
+    }
+
     void Spline::MapToSpan(float t, const vector<Vector3>& points, uint32_t& span_index, float& local_t) const
     {
         uint32_t span_count = m_closed_loop ? static_cast<uint32_t>(points.size()) : static_cast<uint32_t>(points.size()) - 1;
@@ -42,6 +42,15 @@ namespace spartan
         Max
     };
 
+    // a point on the spline and an orthonormal frame around it, what road cross-sections and followers are oriented by
+    struct SplineFrame
+    {
+        math::Vector3 position;
+        math::Vector3 tangent;
+        math::Vector3 right;
+        math::Vector3 up;
+    };
+
     class Spline : public Component
     {
     public:
@@ -55,10 +64,17 @@ namespace spartan
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
 
-        // evaluation - t is normalized [0, 1] across the entire spline
+        // evaluation - t is normalized [0, 1] across the entire spline, equal steps in t are not equal distances
         math::Vector3 GetPoint(float t) const;
         math::Vector3 GetTangent(float t) const;
-        float GetLength(uint32_t samples_per_span = 10) const;
+
+        // arc length - distances are in meters along the spline, looked up in a table that is only rebuilt when control points change
+        float GetLength() const;
+        float GetTAtDistance(float distance) const; // wraps for closed loops, clamps otherwise
+        float GetDistanceAtT(float t) const;
+        math::Vector3 GetPointAtDistance(float distance) const;
+        SplineFrame GetFrameAtDistance(float distance) const;
+        float GetClosestDistance(const math::Vector3& position) const; // distance along the spline to the point closest to position
 
         // control point management (children of the owning entity)
         uint32_t GetControlPointCount() const;
@@ -101,11 +117,26 @@ namespace spartan
         void SetInstanceMeshPath(const std::string& path)       { m_instance_mesh_path = path; }
 
     private:
-        // gather control point world positions from child entities
-        std::vector<math::Vector3> GetControlPoints() const;
-
-        // gather control point positions local to the spline entity
-        std::vector<math::Vector3> GetControlPointsLocal() const;
+        // control points and the arc length table, world space unless noted
+        struct Cache
+        {
+            size_t child_count = 0;                        // any addition or removal changes it
+            std::vector<uint32_t> control_point_indices;   // where the control points sit among the children
+            std::vector<Entity*> control_points;           // compared by pointer before they are dereferenced
+            std::vector<uint64_t> control_point_revisions; // their transform revisions, to detect movement
+            std::vector<math::Vector3> points;
+            std::vector<math::Vector3> points_local;
+            std::vector<math::Vector3> samples;    // positions at uniform steps in t
+            std::vector<float> distances;          // arc length at each sample
+            bool closed_loop = false;
+            bool valid       = false;
+        };
+
+        // rebuilds when invalid, queries don't validate so followers only pay for a lookup
+        const Cache& GetCache() const;
+
+        // once per frame, invalidates the cache when control points were added, removed or moved
+        void ValidateCache();
 
         // resolve the current profile into a set of 2d cross-section points (in right-up plane)
         std::vector<math::Vector2> GetProfilePoints() const;
@@ -114,7 +145,7 @@ namespace spartan
         bool IsProfileClosed() const;
 
         // generalized mesh extrusion along the spline using the given cross-section
-        void GenerateMesh(const std::vector<math::Vector3>& spline_points, const std::vector<math::Vector2>& profile_points, bool close_profile);
+        void GenerateMesh(const std::vector<math::Vector2>& profile_points, bool close_profile);
 
         // catmull-rom interpolation between four points
         static math::Vector3 CatmullRom(
@@ -133,6 +164,7 @@ namespace spartan
         // evaluate spline position from an arbitrary set of control points
         math::Vector3 EvaluatePoint(const std::vector<math::Vector3>& points, float t) const;
         math::Vector3 EvaluateTangent(const std::vector<math::Vector3>& points, float t) const;
+        SplineFrame EvaluateFrame(const std::vector<math::Vector3>& points, float t) const;
 
         // maps a normalized t to a span index and local t
         void MapToSpan(float t, const std::vector<math::Vector3>& points, uint32_t& span_index, float& local_t) const;
@@ -159,5 +191,8 @@ namespace spartan
 
         // generated mesh
         std::shared_ptr<Mesh> m_mesh;
+
+        // shared by followers, mesh generation and instance spawning
+        mutable Cache m_cache;
     };
 }
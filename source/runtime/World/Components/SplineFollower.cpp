@@ -40,8 +40,10 @@ namespace spartan
 {
     SplineFollower::SplineFollower(Entity* entity) : Component(entity)
     {
-        SP_REGISTER_ATTRIBUTE_GET_SET(GetSpeed,          SetSpeed,          float);
-        SP_REGISTER_ATTRIBUTE_GET_SET(GetAlignToSpline,  SetAlignToSpline,  bool);
+        SP_REGISTER_ATTRIBUTES(
+            SP_ATTRIBUTE_GET_SET(GetSpeed, SetSpeed),
+            SP_ATTRIBUTE_GET_SET(GetAlignToSpline, SetAlignToSpline)
+        );
     }
 
     void SplineFollower::SetSplineEntityId(uint64_t id)
@@ -122,19 +124,14 @@ namespace spartan
             break;
         }
 
-        // set position along the spline
-        Vector3 position = spline->GetPoint(m_progress);
-        GetEntity()->SetPosition(position);
+        // progress is a fraction of the arc length, so the speed stays constant regardless of control point spacing
+        SplineFrame frame = spline->GetFrameAtDistance(m_progress * spline_length);
+        GetEntity()->SetPosition(frame.position);
 
         // optionally orient the entity along the tangent
-        if (m_align_to_spline)
+        if (m_align_to_spline && frame.tangent.LengthSquared() > 0.0f)
         {
-            Vector3 tangent = spline->GetTangent(m_progress);
-            if (tangent.LengthSquared() > 0.0f)
-            {
-                tangent.Normalize();
-                GetEntity()->SetRotation(Quaternion::FromLookRotation(tangent, Vector3::Up));
-            }
+            GetEntity()->SetRotation(Quaternion::FromLookRotation(frame.tangent, Vector3::Up));
         }
     }
 
@@ -157,6 +154,17 @@ namespace spartan
         m_spline_entity = nullptr;
     }
 
+    void SplineFollower::CopyFromPrototype(const Component* prototype)
+    {
+        const SplineFollower* follower = static_cast<const SplineFollower*>(prototype);
+
+        m_spline_entity_id = follower->m_spline_entity_id;
+        m_speed            = follower->m_speed;
+        m_follow_mode      = follower->m_follow_mode;
+        m_align_to_spline  = follower->m_align_to_spline;
+        m_spline_entity    = nullptr;
+    }
+
     void SplineFollower::ResolveSplineEntity()
     {
         if (m_spline_entity_id != 0)
@@ -50,6 +50,7 @@ namespace spartan
         // serialization
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void CopyFromPrototype(const Component* prototype) override;
 
         // spline entity reference
         uint64_t GetSplineEntityId() const            { return m_spline_entity_id; }
@@ -86,7 +87,7 @@ namespace spartan
         // orient the entity along the spline tangent
         bool m_align_to_spline = true;
 
-        // current normalized position along the spline [0, 1]
+        // current normalized distance along the spline [0, 1]
         float m_progress = 0.0f;
 
         // travel direction: +1 forward, -1 backward (used by ping-pong)
@@ -23,15 +23,18 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pch.h"
 #include "Terrain.h"
 #include "Renderable.h"
+#include "Physics.h"
+#include "Camera.h"
 #include "../Entity.h"
 #include "../World.h"
 #include "../../RHI/RHI_Texture.h"
 #include "../../Resource/ResourceCache.h"
 #include "../../Geometry/Mesh.h"
 #include "../../Rendering/Material.h"
-#include "../../Geometry/GeometryProcessing.h"
 #include "../../Core/ThreadPool.h"
 #include "../../Core/ProgressTracker.h"
+#include "../../FileSystem/FileSystem.h"
+#include "../../Commands/Console/ConsoleCommands.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
@@ -53,30 +56,25 @@ namespace spartan
         };
 
         void compute_triangle_data(
-            const vector<vector<RHI_Vertex_PosTexNorTan>>& vertices_terrain,
-            const vector<vector<uint32_t>>& indices_terrain,
-            uint32_t tile_index,
-            unordered_map<uint64_t, vector<TriangleData>>& triangle_data_out
+            const vector<RHI_Vertex_PosTexNorTan>& vertices_chunk,
+            const vector<uint32_t>& indices_chunk,
+            vector<TriangleData>& chunk_triangle_data
         )
         {
-            const vector<RHI_Vertex_PosTexNorTan>& vertices_tile = vertices_terrain[tile_index];
-            const vector<uint32_t>& indices_tile                 = indices_terrain[tile_index];
+            uint32_t triangle_count = static_cast<uint32_t>(indices_chunk.size() / 3);
+            chunk_triangle_data.resize(triangle_count);
 
-            uint32_t triangle_count  = static_cast<uint32_t>(indices_tile.size() / 3);
-            auto& tile_triangle_data = triangle_data_out[tile_index];
-            tile_triangle_data.resize(triangle_count);
-
-            auto compute_triangle = [&vertices_tile, &indices_tile, &tile_triangle_data](uint32_t start_index, uint32_t end_index)
+            auto compute_triangle = [&vertices_chunk, &indices_chunk, &chunk_triangle_data](uint32_t start_index, uint32_t end_index)
             {
                 for (uint32_t i = start_index; i < end_index; i++)
                 {
-                    uint32_t idx0 = indices_tile[i * 3];
-                    uint32_t idx1 = indices_tile[i * 3 + 1];
-                    uint32_t idx2 = indices_tile[i * 3 + 2];
+                    uint32_t idx0 = indices_chunk[i * 3];
+                    uint32_t idx1 = indices_chunk[i * 3 + 1];
+                    uint32_t idx2 = indices_chunk[i * 3 + 2];
 
-                    Vector3 v0(vertices_tile[idx0].pos[0], vertices_tile[idx0].pos[1], vertices_tile[idx0].pos[2]);
-                    Vector3 v1(vertices_tile[idx1].pos[0], vertices_tile[idx1].pos[1], vertices_tile[idx1].pos[2]);
-                    Vector3 v2(vertices_tile[idx2].pos[0], vertices_tile[idx2].pos[1], vertices_tile[idx2].pos[2]);
+                    Vector3 v0(vertices_chunk[idx0].pos[0], vertices_chunk[idx0].pos[1], vertices_chunk[idx0].pos[2]);
+                    Vector3 v1(vertices_chunk[idx1].pos[0], vertices_chunk[idx1].pos[1], vertices_chunk[idx1].pos[2]);
+                    Vector3 v2(vertices_chunk[idx2].pos[0], vertices_chunk[idx2].pos[1], vertices_chunk[idx2].pos[2]);
 
                     Vector3 v1_minus_v0           = v1 - v0;
                     Vector3 v2_minus_v0           = v2 - v0;
@@ -85,7 +83,7 @@ namespace spartan
                     Quaternion rotation_to_normal = Quaternion::FromRotation(Vector3::Up, normal);
                     Vector3 centroid              = v0 + (v1_minus_v0 + v2_minus_v0) / 3.0f;
 
-                    tile_triangle_data[i] = {
+                    chunk_triangle_data[i] = {
                         normal, v0, v1_minus_v0, v2_minus_v0, slope_radians,
                         min({ v0.y, v1.y, v2.y }), max({ v0.y, v1.y, v2.y }),
                         rotation_to_normal, centroid
@@ -99,43 +97,40 @@ namespace spartan
         void find_transforms(
             TerrainPropDescription prop_desc,
             const float density_fraction,
-            uint32_t tile_index,
+            uint32_t chunk_index,
             vector<Matrix>& transforms_out,
-            unordered_map<uint64_t, vector<TriangleData>>& triangle_data
+            vector<TriangleData>& chunk_triangle_data
         )
         {
-            auto it = triangle_data.find(tile_index);
-            if (it == triangle_data.end())
+            if (chunk_triangle_data.empty())
             {
-                SP_LOG_ERROR("no triangle data found for tile %d", tile_index);
+                SP_LOG_ERROR("no triangle data found for chunk %d", chunk_index);
                 return;
             }
-            vector<TriangleData>& tile_triangle_data = it->second;
-            SP_ASSERT(!tile_triangle_data.empty());
 
-            // compute tile bounds using parallel reduction
-            uint32_t tri_count_bounds = static_cast<uint32_t>(tile_triangle_data.size());
-            uint32_t num_chunks = min(tri_count_bounds, static_cast<uint32_t>(thread::hardware_concurrency()));
-            if (num_chunks == 0) num_chunks = 1;
+            // compute chunk bounds using parallel reduction
+            uint32_t tri_count_bounds = static_cast<uint32_t>(chunk_triangle_data.size());
+            uint32_t num_batches      = min(tri_count_bounds, static_cast<uint32_t>(thread::hardware_concurrency()));
+            if (num_batches == 0) num_batches = 1;
             
             struct Bounds { float min_x, max_x, min_z, max_z; };
-            vector<Bounds> chunk_bounds(num_chunks, { 
+            vector<Bounds> batch_bounds(num_batches, { 
                 numeric_limits<float>::max(), numeric_limits<float>::lowest(),
                 numeric_limits<float>::max(), numeric_limits<float>::lowest() 
             });
             
-            uint32_t chunk_size = (tri_count_bounds + num_chunks - 1) / num_chunks;
+            uint32_t batch_size = (tri_count_bounds + num_batches - 1) / num_batches;
             auto parallel_bounds = [&](uint32_t start, uint32_t end)
             {
-                for (uint32_t c = start; c < end; c++)
+                for (uint32_t batch = start; batch < end; batch++)
                 {
-                    uint32_t chunk_start = c * chunk_size;
-                    uint32_t chunk_end   = min(chunk_start + chunk_size, tri_count_bounds);
-                    Bounds& b            = chunk_bounds[c];
+                    uint32_t batch_start = batch * batch_size;
+                    uint32_t batch_end   = min(batch_start + batch_size, tri_count_bounds);
+                    Bounds& b            = batch_bounds[batch];
                     
-                    for (uint32_t i = chunk_start; i < chunk_end; i++)
+                    for (uint32_t i = batch_start; i < batch_end; i++)
                     {
-                        const auto& tri = tile_triangle_data[i];
+                        const auto& tri = chunk_triangle_data[i];
                         b.min_x = min(b.min_x, tri.centroid.x);
                         b.max_x = max(b.max_x, tri.centroid.x);
                         b.min_z = min(b.min_z, tri.centroid.z);
@@ -143,33 +138,33 @@ namespace spartan
                     }
                 }
             };
-            ThreadPool::ParallelLoop(parallel_bounds, num_chunks);
+            ThreadPool::ParallelLoop(parallel_bounds, num_batches);
             
-            // merge chunk results
-            float tile_min_x = numeric_limits<float>::max();
-            float tile_max_x = numeric_limits<float>::lowest();
-            float tile_min_z = numeric_limits<float>::max();
-            float tile_max_z = numeric_limits<float>::lowest();
-            for (const auto& b : chunk_bounds)
-            {
-                tile_min_x = min(tile_min_x, b.min_x);
-                tile_max_x = max(tile_max_x, b.max_x);
-                tile_min_z = min(tile_min_z, b.min_z);
-                tile_max_z = max(tile_max_z, b.max_z);
+            // merge batch results
+            float chunk_min_x = numeric_limits<float>::max();
+            float chunk_max_x = numeric_limits<float>::lowest();
+            float chunk_min_z = numeric_limits<float>::max();
+            float chunk_max_z = numeric_limits<float>::lowest();
+            for (const auto& b : batch_bounds)
+            {
+                chunk_min_x = min(chunk_min_x, b.min_x);
+                chunk_max_x = max(chunk_max_x, b.max_x);
+                chunk_min_z = min(chunk_min_z, b.min_z);
+                chunk_max_z = max(chunk_max_z, b.max_z);
             }
 
             // filter triangles that meet spawn criteria
             const float edge_epsilon = 0.01f;
-            float edge_threshold_x   = tile_max_x - edge_epsilon;
-            float edge_threshold_z   = tile_max_z - edge_epsilon;
+            float edge_threshold_x   = chunk_max_x - edge_epsilon;
+            float edge_threshold_z   = chunk_max_z - edge_epsilon;
 
             vector<uint32_t> acceptable_triangles;
-            acceptable_triangles.reserve(tile_triangle_data.size());
-            for (uint32_t i = 0; i < tile_triangle_data.size(); i++)
+            acceptable_triangles.reserve(chunk_triangle_data.size());
+            for (uint32_t i = 0; i < chunk_triangle_data.size(); i++)
             {
-                const TriangleData& tri = tile_triangle_data[i];
+                const TriangleData& tri = chunk_triangle_data[i];
 
-                // skip edge triangles to prevent double-spawning at tile boundaries
+                // skip edge triangles to prevent double-spawning at chunk boundaries
                 if (tri.centroid.x >= edge_threshold_x || tri.centroid.z >= edge_threshold_z)
                     continue;
 
@@ -190,10 +185,10 @@ namespace spartan
                 return;
 
             // setup cluster parameters
-            float safe_min_x   = tile_min_x + prop_desc.cluster_radius;
-            float safe_max_x   = tile_max_x - prop_desc.cluster_radius;
-            float safe_min_z   = tile_min_z + prop_desc.cluster_radius;
-            float safe_max_z   = tile_max_z - prop_desc.cluster_radius;
+            float safe_min_x   = chunk_min_x + prop_desc.cluster_radius;
+            float safe_max_x   = chunk_max_x - prop_desc.cluster_radius;
+            float safe_min_z   = chunk_min_z + prop_desc.cluster_radius;
+            float safe_max_z   = chunk_max_z - prop_desc.cluster_radius;
             bool has_safe_zone = (safe_min_x < safe_max_x) && (safe_min_z < safe_max_z);
 
             uint32_t cluster_count              = adjusted_count;
@@ -210,7 +205,7 @@ namespace spartan
             // place cluster centers
             auto place_cluster = [&](uint32_t start_index, uint32_t end_index)
             {
-                mt19937 generator(tile_index * 1000003u + start_index * 31u + 12345u);
+                mt19937 generator(chunk_index * 1000003u + start_index * 31u + 12345u);
                 const uint32_t tri_count = static_cast<uint32_t>(acceptable_triangles.size());
                 uniform_int_distribution<> triangle_dist(0, tri_count - 1);
                 uniform_real_distribution<float> dist(0.0f, 1.0f);
@@ -225,7 +220,7 @@ namespace spartan
                     do
                     {
                         tri_idx           = acceptable_triangles[triangle_dist(generator)];
-                        TriangleData& tri = tile_triangle_data[tri_idx];
+                        TriangleData& tri = chunk_triangle_data[tri_idx];
 
                         float r1      = dist(generator);
                         float r2      = dist(generator);
@@ -252,9 +247,9 @@ namespace spartan
             const float max_effective_radius = prop_desc.cluster_radius * 1.6f;
             const float cell_size            = max(max_effective_radius, 1.0f);
             
-            int32_t grid_min_x  = static_cast<int32_t>(floorf(tile_min_x / cell_size));
-            int32_t grid_min_z  = static_cast<int32_t>(floorf(tile_min_z / cell_size));
-            int32_t grid_max_x  = static_cast<int32_t>(floorf(tile_max_x / cell_size));
+            int32_t grid_min_x  = static_cast<int32_t>(floorf(chunk_min_x / cell_size));
+            int32_t grid_min_z  = static_cast<int32_t>(floorf(chunk_min_z / cell_size));
+            int32_t grid_max_x  = static_cast<int32_t>(floorf(chunk_max_x / cell_size));
             int32_t grid_width  = grid_max_x - grid_min_x + 1;
             
             unordered_map<int64_t, vector<uint32_t>> spatial_grid;
@@ -263,7 +258,7 @@ namespace spartan
                 for (uint32_t t = 0; t < static_cast<uint32_t>(acceptable_triangles.size()); t++)
                 {
                     uint32_t tri_idx  = acceptable_triangles[t];
-                    TriangleData& tri = tile_triangle_data[tri_idx];
+                    TriangleData& tri = chunk_triangle_data[tri_idx];
                     int32_t cell_x    = static_cast<int32_t>(floorf(tri.centroid.x / cell_size)) - grid_min_x;
                     int32_t cell_z    = static_cast<int32_t>(floorf(tri.centroid.z / cell_size)) - grid_min_z;
                     int64_t cell_key  = static_cast<int64_t>(cell_z) * grid_width + cell_x;
@@ -323,7 +318,7 @@ namespace spartan
                             for (uint32_t t : grid_it->second)
                             {
                                 uint32_t tri_idx  = acceptable_triangles[t];
-                                TriangleData& tri = tile_triangle_data[tri_idx];
+                                TriangleData& tri = chunk_triangle_data[tri_idx];
                                 Vector2 tri_xz(tri.centroid.x, tri.centroid.z);
                                 Vector2 offset  = tri_xz - cl_xz;
                                 float dist_sq   = offset.LengthSquared();
@@ -359,7 +354,7 @@ namespace spartan
             // place instances within clusters
             auto place_mesh = [&](uint32_t start_index, uint32_t end_index)
             {
-                mt19937 generator(tile_index * 2000003u + start_index * 37u + 67890u);
+                mt19937 generator(chunk_index * 2000003u + start_index * 37u + 67890u);
                 uniform_real_distribution<float> dist(0.0f, 1.0f);
                 uniform_real_distribution<float> angle_dist(0.0f, 360.0f);
                 uniform_real_distribution<float> scale_dist(prop_desc.min_scale, prop_desc.max_scale);
@@ -380,7 +375,7 @@ namespace spartan
 
                     uniform_int_distribution<int> nearby_dist(0, static_cast<int>(nearby.size()) - 1);
                     uint32_t tri_idx  = nearby[nearby_dist(generator)];
-                    TriangleData& tri = tile_triangle_data[tri_idx];
+                    TriangleData& tri = chunk_triangle_data[tri_idx];
 
                     // random position within triangle
                     float r1      = dist(generator);
@@ -419,46 +414,42 @@ namespace spartan
 
     namespace
     {
-        float compute_surface_area_km2(const vector<RHI_Vertex_PosTexNorTan>& vertices, const vector<uint32_t>& indices)
+        constexpr uint32_t chunk_quads        = 256;   // height field quads along a chunk side
+        constexpr uint32_t chunk_jobs_max     = 4;     // chunks building on worker threads at once
+        constexpr float evict_distance_factor = 1.25f; // hysteresis, so chunks at the edge of the range don't thrash
+
+        TConsoleVar<float> cvar_terrain_stream_distance("terrain.stream_distance",  4000.0f, "terrain chunks within this distance of the camera are kept in memory");
+        TConsoleVar<float> cvar_terrain_memory_budget  ("terrain.memory_budget_mb", 1024.0f, "memory budget for terrain chunk geometry and placement data, the farthest chunks are evicted first");
+
+        float compute_surface_area_km2(const vector<Vector3>& positions, uint32_t width, uint32_t height)
         {
-            uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
-            vector<float> partial_areas(triangle_count);
-            
-            auto compute_areas = [&](uint32_t start_tri, uint32_t end_tri)
+            uint32_t quad_count = (width - 1) * (height - 1);
+            vector<float> partial_areas(quad_count);
+
+            auto compute_areas = [&](uint32_t start_quad, uint32_t end_quad)
             {
-                for (uint32_t t = start_tri; t < end_tri; t++)
+                for (uint32_t quad = start_quad; quad < end_quad; quad++)
                 {
-                    size_t i        = static_cast<size_t>(t) * 3;
-                    const auto& v0  = vertices[indices[i + 0]].pos;
-                    const auto& v1  = vertices[indices[i + 1]].pos;
-                    const auto& v2  = vertices[indices[i + 2]].pos;
-                    
-                    float e1x = v1[0] - v0[0], e1y = v1[1] - v0[1], e1z = v1[2] - v0[2];
-                    float e2x = v2[0] - v0[0], e2y = v2[1] - v0[1], e2z = v2[2] - v0[2];
-                    float cx  = e1y * e2z - e1z * e2y;
-                    float cy  = e1z * e2x - e1x * e2z;
-                    float cz  = e1x * e2y - e1y * e2x;
-                    
-                    partial_areas[t] = 0.5f * sqrtf(cx * cx + cy * cy + cz * cz);
+                    uint32_t x           = quad % (width - 1);
+                    uint32_t y           = quad / (width - 1);
+                    const Vector3& p_bl  = positions[y * width + x];
+                    const Vector3& p_br  = positions[y * width + x + 1];
+                    const Vector3& p_tl  = positions[(y + 1) * width + x];
+                    const Vector3& p_tr  = positions[(y + 1) * width + x + 1];
+
+                    partial_areas[quad] = 0.5f * (Vector3::Cross(p_bl - p_br, p_tl - p_br).Length() + Vector3::Cross(p_tl - p_br, p_tr - p_br).Length());
                 }
             };
-            ThreadPool::ParallelLoop(compute_areas, triangle_count);
-            
+            ThreadPool::ParallelLoop(compute_areas, quad_count);
+
             float area_m2 = 0.0f;
             for (float a : partial_areas)
                 area_m2 += a;
-            
+
             return area_m2 / 1'000'000.0f;
         }
-        
-        void get_values_from_height_map(
-            vector<float>& height_data_out,
-            RHI_Texture* height_texture,
-            float min_y,
-            float max_y,
-            uint32_t smoothing,
-            bool create_border
-        )
+
+        void get_values_from_height_map(vector<float>& height_data_out, RHI_Texture* height_texture, float min_y, float max_y)
         {
             vector<byte> height_data = height_texture->GetMip(0, 0)->bytes;
             SP_ASSERT(height_data.size() > 0);
@@ -478,11 +469,11 @@ namespace spartan
                 }
             };
             ThreadPool::ParallelLoop(map_height, pixel_count);
-        
-            // smooth height map to reduce hard edges
-            const uint32_t width  = height_texture->GetWidth();
-            const uint32_t height = height_texture->GetHeight();
+        }
 
+        void smooth_height_map(vector<float>& height_data_out, uint32_t width, uint32_t height, float min_y, uint32_t smoothing, bool create_border)
+        {
+            // smooth height map to reduce hard edges
             for (uint32_t iteration = 0; iteration < smoothing; iteration++)
             {
                 vector<float> smoothed_height_data(height_data_out.size());
@@ -804,139 +795,350 @@ namespace spartan
             apply_wind_erosion(positions, width, height, wind_strength);
         }
 
-        void generate_vertices_and_indices(vector<RHI_Vertex_PosTexNorTan>& vertices, vector<uint32_t>& indices, const vector<Vector3>& positions, uint32_t width, uint32_t height)
+        // a chunk's slice of the height field, normals come from the full height field so they agree across chunk borders
+        void build_chunk_geometry(
+            const vector<Vector3>& positions,
+            uint32_t width,
+            uint32_t height,
+            const TerrainChunk& chunk,
+            vector<RHI_Vertex_PosTexNorTan>& vertices,
+            vector<uint32_t>& indices
+        )
         {
             SP_ASSERT_MSG(!positions.empty(), "positions are empty");
 
             const float inv_width  = 1.0f / static_cast<float>(width - 1);
             const float inv_height = 1.0f / static_cast<float>(height - 1);
-            
-            auto gen_vertices = [&](uint32_t start_idx, uint32_t end_idx)
+
+            vertices.resize(chunk.width * chunk.height);
+            for (uint32_t j = 0; j < chunk.height; j++)
             {
-                for (uint32_t idx = start_idx; idx < end_idx; idx++)
+                for (uint32_t i = 0; i < chunk.width; i++)
                 {
-                    uint32_t x   = idx % width;
-                    uint32_t y   = idx / width;
-                    vertices[idx] = RHI_Vertex_PosTexNorTan(positions[idx], Vector2(x * inv_width, y * inv_height));
+                    uint32_t x        = chunk.x + i;
+                    uint32_t y        = chunk.z + j;
+                    const Vector3& p  = positions[y * width + x];
+                    uint32_t x_left   = (x > 0) ? x - 1 : x;
+                    uint32_t x_right  = (x < width - 1) ? x + 1 : x;
+                    uint32_t y_bottom = (y > 0) ? y - 1 : y;
+                    uint32_t y_top    = (y < height - 1) ? y + 1 : y;
+
+                    float dh_dx = (positions[y * width + x_right].y - positions[y * width + x_left].y) / static_cast<float>(x_right - x_left);
+                    float dh_dz = (positions[y_top * width + x].y - positions[y_bottom * width + x].y) / static_cast<float>(y_top - y_bottom);
+
+                    RHI_Vertex_PosTexNorTan& vertex = vertices[j * chunk.width + i];
+                    vertex = RHI_Vertex_PosTexNorTan(Vector3(p.x - chunk.offset.x, p.y, p.z - chunk.offset.z), Vector2(x * inv_width, y * inv_height));
+
+                    float nx      = -dh_dx, ny = 1.0f, nz = -dh_dz;
+                    float inv_len = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz);
+                    nx *= inv_len; ny *= inv_len; nz *= inv_len;
+                    vertex.nor[0] = nx;
+                    vertex.nor[1] = ny;
+                    vertex.nor[2] = nz;
+
+                    float proj      = nx;
+                    float tx        = 1.0f - nx * proj, ty = -ny * proj, tz = -nz * proj;
+                    float t_inv_len = 1.0f / sqrtf(tx * tx + ty * ty + tz * tz);
+                    vertex.tan[0] = tx * t_inv_len;
+                    vertex.tan[1] = ty * t_inv_len;
+                    vertex.tan[2] = tz * t_inv_len;
                 }
-            };
-            ThreadPool::ParallelLoop(gen_vertices, width * height);
-            
-            uint32_t quad_count = (width - 1) * (height - 1);
-            auto gen_indices = [&](uint32_t start_quad, uint32_t end_quad)
+            }
+
+            uint32_t quad_count = (chunk.width - 1) * (chunk.height - 1);
+            indices.resize(quad_count * 6);
+            for (uint32_t quad = 0; quad < quad_count; quad++)
             {
-                for (uint32_t quad = start_quad; quad < end_quad; quad++)
+                uint32_t x  = quad % (chunk.width - 1);
+                uint32_t y  = quad / (chunk.width - 1);
+                uint32_t k  = quad * 6;
+                uint32_t bl = y * chunk.width + x;
+                uint32_t br = bl + 1;
+                uint32_t tl = bl + chunk.width;
+                uint32_t tr = tl + 1;
+
+                indices[k]     = br;
+                indices[k + 1] = bl;
+                indices[k + 2] = tl;
+                indices[k + 3] = br;
+                indices[k + 4] = tl;
+                indices[k + 5] = tr;
+            }
+        }
+
+        // generation cache, content addressed so terrains with different inputs never collide and identical ones share files
+        // a file is a 64 byte header followed by the raw array, so it can be read in one go or mapped and used in place
+        const char* cache_directory      = "terrain_cache";
+        const uint32_t cache_magic       = 0x43545053; // "SPTC"
+        const uint32_t cache_version     = 1;          // bump when a stage's algorithm changes
+        const uint32_t cache_files_max   = 64;         // least recently used files beyond this are deleted
+
+        struct CacheHeader
+        {
+            uint32_t magic        = cache_magic;
+            uint32_t version      = cache_version;
+            uint64_t hash         = 0;
+            uint32_t width        = 0;
+            uint32_t height       = 0;
+            uint32_t element_size = 0;
+            uint32_t reserved     = 0;
+            uint64_t element_count = 0;
+            uint8_t padding[24]   = {};
+        };
+        static_assert(sizeof(CacheHeader) == 64, "the payload should start on a cache line");
+
+        string cache_get_path(uint64_t hash)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+            return string(cache_directory) + "/" + name;
+        }
+
+        template<typename T>
+        bool cache_load(uint64_t hash, uint32_t width, uint32_t height, vector<T>& data)
+        {
+            const string path = cache_get_path(hash);
+            ifstream file(path, ios::binary);
+            if (!file.is_open())
+                return false;
+
+            CacheHeader header;
+            file.read(reinterpret_cast<char*>(&header), sizeof(CacheHeader));
+            if (!file || header.magic != cache_magic || header.version != cache_version || header.hash != hash ||
+                header.width != width || header.height != height || header.element_size != sizeof(T) ||
+                header.element_count != static_cast<uint64_t>(width) * height)
+            {
+                SP_LOG_WARNING("ignoring invalid terrain cache file \"%s\"", path.c_str());
+                return false;
+            }
+
+            vector<T> loaded(header.element_count);
+            file.read(reinterpret_cast<char*>(loaded.data()), header.element_count * sizeof(T));
+            if (!file)
+            {
+                SP_LOG_WARNING("terrain cache file \"%s\" is truncated", path.c_str());
+                return false;
+            }
+            data = move(loaded);
+
+            // recently used files survive pruning
+            error_code error;
+            filesystem::last_write_time(path, filesystem::file_time_type::clock::now(), error);
+
+            return true;
+        }
+
+        void cache_prune()
+        {
+            error_code error;
+            vector<pair<filesystem::file_time_type, filesystem::path>> files;
+            for (const filesystem::directory_entry& entry : filesystem::directory_iterator(cache_directory, error))
+            {
+                if (entry.is_regular_file(error) && entry.path().extension() == ".bin")
                 {
-                    uint32_t x  = quad % (width - 1);
-                    uint32_t y  = quad / (width - 1);
-                    uint32_t k  = quad * 6;
-                    uint32_t bl = y * width + x;
-                    uint32_t br = bl + 1;
-                    uint32_t tl = bl + width;
-                    uint32_t tr = tl + 1;
-                    
-                    indices[k]     = br;
-                    indices[k + 1] = bl;
-                    indices[k + 2] = tl;
-                    indices[k + 3] = br;
-                    indices[k + 4] = tl;
-                    indices[k + 5] = tr;
+                    files.emplace_back(entry.last_write_time(error), entry.path());
                 }
-            };
-            ThreadPool::ParallelLoop(gen_indices, quad_count);
+            }
+
+            if (files.size() <= cache_files_max)
+                return;
+
+            sort(files.begin(), files.end());
+            for (size_t i = 0; i < files.size() - cache_files_max; i++)
+            {
+                filesystem::remove(files[i].second, error);
+            }
         }
 
-        void generate_normals(vector<RHI_Vertex_PosTexNorTan>& vertices, uint32_t width, uint32_t height)
+        template<typename T>
+        void cache_save(uint64_t hash, uint32_t width, uint32_t height, const vector<T>& data)
         {
-            SP_ASSERT_MSG(!vertices.empty(), "vertices are empty");
-        
-            // interior vertices - no boundary checks needed
-            uint32_t interior_count = (width - 2) * (height - 2);
-            if (interior_count > 0)
+            SP_ASSERT(data.size() == static_cast<size_t>(width) * height);
+
+            if (!FileSystem::Exists(cache_directory))
             {
-                auto compute_interior = [&](uint32_t start, uint32_t end)
+                FileSystem::CreateDirectory_(cache_directory);
+            }
+
+            // written under a temporary name, so an interrupted write never looks like a valid file
+            const string path      = cache_get_path(hash);
+            const string path_temp = path + ".tmp";
+            {
+                ofstream file(path_temp, ios::binary | ios::trunc);
+                if (!file.is_open())
                 {
-                    for (uint32_t index = start; index < end; index++)
-                    {
-                        uint32_t interior_width = width - 2;
-                        uint32_t i              = (index % interior_width) + 1;
-                        uint32_t j              = (index / interior_width) + 1;
-                        uint32_t vertex_idx     = j * width + i;
-                        
-                        float h_left   = vertices[vertex_idx - 1].pos[1];
-                        float h_right  = vertices[vertex_idx + 1].pos[1];
-                        float h_bottom = vertices[vertex_idx - width].pos[1];
-                        float h_top    = vertices[vertex_idx + width].pos[1];
-                        
-                        float dh_dx = (h_right - h_left) * 0.5f;
-                        float dh_dz = (h_top - h_bottom) * 0.5f;
-                        
-                        float nx      = -dh_dx, ny = 1.0f, nz = -dh_dz;
-                        float inv_len = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz);
-                        nx *= inv_len; ny *= inv_len; nz *= inv_len;
-                        vertices[vertex_idx].nor[0] = nx;
-                        vertices[vertex_idx].nor[1] = ny;
-                        vertices[vertex_idx].nor[2] = nz;
-                        
-                        float proj      = nx;
-                        float tx        = 1.0f - nx * proj, ty = -ny * proj, tz = -nz * proj;
-                        float t_inv_len = 1.0f / sqrtf(tx * tx + ty * ty + tz * tz);
-                        vertices[vertex_idx].tan[0] = tx * t_inv_len;
-                        vertices[vertex_idx].tan[1] = ty * t_inv_len;
-                        vertices[vertex_idx].tan[2] = tz * t_inv_len;
-                    }
-                };
-                ThreadPool::ParallelLoop(compute_interior, interior_count);
+                    SP_LOG_ERROR("failed to open file for writing: %s", path_temp.c_str());
+                    return;
+                }
+
+                CacheHeader header;
+                header.hash          = hash;
+                header.width         = width;
+                header.height        = height;
+                header.element_size  = sizeof(T);
+                header.element_count = data.size();
+                file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+                file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
             }
-            
-            // edge vertices with boundary handling
-            uint32_t edge_count = 2 * width + 2 * (height - 2);
-            auto compute_edges = [&](uint32_t start, uint32_t end)
+
+            error_code error;
+            filesystem::rename(path_temp, path, error);
+            if (error)
             {
-                for (uint32_t edge_idx = start; edge_idx < end; edge_idx++)
+                SP_LOG_ERROR("failed to write terrain cache file \"%s\": %s", path.c_str(), error.message().c_str());
+                filesystem::remove(path_temp, error);
+                return;
+            }
+
+            cache_prune();
+        }
+
+        // collision surfaces, indexed by the height field's per triangle surface indices
+        enum class TerrainSurface : uint8_t
+        {
+            Grass,
+            Rock,
+            Snow,
+            Sand,
+            Max
+        };
+
+        const float rock_slope_rad = 35.0f * deg_to_rad;
+
+        TerrainSurface classify_surface(const Vector3& v0, const Vector3& v1, const Vector3& v2, float level_sea, float level_snow)
+        {
+            float height = (v0.y + v1.y + v2.y) / 3.0f;
+            if (height < level_sea)
+                return TerrainSurface::Sand;
+
+            if (height > level_snow)
+                return TerrainSurface::Snow;
+
+            Vector3 normal = Vector3::Cross(v1 - v0, v2 - v0).Normalized();
+            return acos(abs(normal.y)) > rock_slope_rad ? TerrainSurface::Rock : TerrainSurface::Grass;
+        }
+
+        // the chunk's samples straight from the height field, at full resolution and without cooking
+        // rows run along x and columns along z, the chunk entity sits at chunk.offset
+        PhysicsHeightField build_chunk_height_field(const vector<Vector3>& positions, uint32_t width, const TerrainChunk& chunk, float level_sea, float level_snow)
+        {
+            PhysicsHeightField height_field;
+            height_field.rows    = chunk.width;
+            height_field.columns = chunk.height;
+
+            auto position = [&](uint32_t row, uint32_t column) -> const Vector3&
+            {
+                return positions[(chunk.z + column) * width + chunk.x + row];
+            };
+
+            const Vector3& origin  = position(0, 0);
+            height_field.origin    = Vector3(origin.x - chunk.offset.x, 0.0f, origin.z - chunk.offset.z);
+            height_field.spacing_x = position(1, 0).x - origin.x;
+            height_field.spacing_z = position(0, 1).z - origin.z;
+
+            height_field.heights.resize(static_cast<size_t>(height_field.rows) * height_field.columns);
+            for (uint32_t row = 0; row < height_field.rows; row++)
+            {
+                for (uint32_t column = 0; column < height_field.columns; column++)
                 {
-                    uint32_t i, j;
-                    uint32_t perimeter = 2 * width + 2 * (height - 2);
-                    
-                    if (edge_idx < width)
-                        { i = edge_idx; j = 0; }
-                    else if (edge_idx < width + height - 1)
-                        { i = width - 1; j = edge_idx - width + 1; }
-                    else if (edge_idx < 2 * width + height - 2)
-                        { i = 2 * width + height - 3 - edge_idx; j = height - 1; }
-                    else
-                        { i = 0; j = perimeter - edge_idx; }
-                    
-                    uint32_t index   = j * width + i;
-                    uint32_t i_left  = (i > 0) ? i - 1 : i;
-                    uint32_t i_right = (i < width - 1) ? i + 1 : i;
-                    uint32_t j_bot   = (j > 0) ? j - 1 : j;
-                    uint32_t j_top   = (j < height - 1) ? j + 1 : j;
-                    
-                    float h_left  = vertices[j * width + i_left].pos[1];
-                    float h_right = vertices[j * width + i_right].pos[1];
-                    float h_bot   = vertices[j_bot * width + i].pos[1];
-                    float h_top   = vertices[j_top * width + i].pos[1];
-                    
-                    float dh_dx = (h_right - h_left) / ((i_right != i_left) ? static_cast<float>(i_right - i_left) : 1.0f);
-                    float dh_dz = (h_top - h_bot) / ((j_top != j_bot) ? static_cast<float>(j_top - j_bot) : 1.0f);
-                    
-                    float nx      = -dh_dx, ny = 1.0f, nz = -dh_dz;
-                    float inv_len = 1.0f / sqrtf(nx * nx + ny * ny + nz * nz);
-                    nx *= inv_len; ny *= inv_len; nz *= inv_len;
-                    vertices[index].nor[0] = nx;
-                    vertices[index].nor[1] = ny;
-                    vertices[index].nor[2] = nz;
-                    
-                    float proj      = nx;
-                    float tx        = 1.0f - nx * proj, ty = -ny * proj, tz = -nz * proj;
-                    float t_inv_len = 1.0f / sqrtf(tx * tx + ty * ty + tz * tz);
-                    vertices[index].tan[0] = tx * t_inv_len;
-                    vertices[index].tan[1] = ty * t_inv_len;
-                    vertices[index].tan[2] = tz * t_inv_len;
+                    height_field.heights[row * height_field.columns + column] = position(row, column).y;
                 }
+            }
+
+            // grass, rock, snow, sand
+            height_field.surfaces =
+            {
+                { 0.8f, 0.7f, 0.1f  },
+                { 0.9f, 0.8f, 0.2f  },
+                { 0.2f, 0.15f, 0.05f },
+                { 0.6f, 0.5f, 0.05f }
             };
-            ThreadPool::ParallelLoop(compute_edges, edge_count);
+            static_assert(static_cast<size_t>(TerrainSurface::Max) == 4, "surfaces out of sync with TerrainSurface");
+
+            // two triangles per cell, split along the diagonal that doesn't touch the cell's first sample
+            height_field.surfaces_indices.resize(static_cast<size_t>(height_field.rows - 1) * (height_field.columns - 1) * 2);
+            for (uint32_t row = 0; row < height_field.rows - 1; row++)
+            {
+                for (uint32_t column = 0; column < height_field.columns - 1; column++)
+                {
+                    const Vector3& p00 = position(row, column);
+                    const Vector3& p10 = position(row + 1, column);
+                    const Vector3& p01 = position(row, column + 1);
+                    const Vector3& p11 = position(row + 1, column + 1);
+
+                    size_t cell = (static_cast<size_t>(row) * (height_field.columns - 1) + column) * 2;
+                    height_field.surfaces_indices[cell]     = static_cast<uint8_t>(classify_surface(p00, p10, p01, level_sea, level_snow));
+                    height_field.surfaces_indices[cell + 1] = static_cast<uint8_t>(classify_surface(p10, p11, p01, level_sea, level_snow));
+                }
+            }
+
+            return height_field;
+        }
+
+        // the source heights kept by the physics component plus physx's 4 byte samples
+        uint64_t height_field_bytes(const PhysicsHeightField& height_field)
+        {
+            return height_field.heights.size() * (sizeof(float) + 4) + height_field.surfaces_indices.size();
+        }
+
+        // rough size of a chunk with its lod chain, used to keep requests within the budget
+        uint64_t estimate_chunk_bytes(const TerrainChunk& chunk)
+        {
+            uint64_t vertex_count = static_cast<uint64_t>(chunk.width) * chunk.height;
+            uint64_t index_count  = static_cast<uint64_t>(chunk.width - 1) * (chunk.height - 1) * 6;
+            return 2 * (vertex_count * sizeof(RHI_Vertex_PosTexNorTan) + index_count * sizeof(uint32_t));
+        }
+
+        float distance_to(const BoundingBox& aabb, const Vector3& position)
+        {
+            return Vector3::Distance(aabb.GetClosestPoint(position), position);
+        }
+
+        uint32_t build_quad_node(vector<TerrainQuadNode>& nodes, const vector<unique_ptr<TerrainChunk>>& chunks, uint32_t chunk_count_x, uint32_t x0, uint32_t z0, uint32_t x1, uint32_t z1)
+        {
+            uint32_t node_index = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+
+            // leaf
+            if (x1 - x0 == 1 && z1 - z0 == 1)
+            {
+                nodes[node_index].chunk_index = z0 * chunk_count_x + x0;
+                nodes[node_index].aabb        = chunks[nodes[node_index].chunk_index]->aabb;
+                return node_index;
+            }
+
+            // split at the middle, a side that's one chunk wide isn't split
+            uint32_t x_mid = (x1 - x0 > 1) ? (x0 + x1) / 2 : x1;
+            uint32_t z_mid = (z1 - z0 > 1) ? (z0 + z1) / 2 : z1;
+            const uint32_t rects[4][4] =
+            {
+                { x0, z0, x_mid, z_mid }, { x_mid, z0, x1, z_mid },
+                { x0, z_mid, x_mid, z1 }, { x_mid, z_mid, x1, z1 }
+            };
+
+            BoundingBox aabb;
+            uint32_t count   = 0;
+            uint32_t children[4];
+            for (const auto& rect : rects)
+            {
+                if (rect[0] >= rect[2] || rect[1] >= rect[3])
+                    continue;
+
+                children[count] = build_quad_node(nodes, chunks, chunk_count_x, rect[0], rect[1], rect[2], rect[3]);
+                aabb.Merge(nodes[children[count]].aabb);
+                count++;
+            }
+
+            // nodes may have reallocated during recursion
+            TerrainQuadNode& node = nodes[node_index];
+            node.aabb             = aabb;
+            node.child_count      = count;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                node.children[i] = children[i];
+            }
+
+            return node_index;
         }
 
         void apply_perlin_noise(vector<Vector3>& positions, uint32_t width, uint32_t height, float amplitude = 5.0f, float frequency = 0.01f, uint32_t octaves = 4, float persistence = 1.0f)
@@ -1028,9 +1230,147 @@ namespace spartan
 
     Terrain::~Terrain()
     {
+        // in-flight builds write into the chunks
+        while (m_chunk_jobs > 0)
+        {
+            this_thread::yield();
+        }
+
         m_height_map_seed = nullptr;
     }
 
+    void Terrain::Tick()
+    {
+        if (m_is_generating || m_chunks.empty())
+            return;
+
+        Camera* camera = World::GetCamera();
+        if (!camera)
+            return;
+
+        // chunk bounds are relative to the terrain, so bring the camera into terrain space
+        Vector3 camera_position = GetEntity()->GetMatrix().Inverted() * camera->GetEntity()->GetPosition();
+        float distance_stream   = max(cvar_terrain_stream_distance.GetValue(), 0.0f);
+        float distance_evict    = distance_stream * evict_distance_factor;
+        uint64_t budget         = static_cast<uint64_t>(max(cvar_terrain_memory_budget.GetValue(), 0.0f) * 1024.0f * 1024.0f);
+
+        // upload finished chunks and evict the ones that fell out of range
+        uint64_t memory_building = 0;
+        for (unique_ptr<TerrainChunk>& chunk : m_chunks)
+        {
+            TerrainChunkState state = chunk->state;
+            if (state == TerrainChunkState::Built)
+            {
+                UploadChunk(*chunk);
+            }
+            else if (state == TerrainChunkState::Building)
+            {
+                memory_building += estimate_chunk_bytes(*chunk);
+            }
+            else if (chunk->memory_bytes > 0 && distance_to(chunk->aabb, camera_position) > distance_evict)
+            {
+                EvictChunk(*chunk);
+            }
+        }
+
+        // evicts the farthest chunk that is farther than the given distance
+        auto evict_farthest = [this, &camera_position](float distance_min)
+        {
+            TerrainChunk* farthest = nullptr;
+            float distance_max     = distance_min;
+            for (unique_ptr<TerrainChunk>& chunk : m_chunks)
+            {
+                TerrainChunkState state = chunk->state;
+                if (chunk->memory_bytes == 0 || state == TerrainChunkState::Building || state == TerrainChunkState::Built)
+                    continue;
+
+                float distance = distance_to(chunk->aabb, camera_position);
+                if (distance > distance_max)
+                {
+                    distance_max = distance;
+                    farthest     = chunk.get();
+                }
+            }
+
+            if (farthest)
+            {
+                EvictChunk(*farthest);
+            }
+
+            return farthest != nullptr;
+        };
+
+        // the budget can be lowered at runtime
+        while (m_chunk_memory > budget && evict_farthest(-1.0f)) {}
+
+        // gather the chunks in range from the quadtree, out of range nodes skip their whole subtree
+        m_chunks_in_range.clear();
+        vector<uint32_t> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+        while (!stack.empty())
+        {
+            const TerrainQuadNode& node = m_quadtree[stack.back()];
+            stack.pop_back();
+
+            float distance = distance_to(node.aabb, camera_position);
+            if (distance > distance_stream)
+                continue;
+
+            if (node.child_count == 0)
+            {
+                m_chunks_in_range.emplace_back(distance, node.chunk_index);
+                continue;
+            }
+
+            for (uint32_t i = 0; i < node.child_count; i++)
+            {
+                stack.push_back(node.children[i]);
+            }
+        }
+        sort(m_chunks_in_range.begin(), m_chunks_in_range.end());
+
+        // request missing chunks nearest first, room is made by evicting chunks that are farther away
+        for (const auto& [distance, chunk_index] : m_chunks_in_range)
+        {
+            if (m_chunk_jobs >= chunk_jobs_max)
+                break;
+
+            TerrainChunk& chunk = *m_chunks[chunk_index];
+            if (chunk.state != TerrainChunkState::Unloaded)
+                continue;
+
+            uint64_t bytes = estimate_chunk_bytes(chunk);
+            while (m_chunk_memory + memory_building + bytes > budget && evict_farthest(distance)) {}
+            if (m_chunk_memory + memory_building + bytes > budget)
+                break;
+
+            memory_building        += bytes;
+            chunk.state             = TerrainChunkState::Building;
+            TerrainChunk* chunk_ptr = &chunk;
+            m_chunk_jobs++;
+            ThreadPool::AddTask([this, chunk_ptr]()
+            {
+                BuildChunk(*chunk_ptr);
+                m_chunk_jobs--;
+            });
+        }
+    }
+
+    uint32_t Terrain::GetChunkCountResident() const
+    {
+        uint32_t count = 0;
+        for (const unique_ptr<TerrainChunk>& chunk : m_chunks)
+        {
+            if (chunk->state == TerrainChunkState::Resident)
+            {
+                count++;
+            }
+        }
+
+        return count;
+    }
+
     void Terrain::Save(pugi::xml_node& node)
     {
         // height map seed texture path
@@ -1048,6 +1388,7 @@ namespace spartan
         node.append_attribute("density")       = m_density;
         node.append_attribute("scale")         = m_scale;
         node.append_attribute("create_border") = m_create_border;
+        node.append_attribute("collision")     = m_collision;
     }
 
     void Terrain::Load(pugi::xml_node& node)
@@ -1071,6 +1412,7 @@ namespace spartan
         m_density       = node.attribute("density").as_uint(3);
         m_scale         = node.attribute("scale").as_uint(6);
         m_create_border = node.attribute("create_border").as_bool(true);
+        m_collision     = node.attribute("collision").as_bool(false);
 
         // regenerate terrain if we have a height map
         if (m_height_map_seed)
@@ -1079,41 +1421,60 @@ namespace spartan
         }
     }
 
-    uint64_t Terrain::ComputeCacheHash() const
+    Terrain::StageHashes Terrain::ComputeStageHashes() const
     {
-        // hash inputs to detect when cache is stale
+        // every stage hashes its own inputs on top of the previous stage's hash
         uint64_t hash = 14695981039346656037ull; // fnv-1a offset basis
         auto hash_combine = [&hash](uint64_t value) {
             hash ^= value;
             hash *= 1099511628211ull; // fnv-1a prime
         };
+        auto hash_float = [&hash_combine](float value) {
+            uint32_t bits = 0;
+            memcpy(&bits, &value, sizeof(float));
+            hash_combine(bits);
+        };
 
-        hash_combine(static_cast<uint64_t>(m_min_y * 1000));
-        hash_combine(static_cast<uint64_t>(m_max_y * 1000));
-        hash_combine(static_cast<uint64_t>(m_level_sea * 1000));
-        hash_combine(static_cast<uint64_t>(m_level_snow * 1000));
-        hash_combine(m_smoothing);
-        hash_combine(m_density);
-        hash_combine(m_scale);
-        hash_combine(m_create_border ? 1 : 0);
-        
-        if (m_height_map_seed)
-        {
-            hash_combine(m_height_map_seed->GetWidth());
-            hash_combine(m_height_map_seed->GetHeight());
+        StageHashes hashes = {};
+        hash_combine(cache_version);
 
-            // hash the file path (stable across runs) instead of object id (random per run)
-            const string& file_path = m_height_map_seed->GetResourceFilePath();
-            for (char c : file_path)
+        // the seed's pixels rather than its path, so edits to the image are picked up
+        hash_combine(m_height_map_seed->GetWidth());
+        hash_combine(m_height_map_seed->GetHeight());
+        if (RHI_Texture_Mip* mip = m_height_map_seed->GetMip(0, 0))
+        {
+            const vector<byte>& bytes = mip->bytes;
+            size_t i = 0;
+            for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t))
             {
-                hash_combine(static_cast<uint64_t>(c));
+                uint64_t word = 0;
+                memcpy(&word, &bytes[i], sizeof(uint64_t));
+                hash_combine(word);
+            }
+            for (; i < bytes.size(); i++)
+            {
+                hash_combine(static_cast<uint64_t>(bytes[i]));
             }
         }
+        hash_float(m_min_y);
+        hash_float(m_max_y);
+        hashes[static_cast<size_t>(Stage::HeightMap)] = hash;
+
+        hash_combine(m_smoothing);
+        hash_combine(m_create_border ? 1 : 0);
+        hashes[static_cast<size_t>(Stage::Smoothed)] = hash;
+
+        hash_combine(m_density);
+        hashes[static_cast<size_t>(Stage::Densified)] = hash;
 
-        return hash;
+        hash_combine(m_scale);
+        hash_float(m_level_sea);
+        hashes[static_cast<size_t>(Stage::Shaped)] = hash;
+
+        return hashes;
     }
 
-    void Terrain::FindTransforms(const uint32_t tile_index, const TerrainProp terrain_prop, Entity* entity, const float density_fraction, const float scale, vector<Matrix>& transforms_out)
+    void Terrain::FindTransforms(const uint32_t chunk_index, const TerrainProp terrain_prop, Entity* entity, const float density_fraction, const float scale, vector<Matrix>& transforms_out)
     {
         TerrainPropDescription description;
 
@@ -1160,7 +1521,14 @@ namespace spartan
             SP_ASSERT_MSG(false, "unknown terrain prop type");
         }
 
-        placement::find_transforms(description, density_fraction, tile_index, transforms_out, m_triangle_data);
+        shared_ptr<vector<TriangleData>> triangle_data = GetTriangleData(chunk_index);
+        if (!triangle_data)
+        {
+            SP_LOG_ERROR("invalid terrain chunk %u", chunk_index);
+            return;
+        }
+
+        placement::find_transforms(description, density_fraction, chunk_index, transforms_out, *triangle_data);
 
         // compensate for entity scale
         if (entity && entity->GetScale() != Vector3::One && entity->GetScale() != Vector3::Zero)
@@ -1171,155 +1539,35 @@ namespace spartan
         }
     }
 
-    void Terrain::SaveToFile(const char* file_path)
+    shared_ptr<vector<TriangleData>> Terrain::GetTriangleData(uint32_t chunk_index)
     {
-        ofstream file(file_path, ios::binary);
-        if (!file.is_open())
-        {
-            SP_LOG_ERROR("failed to open file for writing: %s", file_path);
-            return;
-        }
-    
-        uint32_t width               = GetWidth();
-        uint32_t height              = GetHeight();
-        uint32_t height_data_size    = static_cast<uint32_t>(m_height_data.size());
-        uint32_t vertex_count        = static_cast<uint32_t>(m_vertices.size());
-        uint32_t index_count         = static_cast<uint32_t>(m_indices.size());
-        uint32_t tile_count          = static_cast<uint32_t>(m_tile_vertices.size());
-        uint32_t triangle_data_count = static_cast<uint32_t>(m_triangle_data.size());
-        uint32_t offset_count        = static_cast<uint32_t>(m_tile_offsets.size());
-        uint32_t position_count      = static_cast<uint32_t>(m_positions.size());
-        uint64_t cache_hash          = ComputeCacheHash();
-    
-        // header
-        file.write(reinterpret_cast<const char*>(&cache_hash), sizeof(uint64_t));
-        file.write(reinterpret_cast<const char*>(&width), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&height), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&height_data_size), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&vertex_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&index_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&tile_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&triangle_data_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&offset_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&position_count), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&m_dense_width), sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(&m_dense_height), sizeof(uint32_t));
-    
-        // main data
-        file.write(reinterpret_cast<const char*>(m_height_data.data()), height_data_size * sizeof(float));
-        file.write(reinterpret_cast<const char*>(m_vertices.data()), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
-        file.write(reinterpret_cast<const char*>(m_indices.data()), index_count * sizeof(uint32_t));
-        file.write(reinterpret_cast<const char*>(m_tile_offsets.data()), offset_count * sizeof(Vector3));
-        file.write(reinterpret_cast<const char*>(m_positions.data()), position_count * sizeof(Vector3));
-    
-        // triangle data
-        for (const auto& [tile_id, tile_triangles] : m_triangle_data)
-        {
-            file.write(reinterpret_cast<const char*>(&tile_id), sizeof(uint64_t));
-            uint32_t triangle_count = static_cast<uint32_t>(tile_triangles.size());
-            file.write(reinterpret_cast<const char*>(&triangle_count), sizeof(uint32_t));
-            file.write(reinterpret_cast<const char*>(tile_triangles.data()), triangle_count * sizeof(TriangleData));
-        }
-    
-        // tile data
-        for (uint32_t i = 0; i < tile_count; i++)
-        {
-            uint32_t vertex_size = static_cast<uint32_t>(m_tile_vertices[i].size());
-            uint32_t index_size  = static_cast<uint32_t>(m_tile_indices[i].size());
-            file.write(reinterpret_cast<const char*>(&vertex_size), sizeof(uint32_t));
-            file.write(reinterpret_cast<const char*>(&index_size), sizeof(uint32_t));
-            file.write(reinterpret_cast<const char*>(m_tile_vertices[i].data()), vertex_size * sizeof(RHI_Vertex_PosTexNorTan));
-            file.write(reinterpret_cast<const char*>(m_tile_indices[i].data()), index_size * sizeof(uint32_t));
-        }
-    
-        file.close();
-        SP_LOG_INFO("saved terrain cache: hash=%llu", cache_hash);
-    }
-    
-    void Terrain::LoadFromFile(const char* file_path)
-    {
-        ifstream file(file_path, ios::binary);
-        if (!file.is_open())
-            return;
-    
-        // verify cache hash matches current parameters
-        uint64_t stored_hash = 0;
-        file.read(reinterpret_cast<char*>(&stored_hash), sizeof(uint64_t));
-        
-        uint64_t current_hash = ComputeCacheHash();
-        if (stored_hash != current_hash)
-        {
-            SP_LOG_INFO("terrain cache invalidated (hash mismatch: %llu vs %llu)", stored_hash, current_hash);
-            file.close();
-            return;
-        }
+        if (chunk_index >= m_chunks.size())
+            return nullptr;
 
-        uint32_t height_data_size    = 0;
-        uint32_t vertex_count        = 0;
-        uint32_t index_count         = 0;
-        uint32_t tile_count          = 0;
-        uint32_t triangle_data_count = 0;
-        uint32_t offset_count        = 0;
-        uint32_t position_count      = 0;
-    
-        file.read(reinterpret_cast<char*>(&m_width), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&m_height), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&height_data_size), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&vertex_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&index_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&tile_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&triangle_data_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&offset_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&position_count), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&m_dense_width), sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(&m_dense_height), sizeof(uint32_t));
-    
-        if (tile_count > 10000 || offset_count > 10000)
+        TerrainChunk& chunk = *m_chunks[chunk_index];
         {
-            SP_LOG_ERROR("invalid tile_count (%u) or offset_count (%u), aborting load", tile_count, offset_count);
-            file.close();
-            return;
+            lock_guard<mutex> lock(m_chunk_mutex);
+            if (chunk.triangle_data)
+                return chunk.triangle_data;
         }
-    
-        m_height_data.resize(height_data_size);
-        m_vertices.resize(vertex_count);
-        m_indices.resize(index_count);
-        m_tile_vertices.resize(tile_count);
-        m_tile_indices.resize(tile_count);
-        m_tile_offsets.resize(offset_count);
-        m_positions.resize(position_count);
-        m_triangle_data.clear();
-    
-        file.read(reinterpret_cast<char*>(m_height_data.data()), height_data_size * sizeof(float));
-        file.read(reinterpret_cast<char*>(m_vertices.data()), vertex_count * sizeof(RHI_Vertex_PosTexNorTan));
-        file.read(reinterpret_cast<char*>(m_indices.data()), index_count * sizeof(uint32_t));
-        file.read(reinterpret_cast<char*>(m_tile_offsets.data()), offset_count * sizeof(Vector3));
-        file.read(reinterpret_cast<char*>(m_positions.data()), position_count * sizeof(Vector3));
-    
-        for (uint32_t i = 0; i < triangle_data_count; i++)
-        {
-            uint64_t tile_id;
-            uint32_t triangle_count;
-            file.read(reinterpret_cast<char*>(&tile_id), sizeof(uint64_t));
-            file.read(reinterpret_cast<char*>(&triangle_count), sizeof(uint32_t));
-            vector<TriangleData>& tile_triangles = m_triangle_data[tile_id];
-            tile_triangles.resize(triangle_count);
-            file.read(reinterpret_cast<char*>(tile_triangles.data()), triangle_count * sizeof(TriangleData));
-        }
-    
-        for (uint32_t i = 0; i < tile_count; i++)
+
+        // built outside the lock so that chunks can be processed in parallel
+        vector<RHI_Vertex_PosTexNorTan> vertices;
+        vector<uint32_t> indices;
+        build_chunk_geometry(m_positions, m_dense_width, m_dense_height, chunk, vertices, indices);
+        shared_ptr<vector<TriangleData>> triangle_data = make_shared<vector<TriangleData>>();
+        placement::compute_triangle_data(vertices, indices, *triangle_data);
+
+        lock_guard<mutex> lock(m_chunk_mutex);
+        if (!chunk.triangle_data)
         {
-            uint32_t vertex_size, index_size;
-            file.read(reinterpret_cast<char*>(&vertex_size), sizeof(uint32_t));
-            file.read(reinterpret_cast<char*>(&index_size), sizeof(uint32_t));
-            m_tile_vertices[i].resize(vertex_size);
-            m_tile_indices[i].resize(index_size);
-            file.read(reinterpret_cast<char*>(m_tile_vertices[i].data()), vertex_size * sizeof(RHI_Vertex_PosTexNorTan));
-            file.read(reinterpret_cast<char*>(m_tile_indices[i].data()), index_size * sizeof(uint32_t));
+            uint64_t bytes       = triangle_data->size() * sizeof(TriangleData);
+            chunk.triangle_data  = triangle_data;
+            chunk.memory_bytes  += bytes;
+            m_chunk_memory      += bytes;
         }
-    
-        file.close();
-        SP_LOG_INFO("loaded terrain from cache: hash=%llu", stored_hash);
+
+        return chunk.triangle_data;
     }
 
     void Terrain::Generate()
@@ -1329,94 +1577,104 @@ namespace spartan
             SP_LOG_WARNING("terrain generation already in progress");
             return;
         }
-    
+
         if (!m_height_map_seed)
         {
             SP_LOG_WARNING("assign a height map before generating terrain");
             return;
         }
-    
+
         m_is_generating = true;
-    
-        uint32_t job_count = 9;
-        ProgressTracker::GetProgress(ProgressType::Terrain).Start(job_count, "generating terrain...");
-    
-        // try loading from cache
-        const string cache_file = "terrain_cache.bin";
-        bool loaded_from_cache  = false;
-
-        LoadFromFile(cache_file.c_str());
-        if (!m_vertices.empty())
+
+        // chunks of a previous generation go away, along with anything placed on them
+        Clear();
+
+        const uint32_t stage_count = static_cast<uint32_t>(Stage::Max);
+        Progress& progress         = ProgressTracker::GetProgress(ProgressType::Terrain);
+        progress.Start(stage_count + 1, "generating terrain...");
+
+        m_width        = m_height_map_seed->GetWidth();
+        m_height       = m_height_map_seed->GetHeight();
+        m_dense_width  = m_density * (m_width - 1) + 1;
+        m_dense_height = m_density * (m_height - 1) + 1;
+
+        // resume from the latest stage whose output is cached, the ones before it aren't needed
+        const StageHashes hashes = ComputeStageHashes();
+        int32_t stage_cached     = -1;
+        for (int32_t stage = stage_count - 1; stage >= 0 && stage_cached == -1; stage--)
         {
-            loaded_from_cache = true;
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("loaded from cache");
-            for (uint32_t i = 0; i < job_count - 1; i++)
-                ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
+            bool loaded = false;
+            switch (static_cast<Stage>(stage))
+            {
+                case Stage::HeightMap:
+                case Stage::Smoothed:  loaded = cache_load(hashes[stage], m_width, m_height, m_height_data);             break;
+                case Stage::Densified: loaded = cache_load(hashes[stage], m_dense_width, m_dense_height, m_height_data); break;
+                case Stage::Shaped:    loaded = cache_load(hashes[stage], m_dense_width, m_dense_height, m_positions);   break;
+                default: break;
+            }
+
+            if (loaded)
+            {
+                stage_cached = stage;
+            }
         }
 
-        if (!loaded_from_cache)
+        const char* stage_names[] = { "height map", "smoothing", "densifying", "shaping" };
+        static_assert(size(stage_names) == static_cast<size_t>(Stage::Max), "stage_names out of sync with Stage");
+
+        for (uint32_t stage = 0; stage < stage_count; stage++)
         {
-            SP_LOG_INFO("generating terrain from scratch...");
-    
-            // 1. process height map
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("processing height map...");
-            get_values_from_height_map(m_height_data, m_height_map_seed, m_min_y, m_max_y, m_smoothing, m_create_border);
-            m_width  = m_height_map_seed->GetWidth();
-            m_height = m_height_map_seed->GetHeight();
-            densify_height_map(m_height_data, m_width, m_height, m_density);
-            m_dense_width  = m_density * (m_width - 1) + 1;
-            m_dense_height = m_density * (m_height - 1) + 1;
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-    
-            // 2. generate positions
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("generating positions...");
-            m_positions.resize(m_dense_width * m_dense_height);
-            generate_positions(m_positions, m_height_data, m_dense_width, m_dense_height, m_density, m_scale);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            // 3. apply perlin noise
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("applying perlin noise...");
-            apply_perlin_noise(m_positions, m_dense_width, m_dense_height);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            // 4. apply erosion
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("applying erosion...");
-            apply_erosion(m_positions, m_dense_width, m_dense_height, m_level_sea);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            // 5. generate vertices and indices
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("generating mesh...");
-            m_vertices.resize(m_dense_width * m_dense_height);
-            m_indices.resize((m_dense_width - 1) * (m_dense_height - 1) * 6);
-            generate_vertices_and_indices(m_vertices, m_indices, m_positions, m_dense_width, m_dense_height);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-    
-            // 6. generate normals
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("generating normals...");
-            generate_normals(m_vertices, m_dense_width, m_dense_height);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-    
-            // 7. split into tiles
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("splitting into tiles...");
-            uint32_t tile_count = 16;
-            geometry_processing::split_surface_into_tiles(m_vertices, m_indices, tile_count, m_tile_vertices, m_tile_indices, m_tile_offsets);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            // 8. compute triangle data for placement
-            ProgressTracker::GetProgress(ProgressType::Terrain).SetText("computing placement data...");
-            for (uint32_t tile_index = 0; tile_index < m_tile_vertices.size(); tile_index++)
-                placement::compute_triangle_data(m_tile_vertices, m_tile_indices, tile_index, m_triangle_data);
-            ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-
-            SaveToFile(cache_file.c_str());
+            if (static_cast<int32_t>(stage) <= stage_cached)
+            {
+                progress.SetText(string(stage_names[stage]) + ": cached");
+                progress.JobDone();
+                continue;
+            }
+
+            progress.SetText(string(stage_names[stage]) + "...");
+            uint64_t hash = hashes[stage];
+            switch (static_cast<Stage>(stage))
+            {
+                case Stage::HeightMap:
+                {
+                    get_values_from_height_map(m_height_data, m_height_map_seed, m_min_y, m_max_y);
+                    cache_save(hash, m_width, m_height, m_height_data);
+                    break;
+                }
+                case Stage::Smoothed:
+                {
+                    smooth_height_map(m_height_data, m_width, m_height, m_min_y, m_smoothing, m_create_border);
+                    cache_save(hash, m_width, m_height, m_height_data);
+                    break;
+                }
+                case Stage::Densified:
+                {
+                    densify_height_map(m_height_data, m_width, m_height, m_density);
+                    cache_save(hash, m_dense_width, m_dense_height, m_height_data);
+                    break;
+                }
+                case Stage::Shaped:
+                {
+                    m_positions.resize(m_dense_width * m_dense_height);
+                    generate_positions(m_positions, m_height_data, m_dense_width, m_dense_height, m_density, m_scale);
+                    apply_perlin_noise(m_positions, m_dense_width, m_dense_height);
+                    apply_erosion(m_positions, m_dense_width, m_dense_height, m_level_sea);
+                    cache_save(hash, m_dense_width, m_dense_height, m_positions);
+                    break;
+                }
+                default: break;
+            }
+            progress.JobDone();
         }
 
+        SP_LOG_INFO("terrain: %d of %u generation stages came from the cache", stage_cached + 1, stage_count);
+
         // bake height map texture
         {
             vector<RHI_Texture_Slice> data(1);
             data[0].mips.resize(1);
             data[0].mips[0].bytes.resize(m_dense_width * m_dense_height * sizeof(float));
-        
+
             float* height_ptr = reinterpret_cast<float*>(data[0].mips[0].bytes.data());
             auto copy_heights = [this, height_ptr](uint32_t start, uint32_t end)
             {
@@ -1424,7 +1682,7 @@ namespace spartan
                     height_ptr[i] = m_positions[i].y;
             };
             ThreadPool::ParallelLoop(copy_heights, m_dense_width * m_dense_height);
-        
+
             m_height_map_final = make_shared<RHI_Texture>(
                 RHI_Texture_Type::Type2D,
                 m_dense_width, m_dense_height, 1, 1,
@@ -1432,64 +1690,210 @@ namespace spartan
                 "terrain_baked", data
             );
         }
-    
-        // compute stats
+
+        // compute stats (full resolution, regardless of what is resident)
         m_height_samples = m_dense_width * m_dense_height;
-        m_vertex_count   = static_cast<uint32_t>(m_vertices.size());
-        m_index_count    = static_cast<uint32_t>(m_indices.size());
+        m_vertex_count   = m_dense_width * m_dense_height;
+        m_index_count    = (m_dense_width - 1) * (m_dense_height - 1) * 6;
         m_triangle_count = m_index_count / 3;
-        m_area_km2       = compute_surface_area_km2(m_vertices, m_indices);
+        m_area_km2       = compute_surface_area_km2(m_positions, m_dense_width, m_dense_height);
 
-        // 9. create tile entities and gpu buffers
-        ProgressTracker::GetProgress(ProgressType::Terrain).SetText("creating gpu mesh...");
-        m_mesh = make_shared<Mesh>();
-        m_mesh->SetObjectName("terrain_mesh");
-        m_mesh->SetFlag(static_cast<uint32_t>(MeshFlags::PostProcessOptimize), false);
-        m_mesh->SetFlag(static_cast<uint32_t>(MeshFlags::PostProcessPreserveTerrainEdges), true);
+        // create chunks, their geometry is streamed in around the camera
+        progress.SetText("creating chunks...");
+        CreateChunks();
+        progress.JobDone();
 
-        for (uint32_t tile_index = 0; tile_index < static_cast<uint32_t>(m_tile_vertices.size()); tile_index++)
+        m_is_generating = false;
+    }
+
+    void Terrain::CreateChunks()
+    {
+        uint32_t chunk_count_x = max(1u, (m_dense_width - 1 + chunk_quads - 1) / chunk_quads);
+        uint32_t chunk_count_z = max(1u, (m_dense_height - 1 + chunk_quads - 1) / chunk_quads);
+        uint32_t chunk_count   = chunk_count_x * chunk_count_z;
+
+        m_chunks.resize(chunk_count);
+        for (uint32_t z = 0; z < chunk_count_z; z++)
+        {
+            for (uint32_t x = 0; x < chunk_count_x; x++)
+            {
+                unique_ptr<TerrainChunk> chunk = make_unique<TerrainChunk>();
+                chunk->x                       = x * chunk_quads;
+                chunk->z                       = z * chunk_quads;
+                chunk->width                   = min(chunk_quads, m_dense_width - 1 - chunk->x) + 1;
+                chunk->height                  = min(chunk_quads, m_dense_height - 1 - chunk->z) + 1;
+                m_chunks[z * chunk_count_x + x] = move(chunk);
+            }
+        }
+
+        // bounds, this touches the whole height field so it runs in parallel
+        auto compute_bounds = [this](uint32_t start_index, uint32_t end_index)
+        {
+            for (uint32_t index = start_index; index < end_index; index++)
+            {
+                TerrainChunk& chunk = *m_chunks[index];
+                Vector3 position_min = Vector3::Infinity;
+                Vector3 position_max = Vector3::InfinityNeg;
+                for (uint32_t j = 0; j < chunk.height; j++)
+                {
+                    for (uint32_t i = 0; i < chunk.width; i++)
+                    {
+                        const Vector3& position = m_positions[(chunk.z + j) * m_dense_width + chunk.x + i];
+                        position_min            = Vector3::Min(position_min, position);
+                        position_max            = Vector3::Max(position_max, position);
+                    }
+                }
+
+                chunk.aabb   = BoundingBox(position_min, position_max);
+                chunk.offset = Vector3(chunk.aabb.GetCenter().x, 0.0f, chunk.aabb.GetCenter().z);
+            }
+        };
+        ThreadPool::ParallelLoop(compute_bounds, chunk_count);
+
+        // entities, a chunk's index is also its index among the terrain's children
+        for (uint32_t index = 0; index < chunk_count; index++)
         {
-            uint32_t sub_mesh_index = 0;
-            m_mesh->AddGeometry(m_tile_vertices[tile_index], m_tile_indices[tile_index], true, &sub_mesh_index);
-            
             Entity* entity = World::CreateEntity();
-            entity->SetObjectName("tile_" + to_string(tile_index + 1));
+            entity->SetObjectName("chunk_" + to_string(index));
             entity->SetParent(GetEntity());
-            entity->SetPosition(m_tile_offsets[tile_index]);
+            entity->SetPosition(m_chunks[index]->offset);
+            m_chunks[index]->entity = entity;
+        }
+
+        m_quadtree.clear();
+        m_quadtree.reserve(chunk_count * 2);
+        build_quad_node(m_quadtree, m_chunks, chunk_count_x, 0, 0, chunk_count_x, chunk_count_z);
 
-            if (Renderable* renderable = entity->AddComponent<Renderable>())
+        // build the chunks around the camera right away, so there is ground (and collision) on the first frame
+        if (Camera* camera = World::GetCamera())
+        {
+            Vector3 camera_position = GetEntity()->GetMatrix().Inverted() * camera->GetEntity()->GetPosition();
+            float distance_max      = m_chunks[0]->aabb.GetSize().x;
+
+            vector<TerrainChunk*> chunks_near;
+            for (unique_ptr<TerrainChunk>& chunk : m_chunks)
             {
-                renderable->SetMesh(m_mesh.get(), sub_mesh_index);
-                renderable->SetMaterial(m_material);
+                if (distance_to(chunk->aabb, camera_position) <= distance_max)
+                {
+                    chunks_near.push_back(chunk.get());
+                }
             }
+
+            auto build_chunks = [this, &chunks_near](uint32_t start_index, uint32_t end_index)
+            {
+                for (uint32_t index = start_index; index < end_index; index++)
+                {
+                    BuildChunk(*chunks_near[index]);
+                }
+            };
+            ThreadPool::ParallelLoop(build_chunks, static_cast<uint32_t>(chunks_near.size()));
         }
-    
-        m_mesh->CreateGpuBuffers();
-        ProgressTracker::GetProgress(ProgressType::Terrain).JobDone();
-    
-        // free temporary data
-        m_vertices.clear();
-        m_indices.clear();
-        m_tile_vertices.clear();
-        m_tile_indices.clear();
 
-        m_is_generating = false;
+        SP_LOG_INFO("terrain split into %ux%u chunks", chunk_count_x, chunk_count_z);
+    }
+
+    void Terrain::BuildChunk(TerrainChunk& chunk)
+    {
+        vector<RHI_Vertex_PosTexNorTan> vertices;
+        vector<uint32_t> indices;
+        build_chunk_geometry(m_positions, m_dense_width, m_dense_height, chunk, vertices, indices);
+
+        // the lod chain keeps the border vertices locked, so neighbors at different lods still meet without cracks
+        shared_ptr<Mesh> mesh = make_shared<Mesh>();
+        mesh->SetObjectName("terrain_" + chunk.entity->GetObjectName());
+        mesh->SetFlag(static_cast<uint32_t>(MeshFlags::PostProcessOptimize), false);
+        mesh->SetFlag(static_cast<uint32_t>(MeshFlags::PostProcessPreserveTerrainEdges), true);
+        mesh->AddGeometry(vertices, indices, true);
+
+        chunk.mesh  = mesh;
+        chunk.state = TerrainChunkState::Built;
+    }
+
+    void Terrain::UploadChunk(TerrainChunk& chunk)
+    {
+        chunk.mesh->CreateGpuBuffers();
+
+        if (Renderable* renderable = chunk.entity->AddComponent<Renderable>())
+        {
+            renderable->SetMesh(chunk.mesh.get());
+            renderable->SetMaterial(m_material);
+        }
+
+        uint64_t bytes = chunk.mesh->GetMemoryUsage();
+
+        if (m_collision)
+        {
+            Physics* physics = chunk.entity->AddComponent<Physics>();
+            physics->SetHeightField(build_chunk_height_field(m_positions, m_dense_width, chunk, m_level_sea, m_level_snow));
+            physics->SetBodyType(BodyType::HeightField);
+            bytes += height_field_bytes(physics->GetHeightField());
+        }
+
+        chunk.memory_bytes += bytes;
+        m_chunk_memory     += bytes;
+        chunk.state         = TerrainChunkState::Resident;
+    }
+
+    void Terrain::EvictChunk(TerrainChunk& chunk)
+    {
+        if (chunk.state == TerrainChunkState::Resident)
+        {
+            uint64_t bytes = chunk.mesh->GetMemoryUsage();
+
+            if (Physics* physics = chunk.entity->GetComponent<Physics>(); physics && physics->GetBodyType() == BodyType::HeightField)
+            {
+                bytes += height_field_bytes(physics->GetHeightField());
+                chunk.entity->RemoveComponentById(physics->GetObjectId());
+            }
+
+            if (Renderable* renderable = chunk.entity->GetComponent<Renderable>())
+            {
+                chunk.entity->RemoveComponentById(renderable->GetObjectId());
+            }
+
+            chunk.memory_bytes -= bytes;
+            m_chunk_memory     -= bytes;
+            chunk.mesh          = nullptr; // gives its geometry buffer ranges back
+            chunk.state         = TerrainChunkState::Unloaded;
+        }
+
+        // placement data, whoever is still using it holds a reference
+        lock_guard<mutex> lock(m_chunk_mutex);
+        if (chunk.triangle_data)
+        {
+            uint64_t bytes      = chunk.triangle_data->size() * sizeof(TriangleData);
+            chunk.memory_bytes -= bytes;
+            m_chunk_memory     -= bytes;
+            chunk.triangle_data = nullptr;
+        }
     }
 
     void Terrain::Clear()
     {
-        m_vertices.clear();
-        m_indices.clear();
-        m_tile_vertices.clear();
-        m_tile_indices.clear();
-        m_triangle_data.clear();
-        ResourceCache::Remove(m_mesh);
-        m_mesh = nullptr;
-
-        for (Entity* child : m_entity_ptr->GetChildren())
+        // in-flight builds write into the chunks
+        while (m_chunk_jobs > 0)
         {
-            if (Renderable* renderable = child->AddComponent<Renderable>())
-                renderable->SetMesh(nullptr);
+            this_thread::yield();
         }
+
+        for (unique_ptr<TerrainChunk>& chunk : m_chunks)
+        {
+            // built but never uploaded chunks just drop their mesh
+            if (chunk->state == TerrainChunkState::Built)
+            {
+                chunk->state = TerrainChunkState::Unloaded;
+            }
+
+            // renderables go right away, entity removal is deferred and the meshes are about to be freed
+            EvictChunk(*chunk);
+            World::RemoveEntity(chunk->entity);
+        }
+
+        m_chunks.clear();
+        m_quadtree.clear();
+        m_chunks_in_range.clear();
+        m_positions.clear();
+        m_height_data.clear();
+        m_chunk_memory = 0;
     }
 }
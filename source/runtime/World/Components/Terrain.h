@@ -23,10 +23,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =========================
 #include "Component.h"
+#include <array>
 #include <atomic>
-#include <unordered_map>
+#include <mutex>
 #include "../../RHI/RHI_Definitions.h"
 #include "../../Math/Quaternion.h"
+#include "../../Math/BoundingBox.h"
 //====================================
 
 namespace spartan
@@ -75,12 +77,47 @@ namespace spartan
         math::Vector3 centroid;
     };
 
+    enum class TerrainChunkState : uint8_t
+    {
+        Unloaded, // no geometry
+        Building, // geometry and lods are being built on a worker thread
+        Built,    // waiting for the main thread to upload it
+        Resident  // uploaded and rendered
+    };
+
+    // a region of the height field with its own mesh and lod chain, streamed in and out around the camera
+    struct TerrainChunk
+    {
+        uint32_t x      = 0; // first column in the height field
+        uint32_t z      = 0; // first row in the height field
+        uint32_t width  = 0; // columns, the last one is shared with the neighbor
+        uint32_t height = 0; // rows, the last one is shared with the neighbor
+        math::Vector3 offset;   // center, relative to the terrain
+        math::BoundingBox aabb; // relative to the terrain
+        Entity* entity = nullptr;
+        std::shared_ptr<Mesh> mesh;
+        std::shared_ptr<std::vector<TriangleData>> triangle_data; // placement data, built on demand
+        std::atomic<uint64_t> memory_bytes    = 0;
+        std::atomic<TerrainChunkState> state = TerrainChunkState::Unloaded;
+    };
+
+    // quadtree over the chunks, lets streaming skip whole regions that are out of range
+    struct TerrainQuadNode
+    {
+        math::BoundingBox aabb;
+        uint32_t children[4] = { 0, 0, 0, 0 };
+        uint32_t child_count = 0;
+        uint32_t chunk_index = 0; // valid for leaves (no children)
+    };
+
     class Terrain : public Component
     {
     public:
         Terrain(Entity* entity);
         ~Terrain();
 
+        // component
+        void Tick() override;
 
         // height map
         RHI_Texture* GetHeightMapSeed() const          { return m_height_map_seed; }
@@ -112,6 +149,8 @@ namespace spartan
         void SetScale(uint32_t scale)             { m_scale = scale; }
         bool GetCreateBorder() const              { return m_create_border; }
         void SetCreateBorder(bool create)         { m_create_border = create; }
+        bool GetCollision() const                 { return m_collision; }
+        void SetCollision(bool collision)         { m_collision = collision; } // resident chunks get a physics body
 
         // stats
         float GetArea() const                   { return m_area_km2; }
@@ -121,10 +160,16 @@ namespace spartan
         float* GetHeightData()                  { return !m_height_data.empty() ? &m_height_data[0] : nullptr; }
         std::shared_ptr<Material> GetMaterial() { return m_material; }
 
+        // streaming
+        uint32_t GetChunkCount() const         { return static_cast<uint32_t>(m_chunks.size()); }
+        Entity* GetChunkEntity(uint32_t index) { return index < m_chunks.size() ? m_chunks[index]->entity : nullptr; }
+        uint32_t GetChunkCountResident() const;
+        uint64_t GetChunkMemoryUsage() const   { return m_chunk_memory; }
+
         // generation
         void Generate();
         void FindTransforms(
-            const uint32_t tile_index,
+            const uint32_t chunk_index,
             const TerrainProp terrain_prop,
             Entity* entity,
             const float density_fraction,
@@ -136,16 +181,29 @@ namespace spartan
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
 
-        // cache io
-        void SaveToFile(const char* file_path);
-        void LoadFromFile(const char* file_path);
-
-        // triangle data access for placement system
-        std::unordered_map<uint64_t, std::vector<TriangleData>>& GetTriangleData() { return m_triangle_data; }
+        // placement data of a chunk, built if it's not in memory
+        std::shared_ptr<std::vector<TriangleData>> GetTriangleData(uint32_t chunk_index);
 
     private:
         void Clear();
-        uint64_t ComputeCacheHash() const;
+
+        // generation stages, each one's output is cached under a hash of its inputs and those of the stages before it
+        enum class Stage : uint8_t
+        {
+            HeightMap, // seed pixels mapped to heights
+            Smoothed,  // smoothing and border mountains
+            Densified, // upsampled by the density
+            Shaped,    // positions with noise and erosion
+            Max
+        };
+        using StageHashes = std::array<uint64_t, static_cast<size_t>(Stage::Max)>;
+        StageHashes ComputeStageHashes() const;
+
+        // chunks
+        void CreateChunks();
+        void BuildChunk(TerrainChunk& chunk);
+        void UploadChunk(TerrainChunk& chunk);
+        void EvictChunk(TerrainChunk& chunk);
 
         // textures
         RHI_Texture* m_height_map_seed                  = nullptr;
@@ -160,6 +218,7 @@ namespace spartan
         uint32_t m_density     = 3;
         uint32_t m_scale       = 6;
         bool m_create_border   = true;
+        bool m_collision       = false;
 
         // runtime state
         uint32_t m_width                  = 0;
@@ -173,18 +232,17 @@ namespace spartan
         uint32_t m_dense_width            = 0;
         uint32_t m_dense_height           = 0;
 
-        // geometry data
-        std::vector<float> m_height_data;
-        std::vector<std::vector<RHI_Vertex_PosTexNorTan>> m_tile_vertices;
-        std::vector<RHI_Vertex_PosTexNorTan> m_vertices;
-        std::vector<uint32_t> m_indices;
-        std::vector<std::vector<uint32_t>> m_tile_indices;
-        std::shared_ptr<Mesh> m_mesh;
-        std::shared_ptr<Material> m_material;
-        std::vector<math::Vector3> m_tile_offsets;
+        // height field, stays in memory so chunks can be built on demand
+        std::vector<float> m_height_data; // densified heights, empty when the positions came straight from the cache
         std::vector<math::Vector3> m_positions;
+        std::shared_ptr<Material> m_material;
 
-        // placement data (per-terrain, not static)
-        std::unordered_map<uint64_t, std::vector<TriangleData>> m_triangle_data;
+        // chunks
+        std::vector<std::unique_ptr<TerrainChunk>> m_chunks;
+        std::vector<TerrainQuadNode> m_quadtree;
+        std::vector<std::pair<float, uint32_t>> m_chunks_in_range; // distance, chunk index
+        std::atomic<uint64_t> m_chunk_memory = 0;
+        std::atomic<uint32_t> m_chunk_jobs   = 0;
+        std::mutex m_chunk_mutex; // guards triangle data
     };
 }
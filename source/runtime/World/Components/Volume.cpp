@@ -52,7 +52,9 @@ namespace spartan
         }
 
         // register attributes for copy/paste and cloning
-        SP_REGISTER_ATTRIBUTE_GET_SET(GetReverbEnabled, SetReverbEnabled, bool);
+        SP_REGISTER_ATTRIBUTES(
+            SP_ATTRIBUTE_GET_SET(GetReverbEnabled, SetReverbEnabled)
+        );
     }
 
     void Volume::Tick()
@@ -126,6 +128,15 @@ namespace spartan
         m_reverb_enabled = node.attribute("reverb_enabled").as_bool(false);
     }
 
+    void Volume::CopyFromPrototype(const Component* prototype)
+    {
+        const Volume* volume = static_cast<const Volume*>(prototype);
+
+        m_bounding_box   = volume->m_bounding_box;
+        m_options        = volume->m_options;
+        m_reverb_enabled = volume->m_reverb_enabled;
+    }
+
     void Volume::SetOption(const char* name, float value)
     {
         m_options[name] = value;
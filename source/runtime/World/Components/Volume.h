@@ -42,6 +42,7 @@ namespace spartan
         void Tick() override;
         void Save(pugi::xml_node& node) override;
         void Load(pugi::xml_node& node) override;
+        void CopyFromPrototype(const Component* prototype) override;
         //=================================
 
         // box
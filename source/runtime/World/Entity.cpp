@@ -59,7 +59,7 @@ namespace spartan
             clone->SetScale(entity->GetScaleLocal());
 
             // clone all the components
-            for (shared_ptr<Component> component_original : entity->GetAllComponents())
+            for (const shared_ptr<Component>& component_original : entity->GetAllComponents())
             {
                 if (component_original != nullptr)
                 {
@@ -67,7 +67,7 @@ namespace spartan
                     Component* component_clone = clone->AddComponent(component_original->GetType());
 
                     // component's properties
-                    component_clone->SetAttributes(component_original->GetAttributes());
+                    component_clone->CopyAttributesFrom(component_original.get());
                 }
             }
 
@@ -103,6 +103,9 @@ namespace spartan
     {
         m_components.fill(nullptr);
 
+        // entities that never joined the world (or left it without being unregistered) can still have changes queued
+        World::UnmarkEntity(this);
+
         // if this entity is selected, deselect it
         if (Camera* camera = World::GetCamera())
         {
@@ -435,6 +438,15 @@ namespace spartan
             return;
 
         m_is_active = active;
+
+        // descendants inherit the active state, so they change too
+        OnComponentsChanged();
+        vector<Entity*> descendants;
+        GetDescendants(&descendants);
+        for (Entity* descendant : descendants)
+        {
+            descendant->OnComponentsChanged();
+        }
     }
 
     Component* Entity::GetComponentByType(ComponentType Type) const
@@ -493,13 +505,23 @@ namespace spartan
 
         component->SetType(Type);
         component->Initialize();
+        OnComponentsChanged();
 
         return component.get();
     }
 
     void Entity::RemoveComponentByType(ComponentType Type)
     {
-        m_components[static_cast<uint32_t>(Type)] = nullptr;
+        shared_ptr<Component>& component = m_components[static_cast<uint32_t>(Type)];
+        if (!component)
+            return;
+
+        {
+            // raycasts from other threads may be reading the renderable
+            unique_lock<mutex> lock = Type == ComponentType::Renderable ? World::LockRaycasts() : unique_lock<mutex>();
+            component = nullptr;
+        }
+        OnComponentsChanged();
     }
 
     Component* Entity::AddComponent(const ComponentType type)
@@ -529,13 +551,22 @@ namespace spartan
                 if (id == component->GetObjectId())
                 {
                     component->Remove();
-                    component = nullptr;
+                    {
+                        unique_lock<mutex> lock = component->GetType() == ComponentType::Renderable ? World::LockRaycasts() : unique_lock<mutex>();
+                        component = nullptr;
+                    }
+                    OnComponentsChanged();
                     break;
                 }
             }
         }
     }
 
+    void Entity::OnComponentsChanged()
+    {
+        World::MarkEntityChanged(this);
+    }
+
     uint32_t Entity::GetComponentCount() const
     {
         uint32_t count = 0;
@@ -581,6 +612,7 @@ namespace spartan
 
         // mark update
         m_time_since_last_transform_sec = 0.0f;
+        m_transform_revision++;
 
         // update children
         for (Entity* child : m_children)
@@ -589,6 +621,18 @@ namespace spartan
         }
     }
 
+    void Entity::SetTransformLocal(const Vector3& position, const Quaternion& rotation, const Vector3& scale, const bool update)
+    {
+        m_position_local = position;
+        m_rotation_local = rotation;
+        m_scale_local    = scale;
+
+        if (update)
+        {
+            UpdateTransform();
+        }
+    }
+
     void Entity::SetPosition(const Vector3& position)
     {
         if (GetPosition() == position)
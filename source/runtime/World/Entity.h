@@ -88,6 +88,7 @@ namespace spartan
             // initialize component
             component->SetType(type);
             component->Initialize();
+            OnComponentsChanged();
 
             return component.get();
         }
@@ -107,8 +108,7 @@ namespace spartan
         template <class T>
         void RemoveComponent()
         {
-            const ComponentType component_type = Component::TypeToEnum<T>();
-            m_components[static_cast<uint32_t>(component_type)] = nullptr;
+            RemoveComponentByType(Component::TypeToEnum<T>());
         }
 
         bool IsActive() const { return m_is_active; }
@@ -138,6 +138,12 @@ namespace spartan
         void SetScaleLocal(const math::Vector3& scale);
         //========================================================================
 
+        //= TRANSFORM ===================================================================================================================
+        // sets the whole local transform with a single update, bulk writers (e.g. snapshots) can defer the update and call UpdateTransform() on the roots
+        void SetTransformLocal(const math::Vector3& position, const math::Quaternion& rotation, const math::Vector3& scale, const bool update = true);
+        void UpdateTransform();
+        //===============================================================================================================================
+
         //= TRANSLATION/ROTATION ==================
         void Translate(const math::Vector3& delta);
         void Rotate(const math::Quaternion& delta);
@@ -170,11 +176,10 @@ namespace spartan
         std::vector<Entity*>& GetChildren()       { return m_children; }
         //===============================================================================================
 
-        const math::Matrix& GetMatrix() const              { return m_matrix; }
-        const math::Matrix& GetLocalMatrix() const         { return m_matrix_local; }
-        const math::Matrix& GetMatrixPrevious() const      { return m_matrix_previous; }
-        void SetMatrixPrevious(const math::Matrix& matrix) { m_matrix_previous = matrix; }
-        float GetTimeSinceLastTransform() const            { return m_time_since_last_transform_sec; }
+        const math::Matrix& GetMatrix() const      { return m_matrix; }
+        const math::Matrix& GetLocalMatrix() const { return m_matrix_local; }
+        float GetTimeSinceLastTransform() const    { return m_time_since_last_transform_sec; }
+        uint64_t GetTransformRevision() const      { return m_transform_revision; } // bumped on every transform update
 
         // prefab support - if set, this entity saves as a prefab reference instead of its children
         void SetPrefabData(const std::string& type, const std::unordered_map<std::string, std::string>& attributes);
@@ -196,17 +201,16 @@ namespace spartan
         bool m_transient              = false; // transient entities are not serialized
         std::array<std::shared_ptr<Component>, static_cast<uint32_t>(ComponentType::Max)> m_components;
 
-        void UpdateTransform();
         math::Matrix GetParentTransformMatrix();
+        void OnComponentsChanged(); // lets the world update its registries on the next tick
 
         // local
         math::Vector3 m_position_local    = math::Vector3::Zero;
         math::Quaternion m_rotation_local = math::Quaternion::Identity;
         math::Vector3 m_scale_local       = math::Vector3::One;
 
-        math::Matrix m_matrix          = math::Matrix::Identity;
-        math::Matrix m_matrix_previous = math::Matrix::Identity;
-        math::Matrix m_matrix_local    = math::Matrix::Identity;
+        math::Matrix m_matrix       = math::Matrix::Identity;
+        math::Matrix m_matrix_local = math::Matrix::Identity;
 
         // computed during UpdateTransform() and cached for performance
         math::Vector3 m_forward  = math::Vector3::Zero;
@@ -223,6 +227,7 @@ namespace spartan
         std::mutex m_mutex_children;
         std::mutex m_mutex_parent;
         float m_time_since_last_transform_sec = 0.0f;
+        uint64_t m_transform_revision         = 0;
 
         // prefab data (if this entity was created from a prefab)
         std::string m_prefab_type;
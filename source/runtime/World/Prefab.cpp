@@ -27,12 +27,144 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../FileSystem/FileSystem.h"
 //====================================
 
-//= NAMESPACES =====
+//= NAMESPACES ===============
 using namespace std;
-//==================
+using namespace spartan::math;
+//============================
 
 namespace spartan
 {
+    namespace
+    {
+        mutex mutex_templates;
+        unordered_map<string, shared_ptr<PrefabTemplate>> templates;
+
+        Vector3 parse_vector3(const pugi::xml_node& node, const char* name, const Vector3& fallback)
+        {
+            pugi::xml_attribute attribute = node.attribute(name);
+            if (!attribute)
+                return fallback;
+
+            Vector3 value = fallback;
+            stringstream ss(attribute.as_string());
+            ss >> value.x >> value.y >> value.z;
+            return value;
+        }
+
+        Quaternion parse_quaternion(const pugi::xml_node& node, const char* name)
+        {
+            pugi::xml_attribute attribute = node.attribute(name);
+            if (!attribute)
+                return Quaternion::Identity;
+
+            Quaternion value = Quaternion::Identity;
+            stringstream ss(attribute.as_string());
+            ss >> value.x >> value.y >> value.z >> value.w;
+            return value;
+        }
+
+        // splits the children of a prefab or entity node into components, a nested prefab reference and child entities
+        void parse_components(const pugi::xml_node& node, vector<PrefabTemplate::ComponentData>& components, pugi::xml_node* prefab)
+        {
+            for (pugi::xml_node component_node = node.first_child(); component_node; component_node = component_node.next_sibling())
+            {
+                string type_name = component_node.name();
+                if (type_name == "Entity")
+                    continue;
+
+                if (type_name == "prefab")
+                {
+                    if (prefab)
+                    {
+                        *prefab = component_node;
+                    }
+                    continue;
+                }
+
+                ComponentType type = Component::StringToType(type_name);
+                if (type != ComponentType::Max)
+                {
+                    components.push_back({ type, component_node });
+                }
+            }
+        }
+
+        void parse_entities(const pugi::xml_node& node, const int32_t parent, vector<PrefabTemplate::Node>& nodes)
+        {
+            for (pugi::xml_node child_node = node.child("Entity"); child_node; child_node = child_node.next_sibling("Entity"))
+            {
+                PrefabTemplate::Node entry;
+                entry.name     = child_node.attribute("name").as_string();
+                entry.parent   = parent;
+                entry.active   = child_node.attribute("active").as_bool(true);
+                entry.position = parse_vector3(child_node, "position", Vector3::Zero);
+                entry.rotation = parse_quaternion(child_node, "rotation");
+                entry.scale    = parse_vector3(child_node, "scale", Vector3::One);
+                parse_components(child_node, entry.components, &entry.prefab);
+
+                nodes.push_back(move(entry));
+                parse_entities(child_node, static_cast<int32_t>(nodes.size()) - 1, nodes);
+            }
+        }
+
+        // loads the components that instances can copy once, into an entity that never joins the world
+        void load_prototypes(vector<PrefabTemplate::ComponentData>& components, vector<unique_ptr<Entity>>& prototypes)
+        {
+            Entity* entity = nullptr;
+            for (PrefabTemplate::ComponentData& data : components)
+            {
+                if (!Component::IsCopyableFromPrototype(data.type))
+                    continue;
+
+                if (!entity)
+                {
+                    prototypes.push_back(make_unique<Entity>());
+                    entity = prototypes.back().get();
+                }
+
+                if (Component* component = entity->AddComponent(data.type))
+                {
+                    pugi::xml_node component_node = data.node;
+                    component->Load(component_node);
+                    data.prototype = component;
+                }
+            }
+        }
+
+        // mirrors the prefab reference handling of Entity::Load
+        void load_prefab_reference(pugi::xml_node node, Entity* entity)
+        {
+            string prefab_type = node.attribute("type").as_string();
+            string prefab_file = node.attribute("file").as_string();
+
+            unordered_map<string, string> prefab_attributes;
+            for (pugi::xml_attribute attr = node.first_attribute(); attr; attr = attr.next_attribute())
+            {
+                string attr_name = attr.name();
+                if (attr_name == "file")
+                    continue;
+                prefab_attributes[attr_name] = attr.value();
+            }
+            entity->SetPrefabData(prefab_type, prefab_attributes);
+
+            if (!prefab_file.empty())
+            {
+                entity->SetPrefabFilePath(prefab_file);
+            }
+
+            if (!prefab_type.empty() && Prefab::IsRegistered(prefab_type))
+            {
+                Prefab::Create(node, entity);
+            }
+            else if (!prefab_file.empty())
+            {
+                Prefab::LoadFromFile(prefab_file, entity);
+            }
+        }
+    }
+
+    PrefabTemplate::~PrefabTemplate() = default;
+
     unordered_map<string, PrefabCreateFn>& Prefab::GetRegistry()
     {
         static unordered_map<string, PrefabCreateFn> registry;
@@ -126,6 +258,12 @@ namespace spartan
             return false;
         }
 
+        // instances spawned from now on should see the new content
+        {
+            lock_guard<mutex> lock(mutex_templates);
+            templates.erase(file_path);
+        }
+
         SP_LOG_INFO("Saved prefab to: %s", file_path.c_str());
         return true;
     }
@@ -138,63 +276,139 @@ namespace spartan
             return false;
         }
 
+        shared_ptr<const PrefabTemplate> prefab = GetTemplate(file_path);
+        if (!prefab)
+            return false;
+
+        // the parent is the instance root, it receives the components defined on the prefab node
+        vector<Entity*> entities(prefab->nodes.size() + 1);
+        entities[0] = parent;
+        for (size_t i = 1; i < entities.size(); i++)
+        {
+            entities[i] = World::CreateEntity();
+        }
+
+        InstantiateHierarchy(*prefab, entities.data());
+        InstantiateComponents(*prefab, entities.data());
+
+        return true;
+    }
+
+    vector<string> Prefab::GetRegisteredTypes()
+    {
+        vector<string> types;
+        for (const auto& [name, fn] : GetRegistry())
+        {
+            types.push_back(name);
+        }
+        return types;
+    }
+
+    shared_ptr<const PrefabTemplate> Prefab::GetTemplate(const string& file_path)
+    {
+        lock_guard<mutex> lock(mutex_templates);
+
+        auto it = templates.find(file_path);
+        if (it != templates.end())
+            return it->second;
+
         if (!FileSystem::Exists(file_path))
         {
             SP_LOG_WARNING("Prefab file not found: %s", file_path.c_str());
-            return false;
+            return nullptr;
         }
 
-        pugi::xml_document doc;
-        pugi::xml_parse_result result = doc.load_file(file_path.c_str());
+        shared_ptr<PrefabTemplate> prefab = make_shared<PrefabTemplate>();
+        pugi::xml_parse_result result     = prefab->document.load_file(file_path.c_str());
         if (!result)
         {
             SP_LOG_ERROR("Failed to parse prefab file: %s (%s)", file_path.c_str(), result.description());
-            return false;
+            return nullptr;
         }
 
-        pugi::xml_node prefab_node = doc.child("Prefab");
+        pugi::xml_node prefab_node = prefab->document.child("Prefab");
         if (!prefab_node)
         {
             SP_LOG_ERROR("Prefab file missing <Prefab> root node: %s", file_path.c_str());
-            return false;
+            return nullptr;
         }
 
-        // load components defined on the prefab node directly onto the parent entity
-        for (pugi::xml_node component_node = prefab_node.first_child(); component_node; component_node = component_node.next_sibling())
+        prefab->name = prefab_node.attribute("name").as_string();
+        parse_components(prefab_node, prefab->components, nullptr);
+        parse_entities(prefab_node, -1, prefab->nodes);
+
+        load_prototypes(prefab->components, prefab->prototypes);
+        for (PrefabTemplate::Node& node : prefab->nodes)
+        {
+            load_prototypes(node.components, prefab->prototypes);
+        }
+
+        templates[file_path] = prefab;
+        SP_LOG_INFO("Loaded prefab from: %s", file_path.c_str());
+
+        return prefab;
+    }
+
+    void Prefab::ClearTemplates()
+    {
+        lock_guard<mutex> lock(mutex_templates);
+        templates.clear();
+    }
+
+    void Prefab::InstantiateHierarchy(const PrefabTemplate& prefab, Entity* const* entities)
+    {
+        for (size_t i = 0; i < prefab.nodes.size(); i++)
         {
-            string type_name = component_node.name();
-            if (type_name == "Entity")
-                continue; // children are handled below
+            const PrefabTemplate::Node& node = prefab.nodes[i];
+            Entity* entity                   = entities[i + 1];
 
-            ComponentType type = Component::StringToType(type_name);
-            if (type != ComponentType::Max)
+            entity->SetObjectName(node.name);
+            entity->SetPositionLocal(node.position);
+            entity->SetRotationLocal(node.rotation);
+            entity->SetScaleLocal(node.scale);
+            if (!node.active)
             {
-                if (Component* component = parent->AddComponent(type))
-                {
-                    component->Load(component_node);
-                }
+                entity->SetActive(false);
             }
-        }
 
-        // load child entities
-        for (pugi::xml_node child_node = prefab_node.child("Entity"); child_node; child_node = child_node.next_sibling("Entity"))
-        {
-            Entity* child = World::CreateEntity();
-            child->Load(child_node);
-            child->SetParent(parent);
+            // parents come first, so the parent's transform is final by now
+            entity->SetParent(entities[node.parent + 1]);
         }
-
-        SP_LOG_INFO("Loaded prefab from: %s", file_path.c_str());
-        return true;
     }
 
-    vector<string> Prefab::GetRegisteredTypes()
+    void Prefab::InstantiateComponents(const PrefabTemplate& prefab, Entity* const* entities)
     {
-        vector<string> types;
-        for (const auto& [name, fn] : GetRegistry())
+        // prototypes are copied, the rest is loaded from the shared nodes, neither is written to
+        auto add_components = [](const vector<PrefabTemplate::ComponentData>& components, Entity* entity)
         {
-            types.push_back(name);
+            for (const PrefabTemplate::ComponentData& data : components)
+            {
+                Component* component = entity->AddComponent(data.type);
+                if (!component)
+                    continue;
+
+                if (data.prototype)
+                {
+                    component->CopyFromPrototype(data.prototype);
+                }
+                else
+                {
+                    pugi::xml_node component_node = data.node;
+                    component->Load(component_node);
+                }
+            }
+        };
+
+        add_components(prefab.components, entities[0]);
+        for (size_t i = 0; i < prefab.nodes.size(); i++)
+        {
+            const PrefabTemplate::Node& node = prefab.nodes[i];
+            add_components(node.components, entities[i + 1]);
+
+            if (node.prefab)
+            {
+                load_prefab_reference(node.prefab, entities[i + 1]);
+            }
         }
-        return types;
     }
 }
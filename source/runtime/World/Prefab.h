@@ -21,15 +21,19 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ========================
 #include <string>
 #include <vector>
+#include <memory>
 #include <unordered_map>
 #include <functional>
+#include "Components/Component.h"
+#include "../Math/Vector3.h"
+#include "../Math/Quaternion.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
 SP_WARNINGS_ON
-//=============================
+//===================================
 
 namespace spartan
 {
@@ -40,6 +44,38 @@ namespace spartan
     // returns the created entity (or nullptr on failure)
     using PrefabCreateFn = std::function<Entity*(pugi::xml_node& node, Entity* parent)>;
 
+    // a .prefab file parsed once, every instance is built from it instead of reading the file again
+    // components that don't resolve resources are loaded once into prototypes that never join the world, instances copy them
+    struct PrefabTemplate
+    {
+        struct ComponentData
+        {
+            ComponentType type         = ComponentType::Max;
+            pugi::xml_node node;
+            const Component* prototype = nullptr; // null when the type has to be loaded from the node per instance
+        };
+
+        struct Node
+        {
+            std::string name;
+            int32_t parent            = -1; // index into nodes, -1 when the parent is the instance root
+            bool active               = true;
+            math::Vector3 position    = math::Vector3::Zero;
+            math::Quaternion rotation = math::Quaternion::Identity;
+            math::Vector3 scale       = math::Vector3::One;
+            pugi::xml_node prefab;          // nested prefab reference, if any
+            std::vector<ComponentData> components;
+        };
+
+        ~PrefabTemplate();
+
+        std::string name;
+        std::vector<ComponentData> components;           // go on the instance root
+        std::vector<Node> nodes;                         // descendants, parents come before their children
+        pugi::xml_document document;                     // owns the component data
+        std::vector<std::unique_ptr<Entity>> prototypes; // own the prototype components, one per entity that has any
+    };
+
     class Prefab
     {
     public:
@@ -61,6 +97,18 @@ namespace spartan
         // get all registered code prefab type names
         static std::vector<std::string> GetRegisteredTypes();
 
+        // parse a .prefab file once, later calls return the cached template (saving over the file refreshes it)
+        static std::shared_ptr<const PrefabTemplate> GetTemplate(const std::string& file_path);
+
+        // drops the cached templates, their prototypes are entities so this has to happen while the world is still alive
+        static void ClearTemplates();
+
+        // both halves only read the template and only write to the given entities, so instances can be built on any thread
+        // (World::SpawnBatch builds them on the thread pool, the same way world files load their entities)
+        // entities holds the instance root followed by one entity per template node
+        static void InstantiateHierarchy(const PrefabTemplate& prefab, Entity* const* entities);
+        static void InstantiateComponents(const PrefabTemplate& prefab, Entity* const* entities);
+
     private:
         static std::unordered_map<std::string, PrefabCreateFn>& GetRegistry();
     };
@@ -35,9 +35,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Components/Camera.h"
 #include "Components/Light.h"
 #include "Components/AudioSource.h"
+#include "Components/Volume.h"
+#include "Components/Script.h"
+#include "../Geometry/Bvh.h"
 #include "../Resource/ResourceCache.h"
 #include "../RHI/RHI_Texture.h"
 #include "../Rendering/Renderer.h"
+#include "../Rendering/RenderWorld.h"
+#include "../Memory/Allocator.h"
 #include "Components/Physics.h"
 SP_WARNINGS_OFF
 #include "../IO/pugixml.hpp"
@@ -55,72 +60,237 @@ namespace spartan
     {
         sol::state lua_state;
         vector<Entity*> entities;
-        vector<Entity*> entities_lights; // entities subset that contains only lights
+        vector<Entity*> entities_lights;        // entities subset that contains only lights
+        vector<Entity*> entities_volumes;       // entities subset that contains only volumes
+        vector<Entity*> entities_audio_sources; // entities subset that contains only audio sources
         string file_path;
         string world_name; // cached to avoid per-frame allocation
         string world_description;
         mutex entity_access_mutex;
         vector<Entity*> pending_add;
         set<uint64_t> pending_remove;
-        uint32_t audio_source_count = 0;
-        atomic<bool> resolve        = false;
+        atomic<uint64_t> revision   = 0; // bumped whenever entities are added, deleted or change what they are
         bool was_in_editor_mode     = false;
         BoundingBox bounding_box    = BoundingBox::Unit;
         Entity* camera              = nullptr;
         Entity* light               = nullptr;
 
         // snapshot for play/stop state restoration (like unity's play mode)
-        struct EntitySnapshot
-        {
-            Vector3 position;
-            Quaternion rotation;
-            Vector3 scale;
-        };
-        unordered_map<uint64_t, EntitySnapshot> play_mode_snapshot;
-        float play_mode_time_of_day = 0.0f;
-
-        // entity state tracking - things that change the nature of the entity for rendering
-        enum class EntityChange : uint8_t
+        vector<uint8_t> play_mode_snapshot;
+
+        // snapshot layout: a header, one fixed size state per entity, then the component data the states point into
+        namespace snapshot
         {
-            None       = 0,
-            Active     = 1 << 0,
-            Components = 1 << 1,
-            CullMode   = 1 << 2,
-            LightType  = 1 << 3
-        };
-        unordered_map<uint64_t, uint32_t> entity_states; // stores: low 8 bits for flags, next 8 for component count, next 8 for cull mode, next 8 for light type
-
-        // material change tracking - things that change the nature of the material for rendering
-        unordered_map<uint64_t, size_t> material_state_hashes;
-
-        void mark_entity_changed(uint64_t id, EntityChange change)
+            struct Header
+            {
+                uint32_t entity_count = 0;
+                float time_of_day     = 0.0f;
+                uint64_t data_size    = 0; // component data
+            };
+
+            struct EntityState
+            {
+                uint64_t id              = 0;
+                Vector3 position         = Vector3::Zero;
+                Quaternion rotation      = Quaternion::Identity;
+                Vector3 scale            = Vector3::One;
+                uint32_t component_mask  = 0; // the components present when saved, their data is skipped if that changed
+                uint32_t data_offset     = 0;
+                uint32_t data_size       = 0;
+                bool active              = true;
+            };
+
+            static_assert(sizeof(Header) % alignof(EntityState) == 0, "entity states must stay aligned after the header");
+            static_assert(is_trivially_copyable_v<EntityState>, "entity states are written and read as raw bytes");
+            static_assert(static_cast<uint32_t>(ComponentType::Max) <= 32, "the component mask holds one bit per component type");
+
+            uint32_t component_mask(const Entity* entity)
+            {
+                uint32_t mask = 0;
+                const auto& components = entity->GetAllComponents();
+                for (uint32_t i = 0; i < static_cast<uint32_t>(components.size()); i++)
+                {
+                    mask |= components[i] ? (1u << i) : 0u;
+                }
+                return mask;
+            }
+        }
+
+        // change tracking, entities, lights and materials publish what changed and the world applies it once per tick,
+        // so a world where nothing changes costs close to nothing, instead of a scan over every entity every frame
+        namespace changes
         {
-            entity_states[id] |= static_cast<uint32_t>(change);
-            resolve            = true;
+            mutex mutex_pending;
+            vector<Entity*> entities;   // components, active state or light type changed, null where an entity was dropped
+            unordered_map<Entity*, uint32_t> entity_slots; // where each queued entity is in entities, so it's queued once and dropped in constant time
+            vector<uint64_t> lights;    // ids of lights whose properties changed
+            vector<uint64_t> materials; // ids of materials whose properties, textures or gpu state changed
+            bool textures_ready = false; // a material texture finished preparing, it doesn't know which materials use it
+            bool cull_mode   = false;   // a material changed cull mode, the entities using it render differently
+            bool removed     = false;   // entities were removed since the last tick
+            bool rebuild_all = true;    // the registries are rebuilt from scratch, after a shutdown
+
+            // what the last tick applied, read by the renderer
+            bool lights_this_frame    = false;
+            bool materials_this_frame = false;
+
+            // the registries each entity is in, so a change only touches the ones it enters or leaves
+            // an entity has an entry from the moment it joins the world, changes to entities outside of it are ignored
+            constexpr uint8_t in_lights        = 1 << 0;
+            constexpr uint8_t in_audio_sources = 1 << 1;
+            constexpr uint8_t in_volumes       = 1 << 2;
+            constexpr uint8_t in_cameras       = 1 << 3;
+            constexpr uint8_t in_bounds        = 1 << 4;
+            unordered_map<Entity*, uint8_t> memberships;
+
+            // callers hold mutex_pending
+            void queue_entity(Entity* entity)
+            {
+                if (entity_slots.emplace(entity, static_cast<uint32_t>(entities.size())).second)
+                {
+                    entities.push_back(entity);
+                }
+            }
+
+            void drop_entity(Entity* entity)
+            {
+                auto it = entity_slots.find(entity);
+                if (it != entity_slots.end())
+                {
+                    entities[it->second] = nullptr;
+                    entity_slots.erase(it);
+                }
+            }
         }
 
-        size_t compute_material_hash(Material* material)
+        // volumes are looked up by position every frame (audio reverb etc), so they are indexed by a bvh
+        // over their world space boxes, which is only rebuilt when a volume moves, resizes or comes and goes
+        namespace volume_index
         {
-            size_t hash = 17; // FNV-1a seed
+            vector<BoundingBox> boxes; // parallel to entities_volumes
+            Bvh bvh;
+            bool dirty = false;
+
+            void update()
+            {
+                SP_PROFILE_CPU();
+
+                bool rebuild = dirty || boxes.size() != entities_volumes.size();
+                boxes.resize(entities_volumes.size());
+                for (size_t i = 0; i < entities_volumes.size(); i++)
+                {
+                    // a volume component that was removed keeps its slot until the next resolve, the queries skip it
+                    Volume* volume  = entities_volumes[i]->GetComponent<Volume>();
+                    BoundingBox box = volume ? volume->GetBoundingBox() * entities_volumes[i]->GetMatrix() : BoundingBox::Zero;
+                    if (!(box == boxes[i]))
+                    {
+                        boxes[i] = box;
+                        rebuild  = true;
+                    }
+                }
+
+                if (rebuild)
+                {
+                    bvh.Build(boxes);
+                    dirty = false;
+                }
+            }
 
-            // include resource state so async preparation completion triggers an update
-            hash = (hash * 31) ^ static_cast<size_t>(material->GetResourceState());
+            void remove(Entity* entity)
+            {
+                auto it = find(entities_volumes.begin(), entities_volumes.end(), entity);
+                if (it != entities_volumes.end())
+                {
+                    entities_volumes.erase(it);
+                    dirty = true;
+                }
+            }
+
+            void clear()
+            {
+                entities_volumes.clear();
+                boxes.clear();
+                bvh.Clear();
+                dirty = false;
+            }
+
+            void query(const BoundingBox& bounds, vector<Volume*>& volumes)
+            {
+                static thread_local vector<uint32_t> indices;
+                indices.clear();
+                bvh.QueryBox(bounds, indices);
+
+                // entity order, so overlapping volumes resolve the same way every frame
+                sort(indices.begin(), indices.end());
+                for (uint32_t index : indices)
+                {
+                    if (Volume* volume = entities_volumes[index]->GetComponent<Volume>())
+                    {
+                        volumes.push_back(volume);
+                    }
+                }
+            }
+        }
 
-            for (const auto* texture : material->GetTextures())
+        // raycasts go through a bvh over the world space boxes of all renderables, which is brought up to date
+        // lazily by the first query after a renderable moved or the set changed, refitted when only boxes moved and rebuilt otherwise
+        // queries can come from any thread (gameplay code, lua), so they hold mutex_index while they update and walk the index,
+        // and deleting entities or removing renderables takes it too, always before entity_access_mutex
+        namespace renderable_index
+        {
+            mutex mutex_index;
+            vector<Entity*> entities_indexed; // parallel to boxes
+            vector<BoundingBox> boxes;
+            vector<Entity*> entities_current; // scratch for the update, guarded by mutex_index
+            vector<BoundingBox> boxes_current;
+            Bvh bvh;
+            atomic<bool> stale = true;
+
+            // the caller holds mutex_index
+            void update()
             {
-                hash = (hash * 31) ^ reinterpret_cast<size_t>(texture);
+                // cleared before reading so that a change made while updating is picked up by the next query
+                if (!stale.exchange(false))
+                    return;
+
+                SP_PROFILE_CPU();
+
+                entities_current.clear();
+                boxes_current.clear();
+                {
+                    lock_guard<mutex> lock(entity_access_mutex);
+                    for (Entity* entity : entities)
+                    {
+                        Renderable* renderable = entity->GetActive() ? entity->GetComponent<Renderable>() : nullptr;
+                        if (renderable && renderable->GetMesh())
+                        {
+                            entities_current.push_back(entity);
+                            boxes_current.push_back(renderable->GetBoundingBox());
+                        }
+                    }
+                }
 
-                // include texture's resource state so async texture preparation triggers an update
-                if (texture)
+                if (entities_current != entities_indexed)
                 {
-                    hash = (hash * 31) ^ static_cast<size_t>(texture->GetResourceState());
+                    entities_indexed.swap(entities_current);
+                    boxes.swap(boxes_current);
+                    bvh.Build(boxes);
+                }
+                else if (boxes_current != boxes)
+                {
+                    boxes.swap(boxes_current);
+                    bvh.Refit(boxes);
                 }
             }
-            for (const float prop : material->GetProperties())
+
+            // the caller holds mutex_index
+            void clear()
             {
-                hash = (hash * 31) ^ std::hash<float>{}(prop);
+                entities_indexed.clear();
+                boxes.clear();
+                bvh.Clear();
+                stale = true;
             }
-            return hash;
         }
 
         void compute_bounding_box()
@@ -139,6 +309,221 @@ namespace spartan
             }
         }
 
+        Entity* find_camera()
+        {
+            for (Entity* entity : entities)
+            {
+                if (entity->GetActive() && entity->GetComponent<Camera>())
+                    return entity;
+            }
+
+            return nullptr;
+        }
+
+        Entity* find_directional_light()
+        {
+            for (Entity* entity : entities_lights)
+            {
+                Light* light_comp = entity->GetComponent<Light>();
+                if (light_comp && light_comp->GetLightType() == LightType::Directional)
+                    return entity;
+            }
+
+            return nullptr;
+        }
+
+        // adds or removes the entity from a registry when its membership changes, returns true if it did
+        bool update_registry(vector<Entity*>& registry, Entity* entity, const uint8_t membership, const uint8_t wanted, const uint8_t flag)
+        {
+            if ((membership & flag) == (wanted & flag))
+                return false;
+
+            if (wanted & flag)
+            {
+                registry.push_back(entity);
+            }
+            else
+            {
+                registry.erase(find(registry.begin(), registry.end(), entity));
+            }
+
+            return true;
+        }
+
+        // brings the registries up to date with a single entity, returns true if the world's bounds have to be recomputed
+        bool apply_entity_change(Entity* entity)
+        {
+            const bool active   = entity->GetActive();
+            uint8_t& membership = changes::memberships[entity];
+
+            Light* light_comp = active ? entity->GetComponent<Light>() : nullptr;
+            uint8_t wanted    = 0;
+            wanted           |= light_comp                                        ? changes::in_lights        : 0;
+            wanted           |= active && entity->GetComponent<AudioSource>()     ? changes::in_audio_sources : 0;
+            wanted           |= entity->GetComponent<Volume>()                    ? changes::in_volumes       : 0; // regardless of the active state, consumers decide what applies
+            wanted           |= active && entity->GetComponent<Camera>()          ? changes::in_cameras       : 0;
+            wanted           |= active && entity->GetComponent<Renderable>()      ? changes::in_bounds        : 0;
+
+            update_registry(entities_lights, entity, membership, wanted, changes::in_lights);
+            update_registry(entities_audio_sources, entity, membership, wanted, changes::in_audio_sources);
+            if (update_registry(entities_volumes, entity, membership, wanted, changes::in_volumes))
+            {
+                volume_index::dirty = true;
+            }
+
+            // the first camera and directional light found are the ones the world uses
+            if ((wanted & changes::in_cameras) && !camera)
+            {
+                camera = entity;
+            }
+            else if (!(wanted & changes::in_cameras) && camera == entity)
+            {
+                camera = find_camera();
+            }
+
+            bool directional = light_comp && light_comp->GetLightType() == LightType::Directional;
+            if (directional && !light)
+            {
+                light = entity;
+            }
+            else if (!directional && light == entity)
+            {
+                light = find_directional_light();
+            }
+
+            // bounds only grow incrementally, an entity that leaves them may have been defining them
+            bool bounds_stale = (membership & changes::in_bounds) && !(wanted & changes::in_bounds);
+            if (wanted & changes::in_bounds)
+            {
+                bounding_box.Merge(entity->GetComponent<Renderable>()->GetBoundingBox());
+            }
+
+            membership = wanted;
+            return bounds_stale;
+        }
+
+        // drops an entity that is about to be deleted from every registry and from the pending changes
+        void unregister_entity(Entity* entity)
+        {
+            {
+                lock_guard<mutex> lock(changes::mutex_pending);
+                changes::drop_entity(entity);
+                changes::removed = true;
+            }
+
+            auto it = changes::memberships.find(entity);
+            if (it == changes::memberships.end())
+                return;
+
+            const uint8_t membership = it->second;
+            update_registry(entities_lights, entity, membership, 0, changes::in_lights);
+            update_registry(entities_audio_sources, entity, membership, 0, changes::in_audio_sources);
+            volume_index::remove(entity);
+            changes::memberships.erase(it);
+
+            if (camera == entity)
+            {
+                camera = nullptr;
+            }
+            if (light == entity)
+            {
+                light = nullptr;
+            }
+        }
+
+        void rebuild_registries()
+        {
+            camera = nullptr;
+            light  = nullptr;
+            entities_lights.clear();
+            entities_audio_sources.clear();
+            entities_volumes.clear();
+            changes::memberships.clear();
+            bounding_box = BoundingBox::Unit;
+
+            for (Entity* entity : entities)
+            {
+                apply_entity_change(entity);
+            }
+
+            volume_index::dirty = true;
+        }
+
+        // applies everything published since the last tick
+        void apply_changes()
+        {
+            SP_PROFILE_CPU();
+
+            static vector<Entity*> entities_changed;
+            entities_changed.clear();
+            bool cull_mode_changed = false;
+            bool removed           = false;
+            bool rebuild_all       = false;
+            {
+                lock_guard<mutex> lock(changes::mutex_pending);
+
+                entities_changed.swap(changes::entities);
+                changes::entity_slots.clear();
+                changes::lights_this_frame    = !changes::lights.empty();
+                changes::materials_this_frame = !changes::materials.empty() || changes::textures_ready;
+                changes::lights.clear();
+                changes::materials.clear();
+                changes::textures_ready = false;
+
+                cull_mode_changed    = changes::cull_mode;
+                removed              = changes::removed;
+                rebuild_all          = changes::rebuild_all;
+                changes::cull_mode   = false;
+                changes::removed     = false;
+                changes::rebuild_all = false;
+            }
+
+            // a removed camera or light is replaced by the next one in line
+            if (removed)
+            {
+                camera = camera ? camera : find_camera();
+                light  = light  ? light  : find_directional_light();
+            }
+
+            if (rebuild_all)
+            {
+                rebuild_registries();
+            }
+            else if (!entities_changed.empty())
+            {
+                bool bounds_stale = removed;
+                for (Entity* entity : entities_changed)
+                {
+                    bounds_stale |= entity && changes::memberships.count(entity) ? apply_entity_change(entity) : false;
+                }
+
+                if (bounds_stale)
+                {
+                    compute_bounding_box();
+                }
+            }
+            else if (removed)
+            {
+                compute_bounding_box();
+            }
+
+            if (volume_index::dirty)
+            {
+                volume_index::update();
+            }
+
+            if (rebuild_all || removed || cull_mode_changed || !entities_changed.empty())
+            {
+                revision++;
+            }
+
+            // components or active states changed, which can add or remove renderables from the raycast index
+            if (rebuild_all || !entities_changed.empty())
+            {
+                renderable_index::stale = true;
+            }
+        }
+
         bool is_world_in_project_directory(const string& world_file_path)
         {
             // check if the world is in the project directory (has local assets alongside it)
@@ -250,6 +635,7 @@ namespace spartan
             Renderable      ::RegisterForScripting(state_view);
             Physics         ::RegisterForScripting(state_view);
             Light           ::RegisterForScripting(state_view);
+            Script          ::RegisterForScripting(state_view);
 
             lua_state.new_enum("ComponentType",
                 "AudioSource",              ComponentType::AudioSource,
@@ -301,6 +687,24 @@ namespace spartan
             WorldTable["GetTimeOfDay"]              = &World::GetTimeOfDay;
             WorldTable["SetTimeOfDay"]              = &World::SetTimeOfDay;
             WorldTable["GetDirectionalLight"]       = &World::GetDirectionalLight;
+            WorldTable["Raycast"]                   = [](const Vector3& origin, const Vector3& direction, sol::optional<float> max_distance) -> tuple<Entity*, float>
+            {
+                RayHitResult hit(nullptr, Vector3::Zero, numeric_limits<float>::infinity(), false);
+                World::Raycast(Ray(origin, direction), hit, max_distance.value_or(numeric_limits<float>::infinity()));
+                return { hit.m_entity, hit.m_distance };
+            };
+            WorldTable["RaycastAll"]                = [](const Vector3& origin, const Vector3& direction, sol::optional<float> max_distance) -> vector<Entity*>
+            {
+                vector<RayHitResult> hits;
+                World::RaycastAll(Ray(origin, direction), hits, max_distance.value_or(numeric_limits<float>::infinity()));
+
+                vector<Entity*> hit_entities;
+                for (const RayHitResult& hit : hits)
+                {
+                    hit_entities.push_back(hit.m_entity);
+                }
+                return hit_entities;
+            };
 
 
             lua_state.new_usertype<Vector2>("Vector2",
@@ -646,6 +1050,7 @@ namespace spartan
 
     void World::ProcessPendingRemovals()
     {
+        lock_guard<mutex> lock_index(renderable_index::mutex_index);
         lock_guard<mutex> lock(entity_access_mutex);
 
         if (pending_remove.empty())
@@ -656,12 +1061,9 @@ namespace spartan
             uint64_t id = (*it)->GetObjectId();
             if (pending_remove.count(id) > 0)
             {
-                // clean up change tracking
-                entity_states.erase(id);
-                if (Material* mat = (*it)->GetComponent<Renderable>() ? (*it)->GetComponent<Renderable>()->GetMaterial() : nullptr)
-                {
-                    material_state_hashes.erase(mat->GetObjectId());
-                }
+                unregister_entity(*it);
+                renderable_index::stale = true;
+                revision++;
                 delete *it;
                 it = entities.erase(it);
             }
@@ -682,7 +1084,16 @@ namespace spartan
             return;
 
         entities.insert(entities.end(), pending_add.begin(), pending_add.end());
+        {
+            lock_guard<mutex> lock_changes(changes::mutex_pending);
+            for (Entity* entity : pending_add)
+            {
+                changes::queue_entity(entity);
+                changes::memberships.emplace(entity, 0);
+            }
+        }
         pending_add.clear();
+        renderable_index::stale = true;
     }
 
     void World::Initialize()
@@ -694,17 +1105,42 @@ namespace spartan
     {
         Engine::SetFlag(EngineMode::Playing, false); // stop simulation
         Renderer::DestroyAccelerationStructures();   // destroy tlas/blas before clearing resources
+        RenderWorld::Clear();                        // drop the snapshot before the entities it points to
         ResourceCache::Shutdown();                   // release all resources (textures, materials, meshes, etc)n
 
         // clear entities
         camera = nullptr;
         light  = nullptr;
-        for (Entity* entity : entities)
+
+        // clear change tracking first so that the entities have nothing to unmark, the registries are rebuilt on the next tick
         {
-            delete entity;
+            lock_guard<mutex> lock(changes::mutex_pending);
+            changes::entities.clear();
+            changes::entity_slots.clear();
+            changes::lights.clear();
+            changes::materials.clear();
+            changes::textures_ready = false;
+            changes::memberships.clear();
+            changes::rebuild_all = true;
         }
+
+        {
+            lock_guard<mutex> lock(renderable_index::mutex_index);
+            for (Entity* entity : entities)
+            {
+                delete entity;
+            }
+            for (Entity* entity : pending_add)
+            {
+                delete entity;
+            }
+            renderable_index::clear();
+        }
+        Prefab::ClearTemplates(); // their prototypes are entities too, outside of the world
         entities.clear();
         entities_lights.clear();
+        entities_audio_sources.clear();
+        volume_index::clear();
         pending_add.clear();
         camera = nullptr;
         light  = nullptr;
@@ -712,12 +1148,7 @@ namespace spartan
         world_name.clear();
         world_description.clear();
 
-        // clear change tracking
-        entity_states.clear();
-        material_state_hashes.clear();
-
-        // mark for resolve
-        resolve = true;
+        revision++;
     }
 
     void World::Tick()
@@ -727,6 +1158,7 @@ namespace spartan
             return;
 
         SP_PROFILE_CPU();
+        SP_MEMORY_TAG(MemoryTag::World);
 
         // detect game toggling
         const bool started = Engine::IsFlagSet(EngineMode::Playing) && was_in_editor_mode;
@@ -736,20 +1168,8 @@ namespace spartan
         // start
         if (started)
         {
-            // snapshot all entity transforms before simulation begins
-            play_mode_snapshot.clear();
-            for (Entity* entity : entities)
-            {
-                if (!entity->IsTransient())
-                {
-                    EntitySnapshot snapshot;
-                    snapshot.position = entity->GetPositionLocal();
-                    snapshot.rotation = entity->GetRotationLocal();
-                    snapshot.scale    = entity->GetScaleLocal();
-                    play_mode_snapshot[entity->GetObjectId()] = snapshot;
-                }
-            }
-            play_mode_time_of_day = world_time::time_of_day;
+            // snapshot the world before simulation begins
+            SaveSnapshot(play_mode_snapshot);
 
             for (Entity* entity : entities)
             {
@@ -765,24 +1185,15 @@ namespace spartan
                 entity->Stop();
             }
 
-            // restore all entity transforms from snapshot
-            for (Entity* entity : entities)
-            {
-                auto it = play_mode_snapshot.find(entity->GetObjectId());
-                if (it != play_mode_snapshot.end())
-                {
-                    const EntitySnapshot& snapshot = it->second;
-                    entity->SetPositionLocal(snapshot.position);
-                    entity->SetRotationLocal(snapshot.rotation);
-                    entity->SetScaleLocal(snapshot.scale);
-                }
-            }
+            // restore the world to how it was before simulation began
+            LoadSnapshot(play_mode_snapshot);
             play_mode_snapshot.clear();
-            world_time::time_of_day = play_mode_time_of_day;
         }
 
         ProcessPendingRemovals();
 
+        // pick up volumes that moved last frame
+        volume_index::update();
 
         for (Entity* entity : entities)
         {
@@ -792,6 +1203,9 @@ namespace spartan
             }
         }
 
+        // scripts run as one batch, after the other components
+        Script::PreTickAll();
+
         // tick
         for (Entity* entity : entities)
         {
@@ -800,120 +1214,182 @@ namespace spartan
                 entity->Tick();
             }
         }
+        Script::TickAll();
 
-        // check for entity changes
+        ProcessPendingAdditions();
+        apply_changes();
+
+        if (Engine::IsFlagSet(EngineMode::Playing))
+        {
+            world_time::tick();
+            Game::Tick();
+        }
+    }
+
+    void World::SaveSnapshot(vector<uint8_t>& out)
+    {
+        SP_PROFILE_CPU();
+
+        // transient entities are left alone, like when saving
+        vector<Entity*> entities_saved;
+        entities_saved.reserve(entities.size());
         for (Entity* entity : entities)
         {
-            if (entity->GetActive())
+            if (!entity->IsTransient())
+            {
+                entities_saved.push_back(entity);
+            }
+        }
+
+        // the states are filled in place, the component data is appended after them
+        const size_t states_offset = sizeof(snapshot::Header);
+        const size_t data_offset   = states_offset + entities_saved.size() * sizeof(snapshot::EntityState);
+        out.clear();
+        out.resize(data_offset);
+
+        for (size_t i = 0; i < entities_saved.size(); i++)
+        {
+            Entity* entity = entities_saved[i];
+
+            snapshot::EntityState state;
+            state.id             = entity->GetObjectId();
+            state.position       = entity->GetPositionLocal();
+            state.rotation       = entity->GetRotationLocal();
+            state.scale          = entity->GetScaleLocal();
+            state.active         = entity->IsActive();
+            state.component_mask = snapshot::component_mask(entity);
+            state.data_offset    = static_cast<uint32_t>(out.size() - data_offset);
+
+            for (const shared_ptr<Component>& component : entity->GetAllComponents())
             {
-                uint64_t id = entity->GetObjectId();
-                auto it = entity_states.find(id);
-                if (it != entity_states.end())
+                if (component)
                 {
-                    uint32_t& state = it->second;
-                    uint32_t new_state = state;
+                    component->SaveAttributes(out);
+                    component->SaveRuntimeState(out);
+                }
+            }
 
-                    // active state
-                    bool was_active = (state & static_cast<uint32_t>(EntityChange::Active)) != 0;
-                    if (entity->GetActive() != was_active)
-                    {
-                        new_state |= static_cast<uint32_t>(EntityChange::Active);
-                        resolve = true;
-                    }
+            // appending can reallocate, so the state is copied in once its data is written
+            state.data_size = static_cast<uint32_t>(out.size() - data_offset) - state.data_offset;
+            memcpy(out.data() + states_offset + i * sizeof(snapshot::EntityState), &state, sizeof(state));
+        }
 
-                    // component count
-                    uint8_t prev_component_count = (state >> 8) & 0xFF;
-                    uint8_t curr_component_count = static_cast<uint8_t>(min(entity->GetComponentCount(), 255u));
-                    if (curr_component_count != prev_component_count)
-                    {
-                        new_state = (new_state & ~0xFF00) | (curr_component_count << 8);
-                        new_state |= static_cast<uint32_t>(EntityChange::Components);
-                        resolve = true;
-                    }
+        snapshot::Header header;
+        header.entity_count = static_cast<uint32_t>(entities_saved.size());
+        header.time_of_day  = world_time::time_of_day;
+        header.data_size    = out.size() - data_offset;
+        memcpy(out.data(), &header, sizeof(header));
+    }
 
-                    // cull mode
-                    uint8_t prev_cull = (state >> 16) & 0xFF;
-                    uint8_t curr_cull = static_cast<uint8_t>(RHI_CullMode::None);
-                    if (Renderable* renderable = entity->GetComponent<Renderable>())
-                    {
-                        if (Material* material = renderable->GetMaterial())
-                        {
-                            curr_cull = static_cast<uint8_t>(material->GetProperty(MaterialProperty::CullMode));
-                        }
-                    }
-                    if (curr_cull != prev_cull)
-                    {
-                        new_state = (new_state & ~0xFF0000) | (curr_cull << 16);
-                        new_state |= static_cast<uint32_t>(EntityChange::CullMode);
-                        resolve = true;
-                    }
+    bool World::LoadSnapshot(const vector<uint8_t>& data)
+    {
+        SP_PROFILE_CPU();
 
-                    // light type
-                    uint8_t prev_light_type = (state >> 24) & 0xFF;
-                    uint8_t curr_light_type = static_cast<uint8_t>(LightType::Max);
-                    if (Light* light_comp = entity->GetComponent<Light>())
-                    {
-                        curr_light_type = static_cast<uint8_t>(light_comp->GetLightType());
-                    }
-                    if (curr_light_type != prev_light_type)
+        if (data.size() < sizeof(snapshot::Header))
+            return false;
+
+        snapshot::Header header;
+        memcpy(&header, data.data(), sizeof(header));
+
+        const size_t states_offset = sizeof(snapshot::Header);
+        const size_t data_offset   = states_offset + header.entity_count * sizeof(snapshot::EntityState);
+        if (data.size() != data_offset + header.data_size)
+            return false;
+
+        const snapshot::EntityState* states = reinterpret_cast<const snapshot::EntityState*>(data.data() + states_offset);
+        const uint8_t* component_data       = data.data() + data_offset;
+
+        // match entities to their states, positionally while the entity list is unchanged, by id after that
+        vector<const snapshot::EntityState*> matches(entities.size(), nullptr);
+        {
+            unordered_map<uint64_t, const snapshot::EntityState*> states_by_id;
+            uint32_t state_index = 0;
+            for (size_t i = 0; i < entities.size(); i++)
+            {
+                const uint64_t id = entities[i]->GetObjectId();
+                if (states_by_id.empty() && state_index < header.entity_count && states[state_index].id == id)
+                {
+                    matches[i] = &states[state_index++];
+                    continue;
+                }
+
+                // the lists diverged (entities were added, removed or are transient), index the rest once
+                if (states_by_id.empty())
+                {
+                    states_by_id.reserve(header.entity_count - state_index);
+                    for (uint32_t j = state_index; j < header.entity_count; j++)
                     {
-                        new_state = (new_state & ~0xFF000000) | (curr_light_type << 24);
-                        new_state |= static_cast<uint32_t>(EntityChange::LightType);
-                        resolve = true;
+                        states_by_id[states[j].id] = &states[j];
                     }
-
-                    state = new_state;
                 }
+
+                auto it    = states_by_id.find(id);
+                matches[i] = it != states_by_id.end() ? it->second : nullptr;
             }
         }
 
-        ProcessPendingAdditions();
+        // one bulk write of the local transforms, then a single hierarchy update from the roots
+        ThreadPool::ParallelLoop([&](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                if (const snapshot::EntityState* state = matches[i])
+                {
+                    entities[i]->SetTransformLocal(state->position, state->rotation, state->scale, false);
+                }
+            }
+        }, static_cast<uint32_t>(max<size_t>(entities.size(), 1)));
 
-        // resolve if needed
-        if (resolve)
+        ThreadPool::ParallelLoop([&](uint32_t start, uint32_t end)
         {
-            // track entities
+            for (uint32_t i = start; i < end; i++)
             {
-                camera             = nullptr;
-                light              = nullptr;
-                audio_source_count = 0;
-                entities_lights.clear();
-                for (Entity* entity : entities)
+                if (!entities[i]->GetParent())
                 {
-                    if (entity->GetActive())
-                    {
-                        if (!camera && entity->GetComponent<Camera>())
-                        {
-                            camera = entity;
-                        }
+                    entities[i]->UpdateTransform();
+                }
+            }
+        }, static_cast<uint32_t>(max<size_t>(entities.size(), 1)));
 
-                        if (Light* light_comp = entity->GetComponent<Light>())
-                        {
-                            if (!light && light_comp->GetLightType() == LightType::Directional)
-                            {
-                                light = entity;
-                            }
-                            entities_lights.push_back(entity);
-                        }
+        // component state and active state, serially since setters can reach into other systems
+        bool complete = true;
+        for (size_t i = 0; i < entities.size(); i++)
+        {
+            const snapshot::EntityState* state = matches[i];
+            if (!state)
+                continue;
 
-                        if (entity->GetComponent<AudioSource>())
-                        {
-                            audio_source_count++;
-                        }
-                    }
-                }
+            Entity* entity = entities[i];
+            if (entity->IsActive() != state->active)
+            {
+                entity->SetActive(state->active);
             }
 
-            compute_bounding_box();
-            resolve = false;
-            entity_states.clear();
-        }
+            // components added or removed while playing make the data unreadable, keep their current state
+            if (snapshot::component_mask(entity) != state->component_mask)
+            {
+                complete = false;
+                continue;
+            }
 
-        if (Engine::IsFlagSet(EngineMode::Playing))
-        {
-            world_time::tick();
-            Game::Tick();
+            // components rebuild what depends on their attributes as they load, the world and the renderer pick up the rest
+            const uint8_t* cursor   = component_data + state->data_offset;
+            const uint8_t* data_end = cursor + state->data_size;
+            for (const shared_ptr<Component>& component : entity->GetAllComponents())
+            {
+                if (component && !(component->LoadAttributes(cursor, data_end) && component->LoadRuntimeState(cursor, data_end)))
+                {
+                    complete = false;
+                    break;
+                }
+            }
+            MarkEntityChanged(entity);
         }
+
+        world_time::time_of_day = header.time_of_day;
+        RenderWorld::MarkDirty();
+
+        return complete;
     }
 
     bool World::SaveToFile(string file_path)
@@ -1001,6 +1477,8 @@ namespace spartan
 
     bool World::LoadFromFile(const string& file_path_)
     {
+        SP_MEMORY_TAG(MemoryTag::World);
+
         // ensure prefabs are registered before loading
         Game::RegisterPrefabs();
 
@@ -1156,11 +1634,56 @@ namespace spartan
 
         Entity* entity = new Entity();
         pending_add.push_back(entity);
-        mark_entity_changed(entity->GetObjectId(), EntityChange::Components); // new entity requires resolve
 
         return entity;
     }
 
+    vector<Entity*> World::SpawnBatch(const string& prefab_file_path, const vector<Matrix>& transforms)
+    {
+        SP_PROFILE_CPU();
+
+        // parsed once, every instance shares it
+        shared_ptr<const PrefabTemplate> prefab = Prefab::GetTemplate(prefab_file_path);
+        if (!prefab || transforms.empty())
+            return {};
+
+        const uint32_t instance_count = static_cast<uint32_t>(transforms.size());
+        const size_t entity_count     = prefab->nodes.size() + 1;
+        vector<Entity*> roots(instance_count);
+
+        // instances are independent of each other, so they are built in parallel, like the entities of a world file
+        ThreadPool::ParallelLoop([&](uint32_t start, uint32_t end)
+        {
+            vector<Entity*> instance(entity_count);
+            for (uint32_t i = start; i < end; i++)
+            {
+                for (Entity*& entity : instance)
+                {
+                    entity = World::CreateEntity();
+                }
+
+                Entity* root = instance[0];
+                root->SetObjectName(prefab->name);
+                root->SetPrefabFilePath(prefab_file_path); // saved as a reference, the instance only stores its overrides
+
+                Vector3 scale;
+                Quaternion rotation;
+                Vector3 position;
+                transforms[i].Decompose(scale, rotation, position);
+                root->SetPositionLocal(position);
+                root->SetRotationLocal(rotation);
+                root->SetScaleLocal(scale);
+
+                Prefab::InstantiateHierarchy(*prefab, instance.data());
+                Prefab::InstantiateComponents(*prefab, instance.data());
+
+                roots[i] = root;
+            }
+        }, instance_count);
+
+        return roots;
+    }
+
     bool World::EntityExists(Entity* entity)
     {
         SP_ASSERT_MSG(entity != nullptr, "Entity is null");
@@ -1203,14 +1726,13 @@ namespace spartan
                 parent->RemoveChild(entity_to_remove, false);
             }
         }
-
-        resolve = true;
     }
 
     void World::RemoveEntityImmediate(Entity* entity_to_remove)
     {
         SP_ASSERT_MSG(entity_to_remove != nullptr, "Entity is null");
 
+        lock_guard<mutex> lock_index(renderable_index::mutex_index);
         lock_guard<mutex> lock(entity_access_mutex);
 
         // keep track of the local camera pointer so we don't have a dangling pointer
@@ -1233,18 +1755,10 @@ namespace spartan
         // remove and delete immediately
         for (Entity* entity : entities_to_remove)
         {
-            uint64_t id = entity->GetObjectId();
-
             // remove from entities vector
             auto it = find(entities.begin(), entities.end(), entity);
             if (it != entities.end())
             {
-                // clean up change tracking
-                entity_states.erase(id);
-                if (Material* mat = entity->GetComponent<Renderable>() ? entity->GetComponent<Renderable>()->GetMaterial() : nullptr)
-                {
-                    material_state_hashes.erase(mat->GetObjectId());
-                }
                 entities.erase(it);
             }
 
@@ -1255,8 +1769,12 @@ namespace spartan
                 pending_add.erase(pending_it);
             }
 
+            unregister_entity(entity);
+            renderable_index::stale = true;
             delete entity;
         }
+        volume_index::update();
+        revision++;
     }
 
     void World::GetRootEntities(vector<Entity*>& entities_out)
@@ -1373,6 +1891,86 @@ namespace spartan
         return entities_lights;
     }
 
+    const vector<Entity*>& World::GetEntitiesVolumes()
+    {
+        return entities_volumes;
+    }
+
+    void World::GetVolumesAt(const Vector3& position, vector<Volume*>& volumes)
+    {
+        volume_index::query(BoundingBox(position, position), volumes);
+    }
+
+    void World::GetVolumesOverlapping(const BoundingBox& box, vector<Volume*>& volumes)
+    {
+        volume_index::query(box, volumes);
+    }
+
+    bool World::Raycast(const Ray& ray, RayHitResult& hit, const float max_distance)
+    {
+        lock_guard<mutex> lock(renderable_index::mutex_index);
+        renderable_index::update();
+
+        Entity* hit_entity = nullptr;
+        Vector3 hit_normal = Vector3::Zero;
+        float hit_distance = numeric_limits<float>::infinity();
+        renderable_index::bvh.Raycast(ray, max_distance, [&](uint32_t index)
+        {
+            // the closest hit so far also bounds the triangle search of the next mesh
+            Entity* entity         = renderable_index::entities_indexed[index];
+            Renderable* renderable = entity->GetComponent<Renderable>();
+            if (!renderable)
+                return numeric_limits<float>::infinity();
+
+            Vector3 normal = Vector3::Zero;
+            float distance = renderable->Raycast(ray, min(hit_distance, max_distance), &normal);
+            if (distance < hit_distance)
+            {
+                hit_entity   = entity;
+                hit_normal   = normal;
+                hit_distance = distance;
+            }
+
+            return distance;
+        });
+
+        if (!hit_entity)
+            return false;
+
+        hit = RayHitResult(hit_entity, ray.GetStart() + ray.GetDirection() * hit_distance, hit_distance, hit_distance == 0.0f);
+        hit.m_normal = hit_normal;
+        return true;
+    }
+
+    void World::RaycastAll(const Ray& ray, vector<RayHitResult>& hits, const float max_distance)
+    {
+        lock_guard<mutex> lock(renderable_index::mutex_index);
+        renderable_index::update();
+
+        static thread_local vector<uint32_t> indices;
+        indices.clear();
+        renderable_index::bvh.QueryRay(ray, max_distance, indices);
+
+        const size_t first = hits.size();
+        for (uint32_t index : indices)
+        {
+            Entity* entity         = renderable_index::entities_indexed[index];
+            Renderable* renderable = entity->GetComponent<Renderable>();
+            if (!renderable)
+                continue;
+
+            Vector3 normal = Vector3::Zero;
+            float distance = renderable->Raycast(ray, max_distance, &normal);
+            if (distance == numeric_limits<float>::infinity())
+                continue;
+
+            hits.emplace_back(entity, ray.GetStart() + ray.GetDirection() * distance, distance, distance == 0.0f);
+            hits.back().m_normal = normal;
+        }
+
+        sort(hits.begin() + first, hits.end(), [](const RayHitResult& a, const RayHitResult& b) { return a.m_distance < b.m_distance; });
+    }
+
     const string& World::GetName()
     {
         return world_name;
@@ -1405,56 +2003,65 @@ namespace spartan
 
     uint32_t World::GetAudioSourceCount()
     {
-        return audio_source_count;
+        return static_cast<uint32_t>(entities_audio_sources.size());
+    }
+
+    uint64_t World::GetRevision()
+    {
+        return revision;
     }
 
     bool World::HaveMaterialsChangedThisFrame()
     {
-        lock_guard<mutex> lock(entity_access_mutex);
+        return changes::materials_this_frame;
+    }
 
-        bool changed = false;
-        for (Entity* entity : entities)
-        {
-            if (Renderable* renderable = entity->GetComponent<Renderable>())
-            {
-                if (Material* material = renderable->GetMaterial())
-                {
-                    const uint64_t id   = material->GetObjectId();
-                    size_t current_hash = compute_material_hash(material);
-                    auto it = material_state_hashes.find(id);
-                    if (it == material_state_hashes.end())
-                    {
-                        // new material
-                        material_state_hashes[id] = current_hash;
-                        changed = true;
-                    }
-                    else if (it->second != current_hash)
-                    {
-                        // material changed
-                        it->second = current_hash;
-                        changed = true;
-                    }
-                }
-            }
-        }
+    bool World::HaveLightsChangedThisFrame()
+    {
+        return changes::lights_this_frame;
+    }
 
-        return changed;
+    void World::MarkEntityChanged(Entity* entity)
+    {
+        lock_guard<mutex> lock(changes::mutex_pending);
+        changes::queue_entity(entity);
     }
 
-    bool World::HaveLightsChangedThisFrame()
+    void World::UnmarkEntity(Entity* entity)
     {
-        lock_guard<mutex> lock(entity_access_mutex);
+        lock_guard<mutex> lock(changes::mutex_pending);
+        changes::drop_entity(entity);
+    }
 
-        for (Entity* entity : entities_lights)
-        {
-            if (Light* light = entity->GetComponent<Light>())
-            {
-                if (light->HasChangedThisFrame())
-                    return true;
-            }
-        }
+    void World::MarkLightChanged(Light* light_changed)
+    {
+        lock_guard<mutex> lock(changes::mutex_pending);
+        changes::lights.push_back(light_changed->GetObjectId());
+    }
+
+    void World::MarkMaterialChanged(Material* material, const bool cull_mode_changed)
+    {
+        lock_guard<mutex> lock(changes::mutex_pending);
+        changes::materials.push_back(material->GetObjectId());
+        changes::cull_mode = changes::cull_mode || cull_mode_changed;
+    }
 
-        return false;
+    void World::MarkMaterialTexturesReady()
+    {
+        lock_guard<mutex> lock(changes::mutex_pending);
+        changes::textures_ready = true;
+    }
+
+    void World::MarkRenderableBoundsChanged()
+    {
+        renderable_index::stale = true;
+    }
+
+    unique_lock<mutex> World::LockRaycasts()
+    {
+        unique_lock<mutex> lock(renderable_index::mutex_index);
+        renderable_index::stale = true;
+        return lock;
     }
 
     float World::GetTimeOfDay(bool use_real_world_time)
@@ -23,7 +23,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===================
 #include "../Math/BoundingBox.h"
+#include "../Math/Ray.h"
+#include "../Math/RayHitResult.h"
+#include "../Math/Matrix.h"
 #include <string>
+#include <limits>
+#include <mutex>
 #include <sol/sol.hpp>
 //==============================
 
@@ -31,6 +36,8 @@ namespace spartan
 {
     class Camera;
     class Light;
+    class Volume;
+    class Material;
 
     // metadata structure for reading world info without fully loading
     struct WorldMetadata
@@ -50,11 +57,17 @@ namespace spartan
 
         // io
         static bool SaveToFile(std::string filePath);
+
+        // snapshots of the runtime state (transforms, components, physics), used to restore the world when play mode stops
+        static void SaveSnapshot(std::vector<uint8_t>& out);
+        static bool LoadSnapshot(const std::vector<uint8_t>& data); // false if some state could not be restored
         static bool LoadFromFile(const std::string& file_path);
 
         // entities
         static sol::state_view GetLuaState();
         static Entity* CreateEntity();
+        static void ProcessPendingAdditions(); // created entities join the world on the next tick, this makes them join now
+        static std::vector<Entity*> SpawnBatch(const std::string& prefab_file_path, const std::vector<math::Matrix>& transforms); // returns the instance roots
         static bool EntityExists(Entity* entity);
         static void RemoveEntity(Entity* entity);
         static void RemoveEntityImmediate(Entity* entity);
@@ -65,6 +78,18 @@ namespace spartan
         static const std::vector<Entity*>& GetEntities();
         static const std::vector<Entity*>& GetEntitiesLights();
 
+        // volumes, backed by a spatial index, results are appended in entity order
+        static const std::vector<Entity*>& GetEntitiesVolumes();
+        static void GetVolumesAt(const math::Vector3& position, std::vector<Volume*>& volumes);
+        static void GetVolumesOverlapping(const math::BoundingBox& box, std::vector<Volume*>& volumes);
+
+        // raycasts against the triangles of active renderables, distances are in units of the ray direction
+        // safe to call from any thread, concurrent queries are serialized while they share the index
+        // removing a renderable from an entity holds LockRaycasts() so that no query is reading it, entity deletion does the same
+        static bool Raycast(const math::Ray& ray, math::RayHitResult& hit, const float max_distance = std::numeric_limits<float>::infinity());
+        static void RaycastAll(const math::Ray& ray, std::vector<math::RayHitResult>& hits, const float max_distance = std::numeric_limits<float>::infinity()); // appended near to far
+        static std::unique_lock<std::mutex> LockRaycasts();
+
         // misc
         static const std::string& GetName();
         static const std::string& GetFilePath();
@@ -75,6 +100,15 @@ namespace spartan
         static uint32_t GetAudioSourceCount();
         static bool HaveMaterialsChangedThisFrame();
         static bool HaveLightsChangedThisFrame();
+        static uint64_t GetRevision(); // changes when entities are added, removed or change components, caches compare against it
+
+        // change tracking, publishers call these when something actually changes and the world applies it once per tick
+        static void MarkEntityChanged(Entity* entity);                                        // components, active state or light type
+        static void UnmarkEntity(Entity* entity);                                             // drops the pending changes of an entity that is destroyed
+        static void MarkLightChanged(Light* light);                                           // light properties
+        static void MarkMaterialChanged(Material* material, const bool cull_mode_changed = false); // properties, textures or gpu state
+        static void MarkMaterialTexturesReady();                                              // a material texture finished preparing, materials bind it from now on
+        static void MarkRenderableBoundsChanged();                                            // a renderable's world space box changed, raycasts refit their index
 
         // world time: 0.0 = midnight, 0.5 = noon, 1.0 = next midnight
         static float GetTimeOfDay(bool use_real_world_time = false);
@@ -89,6 +123,5 @@ namespace spartan
 
     private:
         static void ProcessPendingRemovals();
-        static void ProcessPendingAdditions();
     };
 }